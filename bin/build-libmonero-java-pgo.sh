@@ -0,0 +1,35 @@
+#!/bin/sh
+
+# Builds libmonero-java with profile guided optimization:
+#   1. build with instrumentation
+#   2. run a training workload which exercises the JNI hot paths
+#   3. rebuild using the collected profiles
+#
+# Arguments are passed to cmake (e.g. -DMONERO_JAVA_LTO=ON).  The training
+# workload is the command in PGO_TRAINING_CMD, run from the project root.
+# libmonero-cpp must already be built to ./build (see build-libmonero-java.sh).
+
+PGO_DIR="$(pwd)/build/pgo"
+PGO_TRAINING_CMD=${PGO_TRAINING_CMD:-"mvn -q -Pbenchmark test-compile exec:exec -Djmh.args=\"-wi 1 -i 3 -f 1\""}
+NUM_JOBS=${NUM_JOBS:-$(getconf _NPROCESSORS_ONLN)}
+
+# Build instrumented library
+rm -rf "$PGO_DIR" &&
+mkdir -p ./build && cd build &&
+cmake -DCMAKE_BUILD_TYPE=${BUILD_TYPE:-Release} -DMONERO_JAVA_PGO=GENERATE -DMONERO_JAVA_PGO_DIR="$PGO_DIR" "$@" .. &&
+cmake --build . -- -j$NUM_JOBS &&
+cd .. &&
+
+# Run training workload
+echo "Training with: $PGO_TRAINING_CMD" &&
+sh -c "$PGO_TRAINING_CMD" &&
+
+# Merge clang's raw profiles, gcc reads its .gcda files directly
+if ls "$PGO_DIR"/*.profraw >/dev/null 2>&1; then
+  llvm-profdata merge -output="$PGO_DIR/default.profdata" "$PGO_DIR"/*.profraw || exit 1
+fi &&
+
+# Rebuild optimized with profiles
+cd build &&
+cmake -DMONERO_JAVA_PGO=USE "$@" .. &&
+cmake --build . -- -j$NUM_JOBS
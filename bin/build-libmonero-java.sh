@@ -2,17 +2,19 @@
 
 #EMCC_DEBUG=1 
 
-# Make libmonero-cpp.dylib
+# Shared library suffix of the platform
+if [ "$(uname)" = "Darwin" ]; then LIB_SUFFIX=dylib; else LIB_SUFFIX=so; fi
+
+# Make libmonero-cpp
 cd ./external/monero-cpp-library/ && 
 ./bin/build-libmonero-cpp.sh &&
 
-# Copy libmonero-cpp.dylib to ./build
+# Copy libmonero-cpp to ./build
 cd ../../ &&
 mkdir -p ./build &&
-cp ./external/monero-cpp-library/build/libmonero-cpp.dylib ./build &&
+cp ./external/monero-cpp-library/build/libmonero-cpp.$LIB_SUFFIX ./build &&
 
-# Make libmonero-java.dylib
+# Make libmonero-java, passing any arguments to cmake (e.g. -DMONERO_JAVA_LTO=ON)
 cd build && 
-cmake .. && 
-cmake --build . && 
-make .
\ No newline at end of file
+cmake -DCMAKE_BUILD_TYPE=${BUILD_TYPE:-Release} "$@" .. && 
+cmake --build . -- -j${NUM_JOBS:-$(getconf _NPROCESSORS_ONLN)}
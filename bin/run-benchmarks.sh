@@ -0,0 +1,27 @@
+#!/bin/sh
+
+# Runs the native benchmarks and the JMH benchmarks, writing json results to
+# ./build/benchmarks/native.json and ./build/benchmarks/jmh.json.
+#
+# libmonero-cpp and libmonero-java must already be built to ./build (see
+# build-libmonero-java.sh) and google benchmark must be installed.  Arguments
+# are passed to cmake.  BENCHMARK_FILTER selects benchmarks by regex in both
+# suites and JMH_ARGS replaces the default JMH options.  The recorded blocks
+# benchmarks are skipped unless MONERO_JAVA_RECORDED_BLOCKS is the path of a
+# response saved by `monero-java-fixtures record DAEMON_URI BLOCKS_PATH`.
+
+BENCHMARK_FILTER=${BENCHMARK_FILTER:-.}
+JMH_ARGS=${JMH_ARGS:-"-rf json -rff build/benchmarks/jmh.json"}
+NUM_JOBS=${NUM_JOBS:-$(getconf _NPROCESSORS_ONLN)}
+
+mkdir -p ./build/benchmarks &&
+
+# Build and run native benchmarks
+cd build &&
+cmake -DMONERO_JAVA_BENCHMARKS=ON "$@" .. &&
+cmake --build . --target monero-java-benchmark -- -j$NUM_JOBS &&
+./monero-java-benchmark --benchmark_filter="$BENCHMARK_FILTER" --benchmark_out=benchmarks/native.json --benchmark_out_format=json &&
+cd .. &&
+
+# Run JMH benchmarks
+mvn -q -Pbenchmark test-compile exec:exec -Djmh.args="$JMH_ARGS $BENCHMARK_FILTER"
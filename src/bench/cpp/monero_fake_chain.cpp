@@ -0,0 +1,368 @@
+/**
+ * Copyright (c) 2017-2019 woodser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "monero_fake_chain.h"
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <random>
+#include <stdexcept>
+#include "cryptonote_basic/account.h"
+#include "cryptonote_basic/cryptonote_format_utils.h"
+#include "cryptonote_core/cryptonote_tx_utils.h"
+#include "device/device.hpp"
+#include "file_io_utils.h"
+#include "mnemonics/electrum-words.h"
+#include "ringct/rctOps.h"
+#include "storages/portable_storage_template_helper.h"
+
+using namespace std;
+
+namespace {
+
+  const uint64_t BLOCK_TIMESTAMP = 1570000000; // timestamp of block 1
+  const uint64_t MINER_REWARD = 600000000000;
+  const uint64_t FEE = 30000000;
+  const uint64_t MIN_OUTPUT_AMOUNT = 10000000000;
+  const uint64_t MAX_OUTPUT_AMOUNT = 1000000000000;
+
+  /**
+   * Chain as saved to a file.
+   */
+  struct fake_chain_file {
+    uint8_t network_type;
+    string mnemonic;
+    uint32_t num_accounts;
+    uint32_t num_subaddresses;
+    vector<cryptonote::block_complete_entry> blocks;
+    vector<cryptonote::COMMAND_RPC_GET_BLOCKS_FAST::block_output_indices> output_indices;
+
+    BEGIN_KV_SERIALIZE_MAP()
+      KV_SERIALIZE(network_type)
+      KV_SERIALIZE(mnemonic)
+      KV_SERIALIZE(num_accounts)
+      KV_SERIALIZE(num_subaddresses)
+      KV_SERIALIZE(blocks)
+      KV_SERIALIZE(output_indices)
+    END_KV_SERIALIZE_MAP()
+  };
+
+  /**
+   * Subaddress paid by the chain.
+   */
+  struct recipient {
+    crypto::public_key m_spend_key;
+    crypto::public_key m_view_key;
+    bool m_is_subaddress;
+  };
+
+  /**
+   * Output paid to the wallet which may later be spent.
+   */
+  struct wallet_output {
+    crypto::public_key m_key;
+    crypto::public_key m_tx_pub_key;
+    size_t m_index;
+    uint64_t m_amount;
+    uint64_t m_global_index;
+    uint64_t m_height;
+  };
+
+  /**
+   * Generates scalars and amounts deterministically from a seed.
+   */
+  class fake_random {
+  public:
+    fake_random(uint64_t seed) : m_rng(seed) { }
+
+    rct::key next_scalar() {
+      rct::key key;
+      for (size_t i = 0; i < sizeof(key.bytes); i += sizeof(uint64_t)) {
+        uint64_t value = m_rng();
+        memcpy(key.bytes + i, &value, sizeof(value));
+      }
+      return rct::hash_to_scalar(key);
+    }
+
+    crypto::public_key next_public_key() {
+      return rct::rct2pk(rct::scalarmultBase(next_scalar()));
+    }
+
+    uint64_t next_uint64(uint64_t min, uint64_t max) {
+      return uniform_int_distribution<uint64_t>(min, max)(m_rng);
+    }
+
+    double next_double() {
+      return uniform_real_distribution<double>(0, 1)(m_rng);
+    }
+
+  private:
+    mt19937_64 m_rng;
+  };
+
+  cryptonote::transaction build_miner_tx(uint64_t height, fake_random& random) {
+    cryptonote::transaction tx;
+    tx.version = 1;
+    tx.unlock_time = height + CRYPTONOTE_MINED_MONEY_UNLOCK_WINDOW;
+    cryptonote::txin_gen in;
+    in.height = height;
+    tx.vin.push_back(in);
+    cryptonote::tx_out out;
+    out.amount = MINER_REWARD;
+    out.target = cryptonote::txout_to_key(random.next_public_key());
+    tx.vout.push_back(out);
+    cryptonote::add_tx_pub_key_to_extra(tx, random.next_public_key());
+    return tx;
+  }
+
+  cryptonote::COMMAND_RPC_GET_BLOCKS_FAST::tx_output_indices assign_output_indices(const cryptonote::transaction& tx, uint64_t& num_outputs) {
+    cryptonote::COMMAND_RPC_GET_BLOCKS_FAST::tx_output_indices indices;
+    for (size_t i = 0; i < tx.vout.size(); i++) indices.indices.push_back(num_outputs++);
+    return indices;
+  }
+}
+
+monero_fake_chain monero_fake_chain::generate(const monero_fake_chain_config& config) {
+  if (config.m_num_blocks == 0) throw runtime_error("Fake chain must have at least the genesis block");
+  if (config.m_num_accounts == 0 || config.m_num_subaddresses == 0) throw runtime_error("Fake chain must pay at least one subaddress");
+  if (config.m_outputs_per_tx == 0) throw runtime_error("Fake chain txs must have at least one output");
+
+  // derive wallet keys from mnemonic
+  crypto::secret_key recovery_key;
+  string language;
+  if (!crypto::ElectrumWords::words_to_bytes(config.m_mnemonic, recovery_key, language)) throw runtime_error("Invalid mnemonic");
+  cryptonote::account_base account;
+  account.generate(recovery_key, true, false);
+  const cryptonote::account_keys& keys = account.get_keys();
+  hw::device& hwdev = hw::get_device("default");
+
+  // derive subaddresses to pay and look up for key images
+  vector<recipient> recipients;
+  unordered_map<crypto::public_key, cryptonote::subaddress_index> subaddresses;
+  for (uint32_t account_idx = 0; account_idx < config.m_num_accounts; account_idx++) {
+    vector<crypto::public_key> spend_keys = hwdev.get_subaddress_spend_public_keys(keys, account_idx, 0, config.m_num_subaddresses);
+    if (account_idx == 0) spend_keys[0] = keys.m_account_address.m_spend_public_key;
+    for (uint32_t subaddress_idx = 0; subaddress_idx < config.m_num_subaddresses; subaddress_idx++) {
+      recipient r;
+      r.m_is_subaddress = account_idx != 0 || subaddress_idx != 0;
+      r.m_spend_key = spend_keys[subaddress_idx];
+      r.m_view_key = r.m_is_subaddress ? rct::rct2pk(rct::scalarmultKey(rct::pk2rct(r.m_spend_key), rct::sk2rct(keys.m_view_secret_key))) : keys.m_account_address.m_view_public_key;
+      recipients.push_back(r);
+      subaddresses[r.m_spend_key] = {account_idx, subaddress_idx};
+    }
+  }
+
+  monero_fake_chain chain;
+  chain.m_network_type = config.m_network_type;
+  chain.m_mnemonic = config.m_mnemonic;
+  chain.m_num_accounts = config.m_num_accounts;
+  chain.m_num_subaddresses = config.m_num_subaddresses;
+  chain.m_blocks.reserve(config.m_num_blocks);
+  chain.m_output_indices.reserve(config.m_num_blocks);
+  chain.m_block_hashes.reserve(config.m_num_blocks);
+
+  // start from the network's genesis block
+  cryptonote::block genesis;
+  const cryptonote::config_t& network_config = cryptonote::get_config(config.m_network_type);
+  if (!cryptonote::generate_genesis_block(genesis, network_config.GENESIS_TX, network_config.GENESIS_NONCE)) throw runtime_error("Failed to generate genesis block");
+  uint64_t num_outputs = 0;
+  cryptonote::COMMAND_RPC_GET_BLOCKS_FAST::block_output_indices genesis_indices;
+  genesis_indices.indices.push_back(assign_output_indices(genesis.miner_tx, num_outputs));
+  chain.add_block(genesis, {}, std::move(genesis_indices));
+
+  // build blocks paying the wallet
+  fake_random random(config.m_seed);
+  deque<wallet_output> unspent; // in order received so the oldest is spent first
+  size_t recipient_idx = 0;
+  for (uint64_t height = 1; height < config.m_num_blocks; height++) {
+    cryptonote::block block;
+    block.major_version = HARD_FORK_VERSION;
+    block.minor_version = HARD_FORK_VERSION;
+    block.timestamp = BLOCK_TIMESTAMP + (height - 1) * DIFFICULTY_TARGET_V2;
+    block.prev_id = chain.m_block_hashes.back();
+    block.nonce = static_cast<uint32_t>(height);
+    block.miner_tx = build_miner_tx(height, random);
+    cryptonote::COMMAND_RPC_GET_BLOCKS_FAST::block_output_indices block_indices;
+    block_indices.indices.push_back(assign_output_indices(block.miner_tx, num_outputs));
+
+    vector<cryptonote::transaction> txs;
+    txs.reserve(config.m_txs_per_block);
+    for (uint32_t tx_idx = 0; tx_idx < config.m_txs_per_block; tx_idx++) {
+      cryptonote::transaction tx;
+      tx.version = 1;
+      tx.unlock_time = 0;
+
+      // drop the oldest wallet output if it's too small to pay the fee
+      while (!unspent.empty() && unspent.front().m_amount < FEE + config.m_outputs_per_tx) unspent.pop_front();
+
+      // spend the oldest mature wallet output or an unrelated input
+      cryptonote::txin_to_key in;
+      uint64_t amount;
+      if (!unspent.empty() && unspent.front().m_height + CRYPTONOTE_DEFAULT_TX_SPENDABLE_AGE <= height && random.next_double() < config.m_spend_ratio) {
+        const wallet_output& output = unspent.front();
+        cryptonote::keypair ephemeral;
+        if (!cryptonote::generate_key_image_helper(keys, subaddresses, output.m_key, output.m_tx_pub_key, {}, output.m_index, ephemeral, in.k_image, hwdev)) throw runtime_error("Failed to generate key image");
+        in.amount = output.m_amount;
+        in.key_offsets.push_back(output.m_global_index);
+        amount = (output.m_amount - FEE) / config.m_outputs_per_tx;
+        unspent.pop_front();
+      } else {
+        amount = random.next_uint64(MIN_OUTPUT_AMOUNT, MAX_OUTPUT_AMOUNT);
+        in.amount = amount * config.m_outputs_per_tx + FEE;
+        in.key_offsets.push_back(random.next_uint64(0, num_outputs - 1));
+        in.k_image = rct::rct2ki(rct::scalarmultBase(random.next_scalar()));
+      }
+      tx.vin.push_back(in);
+      tx.signatures.push_back(vector<crypto::signature>(in.key_offsets.size()));
+
+      // pay the next subaddress
+      const recipient& r = recipients[recipient_idx++ % recipients.size()];
+      rct::key tx_key = random.next_scalar();
+      crypto::public_key tx_pub_key = rct::rct2pk(r.m_is_subaddress ? rct::scalarmultKey(rct::pk2rct(r.m_spend_key), tx_key) : rct::scalarmultBase(tx_key));
+      crypto::key_derivation derivation;
+      if (!crypto::generate_key_derivation(r.m_view_key, rct::rct2sk(tx_key), derivation)) throw runtime_error("Failed to generate key derivation");
+      for (uint32_t out_idx = 0; out_idx < config.m_outputs_per_tx; out_idx++) {
+        crypto::public_key out_key;
+        if (!crypto::derive_public_key(derivation, out_idx, r.m_spend_key, out_key)) throw runtime_error("Failed to derive output key");
+        cryptonote::tx_out out;
+        out.amount = amount;
+        out.target = cryptonote::txout_to_key(out_key);
+        tx.vout.push_back(out);
+        unspent.push_back({out_key, tx_pub_key, out_idx, amount, num_outputs + out_idx, height});
+      }
+      cryptonote::add_tx_pub_key_to_extra(tx, tx_pub_key);
+      block_indices.indices.push_back(assign_output_indices(tx, num_outputs));
+      block.tx_hashes.push_back(cryptonote::get_transaction_hash(tx));
+      txs.push_back(std::move(tx));
+    }
+    chain.add_block(block, txs, std::move(block_indices));
+  }
+  return chain;
+}
+
+monero_fake_chain monero_fake_chain::load(const string& path) {
+  string file_bin;
+  if (!epee::file_io_utils::load_file_to_string(path, file_bin)) throw runtime_error("Failed to read fake chain from " + path);
+  fake_chain_file file;
+  if (!epee::serialization::load_t_from_binary(file, file_bin)) throw runtime_error("Invalid fake chain file " + path);
+  if (file.blocks.empty() || file.blocks.size() != file.output_indices.size()) throw runtime_error("Invalid fake chain file " + path);
+  monero_fake_chain chain;
+  chain.m_network_type = static_cast<cryptonote::network_type>(file.network_type);
+  chain.m_mnemonic = file.mnemonic;
+  chain.m_num_accounts = file.num_accounts;
+  chain.m_num_subaddresses = file.num_subaddresses;
+  chain.m_blocks = std::move(file.blocks);
+  chain.m_output_indices = std::move(file.output_indices);
+  chain.index_blocks();
+  return chain;
+}
+
+void monero_fake_chain::save(const string& path) const {
+  fake_chain_file file;
+  file.network_type = static_cast<uint8_t>(m_network_type);
+  file.mnemonic = m_mnemonic;
+  file.num_accounts = m_num_accounts;
+  file.num_subaddresses = m_num_subaddresses;
+  file.blocks = m_blocks;
+  file.output_indices = m_output_indices;
+  string file_bin;
+  if (!epee::serialization::store_t_to_binary(file, file_bin)) throw runtime_error("Failed to serialize fake chain");
+  if (!epee::file_io_utils::save_string_to_file(path, file_bin)) throw runtime_error("Failed to write fake chain to " + path);
+}
+
+bool monero_fake_chain::find_split_height(const list<crypto::hash>& block_ids, uint64_t& height) const {
+  for (const crypto::hash& block_id : block_ids) {
+    unordered_map<crypto::hash, uint64_t>::const_iterator iter = m_heights.find(block_id);
+    if (iter != m_heights.end()) {
+      height = iter->second;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool monero_fake_chain::find_tx(const crypto::hash& tx_hash, uint64_t& height, size_t& idx) const {
+  unordered_map<crypto::hash, pair<uint64_t, size_t>>::const_iterator iter = m_tx_locations.find(tx_hash);
+  if (iter == m_tx_locations.end()) return false;
+  height = iter->second.first;
+  idx = iter->second.second;
+  return true;
+}
+
+void monero_fake_chain::add_block(const cryptonote::block& block, const vector<cryptonote::transaction>& txs, cryptonote::COMMAND_RPC_GET_BLOCKS_FAST::block_output_indices&& output_indices) {
+  cryptonote::block_complete_entry entry;
+  entry.pruned = false;
+  entry.block = cryptonote::block_to_blob(block);
+  entry.block_weight = cryptonote::get_transaction_weight(block.miner_tx);
+  for (const cryptonote::transaction& tx : txs) {
+    cryptonote::blobdata tx_blob = cryptonote::tx_to_blob(tx);
+    entry.block_weight += tx_blob.size(); // weight of a version 1 tx is its size
+    entry.txs.push_back(cryptonote::tx_blob_entry(tx_blob));
+  }
+  crypto::hash hash = cryptonote::get_block_hash(block);
+  uint64_t height = m_blocks.size();
+  m_heights[hash] = height;
+  m_block_hashes.push_back(hash);
+  m_blocks.push_back(std::move(entry));
+  m_output_indices.push_back(std::move(output_indices));
+  index_tx(height, block.miner_tx);
+  for (size_t idx = 0; idx < txs.size(); idx++) {
+    m_tx_locations[cryptonote::get_transaction_hash(txs[idx])] = make_pair(height, idx);
+    index_tx(height, txs[idx]);
+  }
+  m_num_outputs_through.push_back(m_outputs.size());
+}
+
+void monero_fake_chain::index_blocks() {
+  m_block_hashes.clear();
+  m_heights.clear();
+  m_tx_locations.clear();
+  m_key_images.clear();
+  m_outputs.clear();
+  m_num_outputs_through.clear();
+  for (size_t height = 0; height < m_blocks.size(); height++) {
+    cryptonote::block block;
+    if (!cryptonote::parse_and_validate_block_from_blob(m_blocks[height].block, block)) throw runtime_error("Invalid block at height " + to_string(height));
+    crypto::hash hash = cryptonote::get_block_hash(block);
+    m_heights[hash] = height;
+    m_block_hashes.push_back(hash);
+    index_tx(height, block.miner_tx);
+    for (size_t idx = 0; idx < m_blocks[height].txs.size(); idx++) {
+      cryptonote::transaction tx;
+      if (!cryptonote::parse_and_validate_tx_from_blob(m_blocks[height].txs[idx].blob, tx)) throw runtime_error("Invalid tx at height " + to_string(height));
+      m_tx_locations[cryptonote::get_transaction_hash(tx)] = make_pair(height, idx);
+      index_tx(height, tx);
+    }
+    m_num_outputs_through.push_back(m_outputs.size());
+  }
+}
+
+void monero_fake_chain::index_tx(uint64_t height, const cryptonote::transaction& tx) {
+  for (const cryptonote::txin_v& in : tx.vin) {
+    if (in.type() == typeid(cryptonote::txin_to_key)) m_key_images.insert(boost::get<cryptonote::txin_to_key>(in).k_image);
+  }
+  crypto::hash txid = cryptonote::get_transaction_hash(tx);
+  uint64_t unlock_height = max(height + CRYPTONOTE_DEFAULT_TX_SPENDABLE_AGE, tx.unlock_time); // unlock times are heights on this chain
+  for (const cryptonote::tx_out& out : tx.vout) {
+    m_outputs.push_back({boost::get<cryptonote::txout_to_key>(out.target).key, out.amount, txid, height, unlock_height});
+  }
+}
@@ -0,0 +1,172 @@
+/**
+ * Copyright (c) 2017-2019 woodser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef monero_fake_chain_h
+#define monero_fake_chain_h
+
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "cryptonote_basic/cryptonote_basic.h"
+#include "rpc/core_rpc_server_commands_defs.h"
+
+/**
+ * Shape of a generated chain and the wallet it pays.
+ */
+struct monero_fake_chain_config {
+  cryptonote::network_type m_network_type = cryptonote::STAGENET;
+  std::string m_mnemonic;           // seed of the wallet paid by the chain
+  uint64_t m_num_blocks = 1000;     // including the genesis block
+  uint32_t m_txs_per_block = 10;
+  uint32_t m_outputs_per_tx = 2;
+  uint32_t m_num_accounts = 5;
+  uint32_t m_num_subaddresses = 50; // per account
+  double m_spend_ratio = 0.5;       // fraction of txs which spend a wallet output
+  uint64_t m_seed = 1;
+};
+
+/**
+ * Output of a fake chain as the daemon returns it from get_outs.
+ */
+struct monero_fake_output {
+  crypto::public_key m_key;
+  uint64_t m_amount;
+  crypto::hash m_txid;
+  uint64_t m_height;
+  uint64_t m_unlock_height;  // height from which the output may be spent
+};
+
+/**
+ * Deterministic synthetic chain which pays a wallet, for syncing and
+ * benchmarking without a network.
+ *
+ * The chain starts with the network's real genesis block so a wallet
+ * restored from height 0 accepts it.  Each later block has a miner tx to an
+ * unrelated key and txs whose outputs pay the wallet's subaddresses round
+ * robin.  A tx either spends one of the wallet's mature outputs, so the
+ * wallet records it as outgoing, or an unrelated input.
+ *
+ * Txs are version 1 with cleartext amounts, which the wallet scans without
+ * decrypting amounts, and carry empty signatures since the wallet trusts its
+ * daemon to have verified them.  Nothing here would pass consensus; blocks
+ * have no proof of work and inputs reference arbitrary ring members.
+ *
+ * Blocks are kept as the blobs and output indices the daemon sends in
+ * getblocks.bin, and saved to a file in portable storage.  Outputs of all
+ * amounts share one global index space.
+ */
+class monero_fake_chain {
+public:
+
+  /**
+   * Generate a chain.
+   *
+   * @param config is the shape of the chain to generate
+   * @return the generated chain
+   * @throws runtime_error if the mnemonic is invalid
+   */
+  static monero_fake_chain generate(const monero_fake_chain_config& config);
+
+  /**
+   * Load a chain saved by save().
+   *
+   * @param path is the path of the chain file
+   * @return the loaded chain
+   * @throws runtime_error if the file cannot be read or is invalid
+   */
+  static monero_fake_chain load(const std::string& path);
+
+  /**
+   * Save the chain.
+   *
+   * @param path is the path of the chain file to write
+   * @throws runtime_error if the file cannot be written
+   */
+  void save(const std::string& path) const;
+
+  cryptonote::network_type get_network_type() const { return m_network_type; }
+  const std::string& get_mnemonic() const { return m_mnemonic; }
+  uint32_t get_num_accounts() const { return m_num_accounts; }
+  uint32_t get_num_subaddresses() const { return m_num_subaddresses; }
+  uint64_t get_height() const { return m_blocks.size(); }
+  const crypto::hash& get_block_hash(uint64_t height) const { return m_block_hashes.at(height); }
+  const cryptonote::block_complete_entry& get_block_entry(uint64_t height) const { return m_blocks.at(height); }
+  const cryptonote::COMMAND_RPC_GET_BLOCKS_FAST::block_output_indices& get_output_indices(uint64_t height) const { return m_output_indices.at(height); }
+  uint64_t get_num_outputs() const { return m_outputs.size(); }
+  const monero_fake_output& get_output(uint64_t index) const { return m_outputs.at(index); }
+  uint64_t get_num_outputs_before(uint64_t height) const { return height == 0 ? 0 : m_num_outputs_through.at(height - 1); }
+
+  /**
+   * Get the height of the highest block in a wallet's short chain history
+   * which is in this chain.
+   *
+   * @param block_ids are block hashes from highest to lowest
+   * @param height is assigned the height of the first known block
+   * @return true if a block is known, false otherwise
+   */
+  bool find_split_height(const std::list<crypto::hash>& block_ids, uint64_t& height) const;
+
+  /**
+   * Find a tx other than a miner tx.
+   *
+   * @param tx_hash is the hash of the tx to find
+   * @param height is assigned the height of the tx's block
+   * @param idx is assigned the index of the tx in its block's txs
+   * @return true if the tx is in the chain, false otherwise
+   */
+  bool find_tx(const crypto::hash& tx_hash, uint64_t& height, size_t& idx) const;
+
+  /**
+   * Indicates if a key image is spent by a tx in the chain.
+   */
+  bool is_key_image_spent(const crypto::key_image& key_image) const { return m_key_images.count(key_image) > 0; }
+
+  /**
+   * Get the hard fork version of blocks after the genesis block.
+   */
+  static uint8_t get_hard_fork_version() { return HARD_FORK_VERSION; }
+
+private:
+  cryptonote::network_type m_network_type;
+  std::string m_mnemonic;
+  uint32_t m_num_accounts;
+  uint32_t m_num_subaddresses;
+  std::vector<cryptonote::block_complete_entry> m_blocks;
+  std::vector<cryptonote::COMMAND_RPC_GET_BLOCKS_FAST::block_output_indices> m_output_indices;
+  std::vector<crypto::hash> m_block_hashes;
+  std::unordered_map<crypto::hash, uint64_t> m_heights;
+  std::unordered_map<crypto::hash, std::pair<uint64_t, size_t>> m_tx_locations; // height and index in block of each tx
+  std::unordered_set<crypto::key_image> m_key_images;  // spent by txs in the chain
+  std::vector<monero_fake_output> m_outputs;          // by global index
+  std::vector<uint64_t> m_num_outputs_through;        // number of outputs up to and including each block
+
+  static const uint8_t HARD_FORK_VERSION = 12;
+
+  void add_block(const cryptonote::block& block, const std::vector<cryptonote::transaction>& txs, cryptonote::COMMAND_RPC_GET_BLOCKS_FAST::block_output_indices&& output_indices);
+  void index_blocks();
+  void index_tx(uint64_t height, const cryptonote::transaction& tx);
+};
+
+#endif /* monero_fake_chain_h */
@@ -0,0 +1,441 @@
+/**
+ * Copyright (c) 2017-2019 woodser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "monero_fake_daemon.h"
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include "crypto/crypto.h"
+#include "cryptonote_basic/cryptonote_format_utils.h"
+#include "ringct/rctOps.h"
+#include "string_tools.h"
+
+using namespace std;
+using namespace cryptonote;
+
+// formats a difficulty as the daemon's wide difficulty fields
+static string to_wide_difficulty(uint64_t difficulty) {
+  ostringstream oss;
+  oss << "0x" << std::hex << difficulty;
+  return oss.str();
+}
+
+bool monero_fake_daemon::init(const string& bind_ip, const string& bind_port) {
+  return epee::http_server_impl_base<monero_fake_daemon>::init([](size_t size, uint8_t* data) { crypto::generate_random_bytes_thread_safe(size, data); }, bind_port, bind_ip, {}, boost::none, epee::net_utils::ssl_support_t::e_ssl_support_disabled);
+}
+
+bool monero_fake_daemon::on_get_info(const COMMAND_RPC_GET_INFO::request& req, COMMAND_RPC_GET_INFO::response& res, const connection_context* ctx) {
+  uint64_t height = m_chain.get_height();
+  res.height = height;
+  res.target_height = height;
+  res.difficulty = DIFFICULTY;
+  res.wide_difficulty = to_wide_difficulty(DIFFICULTY);
+  res.target = DIFFICULTY_TARGET_V2;
+  res.top_block_hash = epee::string_tools::pod_to_hex(m_chain.get_block_hash(height - 1));
+  res.cumulative_difficulty = height * DIFFICULTY;
+  res.wide_cumulative_difficulty = to_wide_difficulty(height * DIFFICULTY);
+  res.block_size_limit = res.block_weight_limit = 2 * CRYPTONOTE_BLOCK_GRANTED_FULL_REWARD_ZONE_V5;
+  res.block_size_median = res.block_weight_median = CRYPTONOTE_BLOCK_GRANTED_FULL_REWARD_ZONE_V5;
+  res.mainnet = m_chain.get_network_type() == MAINNET;
+  res.testnet = m_chain.get_network_type() == TESTNET;
+  res.stagenet = m_chain.get_network_type() == STAGENET;
+  res.nettype = res.mainnet ? "mainnet" : res.testnet ? "testnet" : res.stagenet ? "stagenet" : "fakechain";
+  res.offline = false;
+  {
+    lock_guard<mutex> lock(m_pool_mutex);
+    res.tx_pool_size = m_pool_txs.size();
+  }
+  res.untrusted = false;
+  res.status = CORE_RPC_STATUS_OK;
+  return true;
+}
+
+bool monero_fake_daemon::on_get_height(const COMMAND_RPC_GET_HEIGHT::request& req, COMMAND_RPC_GET_HEIGHT::response& res, const connection_context* ctx) {
+  res.height = m_chain.get_height();
+  res.untrusted = false;
+  res.status = CORE_RPC_STATUS_OK;
+  return true;
+}
+
+bool monero_fake_daemon::on_get_blocks(const COMMAND_RPC_GET_BLOCKS_FAST::request& req, COMMAND_RPC_GET_BLOCKS_FAST::response& res, const connection_context* ctx) {
+
+  // start from the requested height or else the highest block the wallet shares with the chain, as the daemon does
+  uint64_t start_height;
+  if (req.start_height > 0) {
+    if (req.start_height >= m_chain.get_height()) {
+      res.status = "Failed";
+      return true;
+    }
+    start_height = req.start_height;
+  } else if (!m_chain.find_split_height(req.block_ids, start_height)) {
+    res.status = "Failed";
+    return true;
+  }
+
+  // replay blocks with their output indices
+  uint64_t end_height = min(m_chain.get_height(), start_height + MAX_BLOCKS_PER_REQUEST);
+  res.blocks.reserve(end_height - start_height);
+  res.output_indices.reserve(end_height - start_height);
+  for (uint64_t height = start_height; height < end_height; height++) {
+    res.blocks.push_back(m_chain.get_block_entry(height));
+    res.output_indices.push_back(m_chain.get_output_indices(height));
+  }
+  res.start_height = start_height;
+  res.current_height = m_chain.get_height();
+  res.untrusted = false;
+  res.status = CORE_RPC_STATUS_OK;
+  return true;
+}
+
+bool monero_fake_daemon::on_get_blocks_by_height(const COMMAND_RPC_GET_BLOCKS_BY_HEIGHT::request& req, COMMAND_RPC_GET_BLOCKS_BY_HEIGHT::response& res, const connection_context* ctx) {
+  res.blocks.reserve(req.heights.size());
+  for (uint64_t height : req.heights) {
+    if (height >= m_chain.get_height()) {
+      res.blocks.clear();
+      res.status = "Error retrieving block at height " + std::to_string(height);
+      return true;
+    }
+    res.blocks.push_back(m_chain.get_block_entry(height));
+  }
+  res.untrusted = false;
+  res.status = CORE_RPC_STATUS_OK;
+  return true;
+}
+
+bool monero_fake_daemon::on_get_hashes(const COMMAND_RPC_GET_HASHES_FAST::request& req, COMMAND_RPC_GET_HASHES_FAST::response& res, const connection_context* ctx) {
+  uint64_t start_height;
+  if (!m_chain.find_split_height(req.block_ids, start_height)) {
+    res.status = "Failed";
+    return true;
+  }
+  start_height = max(start_height, req.start_height);
+  for (uint64_t height = start_height; height < m_chain.get_height(); height++) res.m_block_ids.push_back(m_chain.get_block_hash(height));
+  res.start_height = start_height;
+  res.current_height = m_chain.get_height();
+  res.untrusted = false;
+  res.status = CORE_RPC_STATUS_OK;
+  return true;
+}
+
+bool monero_fake_daemon::on_get_transaction_pool_hashes_bin(const COMMAND_RPC_GET_TRANSACTION_POOL_HASHES_BIN::request& req, COMMAND_RPC_GET_TRANSACTION_POOL_HASHES_BIN::response& res, const connection_context* ctx) {
+  {
+    lock_guard<mutex> lock(m_pool_mutex);
+    for (const auto& pool_tx : m_pool_txs) res.tx_hashes.push_back(pool_tx.first);
+  }
+  res.untrusted = false;
+  res.status = CORE_RPC_STATUS_OK;
+  return true;
+}
+
+bool monero_fake_daemon::on_get_transaction_pool_hashes(const COMMAND_RPC_GET_TRANSACTION_POOL_HASHES::request& req, COMMAND_RPC_GET_TRANSACTION_POOL_HASHES::response& res, const connection_context* ctx) {
+  {
+    lock_guard<mutex> lock(m_pool_mutex);
+    for (const auto& pool_tx : m_pool_txs) res.tx_hashes.push_back(epee::string_tools::pod_to_hex(pool_tx.first));
+  }
+  res.untrusted = false;
+  res.status = CORE_RPC_STATUS_OK;
+  return true;
+}
+
+bool monero_fake_daemon::on_get_transactions(const COMMAND_RPC_GET_TRANSACTIONS::request& req, COMMAND_RPC_GET_TRANSACTIONS::response& res, const connection_context* ctx) {
+  for (const string& tx_hash_hex : req.txs_hashes) {
+    crypto::hash tx_hash;
+    if (!epee::string_tools::hex_to_pod(tx_hash_hex, tx_hash)) {
+      res.status = "Failed to parse hex representation of transaction hash";
+      return true;
+    }
+
+    // find tx in the chain or else the pool, always returning the whole tx
+    COMMAND_RPC_GET_TRANSACTIONS::entry entry;
+    entry.tx_hash = tx_hash_hex;
+    entry.double_spend_seen = false;
+    cryptonote::blobdata tx_blob;
+    uint64_t height;
+    size_t idx;
+    if (m_chain.find_tx(tx_hash, height, idx)) {
+      tx_blob = m_chain.get_block_entry(height).txs[idx].blob;
+      block b;
+      if (!parse_and_validate_block_from_blob(m_chain.get_block_entry(height).block, b)) throw runtime_error("Invalid block at height " + std::to_string(height));
+      entry.in_pool = false;
+      entry.block_height = height;
+      entry.block_timestamp = b.timestamp;
+      entry.output_indices = m_chain.get_output_indices(height).indices[idx + 1].indices; // after the miner tx
+    } else {
+      lock_guard<mutex> lock(m_pool_mutex);
+      auto iter = m_pool_txs.find(tx_hash);
+      if (iter == m_pool_txs.end()) {
+        res.missed_tx.push_back(tx_hash_hex);
+        continue;
+      }
+      tx_blob = iter->second;
+      entry.in_pool = true;
+      entry.relayed = true;
+      entry.block_height = 0;
+      entry.block_timestamp = 0;
+    }
+    entry.as_hex = epee::string_tools::buff_to_hex_nodelimer(tx_blob);
+    if (req.decode_as_json) {
+      transaction tx;
+      if (!parse_and_validate_tx_from_blob(tx_blob, tx)) throw runtime_error("Invalid tx " + tx_hash_hex);
+      entry.as_json = obj_to_json_str(tx);
+    }
+    res.txs_as_hex.push_back(entry.as_hex);
+    res.txs.push_back(std::move(entry));
+  }
+  res.untrusted = false;
+  res.status = CORE_RPC_STATUS_OK;
+  return true;
+}
+
+bool monero_fake_daemon::on_is_key_image_spent(const COMMAND_RPC_IS_KEY_IMAGE_SPENT::request& req, COMMAND_RPC_IS_KEY_IMAGE_SPENT::response& res, const connection_context* ctx) {
+  lock_guard<mutex> lock(m_pool_mutex);
+  for (const string& key_image_hex : req.key_images) {
+    crypto::key_image key_image;
+    if (!epee::string_tools::hex_to_pod(key_image_hex, key_image)) {
+      res.spent_status.clear();
+      res.status = "Failed";
+      return true;
+    }
+    if (m_chain.is_key_image_spent(key_image)) res.spent_status.push_back(COMMAND_RPC_IS_KEY_IMAGE_SPENT::SPENT_IN_BLOCKCHAIN);
+    else if (m_pool_key_images.count(key_image)) res.spent_status.push_back(COMMAND_RPC_IS_KEY_IMAGE_SPENT::SPENT_IN_POOL);
+    else res.spent_status.push_back(COMMAND_RPC_IS_KEY_IMAGE_SPENT::UNSPENT);
+  }
+  res.untrusted = false;
+  res.status = CORE_RPC_STATUS_OK;
+  return true;
+}
+
+bool monero_fake_daemon::on_send_raw_tx(const COMMAND_RPC_SEND_RAW_TX::request& req, COMMAND_RPC_SEND_RAW_TX::response& res, const connection_context* ctx) {
+  cryptonote::blobdata tx_blob;
+  transaction tx;
+  if (!epee::string_tools::parse_hexstr_to_binbuff(req.tx_as_hex, tx_blob) || !parse_and_validate_tx_from_blob(tx_blob, tx)) {
+    res.status = "Failed";
+    res.reason = "Failed to parse tx";
+    return true;
+  }
+  crypto::hash tx_hash = get_transaction_hash(tx);
+
+  // add to the pool unless a key image is already spent in it, acknowledging a tx already in the pool
+  lock_guard<mutex> lock(m_pool_mutex);
+  if (m_pool_txs.count(tx_hash) == 0) {
+    for (const txin_v& in : tx.vin) {
+      if (in.type() == typeid(txin_to_key) && m_pool_key_images.count(boost::get<txin_to_key>(in).k_image)) {
+        res.status = "Failed";
+        res.reason = "double spend";
+        res.double_spend = true;
+        return true;
+      }
+    }
+    for (const txin_v& in : tx.vin) {
+      if (in.type() == typeid(txin_to_key)) m_pool_key_images.insert(boost::get<txin_to_key>(in).k_image);
+    }
+    m_pool_txs[tx_hash] = tx_blob;
+  }
+  res.not_relayed = req.do_not_relay;
+  res.untrusted = false;
+  res.status = CORE_RPC_STATUS_OK;
+  return true;
+}
+
+bool monero_fake_daemon::on_get_outs_bin(const COMMAND_RPC_GET_OUTPUTS_BIN::request& req, COMMAND_RPC_GET_OUTPUTS_BIN::response& res, const connection_context* ctx) {
+  if (req.outputs.size() > MAX_OUTPUTS_PER_REQUEST) {
+    res.status = "Too many outs requested";
+    return true;
+  }
+  res.outs.resize(req.outputs.size());
+  for (size_t i = 0; i < req.outputs.size(); i++) {
+    if (!fill_outkey(req.outputs[i], res.outs[i])) {
+      res.outs.clear();
+      res.status = "Failed";
+      return true;
+    }
+  }
+  res.untrusted = false;
+  res.status = CORE_RPC_STATUS_OK;
+  return true;
+}
+
+bool monero_fake_daemon::on_get_outs(const COMMAND_RPC_GET_OUTPUTS::request& req, COMMAND_RPC_GET_OUTPUTS::response& res, const connection_context* ctx) {
+  COMMAND_RPC_GET_OUTPUTS_BIN::request req_bin;
+  req_bin.outputs = req.outputs;
+  req_bin.get_txid = req.get_txid;
+  COMMAND_RPC_GET_OUTPUTS_BIN::response res_bin;
+  on_get_outs_bin(req_bin, res_bin, ctx);
+  for (const COMMAND_RPC_GET_OUTPUTS_BIN::outkey& outkey : res_bin.outs) {
+    COMMAND_RPC_GET_OUTPUTS::outkey out;
+    out.key = epee::string_tools::pod_to_hex(outkey.key);
+    out.mask = epee::string_tools::pod_to_hex(outkey.mask);
+    out.unlocked = outkey.unlocked;
+    out.height = outkey.height;
+    if (req.get_txid) out.txid = epee::string_tools::pod_to_hex(outkey.txid);
+    res.outs.push_back(out);
+  }
+  res.untrusted = res_bin.untrusted;
+  res.status = res_bin.status;
+  return true;
+}
+
+bool monero_fake_daemon::on_get_output_distribution_bin(const COMMAND_RPC_GET_OUTPUT_DISTRIBUTION::request& req, COMMAND_RPC_GET_OUTPUT_DISTRIBUTION::response& res, const connection_context* ctx) {
+  if (!fill_output_distribution(req, res)) res.status = "Failed to get output distribution";
+  return true;
+}
+
+bool monero_fake_daemon::on_get_version(const COMMAND_RPC_GET_VERSION::request& req, COMMAND_RPC_GET_VERSION::response& res, const connection_context* ctx) {
+  res.version = CORE_RPC_VERSION;
+  res.release = true;
+  res.untrusted = false;
+  res.status = CORE_RPC_STATUS_OK;
+  return true;
+}
+
+bool monero_fake_daemon::on_hard_fork_info(const COMMAND_RPC_HARD_FORK_INFO::request& req, COMMAND_RPC_HARD_FORK_INFO::response& res, const connection_context* ctx) {
+  uint8_t version = req.version > 0 ? req.version : monero_fake_chain::get_hard_fork_version();
+  res.version = version;
+  res.enabled = version <= monero_fake_chain::get_hard_fork_version();
+  res.earliest_height = version <= 1 ? 0 : res.enabled ? 1 : std::numeric_limits<uint64_t>::max();
+  res.window = 0;
+  res.votes = 0;
+  res.threshold = 0;
+  res.voting = monero_fake_chain::get_hard_fork_version();
+  res.state = 0;
+  res.untrusted = false;
+  res.status = CORE_RPC_STATUS_OK;
+  return true;
+}
+
+bool monero_fake_daemon::on_get_block_count(const COMMAND_RPC_GETBLOCKCOUNT::request& req, COMMAND_RPC_GETBLOCKCOUNT::response& res, const connection_context* ctx) {
+  res.count = m_chain.get_height();
+  res.status = CORE_RPC_STATUS_OK;
+  return true;
+}
+
+bool monero_fake_daemon::on_get_fee_estimate(const COMMAND_RPC_GET_BASE_FEE_ESTIMATE::request& req, COMMAND_RPC_GET_BASE_FEE_ESTIMATE::response& res, const connection_context* ctx) {
+  res.fee = FEE_PER_BYTE;
+  res.quantization_mask = 1;
+  for (int i = PER_KB_FEE_QUANTIZATION_DECIMALS; i < CRYPTONOTE_DISPLAY_DECIMAL_POINT; i++) res.quantization_mask *= 10;
+  res.untrusted = false;
+  res.status = CORE_RPC_STATUS_OK;
+  return true;
+}
+
+bool monero_fake_daemon::on_get_last_block_header(const COMMAND_RPC_GET_LAST_BLOCK_HEADER::request& req, COMMAND_RPC_GET_LAST_BLOCK_HEADER::response& res, epee::json_rpc::error& error_resp, const connection_context* ctx) {
+  fill_block_header(m_chain.get_height() - 1, res.block_header);
+  res.untrusted = false;
+  res.status = CORE_RPC_STATUS_OK;
+  return true;
+}
+
+bool monero_fake_daemon::on_get_block_header_by_height(const COMMAND_RPC_GET_BLOCK_HEADER_BY_HEIGHT::request& req, COMMAND_RPC_GET_BLOCK_HEADER_BY_HEIGHT::response& res, epee::json_rpc::error& error_resp, const connection_context* ctx) {
+  if (req.height >= m_chain.get_height()) {
+    error_resp.code = CORE_RPC_ERROR_CODE_TOO_BIG_HEIGHT;
+    error_resp.message = "Requested block height: " + std::to_string(req.height) + " greater than current top block height: " + std::to_string(m_chain.get_height() - 1);
+    return false;
+  }
+  fill_block_header(req.height, res.block_header);
+  res.untrusted = false;
+  res.status = CORE_RPC_STATUS_OK;
+  return true;
+}
+
+bool monero_fake_daemon::on_get_block_headers_range(const COMMAND_RPC_GET_BLOCK_HEADERS_RANGE::request& req, COMMAND_RPC_GET_BLOCK_HEADERS_RANGE::response& res, epee::json_rpc::error& error_resp, const connection_context* ctx) {
+  if (req.end_height >= m_chain.get_height() || req.start_height > req.end_height) {
+    error_resp.code = CORE_RPC_ERROR_CODE_TOO_BIG_HEIGHT;
+    error_resp.message = "Invalid start/end heights.";
+    return false;
+  }
+  res.headers.resize(req.end_height - req.start_height + 1);
+  for (uint64_t height = req.start_height; height <= req.end_height; height++) fill_block_header(height, res.headers[height - req.start_height]);
+  res.untrusted = false;
+  res.status = CORE_RPC_STATUS_OK;
+  return true;
+}
+
+bool monero_fake_daemon::on_get_output_distribution(const COMMAND_RPC_GET_OUTPUT_DISTRIBUTION::request& req, COMMAND_RPC_GET_OUTPUT_DISTRIBUTION::response& res, epee::json_rpc::error& error_resp, const connection_context* ctx) {
+  if (!fill_output_distribution(req, res)) {
+    error_resp.code = CORE_RPC_ERROR_CODE_WRONG_PARAM;
+    error_resp.message = "Failed to get output distribution";
+    return false;
+  }
+  return true;
+}
+
+bool monero_fake_daemon::fill_outkey(const get_outputs_out& out, COMMAND_RPC_GET_OUTPUTS_BIN::outkey& outkey) const {
+  if (out.index >= m_chain.get_num_outputs()) return false;
+  const monero_fake_output& output = m_chain.get_output(out.index);
+  outkey.key = output.m_key;
+  outkey.mask = rct::zeroCommit(output.m_amount); // cleartext amounts commit with a zero mask
+  outkey.unlocked = output.m_unlock_height <= m_chain.get_height();
+  outkey.height = output.m_height;
+  outkey.txid = output.m_txid;
+  return true;
+}
+
+bool monero_fake_daemon::fill_output_distribution(const COMMAND_RPC_GET_OUTPUT_DISTRIBUTION::request& req, COMMAND_RPC_GET_OUTPUT_DISTRIBUTION::response& res) const {
+
+  // an end height of 0 is the tip
+  uint64_t to_height = req.to_height == 0 ? m_chain.get_height() - 1 : req.to_height;
+  if (req.from_height > to_height || to_height >= m_chain.get_height()) return false;
+
+  // count outputs per block, or cumulatively from the first output when requested as the daemon does
+  for (uint64_t amount : req.amounts) {
+    COMMAND_RPC_GET_OUTPUT_DISTRIBUTION::distribution distribution;
+    distribution.amount = amount;
+    distribution.binary = req.binary;
+    distribution.compress = req.compress;
+    distribution.data.start_height = req.from_height;
+    distribution.data.base = m_chain.get_num_outputs_before(req.from_height);
+    distribution.data.distribution.reserve(to_height - req.from_height + 1);
+    for (uint64_t height = req.from_height; height <= to_height; height++) {
+      uint64_t num_outputs = m_chain.get_num_outputs_before(height + 1) - m_chain.get_num_outputs_before(height);
+      if (req.cumulative) num_outputs += distribution.data.distribution.empty() ? distribution.data.base : distribution.data.distribution.back();
+      distribution.data.distribution.push_back(num_outputs);
+    }
+    if (req.cumulative) distribution.data.base = 0;
+    res.distributions.push_back(std::move(distribution));
+  }
+  res.untrusted = false;
+  res.status = CORE_RPC_STATUS_OK;
+  return true;
+}
+
+void monero_fake_daemon::fill_block_header(uint64_t height, block_header_response& header) const {
+  const block_complete_entry& entry = m_chain.get_block_entry(height);
+  block b;
+  if (!parse_and_validate_block_from_blob(entry.block, b)) throw runtime_error("Invalid block at height " + std::to_string(height));
+  header.major_version = b.major_version;
+  header.minor_version = b.minor_version;
+  header.timestamp = b.timestamp;
+  header.prev_hash = epee::string_tools::pod_to_hex(b.prev_id);
+  header.nonce = b.nonce;
+  header.orphan_status = false;
+  header.height = height;
+  header.depth = m_chain.get_height() - 1 - height;
+  header.hash = epee::string_tools::pod_to_hex(m_chain.get_block_hash(height));
+  header.difficulty = DIFFICULTY;
+  header.wide_difficulty = to_wide_difficulty(DIFFICULTY);
+  header.cumulative_difficulty = (height + 1) * DIFFICULTY;
+  header.wide_cumulative_difficulty = to_wide_difficulty((height + 1) * DIFFICULTY);
+  header.reward = get_outs_money_amount(b.miner_tx);
+  header.block_size = header.block_weight = header.long_term_weight = entry.block_weight;
+  header.num_txes = b.tx_hashes.size();
+  header.miner_tx_hash = epee::string_tools::pod_to_hex(get_transaction_hash(b.miner_tx));
+}
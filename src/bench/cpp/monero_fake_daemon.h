@@ -0,0 +1,139 @@
+/**
+ * Copyright (c) 2017-2019 woodser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef monero_fake_daemon_h
+#define monero_fake_daemon_h
+
+#include <map>
+#include <mutex>
+#include <unordered_set>
+#include "monero_fake_chain.h"
+#include "net/http_server_handlers_map2.h"
+#include "net/http_server_impl_base.h"
+#include "rpc/core_rpc_server_error_codes.h"
+
+/**
+ * Stand-in daemon which serves a fake chain over the RPC calls a wallet
+ * makes to sync and that monero-java makes to fetch blocks and headers.
+ *
+ * Blocks are replayed from the chain as stored and every hard fork up to the
+ * chain's version is enabled from height 1.  Ring members and output
+ * distributions are served from the chain's single output index space
+ * whatever amount is asked for.  Submitted txs are kept in a pool without
+ * verification, except that double spends within the pool are rejected, and
+ * are never mined.
+ * Requests are answered from the immutable chain or the mutex-guarded pool
+ * so any number of server threads can serve them.
+ */
+class monero_fake_daemon : public epee::http_server_impl_base<monero_fake_daemon> {
+public:
+  typedef epee::net_utils::connection_context_base connection_context;
+
+  monero_fake_daemon(const monero_fake_chain& chain) : m_chain(chain) { }
+
+  /**
+   * Listen for requests.
+   *
+   * @param bind_ip is the ip to listen on
+   * @param bind_port is the port to listen on
+   * @return true if listening, false otherwise
+   */
+  bool init(const std::string& bind_ip, const std::string& bind_port);
+
+  CHAIN_HTTP_TO_MAP2(connection_context);
+
+  BEGIN_URI_MAP2()
+    MAP_URI_AUTO_JON2("/get_info", on_get_info, cryptonote::COMMAND_RPC_GET_INFO)
+    MAP_URI_AUTO_JON2("/getinfo", on_get_info, cryptonote::COMMAND_RPC_GET_INFO)
+    MAP_URI_AUTO_JON2("/get_height", on_get_height, cryptonote::COMMAND_RPC_GET_HEIGHT)
+    MAP_URI_AUTO_JON2("/getheight", on_get_height, cryptonote::COMMAND_RPC_GET_HEIGHT)
+    MAP_URI_AUTO_BIN2("/get_blocks.bin", on_get_blocks, cryptonote::COMMAND_RPC_GET_BLOCKS_FAST)
+    MAP_URI_AUTO_BIN2("/getblocks.bin", on_get_blocks, cryptonote::COMMAND_RPC_GET_BLOCKS_FAST)
+    MAP_URI_AUTO_BIN2("/get_blocks_by_height.bin", on_get_blocks_by_height, cryptonote::COMMAND_RPC_GET_BLOCKS_BY_HEIGHT)
+    MAP_URI_AUTO_BIN2("/getblocks_by_height.bin", on_get_blocks_by_height, cryptonote::COMMAND_RPC_GET_BLOCKS_BY_HEIGHT)
+    MAP_URI_AUTO_BIN2("/get_hashes.bin", on_get_hashes, cryptonote::COMMAND_RPC_GET_HASHES_FAST)
+    MAP_URI_AUTO_BIN2("/gethashes.bin", on_get_hashes, cryptonote::COMMAND_RPC_GET_HASHES_FAST)
+    MAP_URI_AUTO_BIN2("/get_transaction_pool_hashes.bin", on_get_transaction_pool_hashes_bin, cryptonote::COMMAND_RPC_GET_TRANSACTION_POOL_HASHES_BIN)
+    MAP_URI_AUTO_JON2("/get_transaction_pool_hashes", on_get_transaction_pool_hashes, cryptonote::COMMAND_RPC_GET_TRANSACTION_POOL_HASHES)
+    MAP_URI_AUTO_JON2("/get_transactions", on_get_transactions, cryptonote::COMMAND_RPC_GET_TRANSACTIONS)
+    MAP_URI_AUTO_JON2("/gettransactions", on_get_transactions, cryptonote::COMMAND_RPC_GET_TRANSACTIONS)
+    MAP_URI_AUTO_JON2("/is_key_image_spent", on_is_key_image_spent, cryptonote::COMMAND_RPC_IS_KEY_IMAGE_SPENT)
+    MAP_URI_AUTO_JON2("/send_raw_transaction", on_send_raw_tx, cryptonote::COMMAND_RPC_SEND_RAW_TX)
+    MAP_URI_AUTO_JON2("/sendrawtransaction", on_send_raw_tx, cryptonote::COMMAND_RPC_SEND_RAW_TX)
+    MAP_URI_AUTO_BIN2("/get_outs.bin", on_get_outs_bin, cryptonote::COMMAND_RPC_GET_OUTPUTS_BIN)
+    MAP_URI_AUTO_JON2("/get_outs", on_get_outs, cryptonote::COMMAND_RPC_GET_OUTPUTS)
+    MAP_URI_AUTO_BIN2("/get_output_distribution.bin", on_get_output_distribution_bin, cryptonote::COMMAND_RPC_GET_OUTPUT_DISTRIBUTION)
+    BEGIN_JSON_RPC_MAP("/json_rpc")
+      MAP_JON_RPC("get_version", on_get_version, cryptonote::COMMAND_RPC_GET_VERSION)
+      MAP_JON_RPC("get_info", on_get_info, cryptonote::COMMAND_RPC_GET_INFO)
+      MAP_JON_RPC("hard_fork_info", on_hard_fork_info, cryptonote::COMMAND_RPC_HARD_FORK_INFO)
+      MAP_JON_RPC("get_block_count", on_get_block_count, cryptonote::COMMAND_RPC_GETBLOCKCOUNT)
+      MAP_JON_RPC("get_fee_estimate", on_get_fee_estimate, cryptonote::COMMAND_RPC_GET_BASE_FEE_ESTIMATE)
+      MAP_JON_RPC("getblockcount", on_get_block_count, cryptonote::COMMAND_RPC_GETBLOCKCOUNT)
+      MAP_JON_RPC_WE("get_last_block_header", on_get_last_block_header, cryptonote::COMMAND_RPC_GET_LAST_BLOCK_HEADER)
+      MAP_JON_RPC_WE("getlastblockheader", on_get_last_block_header, cryptonote::COMMAND_RPC_GET_LAST_BLOCK_HEADER)
+      MAP_JON_RPC_WE("get_block_header_by_height", on_get_block_header_by_height, cryptonote::COMMAND_RPC_GET_BLOCK_HEADER_BY_HEIGHT)
+      MAP_JON_RPC_WE("getblockheaderbyheight", on_get_block_header_by_height, cryptonote::COMMAND_RPC_GET_BLOCK_HEADER_BY_HEIGHT)
+      MAP_JON_RPC_WE("get_block_headers_range", on_get_block_headers_range, cryptonote::COMMAND_RPC_GET_BLOCK_HEADERS_RANGE)
+      MAP_JON_RPC_WE("getblockheadersrange", on_get_block_headers_range, cryptonote::COMMAND_RPC_GET_BLOCK_HEADERS_RANGE)
+      MAP_JON_RPC_WE("get_output_distribution", on_get_output_distribution, cryptonote::COMMAND_RPC_GET_OUTPUT_DISTRIBUTION)
+    END_JSON_RPC_MAP()
+  END_URI_MAP2()
+
+  bool on_get_info(const cryptonote::COMMAND_RPC_GET_INFO::request& req, cryptonote::COMMAND_RPC_GET_INFO::response& res, const connection_context* ctx = NULL);
+  bool on_get_height(const cryptonote::COMMAND_RPC_GET_HEIGHT::request& req, cryptonote::COMMAND_RPC_GET_HEIGHT::response& res, const connection_context* ctx = NULL);
+  bool on_get_blocks(const cryptonote::COMMAND_RPC_GET_BLOCKS_FAST::request& req, cryptonote::COMMAND_RPC_GET_BLOCKS_FAST::response& res, const connection_context* ctx = NULL);
+  bool on_get_blocks_by_height(const cryptonote::COMMAND_RPC_GET_BLOCKS_BY_HEIGHT::request& req, cryptonote::COMMAND_RPC_GET_BLOCKS_BY_HEIGHT::response& res, const connection_context* ctx = NULL);
+  bool on_get_hashes(const cryptonote::COMMAND_RPC_GET_HASHES_FAST::request& req, cryptonote::COMMAND_RPC_GET_HASHES_FAST::response& res, const connection_context* ctx = NULL);
+  bool on_get_transaction_pool_hashes_bin(const cryptonote::COMMAND_RPC_GET_TRANSACTION_POOL_HASHES_BIN::request& req, cryptonote::COMMAND_RPC_GET_TRANSACTION_POOL_HASHES_BIN::response& res, const connection_context* ctx = NULL);
+  bool on_get_transaction_pool_hashes(const cryptonote::COMMAND_RPC_GET_TRANSACTION_POOL_HASHES::request& req, cryptonote::COMMAND_RPC_GET_TRANSACTION_POOL_HASHES::response& res, const connection_context* ctx = NULL);
+  bool on_get_transactions(const cryptonote::COMMAND_RPC_GET_TRANSACTIONS::request& req, cryptonote::COMMAND_RPC_GET_TRANSACTIONS::response& res, const connection_context* ctx = NULL);
+  bool on_is_key_image_spent(const cryptonote::COMMAND_RPC_IS_KEY_IMAGE_SPENT::request& req, cryptonote::COMMAND_RPC_IS_KEY_IMAGE_SPENT::response& res, const connection_context* ctx = NULL);
+  bool on_send_raw_tx(const cryptonote::COMMAND_RPC_SEND_RAW_TX::request& req, cryptonote::COMMAND_RPC_SEND_RAW_TX::response& res, const connection_context* ctx = NULL);
+  bool on_get_outs_bin(const cryptonote::COMMAND_RPC_GET_OUTPUTS_BIN::request& req, cryptonote::COMMAND_RPC_GET_OUTPUTS_BIN::response& res, const connection_context* ctx = NULL);
+  bool on_get_outs(const cryptonote::COMMAND_RPC_GET_OUTPUTS::request& req, cryptonote::COMMAND_RPC_GET_OUTPUTS::response& res, const connection_context* ctx = NULL);
+  bool on_get_output_distribution_bin(const cryptonote::COMMAND_RPC_GET_OUTPUT_DISTRIBUTION::request& req, cryptonote::COMMAND_RPC_GET_OUTPUT_DISTRIBUTION::response& res, const connection_context* ctx = NULL);
+  bool on_get_version(const cryptonote::COMMAND_RPC_GET_VERSION::request& req, cryptonote::COMMAND_RPC_GET_VERSION::response& res, const connection_context* ctx = NULL);
+  bool on_hard_fork_info(const cryptonote::COMMAND_RPC_HARD_FORK_INFO::request& req, cryptonote::COMMAND_RPC_HARD_FORK_INFO::response& res, const connection_context* ctx = NULL);
+  bool on_get_block_count(const cryptonote::COMMAND_RPC_GETBLOCKCOUNT::request& req, cryptonote::COMMAND_RPC_GETBLOCKCOUNT::response& res, const connection_context* ctx = NULL);
+  bool on_get_fee_estimate(const cryptonote::COMMAND_RPC_GET_BASE_FEE_ESTIMATE::request& req, cryptonote::COMMAND_RPC_GET_BASE_FEE_ESTIMATE::response& res, const connection_context* ctx = NULL);
+  bool on_get_last_block_header(const cryptonote::COMMAND_RPC_GET_LAST_BLOCK_HEADER::request& req, cryptonote::COMMAND_RPC_GET_LAST_BLOCK_HEADER::response& res, epee::json_rpc::error& error_resp, const connection_context* ctx = NULL);
+  bool on_get_block_header_by_height(const cryptonote::COMMAND_RPC_GET_BLOCK_HEADER_BY_HEIGHT::request& req, cryptonote::COMMAND_RPC_GET_BLOCK_HEADER_BY_HEIGHT::response& res, epee::json_rpc::error& error_resp, const connection_context* ctx = NULL);
+  bool on_get_block_headers_range(const cryptonote::COMMAND_RPC_GET_BLOCK_HEADERS_RANGE::request& req, cryptonote::COMMAND_RPC_GET_BLOCK_HEADERS_RANGE::response& res, epee::json_rpc::error& error_resp, const connection_context* ctx = NULL);
+  bool on_get_output_distribution(const cryptonote::COMMAND_RPC_GET_OUTPUT_DISTRIBUTION::request& req, cryptonote::COMMAND_RPC_GET_OUTPUT_DISTRIBUTION::response& res, epee::json_rpc::error& error_resp, const connection_context* ctx = NULL);
+
+private:
+  const monero_fake_chain& m_chain;
+  std::mutex m_pool_mutex;
+  std::map<crypto::hash, cryptonote::blobdata> m_pool_txs;
+  std::unordered_set<crypto::key_image> m_pool_key_images;
+
+  static const uint64_t MAX_BLOCKS_PER_REQUEST = 1000; // as COMMAND_RPC_GET_BLOCKS_FAST_MAX_COUNT
+  static const uint64_t MAX_OUTPUTS_PER_REQUEST = 5000; // as MAX_RESTRICTED_GLOBAL_FAKE_OUTS_COUNT
+  static const uint64_t DIFFICULTY = 1;
+
+  void fill_block_header(uint64_t height, cryptonote::block_header_response& header) const;
+  bool fill_outkey(const cryptonote::get_outputs_out& out, cryptonote::COMMAND_RPC_GET_OUTPUTS_BIN::outkey& outkey) const;
+  bool fill_output_distribution(const cryptonote::COMMAND_RPC_GET_OUTPUT_DISTRIBUTION::request& req, cryptonote::COMMAND_RPC_GET_OUTPUT_DISTRIBUTION::response& res) const;
+};
+
+#endif /* monero_fake_daemon_h */
@@ -0,0 +1,174 @@
+/**
+ * Copyright (c) 2017-2019 woodser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Generates fake chains which pay a wallet and serves them from a stand-in
+ * daemon, so sync, queries, and save/open of large wallets can be measured
+ * on one machine without a network:
+ *
+ *   monero-java-fixtures generate CHAIN [--blocks N] [--txs-per-block N] [--outputs-per-tx N]
+ *                                       [--accounts N] [--subaddresses N] [--spend-ratio R]
+ *                                       [--seed N] [--network stagenet|testnet|mainnet] [--mnemonic WORDS]
+ *   monero-java-fixtures serve CHAIN [--ip IP] [--port PORT] [--threads N]
+ *   monero-java-fixtures wallet CHAIN WALLET_PATH [--password PASSWORD] [--port PORT]
+ *   monero-java-fixtures record DAEMON_URI BLOCKS_PATH [--start N] [--blocks N]
+ *
+ * serve runs until interrupted.  wallet serves the chain on a local port,
+ * syncs a wallet restored from the chain's mnemonic against it, and saves the
+ * synced wallet.  record saves a daemon's get_blocks_by_height.bin response
+ * for a range of its blocks, to benchmark decoding real blocks offline.
+ */
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include "chacha.h" // TODO: explicitly include because wallet2.h #include "crypto/chacha.h" is ignored
+#include "monero_daemon_client.h"
+#include "monero_fake_chain.h"
+#include "monero_fake_daemon.h"
+#include "wallet/monero_wallet_core.h"
+
+using namespace std;
+using namespace monero;
+
+// seed of the wallet paid by generated chains, same as the java tests' TestUtils.MNEMONIC
+static const string DEFAULT_MNEMONIC = "goblet went maze cylinder stockpile twofold fewest jaded lurk rally espionage grunt aunt puffin kickoff refer shyness tether building eleven lopped dawn tasked toolbox grunt";
+static const string DEFAULT_IP = "127.0.0.1";
+static const string DEFAULT_PORT = "38081";
+
+/**
+ * Parse "--name value" options following the positional arguments.
+ */
+static map<string, string> parse_options(int argc, char** argv, int first) {
+  map<string, string> options;
+  for (int i = first; i < argc; i += 2) {
+    string name = argv[i];
+    if (name.compare(0, 2, "--") != 0 || i + 1 >= argc) throw runtime_error("Expected --option value but got " + name);
+    options[name.substr(2)] = argv[i + 1];
+  }
+  return options;
+}
+
+static string get_option(const map<string, string>& options, const string& name, const string& default_value) {
+  map<string, string>::const_iterator iter = options.find(name);
+  return iter == options.end() ? default_value : iter->second;
+}
+
+static cryptonote::network_type parse_network_type(const string& network) {
+  if (network == "mainnet") return cryptonote::MAINNET;
+  if (network == "testnet") return cryptonote::TESTNET;
+  if (network == "stagenet") return cryptonote::STAGENET;
+  throw runtime_error("Unknown network: " + network);
+}
+
+static int generate(const string& chain_path, const map<string, string>& options) {
+  monero_fake_chain_config config;
+  config.m_network_type = parse_network_type(get_option(options, "network", "stagenet"));
+  config.m_mnemonic = get_option(options, "mnemonic", DEFAULT_MNEMONIC);
+  config.m_num_blocks = stoull(get_option(options, "blocks", to_string(config.m_num_blocks)));
+  config.m_txs_per_block = stoul(get_option(options, "txs-per-block", to_string(config.m_txs_per_block)));
+  config.m_outputs_per_tx = stoul(get_option(options, "outputs-per-tx", to_string(config.m_outputs_per_tx)));
+  config.m_num_accounts = stoul(get_option(options, "accounts", to_string(config.m_num_accounts)));
+  config.m_num_subaddresses = stoul(get_option(options, "subaddresses", to_string(config.m_num_subaddresses)));
+  config.m_spend_ratio = stod(get_option(options, "spend-ratio", to_string(config.m_spend_ratio)));
+  config.m_seed = stoull(get_option(options, "seed", to_string(config.m_seed)));
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+  monero_fake_chain chain = monero_fake_chain::generate(config);
+  chain.save(chain_path);
+  cout << "Generated " << chain.get_height() << " blocks to " << chain_path << " in " << chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count() << " ms" << endl;
+  return 0;
+}
+
+static int serve(const string& chain_path, const map<string, string>& options) {
+  monero_fake_chain chain = monero_fake_chain::load(chain_path);
+  monero_fake_daemon daemon(chain);
+  string ip = get_option(options, "ip", DEFAULT_IP);
+  string port = get_option(options, "port", DEFAULT_PORT);
+  if (!daemon.init(ip, port)) throw runtime_error("Failed to listen on " + ip + ":" + port);
+  cout << "Serving " << chain.get_height() << " blocks at http://" << ip << ":" << port << endl;
+  daemon.run(stoul(get_option(options, "threads", "4")), true);
+  return 0;
+}
+
+static int sync_wallet(const string& chain_path, const string& wallet_path, const map<string, string>& options) {
+
+  // serve chain in the background
+  monero_fake_chain chain = monero_fake_chain::load(chain_path);
+  monero_fake_daemon daemon(chain);
+  string port = get_option(options, "port", DEFAULT_PORT);
+  if (!daemon.init(DEFAULT_IP, port)) throw runtime_error("Failed to listen on " + DEFAULT_IP + ":" + port);
+  daemon.run(2, false);
+
+  // restore wallet with the subaddresses the chain pays so outputs beyond the lookahead are found
+  monero_rpc_connection daemon_connection = monero_rpc_connection("http://" + DEFAULT_IP + ":" + port, string(""), string(""));
+  unique_ptr<monero_wallet> wallet(monero_wallet_core::create_wallet_from_mnemonic(wallet_path, get_option(options, "password", ""), static_cast<monero_network_type>(chain.get_network_type()), chain.get_mnemonic(), daemon_connection, 0, ""));
+  for (uint32_t account_idx = 0; account_idx < chain.get_num_accounts(); account_idx++) {
+    if (account_idx > 0) wallet->create_account("");
+    for (uint32_t subaddress_idx = 1; subaddress_idx < chain.get_num_subaddresses(); subaddress_idx++) wallet->create_subaddress(account_idx, "");
+  }
+
+  // sync and save
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+  monero_sync_result result = wallet->sync();
+  long sync_ms = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+  wallet->save();
+  cout << "Synced " << result.m_num_blocks_fetched << " blocks in " << sync_ms << " ms to " << wallet_path << " with balance " << wallet->get_balance() << endl;
+  wallet.reset();
+  daemon.send_stop_signal();
+  daemon.timed_wait_server_stop(5000);
+  daemon.deinit();
+  return 0;
+}
+
+static int record(const string& daemon_uri, const string& blocks_path, const map<string, string>& options) {
+  uint64_t start_height = stoull(get_option(options, "start", "1"));
+  uint64_t num_blocks = stoull(get_option(options, "blocks", "100"));
+  vector<uint64_t> heights;
+  for (uint64_t height = start_height; height < start_height + num_blocks; height++) heights.push_back(height);
+  monero_daemon_client client(daemon_uri, "", "");
+  string blocks_bin;
+  string error;
+  if (!client.get_blocks_by_height_bin(heights, blocks_bin, error)) throw runtime_error(error);
+  ofstream file(blocks_path, ios::binary);
+  file.write(blocks_bin.data(), blocks_bin.size());
+  if (!file) throw runtime_error("Failed to write " + blocks_path);
+  cout << "Recorded " << num_blocks << " blocks from height " << start_height << " (" << blocks_bin.size() << " bytes) to " << blocks_path << endl;
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  try {
+    string command = argc > 1 ? argv[1] : "";
+    if (command == "generate" && argc >= 3) return generate(argv[2], parse_options(argc, argv, 3));
+    if (command == "serve" && argc >= 3) return serve(argv[2], parse_options(argc, argv, 3));
+    if (command == "wallet" && argc >= 4) return sync_wallet(argv[2], argv[3], parse_options(argc, argv, 4));
+    if (command == "record" && argc >= 4) return record(argv[2], argv[3], parse_options(argc, argv, 4));
+    cerr << "Usage: " << argv[0] << " generate CHAIN [--option value]... | serve CHAIN [--option value]... | wallet CHAIN WALLET_PATH [--option value]... | record DAEMON_URI BLOCKS_PATH [--option value]..." << endl;
+    return 1;
+  } catch (const exception& e) {
+    cerr << "Error: " << e.what() << endl;
+    return 1;
+  }
+}
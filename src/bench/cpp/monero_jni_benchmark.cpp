@@ -0,0 +1,580 @@
+/**
+ * Copyright (c) 2017-2019 woodser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/**
+ * Benchmarks the native work behind the JNI bridges' hot paths against an
+ * offline in-memory wallet and a fake chain, so regressions in monero-java or
+ * an upgraded monero-cpp show up without a daemon or a JVM.
+ *
+ * Results are written as json with google benchmark's flags, e.g.
+ *
+ *   ./monero-java-benchmark --benchmark_out=native.json --benchmark_out_format=json
+ *
+ * bin/run-benchmarks.sh runs this and the JMH harness in src/bench/java.
+ */
+
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <unistd.h>
+#include "chacha.h" // TODO: explicitly include because wallet2.h #include "crypto/chacha.h" is ignored
+#include "file_io_utils.h"
+#include "monero_byte_throttle.h"
+#include "monero_fake_chain.h"
+#include "monero_fake_daemon.h"
+#include "monero_json_arena.h"
+#include "monero_message_signer.h"
+#include "monero_parallel.h"
+#include "monero_portable_storage.h"
+#include "monero_subaddress_deriver.h"
+#include "monero_trace.h"
+#include "wallet/monero_wallet_core.h"
+#include "utils/monero_utils.h"
+#include "storages/portable_storage_template_helper.h"
+
+using namespace std;
+using namespace monero;
+
+// fixture wallet, same seed as the java tests' TestUtils.MNEMONIC
+static const string MNEMONIC = "goblet went maze cylinder stockpile twofold fewest jaded lurk rally espionage grunt aunt puffin kickoff refer shyness tether building eleven lopped dawn tasked toolbox grunt";
+static const uint32_t NUM_ACCOUNTS = 10;
+static const string FAKE_DAEMON_PORT = "38099";
+
+// tx query as serialized by MoneroWalletJni.getTxs()
+static const string TX_QUERY_JSON = "{\"txs\":[{\"isConfirmed\":true,\"isIncoming\":true,\"minHeight\":100000,\"maxHeight\":500000,\"includeOutputs\":true,\"transferQuery\":{\"accountIndex\":0,\"subaddressIndices\":[0,1,2,3,4]},\"outputQuery\":{\"isSpent\":false,\"accountIndex\":0}}]}";
+
+/**
+ * Get the offline wallet shared by all benchmarks, created in memory on first use.
+ */
+static monero_wallet* get_wallet() {
+  static monero_wallet* wallet = [] {
+    monero_rpc_connection daemon_connection; // no daemon
+    monero_wallet* wallet = monero_wallet_core::create_wallet_from_mnemonic("", "", monero_network_type::STAGENET, MNEMONIC, daemon_connection, 0, "");
+    for (uint32_t i = 1; i < NUM_ACCOUNTS; i++) wallet->create_account("");
+    return wallet;
+  }();
+  return wallet;
+}
+
+/**
+ * Build a graph of blocks with wallet txs, transfers, and outputs shaped like
+ * a getTxs() result.
+ */
+static vector<shared_ptr<monero_block>> build_blocks(int num_blocks, int txs_per_block) {
+  vector<shared_ptr<monero_block>> blocks;
+  for (int i = 0; i < num_blocks; i++) {
+    shared_ptr<monero_block> block = make_shared<monero_block>();
+    block->m_height = 400000 + i;
+    block->m_timestamp = 1570000000 + i * 120;
+    for (int j = 0; j < txs_per_block; j++) {
+      shared_ptr<monero_tx_wallet> tx = make_shared<monero_tx_wallet>();
+      tx->m_block = block;
+      tx->m_hash = string(60, 'a') + to_string(1000 + (i * txs_per_block + j) % 9000);
+      tx->m_version = 2;
+      tx->m_fee = 14000000;
+      tx->m_unlock_time = 0;
+      tx->m_is_confirmed = true;
+      tx->m_in_tx_pool = false;
+      tx->m_num_confirmations = 100 + i;
+      tx->m_is_incoming = true;
+      tx->m_is_outgoing = false;
+      tx->m_note = string("");
+      shared_ptr<monero_incoming_transfer> transfer = make_shared<monero_incoming_transfer>();
+      transfer->m_tx = tx;
+      transfer->m_amount = 1000000000000ull + j;
+      transfer->m_account_index = 0;
+      transfer->m_subaddress_index = j % 5;
+      transfer->m_address = string(95, '5');
+      tx->m_incoming_transfers.push_back(transfer);
+      for (int k = 0; k < 2; k++) {
+        shared_ptr<monero_output_wallet> output = make_shared<monero_output_wallet>();
+        output->m_tx = tx;
+        output->m_amount = 500000000000ull + k;
+        output->m_index = k;
+        output->m_account_index = 0;
+        output->m_subaddress_index = j % 5;
+        output->m_is_spent = false;
+        output->m_is_frozen = false;
+        shared_ptr<monero_key_image> key_image = make_shared<monero_key_image>();
+        key_image->m_hex = string(64, 'b');
+        output->m_key_image = key_image;
+        tx->m_outputs.push_back(output);
+      }
+      block->m_txs.push_back(tx);
+    }
+    blocks.push_back(block);
+  }
+  return blocks;
+}
+
+/**
+ * Build json shaped like a daemon get_outs.bin response with the given number of outputs.
+ */
+static string build_outs_json(int num_outs) {
+  string json = "{\"credits\":0,\"outs\":[";
+  for (int i = 0; i < num_outs; i++) {
+    if (i > 0) json += ",";
+    json += "{\"height\":" + to_string(400000 + i) + ",\"key\":\"" + string(64, 'c') + "\",\"mask\":\"" + string(64, 'd') + "\",\"txid\":\"" + string(64, 'e') + "\",\"unlocked\":true}";
+  }
+  json += "],\"status\":\"OK\",\"top_hash\":\"\",\"untrusted\":false}";
+  return json;
+}
+
+// ------------------------------- JSON -------------------------------------
+
+static void BM_deserialize_tx_query(benchmark::State& state) {
+  for (auto _ : state) {
+    shared_ptr<monero_tx_query> tx_query = monero_tx_query::deserialize_from_block(TX_QUERY_JSON);
+    benchmark::DoNotOptimize(tx_query);
+  }
+  state.SetBytesProcessed(state.iterations() * TX_QUERY_JSON.size());
+}
+BENCHMARK(BM_deserialize_tx_query);
+
+static void BM_serialize_tx_query(benchmark::State& state) {
+  shared_ptr<monero_tx_query> tx_query = monero_tx_query::deserialize_from_block(TX_QUERY_JSON);
+  for (auto _ : state) {
+    monero_json_arena arena;
+    benchmark::DoNotOptimize(arena.serialize(*tx_query->m_block.get()).GetSize());
+  }
+}
+BENCHMARK(BM_serialize_tx_query);
+
+// serializes blocks the way getTxsJni() does, with args as {blocks, txs per block}
+static void BM_serialize_blocks(benchmark::State& state) {
+  vector<shared_ptr<monero_block>> blocks = build_blocks(state.range(0), state.range(1));
+  size_t size = 0;
+  for (auto _ : state) {
+    monero_json_arena arena;
+    rapidjson::Document& doc = arena.doc();
+    doc.SetObject();
+    doc.AddMember("blocks", monero_utils::to_rapidjson_val(doc.GetAllocator(), blocks), doc.GetAllocator());
+    size = arena.serialize().GetSize();
+    benchmark::DoNotOptimize(size);
+  }
+  state.SetBytesProcessed(state.iterations() * size);
+  state.counters["txs"] = benchmark::Counter(state.iterations() * state.range(0) * state.range(1), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_serialize_blocks)->Args({1, 10})->Args({100, 10})->Args({1000, 10});
+
+// deserializes the txs of a block graph as a tx set, which parses the same tx, transfer, and output models
+static void BM_deserialize_txs(benchmark::State& state) {
+  vector<shared_ptr<monero_block>> blocks = build_blocks(state.range(0), state.range(1));
+  monero_tx_set tx_set;
+  for (const shared_ptr<monero_block>& block : blocks) {
+    for (const shared_ptr<monero_tx>& tx : block->m_txs) tx_set.m_txs.push_back(static_pointer_cast<monero_tx_wallet>(tx));
+  }
+  string json = tx_set.serialize();
+  for (auto _ : state) {
+    monero_tx_set deserialized = monero_tx_set::deserialize(json);
+    benchmark::DoNotOptimize(deserialized.m_txs.data());
+  }
+  state.SetBytesProcessed(state.iterations() * json.size());
+  state.counters["txs"] = benchmark::Counter(state.iterations() * state.range(0) * state.range(1), benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_deserialize_txs)->Args({1, 10})->Args({100, 10});
+
+// --------------------------- PORTABLE STORAGE -----------------------------
+
+static void BM_json_to_binary(benchmark::State& state) {
+  string json = build_outs_json(state.range(0));
+  string bin;
+  for (auto _ : state) {
+    monero_portable_storage::json_to_binary(json, bin);
+    benchmark::DoNotOptimize(bin.data());
+  }
+  state.SetBytesProcessed(state.iterations() * json.size());
+}
+BENCHMARK(BM_json_to_binary)->Arg(10)->Arg(1000)->Arg(10000);
+
+static void BM_binary_to_json(benchmark::State& state) {
+  string bin;
+  monero_portable_storage::json_to_binary(build_outs_json(state.range(0)), bin);
+  string json;
+  for (auto _ : state) {
+    monero_portable_storage::binary_to_json(bin, json);
+    benchmark::DoNotOptimize(json.data());
+  }
+  state.SetBytesProcessed(state.iterations() * bin.size());
+}
+BENCHMARK(BM_binary_to_json)->Arg(10)->Arg(1000)->Arg(10000);
+
+/**
+ * Decode a get_blocks_by_height.bin response with epee and cryptonote's json
+ * serialization, which blocks_to_json replaces, for comparison.
+ */
+static void blocks_to_json_reference(const string& bin, string& json) {
+  cryptonote::COMMAND_RPC_GET_BLOCKS_BY_HEIGHT::response res;
+  if (!epee::serialization::load_t_from_binary(res, bin)) throw runtime_error("Failed to load get_blocks_by_height.bin response");
+  string blocks_json = "[";
+  string txs_json = "[";
+  for (size_t block_idx = 0; block_idx < res.blocks.size(); block_idx++) {
+    cryptonote::block block;
+    if (!cryptonote::parse_and_validate_block_from_blob(res.blocks[block_idx].block, block)) throw runtime_error("Failed to parse block " + to_string(block_idx));
+    if (block_idx > 0) blocks_json.push_back(',');
+    blocks_json.append(cryptonote::obj_to_json_str(block));
+    if (block_idx > 0) txs_json.push_back(',');
+    txs_json.push_back('[');
+    for (size_t tx_idx = 0; tx_idx < res.blocks[block_idx].txs.size(); tx_idx++) {
+      cryptonote::transaction tx;
+      if (!cryptonote::parse_and_validate_tx_from_blob(res.blocks[block_idx].txs[tx_idx], tx)) throw runtime_error("Failed to parse tx " + to_string(tx_idx));
+      if (tx_idx > 0) txs_json.push_back(',');
+      txs_json.append(cryptonote::obj_to_json_str(tx));
+    }
+    txs_json.push_back(']');
+  }
+  json = "{\"blocks\":" + blocks_json + "],\"txs\":" + txs_json + "],\"status\":\"" + res.status + "\",\"untrusted\":" + (res.untrusted ? "true" : "false") + "}";
+}
+
+/**
+ * Check blocks_to_json decodes a response to the same json values as the
+ * reference, so the benchmarks compare equivalent work.
+ */
+static void check_blocks_to_json(const string& bin) {
+  string json;
+  string reference_json;
+  monero_portable_storage::blocks_to_json(bin, json);
+  blocks_to_json_reference(bin, reference_json);
+  rapidjson::Document doc;
+  rapidjson::Document reference_doc;
+  if (doc.Parse(json.c_str()).HasParseError()) throw runtime_error("blocks_to_json wrote invalid json");
+  if (reference_doc.Parse(reference_json.c_str()).HasParseError()) throw runtime_error("Reference wrote invalid json");
+  if (doc != reference_doc) throw runtime_error("blocks_to_json differs from the reference");
+}
+
+/**
+ * Load a get_blocks_by_height.bin response recorded from a daemon by
+ * monero-java-fixtures record, at the path in MONERO_JAVA_RECORDED_BLOCKS.
+ */
+static bool load_recorded_blocks(benchmark::State& state, string& bin) {
+  const char* path = getenv("MONERO_JAVA_RECORDED_BLOCKS");
+  if (path == nullptr || !epee::file_io_utils::load_file_to_string(path, bin)) {
+    state.SkipWithError("Set MONERO_JAVA_RECORDED_BLOCKS to a response saved by monero-java-fixtures record");
+    return false;
+  }
+  return true;
+}
+
+// decodes a get_blocks_by_height.bin response of a fake chain's blocks, with args as {blocks, txs per block}
+static void BM_blocks_to_json(benchmark::State& state) {
+  monero_fake_chain_config config;
+  config.m_mnemonic = MNEMONIC;
+  config.m_num_blocks = state.range(0) + 1;
+  config.m_txs_per_block = state.range(1);
+  monero_fake_chain chain = monero_fake_chain::generate(config);
+  cryptonote::COMMAND_RPC_GET_BLOCKS_BY_HEIGHT::response res;
+  for (uint64_t height = 1; height < chain.get_height(); height++) res.blocks.push_back(chain.get_block_entry(height));
+  res.status = CORE_RPC_STATUS_OK;
+  res.untrusted = false;
+  string bin;
+  if (!epee::serialization::store_t_to_binary(res, bin)) throw runtime_error("Failed to serialize get_blocks_by_height.bin response");
+  check_blocks_to_json(bin);
+  string json;
+  for (auto _ : state) {
+    monero_portable_storage::blocks_to_json(bin, json);
+    benchmark::DoNotOptimize(json.data());
+  }
+  state.SetBytesProcessed(state.iterations() * bin.size());
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_blocks_to_json)->Args({100, 10});
+
+// decodes a response recorded from a daemon, whose txs have real ring sizes and proofs
+static void BM_blocks_to_json_recorded(benchmark::State& state) {
+  string bin;
+  if (!load_recorded_blocks(state, bin)) return;
+  check_blocks_to_json(bin);
+  string json;
+  for (auto _ : state) {
+    monero_portable_storage::blocks_to_json(bin, json);
+    benchmark::DoNotOptimize(json.data());
+  }
+  state.SetBytesProcessed(state.iterations() * bin.size());
+}
+BENCHMARK(BM_blocks_to_json_recorded)->Unit(benchmark::kMillisecond);
+
+static void BM_blocks_to_json_recorded_reference(benchmark::State& state) {
+  string bin;
+  if (!load_recorded_blocks(state, bin)) return;
+  string json;
+  for (auto _ : state) {
+    blocks_to_json_reference(bin, json);
+    benchmark::DoNotOptimize(json.data());
+  }
+  state.SetBytesProcessed(state.iterations() * bin.size());
+}
+BENCHMARK(BM_blocks_to_json_recorded_reference)->Unit(benchmark::kMillisecond);
+
+// ------------------------------- SYNC -------------------------------------
+
+// syncs a new wallet from a fake daemon serving a fake chain which pays it, with args as {blocks, txs per block}
+static void BM_sync(benchmark::State& state) {
+  monero_fake_chain_config config;
+  config.m_mnemonic = MNEMONIC;
+  config.m_num_blocks = state.range(0);
+  config.m_txs_per_block = state.range(1);
+  monero_fake_chain chain = monero_fake_chain::generate(config);
+  monero_fake_daemon daemon(chain);
+  if (!daemon.init("127.0.0.1", FAKE_DAEMON_PORT)) throw runtime_error("Failed to start fake daemon");
+  daemon.run(2, false);
+  monero_rpc_connection daemon_connection = monero_rpc_connection("http://127.0.0.1:" + FAKE_DAEMON_PORT, string(""), string(""));
+  for (auto _ : state) {
+    state.PauseTiming();
+    unique_ptr<monero_wallet> wallet(monero_wallet_core::create_wallet_from_mnemonic("", "", static_cast<monero_network_type>(chain.get_network_type()), MNEMONIC, daemon_connection, 0, ""));
+    state.ResumeTiming();
+    benchmark::DoNotOptimize(wallet->sync().m_num_blocks_fetched);
+  }
+  daemon.send_stop_signal();
+  daemon.timed_wait_server_stop(5000);
+  daemon.deinit();
+  state.SetItemsProcessed(state.iterations() * config.m_num_blocks);
+}
+BENCHMARK(BM_sync)->Args({500, 10})->Iterations(3)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// ------------------------------- OPEN -------------------------------------
+
+/**
+ * Get the peak resident memory of the process since it was last reset, 0 if unknown.
+ */
+static uint64_t get_peak_resident_bytes() {
+  ifstream status("/proc/self/status");
+  string line;
+  while (getline(status, line)) {
+    if (line.compare(0, 6, "VmHWM:") == 0) return stoull(line.substr(6)) * 1024;
+  }
+  return 0;
+}
+
+static void reset_peak_resident_bytes() {
+  ofstream clear_refs("/proc/self/clear_refs");
+  clear_refs << "5";
+}
+
+// opens copies of a wallet synced from a fake chain as openWalletsJni() does, with args as {wallets, max open cache bytes in caches (0 for no limit)}
+static void BM_open_wallets(benchmark::State& state) {
+
+  // sync and save a wallet paid by a fake chain
+  monero_fake_chain_config config;
+  config.m_mnemonic = MNEMONIC;
+  config.m_num_blocks = 1000;
+  config.m_txs_per_block = 20;
+  monero_fake_chain chain = monero_fake_chain::generate(config);
+  monero_fake_daemon daemon(chain);
+  if (!daemon.init("127.0.0.1", FAKE_DAEMON_PORT)) throw runtime_error("Failed to start fake daemon");
+  daemon.run(2, false);
+  char dir[] = "/tmp/monero_java_benchmark_XXXXXX";
+  if (mkdtemp(dir) == nullptr) throw runtime_error("Cannot create temporary wallet directory");
+  monero_network_type network_type = static_cast<monero_network_type>(chain.get_network_type());
+  string synced_path = string(dir) + "/synced";
+  {
+    monero_rpc_connection daemon_connection = monero_rpc_connection("http://127.0.0.1:" + FAKE_DAEMON_PORT, string(""), string(""));
+    unique_ptr<monero_wallet> wallet(monero_wallet_core::create_wallet_from_mnemonic(synced_path, "", network_type, MNEMONIC, daemon_connection, 0, ""));
+    wallet->sync();
+    wallet->save();
+  }
+  daemon.send_stop_signal();
+  daemon.timed_wait_server_stop(5000);
+  daemon.deinit();
+
+  // copy the wallet once per open
+  string cache, keys;
+  if (!epee::file_io_utils::load_file_to_string(synced_path, cache) || !epee::file_io_utils::load_file_to_string(synced_path + ".keys", keys)) throw runtime_error("Cannot read synced wallet");
+  vector<string> paths(state.range(0));
+  for (size_t i = 0; i < paths.size(); i++) {
+    paths[i] = string(dir) + "/wallet_" + to_string(i);
+    if (!epee::file_io_utils::save_string_to_file(paths[i], cache) || !epee::file_io_utils::save_string_to_file(paths[i] + ".keys", keys)) throw runtime_error("Cannot copy synced wallet");
+  }
+
+  // open the copies at once, throttled by cache size
+  uint64_t peak_bytes = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    reset_peak_resident_bytes();
+    vector<unique_ptr<monero_wallet>> wallets(paths.size());
+    state.ResumeTiming();
+    monero_byte_throttle throttle(state.range(1) * cache.size());
+    monero_parallel_for(paths.size(), 0, [&](size_t i) {
+      monero_byte_throttle::reservation reservation(throttle, cache.size());
+      wallets[i].reset(monero_wallet_core::open_wallet(paths[i], "", network_type));
+    });
+    state.PauseTiming();
+    peak_bytes = max(peak_bytes, get_peak_resident_bytes());
+    wallets.clear();
+    state.ResumeTiming();
+  }
+  state.counters["cache_mb"] = cache.size() / 1048576.0;
+  state.counters["peak_rss_mb"] = peak_bytes / 1048576.0;
+  state.SetItemsProcessed(state.iterations() * paths.size());
+
+  // delete the wallets
+  for (const string& path : paths) {
+    for (const char* suffix : { "", ".keys", ".address.txt" }) remove((path + suffix).c_str());
+  }
+  for (const char* suffix : { "", ".keys", ".address.txt" }) remove((synced_path + suffix).c_str());
+  rmdir(dir);
+}
+BENCHMARK(BM_open_wallets)->Args({8, 0})->Args({8, 4})->Args({8, 1})->Iterations(3)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// ------------------------------ LISTENERS ---------------------------------
+
+/**
+ * Counts notifications in place of the JNI listener, which additionally
+ * attaches the thread and calls into Java.
+ */
+struct counting_listener : public monero_wallet_listener {
+  uint64_t m_count = 0;
+  void on_output_received(const monero_output_wallet& output) {
+    m_count += *output.m_amount > 0;
+  }
+};
+
+// builds and dispatches received output notifications as the wallet does on sync, with the arg listeners registered
+static void BM_listener_dispatch(benchmark::State& state) {
+  vector<counting_listener> listeners(state.range(0));
+  set<monero_wallet_listener*> registered;
+  for (counting_listener& listener : listeners) registered.insert(&listener);
+  uint64_t height = 400000;
+  for (auto _ : state) {
+    shared_ptr<monero_block> block = make_shared<monero_block>();
+    block->m_height = height++;
+    shared_ptr<monero_tx_wallet> tx = make_shared<monero_tx_wallet>();
+    tx->m_block = block;
+    block->m_txs.push_back(tx);
+    tx->m_hash = string(64, 'a');
+    tx->m_version = 2;
+    tx->m_unlock_time = 0;
+    shared_ptr<monero_output_wallet> output = make_shared<monero_output_wallet>();
+    output->m_tx = tx;
+    output->m_amount = 1000000000000ull;
+    output->m_account_index = 0;
+    output->m_subaddress_index = 1;
+    tx->m_outputs.push_back(output);
+    for (monero_wallet_listener* listener : registered) listener->on_output_received(*output);
+    block->m_txs.clear(); // break cycle
+  }
+  benchmark::DoNotOptimize(listeners[0].m_count);
+}
+BENCHMARK(BM_listener_dispatch)->Arg(1)->Arg(4);
+
+// ------------------------- BALANCES AND ADDRESSES -------------------------
+
+static void BM_get_balances(benchmark::State& state) {
+  monero_wallet* wallet = get_wallet();
+  for (auto _ : state) {
+    uint64_t total = 0;
+    for (uint32_t account_idx = 0; account_idx < NUM_ACCOUNTS; account_idx++) total += wallet->get_balance(account_idx) + wallet->get_unlocked_balance(account_idx);
+    benchmark::DoNotOptimize(total);
+  }
+  state.SetItemsProcessed(state.iterations() * NUM_ACCOUNTS);
+}
+BENCHMARK(BM_get_balances);
+
+static void BM_get_accounts(benchmark::State& state) {
+  monero_wallet* wallet = get_wallet();
+  for (auto _ : state) {
+    vector<monero_account> accounts = wallet->get_accounts(true, string(""));
+    benchmark::DoNotOptimize(accounts.data());
+  }
+}
+BENCHMARK(BM_get_accounts);
+
+// derives addresses one at a time through the wallet as getAddressJni() does
+static void BM_get_address(benchmark::State& state) {
+  monero_wallet* wallet = get_wallet();
+  uint32_t num_subaddresses = state.range(0);
+  for (auto _ : state) {
+    for (uint32_t i = 0; i < num_subaddresses; i++) benchmark::DoNotOptimize(wallet->get_address(0, i));
+  }
+  state.SetItemsProcessed(state.iterations() * num_subaddresses);
+}
+BENCHMARK(BM_get_address)->Arg(1000);
+
+// derives a range of addresses in bulk, with args as {num subaddresses, max threads}
+static void BM_derive_addresses(benchmark::State& state) {
+  monero_wallet* wallet = get_wallet();
+  monero_subaddress_deriver deriver(static_cast<cryptonote::network_type>(wallet->get_network_type()), wallet->get_address(0, 0), wallet->get_private_view_key());
+  uint32_t num_subaddresses = state.range(0);
+  for (auto _ : state) {
+    vector<string> addresses = deriver.derive_addresses(0, 0, num_subaddresses, state.range(1));
+    benchmark::DoNotOptimize(addresses.data());
+  }
+  state.SetItemsProcessed(state.iterations() * num_subaddresses);
+}
+BENCHMARK(BM_derive_addresses)->Args({1000, 1})->Args({1000, 0})->UseRealTime();
+
+// -------------------------------- MESSAGES --------------------------------
+
+/**
+ * Build distinct messages to sign.
+ */
+static vector<string> build_msgs(size_t num_msgs) {
+  vector<string> msgs;
+  for (size_t i = 0; i < num_msgs; i++) msgs.push_back("message " + to_string(i));
+  return msgs;
+}
+
+// signs messages as signBatchJni() does, with args as {num messages, max threads}
+static void BM_sign_batch(benchmark::State& state) {
+  monero_wallet* wallet = get_wallet();
+  epee::wipeable_string private_spend_key = wallet->get_private_spend_key();
+  vector<string> msgs = build_msgs(state.range(0));
+  for (auto _ : state) {
+    vector<string> signatures = monero_message_signer::sign(private_spend_key, msgs, state.range(1));
+    benchmark::DoNotOptimize(signatures.data());
+  }
+  state.SetItemsProcessed(state.iterations() * msgs.size());
+}
+BENCHMARK(BM_sign_batch)->Args({1000, 1})->Args({1000, 0})->UseRealTime();
+
+// verifies signatures as verifyBatchJni() does, with args as {num messages, max threads}
+static void BM_verify_batch(benchmark::State& state) {
+  monero_wallet* wallet = get_wallet();
+  vector<string> msgs = build_msgs(state.range(0));
+  vector<string> addresses(msgs.size(), wallet->get_primary_address());
+  vector<string> signatures = monero_message_signer::sign(wallet->get_private_spend_key(), msgs, 0);
+  cryptonote::network_type network_type = static_cast<cryptonote::network_type>(wallet->get_network_type());
+  for (auto _ : state) {
+    vector<bool> goods = monero_message_signer::verify(network_type, msgs, addresses, signatures, state.range(1));
+    benchmark::DoNotOptimize(goods);
+  }
+  state.SetItemsProcessed(state.iterations() * msgs.size());
+}
+BENCHMARK(BM_verify_batch)->Args({1000, 1})->Args({1000, 0})->UseRealTime();
+
+// -------------------------------- TRACE -----------------------------------
+
+// records spans with tracing enabled if the arg is 1, otherwise checks for tracing and returns
+static void BM_trace_span(benchmark::State& state) {
+  if (state.range(0) == 1) monero_trace::start(1 << 16);
+  for (auto _ : state) {
+    MONERO_TRACE_SPAN("BM_trace_span");
+  }
+  monero_trace::stop();
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_trace_span)->Arg(0)->Arg(1)->ThreadRange(1, 4);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,170 @@
+package benchmark;
+
+import java.lang.reflect.Field;
+import java.lang.reflect.Method;
+import java.math.BigInteger;
+import java.util.ArrayList;
+import java.util.HashMap;
+import java.util.List;
+import java.util.Map;
+import java.util.concurrent.TimeUnit;
+
+import org.openjdk.jmh.annotations.Benchmark;
+import org.openjdk.jmh.annotations.BenchmarkMode;
+import org.openjdk.jmh.annotations.Fork;
+import org.openjdk.jmh.annotations.Level;
+import org.openjdk.jmh.annotations.Measurement;
+import org.openjdk.jmh.annotations.Mode;
+import org.openjdk.jmh.annotations.OperationsPerInvocation;
+import org.openjdk.jmh.annotations.OutputTimeUnit;
+import org.openjdk.jmh.annotations.Param;
+import org.openjdk.jmh.annotations.Scope;
+import org.openjdk.jmh.annotations.Setup;
+import org.openjdk.jmh.annotations.State;
+import org.openjdk.jmh.annotations.TearDown;
+import org.openjdk.jmh.annotations.Warmup;
+import org.openjdk.jmh.infra.Blackhole;
+
+import monero.daemon.model.MoneroNetworkType;
+import monero.utils.MoneroUtils;
+import monero.wallet.MoneroWalletJni;
+import monero.wallet.model.MoneroAccount;
+import monero.wallet.model.MoneroTransferQuery;
+import monero.wallet.model.MoneroTxQuery;
+import monero.wallet.model.MoneroTxWallet;
+import monero.wallet.model.MoneroWalletListener;
+
+/**
+ * Measures the Java -> JNI -> Java round trip of the bridges' hot paths
+ * against an offline in-memory wallet, complementing the native benchmarks in
+ * src/bench/cpp which measure the same work without the JVM.
+ * 
+ * Run with bin/run-benchmarks.sh, which writes results as json.
+ */
+@BenchmarkMode(Mode.Throughput)
+@OutputTimeUnit(TimeUnit.SECONDS)
+@Warmup(iterations = 3, time = 2)
+@Measurement(iterations = 5, time = 2)
+@Fork(1)
+@State(Scope.Benchmark)
+public class MoneroJniBenchmark {
+  
+  // same seed as TestUtils.MNEMONIC
+  private static final String MNEMONIC = "goblet went maze cylinder stockpile twofold fewest jaded lurk rally espionage grunt aunt puffin kickoff refer shyness tether building eleven lopped dawn tasked toolbox grunt";
+  private static final int NUM_ACCOUNTS = 10;
+  private static final int NUM_ADDRESSES = 1000;
+  
+  private MoneroWalletJni wallet;
+  private MoneroTxQuery txQuery;
+  private Object jniListener;
+  private Method onOutputReceived;
+  
+  @Setup(Level.Trial)
+  public void setup() throws Exception {
+    
+    // create offline wallet in memory
+    wallet = MoneroWalletJni.createWalletFromMnemonic("", "", MoneroNetworkType.STAGENET, MNEMONIC);
+    for (int i = 1; i < NUM_ACCOUNTS; i++) wallet.createAccount();
+    
+    // tx query matching the native benchmark's
+    txQuery = new MoneroTxQuery().setIsConfirmed(true).setIsIncoming(true).setMinHeight(100000l).setMaxHeight(500000l).setIncludeOutputs(true);
+    txQuery.setTransferQuery(new MoneroTransferQuery().setAccountIndex(0).setSubaddressIndices(0, 1, 2, 3, 4));
+    
+    // register a listener and get the receiver the native listener calls into
+    wallet.addListener(new MoneroWalletListener());
+    Field field = MoneroWalletJni.class.getDeclaredField("jniListener");
+    field.setAccessible(true);
+    jniListener = field.get(wallet);
+    onOutputReceived = jniListener.getClass().getDeclaredMethod("onOutputReceived", long.class, String.class, String.class, int.class, int.class, int.class, long.class);
+    onOutputReceived.setAccessible(true);
+  }
+  
+  @TearDown(Level.Trial)
+  public void tearDown() {
+    wallet.close();
+  }
+  
+  @Benchmark
+  public List<MoneroTxWallet> getTxs() {
+    return wallet.getTxs(txQuery);
+  }
+  
+  /**
+   * Daemon get_outs.bin response of a given number of outputs.
+   */
+  @State(Scope.Benchmark)
+  public static class OutsPayload {
+    
+    @Param({"10", "1000"})
+    public int numOuts;
+    
+    private Map<String, Object> map;
+    private byte[] binary;
+    
+    @Setup(Level.Trial)
+    public void setup() {
+      List<Map<String, Object>> outs = new ArrayList<Map<String, Object>>();
+      for (int i = 0; i < numOuts; i++) {
+        Map<String, Object> out = new HashMap<String, Object>();
+        out.put("height", 400000 + i);
+        out.put("key", repeat('c', 64));
+        out.put("mask", repeat('d', 64));
+        out.put("txid", repeat('e', 64));
+        out.put("unlocked", true);
+        outs.add(out);
+      }
+      map = new HashMap<String, Object>();
+      map.put("credits", 0);
+      map.put("outs", outs);
+      map.put("status", "OK");
+      map.put("untrusted", false);
+      binary = MoneroUtils.mapToBinary(map);
+    }
+  }
+  
+  @Benchmark
+  public byte[] mapToBinary(OutsPayload payload) {
+    return MoneroUtils.mapToBinary(payload.map);
+  }
+  
+  @Benchmark
+  public Map<String, Object> binaryToMap(OutsPayload payload) {
+    return MoneroUtils.binaryToMap(payload.binary);
+  }
+  
+  @Benchmark
+  public void onOutputReceived() throws Exception {
+    onOutputReceived.invoke(jniListener, 400000l, repeat('a', 64), "1000000000000", 0, 1, 2, 0l);
+  }
+  
+  @Benchmark
+  public void getBalances(Blackhole bh) {
+    for (int i = 0; i < NUM_ACCOUNTS; i++) {
+      BigInteger balance = wallet.getBalance(i);
+      bh.consume(balance.add(wallet.getUnlockedBalance(i)));
+    }
+  }
+  
+  @Benchmark
+  public List<MoneroAccount> getAccounts() {
+    return wallet.getAccounts(true);
+  }
+  
+  @Benchmark
+  @OperationsPerInvocation(NUM_ADDRESSES)
+  public void getAddress(Blackhole bh) {
+    for (int i = 0; i < NUM_ADDRESSES; i++) bh.consume(wallet.getAddress(0, i));
+  }
+  
+  @Benchmark
+  @OperationsPerInvocation(NUM_ADDRESSES)
+  public List<String> getAddresses() {
+    return wallet.getAddresses(0, 0, NUM_ADDRESSES);
+  }
+  
+  private static String repeat(char c, int n) {
+    StringBuilder sb = new StringBuilder(n);
+    for (int i = 0; i < n; i++) sb.append(c);
+    return sb.toString();
+  }
+}
@@ -0,0 +1,188 @@
+/**
+ * Copyright (c) 2017-2019 woodser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "monero_address_codec.h"
+#include <cstring>
+#include "crypto/hash.h"
+
+using namespace std;
+
+namespace {
+  const char ALPHABET[] = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+  const size_t FULL_BLOCK_SIZE = 8;
+  const size_t FULL_ENCODED_BLOCK_SIZE = 11;
+  const size_t ENCODED_BLOCK_SIZES[] = { 0, 2, 3, 5, 6, 7, 9, 10, 11 };
+  const int DECODED_BLOCK_SIZES[] = { 0, -1, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8 };
+  const size_t CHECKSUM_SIZE = 4;
+  const size_t MAX_ADDRESS_SIZE = 1 + 32 + 32 + 8 + CHECKSUM_SIZE;  // tag, spend key, view key, payment id, checksum
+
+  struct reverse_alphabet {
+    int8_t m_digits[256];
+    reverse_alphabet() {
+      memset(m_digits, -1, sizeof(m_digits));
+      for (int i = 0; i < 58; i++) m_digits[(uint8_t) ALPHABET[i]] = i;
+    }
+  };
+  const reverse_alphabet REVERSE_ALPHABET;
+
+  bool decode_block(const char* block, size_t size, uint8_t* out) {
+    int out_size = DECODED_BLOCK_SIZES[size];
+    if (out_size <= 0) return false;
+
+    // accumulate digits, failing on overflow of 64 bits
+    uint64_t num = 0;
+    for (size_t i = 0; i < size; i++) {
+      int8_t digit = REVERSE_ALPHABET.m_digits[(uint8_t) block[i]];
+      if (digit < 0) return false;
+      if (num > (UINT64_MAX - digit) / 58) return false;
+      num = num * 58 + digit;
+    }
+    if (out_size < (int) FULL_BLOCK_SIZE && (UINT64_C(1) << (8 * out_size)) <= num) return false;
+
+    // write big endian
+    for (int i = out_size - 1; i >= 0; i--) {
+      out[i] = (uint8_t) (num & 0xff);
+      num >>= 8;
+    }
+    return true;
+  }
+
+  void encode_block(const uint8_t* block, size_t size, char* out) {
+    uint64_t num = 0;
+    for (size_t i = 0; i < size; i++) num = (num << 8) | block[i];
+    size_t out_size = ENCODED_BLOCK_SIZES[size];
+    for (size_t i = 0; i < out_size; i++) out[i] = ALPHABET[0];
+    for (size_t i = out_size; num > 0; ) {
+      out[--i] = ALPHABET[num % 58];
+      num /= 58;
+    }
+  }
+
+  bool get_type(uint64_t tag, cryptonote::network_type& network_type, monero_address_type& address_type) {
+    const cryptonote::network_type network_types[] = { cryptonote::MAINNET, cryptonote::TESTNET, cryptonote::STAGENET };
+    for (cryptonote::network_type a_network_type : network_types) {
+      const cryptonote::config_t& config = cryptonote::get_config(a_network_type);
+      network_type = a_network_type;
+      if (tag == config.CRYPTONOTE_PUBLIC_ADDRESS_BASE58_PREFIX) address_type = PRIMARY_ADDRESS;
+      else if (tag == config.CRYPTONOTE_PUBLIC_INTEGRATED_ADDRESS_BASE58_PREFIX) address_type = INTEGRATED_ADDRESS;
+      else if (tag == config.CRYPTONOTE_PUBLIC_SUBADDRESS_BASE58_PREFIX) address_type = SUBADDRESS;
+      else continue;
+      return true;
+    }
+    return false;
+  }
+
+  uint64_t get_tag(const monero_decoded_address& decoded) {
+    const cryptonote::config_t& config = cryptonote::get_config(decoded.m_network_type);
+    switch (decoded.m_address_type) {
+      case INTEGRATED_ADDRESS: return config.CRYPTONOTE_PUBLIC_INTEGRATED_ADDRESS_BASE58_PREFIX;
+      case SUBADDRESS: return config.CRYPTONOTE_PUBLIC_SUBADDRESS_BASE58_PREFIX;
+      default: return config.CRYPTONOTE_PUBLIC_ADDRESS_BASE58_PREFIX;
+    }
+  }
+}
+
+bool monero_address_codec::decode(const string& address, monero_decoded_address& decoded) {
+
+  // decode base58 into a fixed buffer
+  if (address.size() > (MAX_ADDRESS_SIZE / FULL_BLOCK_SIZE + 1) * FULL_ENCODED_BLOCK_SIZE) return false;
+  uint8_t data[(MAX_ADDRESS_SIZE / FULL_BLOCK_SIZE + 2) * FULL_BLOCK_SIZE];
+  size_t size;
+  if (!decode_base58(address.data(), address.size(), data, size)) return false;
+  if (size <= CHECKSUM_SIZE) return false;
+
+  // verify checksum
+  crypto::hash hash;
+  crypto::cn_fast_hash(data, size - CHECKSUM_SIZE, hash);
+  if (memcmp(&hash, data + size - CHECKSUM_SIZE, CHECKSUM_SIZE) != 0) return false;
+  size -= CHECKSUM_SIZE;
+
+  // read varint tag
+  uint64_t tag = 0;
+  size_t pos = 0;
+  for (int shift = 0; ; shift += 7) {
+    if (pos >= size || shift > 63) return false;
+    uint8_t byte = data[pos++];
+    tag |= (uint64_t) (byte & 0x7f) << shift;
+    if (!(byte & 0x80)) break;
+  }
+  if (!get_type(tag, decoded.m_network_type, decoded.m_address_type)) return false;
+
+  // read keys and payment id
+  size_t expected_size = pos + 2 * sizeof(crypto::public_key) + (decoded.m_address_type == INTEGRATED_ADDRESS ? sizeof(crypto::hash8) : 0);
+  if (size != expected_size) return false;
+  memcpy(&decoded.m_spend_key, data + pos, sizeof(crypto::public_key));
+  pos += sizeof(crypto::public_key);
+  memcpy(&decoded.m_view_key, data + pos, sizeof(crypto::public_key));
+  pos += sizeof(crypto::public_key);
+  if (decoded.m_address_type == INTEGRATED_ADDRESS) memcpy(&decoded.m_payment_id, data + pos, sizeof(crypto::hash8));
+  else memset(&decoded.m_payment_id, 0, sizeof(crypto::hash8));
+
+  // keys must be valid points
+  return crypto::check_key(decoded.m_spend_key) && crypto::check_key(decoded.m_view_key);
+}
+
+string monero_address_codec::encode(const monero_decoded_address& decoded) {
+  uint8_t data[16 + MAX_ADDRESS_SIZE];
+  size_t size = 0;
+  for (uint64_t tag = get_tag(decoded); ; ) {
+    uint8_t byte = tag & 0x7f;
+    tag >>= 7;
+    data[size++] = tag ? byte | 0x80 : byte;
+    if (!tag) break;
+  }
+  memcpy(data + size, &decoded.m_spend_key, sizeof(crypto::public_key));
+  size += sizeof(crypto::public_key);
+  memcpy(data + size, &decoded.m_view_key, sizeof(crypto::public_key));
+  size += sizeof(crypto::public_key);
+  if (decoded.m_address_type == INTEGRATED_ADDRESS) {
+    memcpy(data + size, &decoded.m_payment_id, sizeof(crypto::hash8));
+    size += sizeof(crypto::hash8);
+  }
+  crypto::hash hash;
+  crypto::cn_fast_hash(data, size, hash);
+  memcpy(data + size, &hash, CHECKSUM_SIZE);
+  size += CHECKSUM_SIZE;
+  return encode_base58(data, size);
+}
+
+bool monero_address_codec::decode_base58(const char* data, size_t size, uint8_t* out, size_t& out_size) {
+  size_t num_full_blocks = size / FULL_ENCODED_BLOCK_SIZE;
+  size_t last_block_size = size % FULL_ENCODED_BLOCK_SIZE;
+  int last_block_decoded_size = DECODED_BLOCK_SIZES[last_block_size];
+  if (last_block_decoded_size < 0) return false;
+  for (size_t i = 0; i < num_full_blocks; i++) {
+    if (!decode_block(data + i * FULL_ENCODED_BLOCK_SIZE, FULL_ENCODED_BLOCK_SIZE, out + i * FULL_BLOCK_SIZE)) return false;
+  }
+  if (last_block_size > 0 && !decode_block(data + num_full_blocks * FULL_ENCODED_BLOCK_SIZE, last_block_size, out + num_full_blocks * FULL_BLOCK_SIZE)) return false;
+  out_size = num_full_blocks * FULL_BLOCK_SIZE + last_block_decoded_size;
+  return true;
+}
+
+string monero_address_codec::encode_base58(const uint8_t* data, size_t size) {
+  size_t num_full_blocks = size / FULL_BLOCK_SIZE;
+  size_t last_block_size = size % FULL_BLOCK_SIZE;
+  string encoded(num_full_blocks * FULL_ENCODED_BLOCK_SIZE + ENCODED_BLOCK_SIZES[last_block_size], ALPHABET[0]);
+  for (size_t i = 0; i < num_full_blocks; i++) encode_block(data + i * FULL_BLOCK_SIZE, FULL_BLOCK_SIZE, &encoded[i * FULL_ENCODED_BLOCK_SIZE]);
+  if (last_block_size > 0) encode_block(data + num_full_blocks * FULL_BLOCK_SIZE, last_block_size, &encoded[num_full_blocks * FULL_ENCODED_BLOCK_SIZE]);
+  return encoded;
+}
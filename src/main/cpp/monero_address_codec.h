@@ -0,0 +1,99 @@
+/**
+ * Copyright (c) 2017-2019 woodser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef monero_address_codec_h
+#define monero_address_codec_h
+
+#include <string>
+#include "crypto/crypto.h"
+#include "cryptonote_config.h"
+
+/**
+ * Address types in the order of MoneroAddressType.
+ */
+enum monero_address_type : int {
+  PRIMARY_ADDRESS = 0,
+  INTEGRATED_ADDRESS,
+  SUBADDRESS
+};
+
+/**
+ * Decoded address.
+ */
+struct monero_decoded_address {
+  cryptonote::network_type m_network_type;
+  monero_address_type m_address_type;
+  crypto::public_key m_spend_key;
+  crypto::public_key m_view_key;
+  crypto::hash8 m_payment_id;  // only set for integrated addresses
+};
+
+/**
+ * Decodes and encodes addresses without a wallet.
+ *
+ * Uses a table-driven codec for Monero's block base58 which works in place
+ * on fixed buffers, so decoding an address does not allocate.  Decoding
+ * accepts the same addresses as cryptonote::get_account_address_from_str(),
+ * including the check that both keys are valid points.
+ */
+class monero_address_codec {
+public:
+
+  /**
+   * Decode an address of any network and type.
+   *
+   * @param address is the address to decode
+   * @param decoded is set to the decoded address
+   * @return true if the address is valid, false otherwise
+   */
+  static bool decode(const std::string& address, monero_decoded_address& decoded);
+
+  /**
+   * Encode an address.
+   *
+   * @param decoded is the address to encode
+   * @return the encoded address
+   */
+  static std::string encode(const monero_decoded_address& decoded);
+
+  /**
+   * Decode base58 in Monero's block format.
+   *
+   * @param data is the base58 to decode
+   * @param size is the number of characters to decode
+   * @param out receives the decoded bytes and must hold size * 8 / 11 + 8 bytes
+   * @param out_size is set to the number of decoded bytes
+   * @return true if the base58 is valid, false otherwise
+   */
+  static bool decode_base58(const char* data, size_t size, uint8_t* out, size_t& out_size);
+
+  /**
+   * Encode bytes as base58 in Monero's block format.
+   *
+   * @param data are the bytes to encode
+   * @param size is the number of bytes to encode
+   * @return the encoded base58
+   */
+  static std::string encode_base58(const uint8_t* data, size_t size);
+};
+
+#endif /* monero_address_codec_h */
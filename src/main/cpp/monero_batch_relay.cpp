@@ -0,0 +1,145 @@
+/**
+ * Copyright (c) 2017-2019 woodser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <atomic>
+#include <thread>
+#include "monero_batch_relay.h"
+#include "monero_daemon_client.h"
+#include "wallet/wallet2.h"
+#include "boost/archive/portable_binary_iarchive.hpp"
+
+using namespace std;
+using namespace monero;
+
+static const string NOT_RELAYED_ERROR = "Not relayed after an earlier tx failed";
+
+/**
+ * Parse a pending tx from tx metadata as created by wallet2.
+ */
+static bool parse_pending_tx(const string& tx_metadata, tools::wallet2::pending_tx& ptx) {
+  cryptonote::blobdata blob;
+  if (!epee::string_tools::parse_hexstr_to_binbuff(tx_metadata, blob)) return false;
+  try {
+    istringstream iss(blob);
+    boost::archive::portable_binary_iarchive ar(iss);
+    ar >> ptx;
+  } catch (...) {
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Parse the tx blob and hash from tx metadata as created by wallet2.
+ */
+static bool parse_tx_metadata(const string& tx_metadata, string& tx_hex, string& tx_hash) {
+  tools::wallet2::pending_tx ptx;
+  if (!parse_pending_tx(tx_metadata, ptx)) return false;
+  tx_hex = epee::string_tools::buff_to_hex_nodelimer(cryptonote::tx_to_blob(ptx.tx));
+  tx_hash = epee::string_tools::pod_to_hex(cryptonote::get_transaction_hash(ptx.tx));
+  return true;
+}
+
+bool get_tx_metadata_key_images(const string& tx_metadata, vector<string>& key_images) {
+  tools::wallet2::pending_tx ptx;
+  if (!parse_pending_tx(tx_metadata, ptx)) return false;
+  for (const cryptonote::txin_v& input : ptx.tx.vin) {
+    if (input.type() != typeid(cryptonote::txin_to_key)) continue;
+    key_images.push_back(epee::string_tools::pod_to_hex(boost::get<cryptonote::txin_to_key>(input).k_image));
+  }
+  return true;
+}
+
+vector<monero_relay_result> relay_txs_parallel(monero_wallet* wallet, monero_output_cache_proxy* proxy, const vector<string>& tx_metadatas, size_t max_in_flight, bool stop_on_error) {
+  vector<monero_relay_result> results(tx_metadatas.size());
+  if (tx_metadatas.empty()) return results;
+
+  // parse tx blobs from metadata
+  vector<string> tx_hexes(tx_metadatas.size());
+  for (size_t i = 0; i < tx_metadatas.size(); i++) {
+    if (parse_tx_metadata(tx_metadatas[i], tx_hexes[i], results[i].m_tx_hash)) continue;
+    if (stop_on_error) throw runtime_error("Failed to parse tx metadata");
+    results[i].m_error = "Failed to parse tx metadata";
+  }
+
+  // commit txs one at a time if the wallet's submissions cannot be answered by a proxy
+  if (proxy == nullptr) {
+    bool failed = false;
+    for (size_t i = 0; i < tx_metadatas.size(); i++) {
+      if (!results[i].m_error.empty()) continue;
+      if (failed) {
+        results[i].m_error = NOT_RELAYED_ERROR;
+        continue;
+      }
+      try {
+        wallet->relay_txs(vector<string>{tx_metadatas[i]});
+      } catch (const exception& e) {
+        results[i].m_error = e.what();
+        failed = stop_on_error;
+      }
+    }
+    return results;
+  }
+
+  // submit txs to the proxied daemon with one connection per worker
+  string uri = proxy->get_daemon_uri();
+  string username = proxy->get_daemon_username();
+  string password = proxy->get_daemon_password();
+  if (uri.empty()) throw runtime_error("Wallet is not connected to daemon");
+  atomic<size_t> next_idx(0);
+  atomic<bool> failed(false);
+  auto submit_loop = [&]() {
+    monero_daemon_client client(uri, username, password);
+    for (size_t i = next_idx++; i < tx_metadatas.size(); i = next_idx++) {
+      if (!results[i].m_error.empty()) continue;
+      if (failed) {
+        results[i].m_error = NOT_RELAYED_ERROR;
+        continue;
+      }
+      try {
+        string error;
+        if (!client.submit_tx_hex(tx_hexes[i], error)) results[i].m_error = error;
+      } catch (const exception& e) {
+        results[i].m_error = e.what();
+      }
+      if (stop_on_error && !results[i].m_error.empty()) failed = true;
+    }
+  };
+  size_t num_workers = min(max(max_in_flight, (size_t) 1), tx_metadatas.size());
+  vector<thread> workers;
+  for (size_t i = 1; i < num_workers; i++) workers.push_back(thread(submit_loop));
+  submit_loop();
+  for (thread& worker : workers) worker.join();
+
+  // record accepted txs in the wallet, whose submissions the proxy answers
+  for (size_t i = 0; i < tx_metadatas.size(); i++) {
+    if (!results[i].m_error.empty()) continue;
+    proxy->expect_submitted(tx_hexes[i]);
+    try {
+      wallet->relay_txs(vector<string>{tx_metadatas[i]});
+    } catch (const exception& e) {
+      results[i].m_error = string("Tx accepted by daemon but not recorded in wallet: ") + e.what();
+    }
+    proxy->forget_submitted(tx_hexes[i]);
+  }
+  return results;
+}
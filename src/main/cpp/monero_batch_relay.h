@@ -0,0 +1,70 @@
+/**
+ * Copyright (c) 2017-2019 woodser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef monero_batch_relay_h
+#define monero_batch_relay_h
+
+#include <string>
+#include <vector>
+#include "wallet/monero_wallet.h"
+#include "monero_output_cache_proxy.h"
+
+/**
+ * Result of relaying one tx in a batch.
+ */
+struct monero_relay_result {
+  std::string m_tx_hash;
+  std::string m_error;  // empty if relayed
+};
+
+/**
+ * Relays prepared txs by submitting them to the daemon over a bounded number
+ * of parallel connections, then records the accepted txs in the wallet.
+ *
+ * wallet2 only records a tx as relayed by committing it, which submits it to
+ * its daemon, so parallel submission needs the wallet to be connected
+ * through the output cache proxy: each accepted tx is expected by the proxy,
+ * which answers the wallet's commit without submitting the tx again.  Without
+ * a proxy the wallet commits each tx itself, one at a time.
+ *
+ * Each tx is submitted once either way.  The caller holds the wallet's mutex.
+ *
+ * @param wallet is the wallet which created the txs
+ * @param proxy is the proxy the wallet is connected through (nullptr if not proxied)
+ * @param tx_metadatas are the metadata of the txs to relay
+ * @param max_in_flight is the maximum number of concurrent daemon submissions
+ * @param stop_on_error specifies if txs are no longer submitted once one fails and no tx is submitted if any metadata is invalid
+ * @return a result per tx in the order given
+ * @throws runtime_error if stop_on_error and a tx's metadata is invalid
+ */
+std::vector<monero_relay_result> relay_txs_parallel(monero::monero_wallet* wallet, monero_output_cache_proxy* proxy, const std::vector<std::string>& tx_metadatas, size_t max_in_flight, bool stop_on_error);
+
+/**
+ * Append the key images spent by a tx to a list.
+ *
+ * @param tx_metadata is the metadata of a tx prepared by the wallet
+ * @param key_images is appended the hex key images of the tx's inputs
+ * @return true if the metadata is parsed, false otherwise
+ */
+bool get_tx_metadata_key_images(const std::string& tx_metadata, std::vector<std::string>& key_images);
+
+#endif /* monero_batch_relay_h */
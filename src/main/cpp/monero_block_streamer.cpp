@@ -0,0 +1,101 @@
+/**
+ * Copyright (c) 2017-2019 woodser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "monero_block_streamer.h"
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include "monero_daemon_client.h"
+#include "monero_portable_storage.h"
+
+using namespace std;
+
+monero_block_streamer::monero_block_streamer(const string& uri, const string& username, const string& password, const vector<chunk>& chunks, size_t max_in_flight) :
+    m_uri(uri), m_username(username), m_password(password), m_chunks(chunks), m_next_claimed(0), m_next_taken(0), m_is_stopped(false) {
+  if (max_in_flight == 0) throw runtime_error("Must fetch at least one chunk at a time");
+  m_max_buffered = 2 * max_in_flight;
+  size_t num_workers = min(max_in_flight, m_chunks.size());
+  for (size_t i = 0; i < num_workers; i++) m_workers.push_back(thread([this]() { run_worker(); }));
+}
+
+monero_block_streamer::~monero_block_streamer() {
+  stop();
+  for (thread& worker : m_workers) worker.join();
+}
+
+bool monero_block_streamer::next(string& blocks_json) {
+  unique_lock<mutex> lock(m_mutex);
+  if (m_is_stopped || m_next_taken == m_chunks.size()) return false;
+  m_result_ready.wait(lock, [this]() { return m_is_stopped || m_results.find(m_next_taken) != m_results.end(); });
+  if (m_is_stopped) return false;
+
+  // take the chunk and make room for workers to claim another
+  result res = std::move(m_results[m_next_taken]);
+  m_results.erase(m_next_taken);
+  m_next_taken++;
+  m_result_taken.notify_all();
+  if (!res.m_error.empty()) throw runtime_error(res.m_error);
+  blocks_json = std::move(res.m_blocks_json);
+  return true;
+}
+
+void monero_block_streamer::stop() {
+  lock_guard<mutex> lock(m_mutex);
+  m_is_stopped = true;
+  m_result_ready.notify_all();
+  m_result_taken.notify_all();
+}
+
+// ------------------------------- PRIVATE HELPERS ----------------------------
+
+void monero_block_streamer::run_worker() {
+  unique_ptr<monero_daemon_client> client;
+  while (true) {
+
+    // claim the next chunk once there is room in the buffer
+    size_t chunk_idx;
+    {
+      unique_lock<mutex> lock(m_mutex);
+      m_result_taken.wait(lock, [this]() { return m_is_stopped || m_next_claimed == m_chunks.size() || m_next_claimed < m_next_taken + m_max_buffered; });
+      if (m_is_stopped || m_next_claimed == m_chunks.size()) return;
+      chunk_idx = m_next_claimed++;
+    }
+
+    // fetch and decode the chunk, connecting on first use so connection errors are reported as the chunk's error
+    result res;
+    try {
+      if (client == nullptr) client.reset(new monero_daemon_client(m_uri, m_username, m_password));
+      vector<uint64_t> heights;
+      for (uint64_t height = m_chunks[chunk_idx].m_start_height; height <= m_chunks[chunk_idx].m_end_height; height++) heights.push_back(height);
+      string blocks_bin;
+      if (client->get_blocks_by_height_bin(heights, blocks_bin, res.m_error)) monero_portable_storage::blocks_to_json(blocks_bin, res.m_blocks_json);
+    } catch (exception& e) {
+      res.m_error = e.what();
+    }
+    if (!res.m_error.empty()) res.m_error = "Failed to fetch blocks " + to_string(m_chunks[chunk_idx].m_start_height) + " to " + to_string(m_chunks[chunk_idx].m_end_height) + ": " + res.m_error;
+
+    // buffer the result for the consumer
+    lock_guard<mutex> lock(m_mutex);
+    m_results[chunk_idx] = std::move(res);
+    m_result_ready.notify_all();
+  }
+}
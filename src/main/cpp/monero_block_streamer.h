@@ -0,0 +1,109 @@
+/**
+ * Copyright (c) 2017-2019 woodser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef monero_block_streamer_h
+#define monero_block_streamer_h
+
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Streams chunks of blocks from a daemon in order while later chunks are
+ * fetched and decoded.
+ *
+ * Each worker thread owns a daemon connection and repeatedly claims the next
+ * chunk, fetches it with get_blocks_by_height.bin, and decodes the portable
+ * storage response to json, so up to max_in_flight chunks download while
+ * others decode.  Decoded chunks wait in a buffer until the consumer takes
+ * them in order; workers stop claiming chunks while 2 * max_in_flight chunks
+ * are claimed but not taken, which bounds the memory held ahead of a slow
+ * consumer.
+ */
+class monero_block_streamer {
+public:
+
+  /**
+   * Range of block heights fetched in one request.
+   */
+  struct chunk {
+    uint64_t m_start_height;
+    uint64_t m_end_height;  // inclusive
+  };
+
+  /**
+   * Start fetching chunks.
+   *
+   * @param uri is the daemon's uri
+   * @param username is the daemon's rpc username (empty if none)
+   * @param password is the daemon's rpc password
+   * @param chunks are the height ranges to fetch in the order delivered
+   * @param max_in_flight is the maximum number of chunks fetched or decoded at once
+   */
+  monero_block_streamer(const std::string& uri, const std::string& username, const std::string& password, const std::vector<chunk>& chunks, size_t max_in_flight);
+
+  /**
+   * Stop fetching and wait for the workers to exit.
+   */
+  ~monero_block_streamer();
+
+  /**
+   * Take the next chunk in order, waiting until it is decoded.
+   *
+   * @param blocks_json is assigned the chunk's blocks and txs as json
+   * @return true if a chunk is taken, false if all chunks are taken
+   * @throws runtime_error if the chunk could not be fetched or decoded
+   */
+  bool next(std::string& blocks_json);
+
+  /**
+   * Stop claiming chunks; chunks already claimed finish but are not delivered.
+   */
+  void stop();
+
+private:
+  struct result {
+    std::string m_blocks_json;
+    std::string m_error;
+  };
+
+  std::string m_uri;
+  std::string m_username;
+  std::string m_password;
+  std::vector<chunk> m_chunks;
+  size_t m_max_buffered;
+  size_t m_next_claimed;
+  size_t m_next_taken;
+  bool m_is_stopped;
+  std::map<size_t, result> m_results;
+  std::mutex m_mutex;
+  std::condition_variable m_result_ready;
+  std::condition_variable m_result_taken;
+  std::vector<std::thread> m_workers;
+
+  void run_worker();
+};
+
+#endif /* monero_block_streamer_h */
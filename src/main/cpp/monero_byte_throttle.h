@@ -0,0 +1,83 @@
+/**
+ * Copyright (c) 2017-2019 woodser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef monero_byte_throttle_h
+#define monero_byte_throttle_h
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+/**
+ * Throttles concurrent tasks by a size in bytes which each task declares,
+ * such as the size of a file it reads.
+ *
+ * A task reserves its size before it starts and releases it when done,
+ * waiting while the reserved total would exceed the limit.  A task larger
+ * than the limit runs once nothing else is reserved, so it never waits
+ * forever.  The throttle only limits how many tasks run at once; what a task
+ * allocates for its size is up to the task.
+ */
+class monero_byte_throttle {
+public:
+
+  /**
+   * Reserves bytes within the limit for the life of the reservation.
+   */
+  class reservation {
+  public:
+    reservation(monero_byte_throttle& throttle, uint64_t num_bytes) : m_throttle(throttle), m_num_bytes(num_bytes) { m_throttle.acquire(m_num_bytes); }
+    ~reservation() { m_throttle.release(m_num_bytes); }
+  private:
+    monero_byte_throttle& m_throttle;
+    uint64_t m_num_bytes;
+    reservation(const reservation&);
+    reservation& operator=(const reservation&);
+  };
+
+  /**
+   * @param max_bytes is the maximum number of bytes reserved at once (0 for no limit)
+   */
+  monero_byte_throttle(uint64_t max_bytes) : m_max_bytes(max_bytes), m_reserved_bytes(0) { }
+
+  void acquire(uint64_t num_bytes) {
+    if (m_max_bytes == 0) return;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_released.wait(lock, [&]() { return m_reserved_bytes == 0 || m_reserved_bytes + num_bytes <= m_max_bytes; });
+    m_reserved_bytes += num_bytes;
+  }
+
+  void release(uint64_t num_bytes) {
+    if (m_max_bytes == 0) return;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_reserved_bytes -= num_bytes;
+    m_released.notify_all();
+  }
+
+private:
+  uint64_t m_max_bytes;
+  uint64_t m_reserved_bytes;
+  std::mutex m_mutex;
+  std::condition_variable m_released;
+};
+
+#endif /* monero_byte_throttle_h */
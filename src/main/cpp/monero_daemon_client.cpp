@@ -0,0 +1,145 @@
+/**
+ * Copyright (c) 2017-2019 woodser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "monero_daemon_client.h"
+#include "storages/http_abstract_invoke.h"
+
+using namespace std;
+
+static const chrono::seconds DAEMON_RPC_TIMEOUT = chrono::seconds(60);
+
+monero_daemon_client::monero_daemon_client(const string& uri, const string& username, const string& password) {
+  boost::optional<epee::net_utils::http::login> login;
+  if (!username.empty()) login = epee::net_utils::http::login(username, password);
+  m_http_client.set_server(uri, login);
+}
+
+bool monero_daemon_client::submit_tx_hex(const string& tx_hex, string& error) {
+  cryptonote::COMMAND_RPC_SEND_RAW_TX::request req;
+  cryptonote::COMMAND_RPC_SEND_RAW_TX::response res;
+  req.tx_as_hex = tx_hex;
+  req.do_not_relay = false;
+  if (!epee::net_utils::invoke_http_json("/send_raw_transaction", req, res, m_http_client, DAEMON_RPC_TIMEOUT)) {
+    error = "No connection to daemon";
+    return false;
+  }
+  if (res.status != CORE_RPC_STATUS_OK) {
+    error = res.reason.empty() ? res.status : res.reason;
+    return false;
+  }
+  return true;
+}
+
+bool monero_daemon_client::get_blocks_by_height_bin(const vector<uint64_t>& heights, string& blocks_bin, string& error) {
+  cryptonote::COMMAND_RPC_GET_BLOCKS_BY_HEIGHT::request req;
+  req.heights = heights;
+  string req_bin;
+  if (!epee::serialization::store_t_to_binary(req, req_bin)) {
+    error = "Failed to serialize get_blocks_by_height.bin request";
+    return false;
+  }
+  const epee::net_utils::http::http_response_info* response = nullptr;
+  if (!m_http_client.invoke_post("/get_blocks_by_height.bin", req_bin, DAEMON_RPC_TIMEOUT, &response) || response == nullptr) {
+    error = "No connection to daemon";
+    return false;
+  }
+  if (response->m_response_code != 200) {
+    error = "Daemon returned HTTP status " + to_string(response->m_response_code);
+    return false;
+  }
+  blocks_bin = response->m_body;
+  return true;
+}
+
+bool monero_daemon_client::get_height(uint64_t& height, string& error) {
+  cryptonote::COMMAND_RPC_GET_HEIGHT::request req;
+  cryptonote::COMMAND_RPC_GET_HEIGHT::response res;
+  if (!epee::net_utils::invoke_http_json("/getheight", req, res, m_http_client, DAEMON_RPC_TIMEOUT)) {
+    error = "No connection to daemon";
+    return false;
+  }
+  if (res.status != CORE_RPC_STATUS_OK) {
+    error = res.status;
+    return false;
+  }
+  height = res.height;
+  return true;
+}
+
+bool monero_daemon_client::get_txs(const vector<string>& tx_hashes, vector<cryptonote::COMMAND_RPC_GET_TRANSACTIONS::entry>& txs, string& error) {
+  cryptonote::COMMAND_RPC_GET_TRANSACTIONS::request req;
+  cryptonote::COMMAND_RPC_GET_TRANSACTIONS::response res;
+  req.txs_hashes = tx_hashes;
+  req.decode_as_json = false;
+  req.prune = false;
+  if (!epee::net_utils::invoke_http_json("/gettransactions", req, res, m_http_client, DAEMON_RPC_TIMEOUT)) {
+    error = "No connection to daemon";
+    return false;
+  }
+  if (res.status != CORE_RPC_STATUS_OK) {
+    error = res.status;
+    return false;
+  }
+  txs = std::move(res.txs);
+  return true;
+}
+
+bool monero_daemon_client::get_key_images_spent(const vector<string>& key_images, vector<int>& spent_statuses, string& error) {
+  cryptonote::COMMAND_RPC_IS_KEY_IMAGE_SPENT::request req;
+  cryptonote::COMMAND_RPC_IS_KEY_IMAGE_SPENT::response res;
+  req.key_images = key_images;
+  if (!epee::net_utils::invoke_http_json("/is_key_image_spent", req, res, m_http_client, DAEMON_RPC_TIMEOUT)) {
+    error = "No connection to daemon";
+    return false;
+  }
+  if (res.status != CORE_RPC_STATUS_OK) {
+    error = res.status;
+    return false;
+  }
+  if (res.spent_status.size() != key_images.size()) {
+    error = "Daemon returned a spent status for " + to_string(res.spent_status.size()) + " of " + to_string(key_images.size()) + " key images";
+    return false;
+  }
+  spent_statuses = std::move(res.spent_status);
+  return true;
+}
+
+bool monero_daemon_client::get_outs_bin(const vector<cryptonote::get_outputs_out>& outputs, vector<cryptonote::COMMAND_RPC_GET_OUTPUTS_BIN::outkey>& outs, string& error) {
+  cryptonote::COMMAND_RPC_GET_OUTPUTS_BIN::request req;
+  cryptonote::COMMAND_RPC_GET_OUTPUTS_BIN::response res;
+  req.outputs = outputs;
+  req.get_txid = false;
+  if (!epee::net_utils::invoke_http_bin("/get_outs.bin", req, res, m_http_client, DAEMON_RPC_TIMEOUT)) {
+    error = "No connection to daemon";
+    return false;
+  }
+  if (res.status != CORE_RPC_STATUS_OK) {
+    error = res.status;
+    return false;
+  }
+  if (res.outs.size() != outputs.size()) {
+    error = "Daemon returned " + to_string(res.outs.size()) + " of " + to_string(outputs.size()) + " outputs";
+    return false;
+  }
+  outs = std::move(res.outs);
+  return true;
+}
@@ -0,0 +1,104 @@
+/**
+ * Copyright (c) 2017-2019 woodser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef monero_daemon_client_h
+#define monero_daemon_client_h
+
+#include <string>
+#include <vector>
+#include "net/http_client.h"
+#include "rpc/core_rpc_server_commands_defs.h"
+
+/**
+ * Minimal client for daemon RPC calls made directly from the JNI bridge.
+ *
+ * Each instance owns one HTTP connection and is not thread-safe; use one
+ * client per thread to keep several requests in flight.
+ */
+class monero_daemon_client {
+public:
+
+  monero_daemon_client(const std::string& uri, const std::string& username, const std::string& password);
+
+  /**
+   * Submit a raw tx to the daemon's pool and relay it.
+   *
+   * @param tx_hex is the tx blob as hex
+   * @param error is assigned the daemon's rejection reason if not accepted
+   * @return true if the daemon accepted the tx, false otherwise
+   */
+  bool submit_tx_hex(const std::string& tx_hex, std::string& error);
+
+  /**
+   * Fetch blocks and their txs by height in the daemon's binary format.
+   *
+   * @param heights are the heights of the blocks to fetch
+   * @param blocks_bin is assigned the daemon's portable storage response
+   * @param error is assigned the reason if the blocks could not be fetched
+   * @return true if the blocks were fetched, false otherwise
+   */
+  bool get_blocks_by_height_bin(const std::vector<uint64_t>& heights, std::string& blocks_bin, std::string& error);
+
+  /**
+   * Fetch the daemon's chain height.
+   *
+   * @param height is assigned the number of blocks in the daemon's chain
+   * @param error is assigned the reason if the height could not be fetched
+   * @return true if the height was fetched, false otherwise
+   */
+  bool get_height(uint64_t& height, std::string& error);
+
+  /**
+   * Fetch unpruned txs by hash from the chain or pool.
+   *
+   * @param tx_hashes are the hashes of the txs to fetch
+   * @param txs is assigned the daemon's entry of each tx found, which omits missed txs
+   * @param error is assigned the reason if the txs could not be fetched
+   * @return true if the txs were fetched, false otherwise
+   */
+  bool get_txs(const std::vector<std::string>& tx_hashes, std::vector<cryptonote::COMMAND_RPC_GET_TRANSACTIONS::entry>& txs, std::string& error);
+
+  /**
+   * Fetch the spent status of key images.
+   *
+   * @param key_images are the key images to check as hex
+   * @param spent_statuses is assigned the daemon's status of each key image in the order given
+   * @param error is assigned the reason if the statuses could not be fetched
+   * @return true if the statuses were fetched, false otherwise
+   */
+  bool get_key_images_spent(const std::vector<std::string>& key_images, std::vector<int>& spent_statuses, std::string& error);
+
+  /**
+   * Fetch outputs by amount and global index in the daemon's binary format.
+   *
+   * @param outputs are the amounts and indices of the outputs to fetch
+   * @param outs is assigned the daemon's output of each request in the order given
+   * @param error is assigned the reason if the outputs could not be fetched
+   * @return true if the outputs were fetched, false otherwise
+   */
+  bool get_outs_bin(const std::vector<cryptonote::get_outputs_out>& outputs, std::vector<cryptonote::COMMAND_RPC_GET_OUTPUTS_BIN::outkey>& outs, std::string& error);
+
+private:
+  epee::net_utils::http::http_simple_client m_http_client;
+};
+
+#endif /* monero_daemon_client_h */
@@ -0,0 +1,155 @@
+/**
+ * Copyright (c) 2017-2019 woodser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "monero_header_cache.h"
+#include <memory>
+#include <unordered_map>
+#include "string_tools.h"
+
+using namespace std;
+
+monero_header_cache& monero_header_cache::instance(const string& daemon_uri) {
+  static mutex caches_mutex;
+  static unordered_map<string, unique_ptr<monero_header_cache>> caches;
+  lock_guard<mutex> lock(caches_mutex);
+  unique_ptr<monero_header_cache>& cache = caches[daemon_uri];
+  if (cache == nullptr) cache.reset(new monero_header_cache());
+  return *cache;
+}
+
+monero_header_cache::monero_header_cache(size_t max_headers) : m_slots(max_headers == 0 ? 1 : max_headers), m_num_headers(0), m_has_tip(false), m_tip_height(0), m_stats() { }
+
+bool monero_header_cache::get_header(uint64_t height, monero_cached_header& header) {
+  lock_guard<mutex> lock(m_mutex);
+  const monero_cached_header* cached = find(height);
+  if (cached == nullptr) {
+    m_stats.m_misses++;
+    return false;
+  }
+  header = *cached;
+  m_stats.m_hits++;
+  return true;
+}
+
+size_t monero_header_cache::get_sizes(uint64_t start_height, uint64_t* sizes, size_t max_sizes) {
+  lock_guard<mutex> lock(m_mutex);
+  size_t num_sizes = 0;
+  for (; num_sizes < max_sizes; num_sizes++) {
+    const monero_cached_header* cached = find(start_height + num_sizes);
+    if (cached == nullptr) break;
+    sizes[num_sizes] = cached->m_size;
+  }
+  m_stats.m_hits += num_sizes;
+  if (num_sizes < max_sizes) m_stats.m_misses++;
+  return num_sizes;
+}
+
+bool monero_header_cache::put_headers(const vector<monero_cached_header>& headers, const string& tip_hash) {
+  lock_guard<mutex> lock(m_mutex);
+  if (headers.empty()) return true;
+
+  // headers must be fetched under the current tip and not above it
+  bool is_valid = m_has_tip && tip_hash == m_tip_hash;
+  for (size_t i = 0; is_valid && i < headers.size(); i++) {
+    const monero_cached_header& header = headers[i];
+    if (header.m_height > m_tip_height) is_valid = false;
+    else if (header.m_height == m_tip_height && epee::string_tools::pod_to_hex(header.m_hash) != m_tip_hash) is_valid = false;
+    else if (i > 0 && (header.m_height != headers[i - 1].m_height + 1 || header.m_prev_hash != headers[i - 1].m_hash)) is_valid = false;
+  }
+
+  // headers must link to the cached headers next to them
+  if (is_valid && headers.front().m_height > 0) {
+    const monero_cached_header* prev = find(headers.front().m_height - 1);
+    if (prev != nullptr && prev->m_hash != headers.front().m_prev_hash) is_valid = false;
+  }
+  if (is_valid) {
+    const monero_cached_header* next = find(headers.back().m_height + 1);
+    if (next != nullptr && next->m_prev_hash != headers.back().m_hash) is_valid = false;
+  }
+  if (!is_valid) {
+    m_stats.m_num_rejected++;
+    return false;
+  }
+
+  for (const monero_cached_header& header : headers) {
+    slot& s = m_slots[header.m_height % m_slots.size()];
+    if (!s.m_is_set) m_num_headers++;
+    s.m_is_set = true;
+    s.m_header = header;
+  }
+  return true;
+}
+
+void monero_header_cache::set_tip(uint64_t height, const string& hash, const string& anchor_hash) {
+  lock_guard<mutex> lock(m_mutex);
+  if (m_has_tip && height == m_tip_height && hash == m_tip_hash) return;
+
+  // clear everything if the previous tip is no longer on the chain
+  if (m_has_tip && (height < m_tip_height || anchor_hash.empty() || anchor_hash != m_tip_hash)) {
+    clear_slots();
+    m_stats.m_num_invalidations++;
+  }
+
+  m_has_tip = true;
+  m_tip_height = height;
+  m_tip_hash = hash;
+}
+
+int64_t monero_header_cache::get_tip_height() {
+  lock_guard<mutex> lock(m_mutex);
+  return m_has_tip ? (int64_t) m_tip_height : -1;
+}
+
+void monero_header_cache::set_max_headers(size_t max_headers) {
+  lock_guard<mutex> lock(m_mutex);
+  vector<slot>(max_headers == 0 ? 1 : max_headers).swap(m_slots);  // release the old ring
+  m_num_headers = 0;
+}
+
+monero_header_cache_stats monero_header_cache::get_stats() {
+  lock_guard<mutex> lock(m_mutex);
+  monero_header_cache_stats stats = m_stats;
+  stats.m_num_headers = m_num_headers;
+  stats.m_max_headers = m_slots.size();
+  return stats;
+}
+
+void monero_header_cache::clear() {
+  lock_guard<mutex> lock(m_mutex);
+  clear_slots();
+  m_has_tip = false;
+  m_tip_height = 0;
+  m_tip_hash.clear();
+  m_stats = monero_header_cache_stats();
+}
+
+// ------------------------------- PRIVATE HELPERS ----------------------------
+
+void monero_header_cache::clear_slots() {
+  for (slot& s : m_slots) s.m_is_set = false;
+  m_num_headers = 0;
+}
+
+const monero_cached_header* monero_header_cache::find(uint64_t height) const {
+  const slot& s = m_slots[height % m_slots.size()];
+  return s.m_is_set && s.m_header.m_height == height ? &s.m_header : nullptr;
+}
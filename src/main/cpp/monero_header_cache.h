@@ -0,0 +1,169 @@
+/**
+ * Copyright (c) 2017-2019 woodser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef monero_header_cache_h
+#define monero_header_cache_h
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "crypto/crypto.h"
+
+/**
+ * Block header as returned by the daemon's get_block_headers_range, packed
+ * into fixed-size fields.  Depth is omitted since it changes with every block.
+ */
+struct monero_cached_header {
+  crypto::hash m_hash;
+  crypto::hash m_prev_hash;
+  crypto::hash m_miner_tx_hash;
+  uint64_t m_height;
+  uint64_t m_timestamp;
+  uint64_t m_size;
+  uint64_t m_weight;
+  uint64_t m_long_term_weight;
+  uint64_t m_reward;
+  uint64_t m_difficulty_lo;
+  uint64_t m_difficulty_hi;
+  uint64_t m_cumulative_difficulty_lo;
+  uint64_t m_cumulative_difficulty_hi;
+  uint32_t m_nonce;
+  uint32_t m_num_txs;
+  uint8_t m_major_version;
+  uint8_t m_minor_version;
+  bool m_orphan_status;
+};
+
+/**
+ * Hit/miss counters and size of the header cache.
+ */
+struct monero_header_cache_stats {
+  uint64_t m_hits;
+  uint64_t m_misses;
+  uint64_t m_num_headers;
+  uint64_t m_max_headers;
+  uint64_t m_num_invalidations;
+  uint64_t m_num_rejected;
+};
+
+/**
+ * Cache of a daemon's block headers in a fixed ring indexed by height.
+ *
+ * A header occupies slot height % max_headers, so the cache never grows
+ * past its initial allocation and lookups copy a fixed-size record without
+ * allocating.  Entries are tied to the chain tip reported through set_tip()
+ * like the output cache: a new block on top of the known tip keeps every
+ * header, a reorg clears the cache.  Each daemon has its own process-wide
+ * cache so clients of daemons on different networks or at different heights
+ * do not clear each other's headers.
+ */
+class monero_header_cache {
+public:
+
+  static const size_t DEFAULT_MAX_HEADERS = 32768;
+
+  /**
+   * Get the process-wide cache of a daemon's headers, created on first use.
+   *
+   * @param daemon_uri is the uri of the daemon whose headers are cached
+   */
+  static monero_header_cache& instance(const std::string& daemon_uri);
+
+  monero_header_cache(size_t max_headers = DEFAULT_MAX_HEADERS);
+
+  /**
+   * Get a cached header.
+   *
+   * @param height is the height of the header
+   * @param header is assigned the cached header if found
+   * @return true if found, false otherwise
+   */
+  bool get_header(uint64_t height, monero_cached_header& header);
+
+  /**
+   * Get the sizes of consecutive cached headers.
+   *
+   * @param start_height is the height of the first header
+   * @param sizes is assigned the block size of each consecutive cached header
+   * @param max_sizes is the maximum number of sizes to assign
+   * @return the number of sizes assigned, stopping at the first miss
+   */
+  size_t get_sizes(uint64_t start_height, uint64_t* sizes, size_t max_sizes);
+
+  /**
+   * Add or replace consecutive headers fetched while the given tip was
+   * reported, replacing whichever headers occupied their slots.
+   *
+   * The headers are rejected if another tip was reported since, if any is
+   * above the tip or differs from it at its height, or if they do not link
+   * to each other and to the cached headers next to them, so headers of a
+   * chain replaced by the tip are not cached.
+   *
+   * @param headers are consecutive headers in ascending height
+   * @param tip_hash is the hash of the tip reported before fetching the headers
+   * @return true if the headers are cached, false if rejected
+   */
+  bool put_headers(const std::vector<monero_cached_header>& headers, const std::string& tip_hash);
+
+  /**
+   * Report the daemon's current chain tip.
+   *
+   * @param height is the height of the tip block
+   * @param hash is the hash of the tip block
+   * @param anchor_hash is the hash, as seen on the current chain, of the block
+   *        at the previously reported tip height (empty if unknown)
+   */
+  void set_tip(uint64_t height, const std::string& hash, const std::string& anchor_hash);
+
+  /**
+   * Get the height of the last reported tip, or -1 if none.
+   */
+  int64_t get_tip_height();
+
+  /**
+   * Change the number of slots in the ring, which clears the cache.
+   */
+  void set_max_headers(size_t max_headers);
+
+  monero_header_cache_stats get_stats();
+  void clear();
+
+private:
+  struct slot {
+    bool m_is_set;
+    monero_cached_header m_header;
+  };
+
+  std::mutex m_mutex;
+  std::vector<slot> m_slots;
+  size_t m_num_headers;
+  bool m_has_tip;
+  uint64_t m_tip_height;
+  std::string m_tip_hash;
+  monero_header_cache_stats m_stats;
+
+  void clear_slots();
+  const monero_cached_header* find(uint64_t height) const;
+};
+
+#endif /* monero_header_cache_h */
@@ -0,0 +1,173 @@
+/**
+ * Copyright (c) 2017-2019 woodser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef monero_json_arena_h
+#define monero_json_arena_h
+
+#include <algorithm>
+#include <memory>
+#include "rapidjson/document.h"
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
+#include "monero_trace.h"
+
+/**
+ * rapidjson document and writer whose memory is owned by the calling thread.
+ *
+ * A query result is serialized by building a document of thousands of small
+ * values which are all freed together once it is written, then writing it to
+ * a string buffer which is copied to Java.  Placing both in per-thread buffers
+ * reused by the thread's next call avoids malloc calls and their lock
+ * contention across threads, and avoids regrowing a multi-MB string buffer by
+ * copying on every call.
+ *
+ * Each buffer is sized to the high water mark of recent calls: it grows to
+ * fit the largest recent result and shrinks back once a spike has aged out,
+ * so a thread which served one huge getTxs() doesn't hold the memory forever.
+ *
+ * Only one arena per thread uses the buffers; an arena constructed while
+ * another is live on the same thread allocates normally.
+ */
+class monero_json_arena {
+public:
+  monero_json_arena() : m_is_shared(claim_buffers()), m_fallback_pool(m_is_shared ? nullptr : new char[FALLBACK_SIZE]), m_fallback_writer(m_is_shared ? nullptr : new rapidjson::StringBuffer()), m_allocator(m_is_shared ? get_buffers().m_pool.get() : m_fallback_pool.get(), m_is_shared ? get_buffers().m_pool_size : FALLBACK_SIZE, CHUNK_SIZE), m_doc(&m_allocator), m_written(0) { }
+
+  // the allocator still references the pool until after this body, so buffers are resized on the next claim
+  ~monero_json_arena() {
+    if (!m_is_shared) return;
+    thread_buffers& buffers = get_buffers();
+    buffers.m_pool_hwm.record(m_allocator.Size());
+    buffers.m_writer_hwm.record(m_written);
+    buffers.m_in_use = false;
+  }
+
+  rapidjson::Document& doc() { return m_doc; }
+
+  // serializes the document; the buffer is valid until the arena is destroyed
+  const rapidjson::StringBuffer& serialize() {
+    return write(m_doc);
+  }
+
+  // serializes a model struct, e.g. a tx set, by building its value in the arena
+  template <class T>
+  const rapidjson::StringBuffer& serialize(const T& obj) {
+    rapidjson::Value val = obj.to_rapidjson_val(m_doc.GetAllocator());
+    return write(val);
+  }
+
+private:
+  static const size_t MIN_POOL_SIZE = 256 * 1024;   // reused by each call on a thread
+  static const size_t MIN_WRITER_SIZE = 256 * 1024;
+  static const size_t CHUNK_SIZE = 256 * 1024;      // allocated once a result outgrows the pool
+  static const size_t FALLBACK_SIZE = 4 * 1024;     // used by nested arenas
+  static const size_t SHRINK_FACTOR = 4;            // buffers shrink once this many times larger than needed
+
+  // largest size recorded over the current and previous window of calls
+  class high_water_mark {
+  public:
+    high_water_mark() : m_cur(0), m_prev(0), m_num_calls(0) { }
+    void record(size_t size) {
+      m_cur = std::max(m_cur, size);
+      if (++m_num_calls < WINDOW) return;
+      m_prev = m_cur;
+      m_cur = 0;
+      m_num_calls = 0;
+    }
+    size_t get() const { return std::max(m_cur, m_prev); }
+  private:
+    static const size_t WINDOW = 32;
+    size_t m_cur;
+    size_t m_prev;
+    size_t m_num_calls;
+  };
+
+  struct thread_buffers {
+    thread_buffers() : m_pool_size(0), m_writer_capacity(0), m_in_use(false) { }
+    std::unique_ptr<char[]> m_pool;
+    size_t m_pool_size;
+    rapidjson::StringBuffer m_writer;
+    size_t m_writer_capacity;
+    high_water_mark m_pool_hwm;
+    high_water_mark m_writer_hwm;
+    bool m_in_use;
+  };
+
+  bool m_is_shared;
+  std::unique_ptr<char[]> m_fallback_pool;                    // used by nested arenas
+  std::unique_ptr<rapidjson::StringBuffer> m_fallback_writer;
+  rapidjson::MemoryPoolAllocator<> m_allocator;
+  rapidjson::Document m_doc;
+  size_t m_written;
+
+  monero_json_arena(const monero_json_arena&);
+  monero_json_arena& operator=(const monero_json_arena&);
+
+  // allocated on first use so threads which never serialize don't hold buffers
+  static thread_buffers& get_buffers() {
+    static thread_local thread_buffers buffers;
+    return buffers;
+  }
+
+  // returns the target size of a buffer given the high water mark of recent calls and its current size
+  static size_t get_target_size(size_t hwm, size_t size, size_t min_size) {
+    size_t target = std::max(min_size, hwm + hwm / 4);
+    if (size >= hwm && size < target * SHRINK_FACTOR) return std::max(size, min_size);  // keep while in range
+    return target;
+  }
+
+  // claims the thread's buffers and resizes them to recent demand, returns false if already claimed
+  static bool claim_buffers() {
+    thread_buffers& buffers = get_buffers();
+    if (buffers.m_in_use) return false;
+    buffers.m_in_use = true;
+
+    // resize document pool
+    size_t pool_size = get_target_size(buffers.m_pool_hwm.get(), buffers.m_pool_size, MIN_POOL_SIZE);
+    if (!buffers.m_pool || pool_size != buffers.m_pool_size) {
+      buffers.m_pool.reset(new char[pool_size]);
+      buffers.m_pool_size = pool_size;
+    }
+
+    // resize string buffer which keeps its capacity when cleared
+    size_t writer_size = get_target_size(buffers.m_writer_hwm.get(), buffers.m_writer_capacity, MIN_WRITER_SIZE);
+    if (writer_size != buffers.m_writer_capacity) {
+      buffers.m_writer.Clear();
+      buffers.m_writer.ShrinkToFit();
+      buffers.m_writer.Reserve(writer_size);
+      buffers.m_writer_capacity = writer_size;
+    }
+    return true;
+  }
+
+  const rapidjson::StringBuffer& write(const rapidjson::Value& val) {
+    MONERO_TRACE_SPAN("monero_json_arena::write");
+    rapidjson::StringBuffer& buffer = m_is_shared ? get_buffers().m_writer : *m_fallback_writer;
+    buffer.Clear();
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    val.Accept(writer);
+    m_written = buffer.GetSize();
+    if (m_is_shared) get_buffers().m_writer_capacity = std::max(get_buffers().m_writer_capacity, m_written + 1);
+    return buffer;
+  }
+};
+
+#endif /* monero_json_arena_h */
@@ -0,0 +1,225 @@
+/**
+ * Copyright (c) 2017-2019 woodser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "monero_lazy_wallet.h"
+#include <cstring>
+#include <stdexcept>
+#include "crypto/chacha.h"
+#include "crypto/hash.h"
+#include "cryptonote_basic/cryptonote_basic_impl.h"
+#include "device/device.hpp"
+#include "file_io_utils.h"
+#include "mnemonics/electrum-words.h"
+#include "rapidjson/document.h"
+#include "serialization/binary_utils.h"
+#include "serialization/crypto.h"
+#include "serialization/string.h"
+#include "storages/portable_storage_template_helper.h"
+#include "span.h"
+#include "string_tools.h"
+#include "wipeable_string.h"
+extern "C" {
+#include "crypto/crypto-ops.h"
+}
+
+using namespace std;
+using namespace monero;
+
+// ------------------------------- PRIVATE HELPERS ----------------------------
+
+namespace {
+
+  const uint64_t KDF_ROUNDS = 1; // as monero_wallet_core opens wallets
+  const char* NETWORK_NAMES[] = { "mainnet", "testnet", "stagenet" };
+
+  /**
+   * Keys file as saved by wallet2.
+   */
+  struct keys_file_data {
+    crypto::chacha_iv iv;
+    string account_data;
+
+    BEGIN_SERIALIZE_OBJECT()
+      FIELD(iv)
+      FIELD(account_data)
+    END_SERIALIZE()
+  };
+
+  // parses a json object in place in a wipeable copy of the buffer so its strings are not copied elsewhere
+  bool parse_json_in_place(const epee::wipeable_string& buf, epee::wipeable_string& json_buf, rapidjson::Document& json) {
+    json_buf = buf;
+    json_buf.push_back('\0');
+    return !json.ParseInsitu(json_buf.data()).HasParseError() && json.IsObject();
+  }
+
+  // gets an integer field of a keys file's json, 0 if absent
+  int64_t get_json_int(const rapidjson::Value& json, const char* name) {
+    if (!json.HasMember(name) || !json[name].IsInt64()) return 0;
+    return json[name].GetInt64();
+  }
+}
+
+// -------------------------------- LAZY KEYS ---------------------------------
+
+unique_ptr<monero_lazy_keys> monero_lazy_keys::decrypt(const string& keys_buf, const string& password, monero_network_type network_type) {
+
+  // decrypt account data with the password key, derived once
+  keys_file_data keys_file;
+  if (!::serialization::parse_binary(keys_buf, keys_file)) throw runtime_error("Failed to deserialize wallet keys file");
+  crypto::chacha_key key;
+  crypto::generate_chacha_key(password.data(), password.size(), key, KDF_ROUNDS);
+  epee::wipeable_string account_data;
+  account_data.resize(keys_file.account_data.size());
+  crypto::chacha20(keys_file.account_data.data(), keys_file.account_data.size(), key, keys_file.iv, account_data.data());
+  epee::wipeable_string json_buf;
+  rapidjson::Document json;
+  bool is_json = parse_json_in_place(account_data, json_buf, json);
+  if (!is_json) {
+    crypto::chacha8(keys_file.account_data.data(), keys_file.account_data.size(), key, keys_file.iv, account_data.data());
+    is_json = parse_json_in_place(account_data, json_buf, json);
+  }
+
+  // read wallet fields as wallet2::load_keys_buf() does, the oldest keys files being the bare account
+  unique_ptr<monero_lazy_keys> keys(new monero_lazy_keys());
+  keys->m_network_type = network_type;
+  keys->m_is_watch_only = false;
+  bool encrypted_secret_keys = false;
+  if (is_json) {
+    if (!json.HasMember("key_data") || !json["key_data"].IsString()) throw runtime_error("Wallet keys file has no key data");
+    if (get_json_int(json, "key_on_device") != 0 || get_json_int(json, "multisig") != 0) return nullptr;
+    if (json.HasMember("nettype")) {
+      int64_t saved_network_type = get_json_int(json, "nettype");
+      if (saved_network_type != network_type) throw runtime_error(string(saved_network_type >= 0 && saved_network_type <= 2 ? NETWORK_NAMES[saved_network_type] : "unknown") + " wallet cannot be opened as " + NETWORK_NAMES[network_type] + " wallet");
+    }
+    if (json.HasMember("seed_language") && json["seed_language"].IsString()) keys->m_language = json["seed_language"].GetString();
+    keys->m_is_watch_only = get_json_int(json, "watch_only") != 0;
+    encrypted_secret_keys = get_json_int(json, "encrypted_secret_keys") != 0;
+    const rapidjson::Value& key_data = json["key_data"];
+    account_data = epee::wipeable_string(key_data.GetString(), key_data.GetStringLength());
+  }
+
+  // load account, whose secret keys are encrypted with the same key if saved encrypted
+  if (!epee::serialization::load_t_from_binary(keys->m_account, epee::span<const uint8_t>(reinterpret_cast<const uint8_t*>(account_data.data()), account_data.size()))) throw runtime_error("invalid password");
+  if (encrypted_secret_keys) keys->m_account.decrypt_keys(key);
+
+  // a wrong password yields keys which do not match the address
+  const cryptonote::account_keys& account_keys = keys->m_account.get_keys();
+  hw::device& hwdev = hw::get_device("default");
+  bool is_valid = hwdev.verify_keys(account_keys.m_view_secret_key, account_keys.m_account_address.m_view_public_key);
+  if (!keys->m_is_watch_only) is_valid = is_valid && hwdev.verify_keys(account_keys.m_spend_secret_key, account_keys.m_account_address.m_spend_public_key);
+  if (!is_valid) throw runtime_error("invalid password");
+  return keys;
+}
+
+string monero_lazy_keys::get_mnemonic() const {
+
+  // only wallets whose view key derives from their spend key have a mnemonic, as wallet2::get_seed() checks
+  if (m_is_watch_only || m_language.empty()) return "";
+  const cryptonote::account_keys& keys = m_account.get_keys();
+  crypto::hash view_key;
+  crypto::cn_fast_hash(&keys.m_spend_secret_key, sizeof(crypto::secret_key), view_key);
+  sc_reduce32((unsigned char*) view_key.data);
+  if (memcmp(view_key.data, keys.m_view_secret_key.data, sizeof(crypto::secret_key)) != 0) return "";
+  epee::wipeable_string mnemonic;
+  if (!crypto::ElectrumWords::bytes_to_words(keys.m_spend_secret_key, mnemonic, m_language)) return "";
+  return string(mnemonic.data(), mnemonic.size());
+}
+
+string monero_lazy_keys::get_public_view_key() const {
+  return epee::string_tools::pod_to_hex(m_account.get_keys().m_account_address.m_view_public_key);
+}
+
+string monero_lazy_keys::get_private_view_key() const {
+  return epee::string_tools::pod_to_hex(unwrap(unwrap(m_account.get_keys().m_view_secret_key)));
+}
+
+string monero_lazy_keys::get_public_spend_key() const {
+  return epee::string_tools::pod_to_hex(m_account.get_keys().m_account_address.m_spend_public_key);
+}
+
+string monero_lazy_keys::get_private_spend_key() const {
+  string private_spend_key = epee::string_tools::pod_to_hex(unwrap(unwrap(m_account.get_keys().m_spend_secret_key)));
+  return private_spend_key == string(64, '0') ? "" : private_spend_key;
+}
+
+string monero_lazy_keys::get_address(uint32_t account_idx, uint32_t subaddress_idx) const {
+  cryptonote::subaddress_index index = { account_idx, subaddress_idx };
+  cryptonote::account_public_address address = hw::get_device("default").get_subaddress(m_account.get_keys(), index);
+  return cryptonote::get_account_address_as_str(static_cast<cryptonote::network_type>(m_network_type), !index.is_zero(), address);
+}
+
+// ------------------------------- LAZY WALLET --------------------------------
+
+monero_lazy_wallet::monero_lazy_wallet(const string& path, const string& password, monero_network_type network_type) : m_wallet(nullptr), m_is_loaded(false) {
+
+  // open full wallet in background
+  m_loader = thread([this, path, password, network_type]() {
+    monero_wallet* wallet = nullptr;
+    exception_ptr error;
+    try {
+      wallet = monero_wallet_core::open_wallet(path, password, network_type);
+    } catch (...) {
+      error = current_exception();
+    }
+    lock_guard<mutex> lock(m_mutex);
+    m_wallet = wallet;
+    m_error = error;
+    m_is_loaded = true;
+    m_loaded.notify_all();
+  });
+
+  // meanwhile decrypt keys in memory
+  try {
+    string keys_buf;
+    if (!epee::file_io_utils::load_file_to_string(path + ".keys", keys_buf)) throw runtime_error("Cannot read wallet keys file: " + path + ".keys");
+    m_keys = monero_lazy_keys::decrypt(keys_buf, password, network_type);
+  } catch (...) {
+    m_loader.join();
+    delete m_wallet;
+    throw;
+  }
+}
+
+monero_lazy_wallet::~monero_lazy_wallet() {
+  if (m_loader.joinable()) m_loader.join();
+  delete m_wallet;
+}
+
+bool monero_lazy_wallet::is_loaded() const {
+  lock_guard<mutex> lock(m_mutex);
+  return m_is_loaded;
+}
+
+monero_wallet* monero_lazy_wallet::await() {
+  unique_lock<mutex> lock(m_mutex);
+  m_loaded.wait(lock, [this]() { return m_is_loaded; });
+  if (m_error) rethrow_exception(m_error);
+  return m_wallet;
+}
+
+monero_wallet* monero_lazy_wallet::release() {
+  if (m_loader.joinable()) m_loader.join();
+  lock_guard<mutex> lock(m_mutex);
+  monero_wallet* wallet = m_wallet;
+  m_wallet = nullptr;
+  return wallet;
+}
@@ -0,0 +1,139 @@
+/**
+ * Copyright (c) 2017-2019 woodser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef monero_lazy_wallet_h
+#define monero_lazy_wallet_h
+
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "cryptonote_basic/account.h"
+#include "wallet/monero_wallet_core.h"
+
+/**
+ * Keys of a wallet decrypted in memory from its keys file, as wallet2 loads
+ * them, without opening the wallet.
+ *
+ * Hardware and multisig wallets are not supported since their keys are not
+ * all in the keys file.
+ */
+class monero_lazy_keys {
+public:
+
+  /**
+   * Decrypt the keys of a wallet.
+   *
+   * @param keys_buf is the contents of the wallet's keys file
+   * @param password is the password of the wallet
+   * @param network_type is the network type of the wallet
+   * @return the wallet's keys, or null if they are not all in its keys file
+   * @throws if the password is invalid or the keys file cannot be read
+   */
+  static std::unique_ptr<monero_lazy_keys> decrypt(const std::string& keys_buf, const std::string& password, monero::monero_network_type network_type);
+
+  // same as the wallet's getters of the same names
+  monero::monero_network_type get_network_type() const { return m_network_type; }
+  std::string get_mnemonic() const;
+  std::string get_mnemonic_language() const { return m_language; }
+  std::string get_public_view_key() const;
+  std::string get_private_view_key() const;
+  std::string get_public_spend_key() const;
+  std::string get_private_spend_key() const;
+  std::string get_address(uint32_t account_idx, uint32_t subaddress_idx) const;
+
+private:
+  monero_lazy_keys() { }
+  monero::monero_network_type m_network_type;
+  std::string m_language;
+  bool m_is_watch_only;
+  cryptonote::account_base m_account;
+};
+
+/**
+ * Opens a wallet in two phases so its keys are available before its cache.
+ *
+ * The keys file is read and decrypted in memory, deriving the password key
+ * once, so key and address queries are answered right away while the full
+ * wallet, including its cache, is opened on a background thread.  Nothing is
+ * written to disk for the keys.
+ *
+ * The full wallet is owned by this object until it is released, so a caller
+ * which switches from the keys to the full wallet may do so while other
+ * callers still use the keys.
+ */
+class monero_lazy_wallet {
+public:
+
+  /**
+   * Read the keys of a wallet and start opening the full wallet in the background.
+   *
+   * @param path is the path of the wallet to open
+   * @param password is the password of the wallet
+   * @param network_type is the network type of the wallet
+   */
+  monero_lazy_wallet(const std::string& path, const std::string& password, monero::monero_network_type network_type);
+
+  /**
+   * Wait for the background open and delete the full wallet if not released.
+   */
+  ~monero_lazy_wallet();
+
+  /**
+   * Get the keys read before the full wallet is loaded.
+   *
+   * @return the keys or null if the wallet's keys cannot be read without opening it
+   */
+  const monero_lazy_keys* get_keys() const { return m_keys.get(); }
+
+  /**
+   * Indicates if the background open is done, successfully or not.
+   */
+  bool is_loaded() const;
+
+  /**
+   * Wait for the full wallet which remains owned by this object.
+   *
+   * @return the full wallet
+   * @throws the error which failed the background open
+   */
+  monero::monero_wallet* await();
+
+  /**
+   * Wait for the background open and take ownership of the full wallet.
+   *
+   * @return the full wallet, or null if the background open failed
+   */
+  monero::monero_wallet* release();
+
+private:
+  std::unique_ptr<monero_lazy_keys> m_keys;
+  monero::monero_wallet* m_wallet;
+  bool m_is_loaded;
+  std::exception_ptr m_error;
+  mutable std::mutex m_mutex;
+  std::condition_variable m_loaded;
+  std::thread m_loader;
+};
+
+#endif /* monero_lazy_wallet_h */
@@ -0,0 +1,95 @@
+/**
+ * Copyright (c) 2017-2019 woodser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "monero_message_signer.h"
+#include "monero_parallel.h"
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+#include "common/base58.h"
+#include "crypto/hash.h"
+#include "cryptonote_basic/cryptonote_basic_impl.h"
+#include "string_tools.h"
+
+using namespace std;
+
+namespace {
+  const string SIGNATURE_HEADER = "SigV1";
+}
+
+vector<string> monero_message_signer::sign(const epee::wipeable_string& private_spend_key, const vector<string>& msgs, size_t max_threads) {
+  crypto::secret_key spend_key;
+  crypto::public_key spend_pub_key;
+  boost::optional<epee::wipeable_string> spend_key_bytes = private_spend_key.parse_hexstr();
+  if (!spend_key_bytes || spend_key_bytes->size() != sizeof(spend_key)) throw runtime_error("Wallet has no private spend key to sign with");
+  memcpy(spend_key.data, spend_key_bytes->data(), sizeof(spend_key));
+  if (spend_key == crypto::null_skey) throw runtime_error("Wallet has no private spend key to sign with");
+  if (!crypto::secret_key_to_public_key(spend_key, spend_pub_key)) throw runtime_error("Invalid private spend key");
+  vector<string> signatures(msgs.size());
+  monero_parallel_for(msgs.size(), max_threads, [&](size_t i) {
+    crypto::hash hash;
+    crypto::cn_fast_hash(msgs[i].data(), msgs[i].size(), hash);
+    crypto::signature signature;
+    crypto::generate_signature(hash, spend_pub_key, spend_key, signature);
+    signatures[i] = SIGNATURE_HEADER + tools::base58::encode(string((const char*) &signature, sizeof(signature)));
+  });
+  return signatures;
+}
+
+vector<bool> monero_message_signer::verify(cryptonote::network_type network_type, const vector<string>& msgs, const vector<string>& addresses, const vector<string>& signatures, size_t max_threads) {
+  if (addresses.size() != msgs.size() || signatures.size() != msgs.size()) throw runtime_error("Must provide an address and signature for each message");
+
+  // decode each distinct address once, indexing entries by their address's spend key
+  vector<crypto::public_key> spend_keys;
+  vector<int> spend_key_idxs(msgs.size());
+  unordered_map<string, int> decoded;
+  for (size_t i = 0; i < addresses.size(); i++) {
+    auto iter = decoded.find(addresses[i]);
+    if (iter == decoded.end()) {
+      cryptonote::address_parse_info info;
+      int idx = -1;
+      if (cryptonote::get_account_address_from_str(info, network_type, addresses[i])) {
+        idx = spend_keys.size();
+        spend_keys.push_back(info.address.m_spend_public_key);
+      }
+      iter = decoded.insert(make_pair(addresses[i], idx)).first;
+    }
+    spend_key_idxs[i] = iter->second;
+  }
+
+  // hash each message and check its signature
+  vector<char> goods(msgs.size(), 0); // not vector<bool> which packs bits shared across threads
+  monero_parallel_for(msgs.size(), max_threads, [&](size_t i) {
+    if (spend_key_idxs[i] == -1) return;
+    const string& signature_str = signatures[i];
+    if (signature_str.compare(0, SIGNATURE_HEADER.size(), SIGNATURE_HEADER) != 0) return;
+    string decoded_signature;
+    if (!tools::base58::decode(signature_str.substr(SIGNATURE_HEADER.size()), decoded_signature)) return;
+    crypto::signature signature;
+    if (decoded_signature.size() != sizeof(signature)) return;
+    memcpy(&signature, decoded_signature.data(), sizeof(signature));
+    crypto::hash hash;
+    crypto::cn_fast_hash(msgs[i].data(), msgs[i].size(), hash);
+    goods[i] = crypto::check_signature(hash, spend_keys[spend_key_idxs[i]], signature);
+  });
+  return vector<bool>(goods.begin(), goods.end());
+}
@@ -0,0 +1,65 @@
+/**
+ * Copyright (c) 2017-2019 woodser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef monero_message_signer_h
+#define monero_message_signer_h
+
+#include <string>
+#include <vector>
+#include "crypto/crypto.h"
+#include "cryptonote_config.h"
+#include "wipeable_string.h"
+
+/**
+ * Signs and verifies messages in bulk using the same SigV1 format as
+ * wallet2::sign() and wallet2::verify().
+ */
+class monero_message_signer {
+public:
+
+  /**
+   * Sign messages with a private spend key over a bounded number of threads.
+   *
+   * @param private_spend_key is the hex private spend key to sign with
+   * @param msgs are the messages to sign
+   * @param max_threads is the maximum number of threads (0 for hardware concurrency)
+   * @return the signature of each message in the order given
+   */
+  static std::vector<std::string> sign(const epee::wipeable_string& private_spend_key, const std::vector<std::string>& msgs, size_t max_threads);
+
+  /**
+   * Verify message signatures over a bounded number of threads.
+   *
+   * Each distinct address is decoded once up front.  An invalid address or
+   * malformed signature fails only its own entry.
+   *
+   * @param network_type is the network type of the addresses
+   * @param msgs are the signed messages
+   * @param addresses are the addresses which signed each message
+   * @param signatures are the signatures to verify
+   * @param max_threads is the maximum number of threads (0 for hardware concurrency)
+   * @return true for each signature in the order given which is good, false otherwise
+   */
+  static std::vector<bool> verify(cryptonote::network_type network_type, const std::vector<std::string>& msgs, const std::vector<std::string>& addresses, const std::vector<std::string>& signatures, size_t max_threads);
+};
+
+#endif /* monero_message_signer_h */
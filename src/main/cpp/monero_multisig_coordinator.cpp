@@ -0,0 +1,106 @@
+/**
+ * Copyright (c) 2017-2019 woodser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "monero_multisig_coordinator.h"
+#include "monero_parallel.h"
+#include <set>
+#include <stdexcept>
+
+using namespace std;
+using namespace monero;
+
+monero_multisig_coordinator::monero_multisig_coordinator(const vector<monero_wallet*>& wallets, size_t max_threads) : m_wallets(wallets), m_max_threads(max_threads) {
+  if (m_wallets.size() < 2) throw runtime_error("Multisig requires at least 2 wallets");
+  set<monero_wallet*> distinct;
+  for (monero_wallet* wallet : m_wallets) {
+    if (wallet == nullptr) throw runtime_error("Wallet is null");
+    if (!distinct.insert(wallet).second) throw runtime_error("Wallet appears more than once in multisig group");
+  }
+}
+
+vector<monero_multisig_init_result> monero_multisig_coordinator::create_group(int threshold, const string& password) {
+  size_t n = m_wallets.size();
+  if (threshold < 2 || (size_t) threshold > n) throw runtime_error("Multisig threshold must be between 2 and " + to_string(n));
+
+  // prepare each wallet
+  vector<string> hexes(n);
+  monero_parallel_for(n, m_max_threads, [&](size_t i) {
+    hexes[i] = m_wallets[i]->prepare_multisig();
+  });
+
+  // make each wallet multisig with the other wallets' prepared hex
+  vector<monero_multisig_init_result> results(n);
+  monero_parallel_for(n, m_max_threads, [&](size_t i) {
+    results[i] = m_wallets[i]->make_multisig(get_others(hexes, i), threshold, password);
+  });
+
+  // exchange keys until every wallet has the shared address, which takes at most n - threshold rounds
+  for (size_t round = 0; ; round++) {
+    size_t num_pending = 0;
+    for (size_t i = 0; i < n; i++) {
+      if (results[i].m_multisig_hex == boost::none || results[i].m_multisig_hex.get().empty()) continue;
+      hexes[i] = results[i].m_multisig_hex.get();
+      num_pending++;
+    }
+    if (num_pending == 0) break;
+    if (num_pending != n) throw runtime_error("Multisig wallets disagree on the number of key exchange rounds");
+    if (round >= n) throw runtime_error("Multisig key exchange did not complete after " + to_string(round) + " rounds");
+    monero_parallel_for(n, m_max_threads, [&](size_t i) {
+      results[i] = m_wallets[i]->exchange_multisig_keys(get_others(hexes, i), password);
+    });
+  }
+
+  // every wallet must agree on the shared address
+  for (size_t i = 0; i < n; i++) {
+    if (results[i].m_address == boost::none) throw runtime_error("Multisig wallet " + to_string(i) + " did not report an address");
+    if (results[i].m_address.get() != results[0].m_address.get()) throw runtime_error("Multisig wallets do not share the same address");
+  }
+  return results;
+}
+
+vector<int> monero_multisig_coordinator::sync_group() {
+  size_t n = m_wallets.size();
+
+  // export each wallet's multisig hex
+  vector<string> hexes(n);
+  monero_parallel_for(n, m_max_threads, [&](size_t i) {
+    hexes[i] = m_wallets[i]->get_multisig_hex();
+  });
+
+  // import the other wallets' hex into each wallet, which refreshes each wallet once
+  vector<int> num_outputs(n);
+  monero_parallel_for(n, m_max_threads, [&](size_t i) {
+    num_outputs[i] = m_wallets[i]->import_multisig_hex(get_others(hexes, i));
+  });
+  return num_outputs;
+}
+
+// ------------------------------- PRIVATE HELPERS ----------------------------
+
+vector<string> monero_multisig_coordinator::get_others(const vector<string>& hexes, size_t idx) const {
+  vector<string> others;
+  others.reserve(hexes.size() - 1);
+  for (size_t i = 0; i < hexes.size(); i++) {
+    if (i != idx) others.push_back(hexes[i]);
+  }
+  return others;
+}
@@ -0,0 +1,73 @@
+/**
+ * Copyright (c) 2017-2019 woodser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef monero_multisig_coordinator_h
+#define monero_multisig_coordinator_h
+
+#include <string>
+#include <vector>
+#include "wallet/monero_wallet.h"
+
+/**
+ * Runs multisig rounds for a group of wallets open in the same process.
+ *
+ * Each round calls every wallet in parallel and hands each wallet the other
+ * wallets' hex from the previous round directly, so nothing is serialized
+ * to or from Java between rounds.  The wallets must be distinct.
+ */
+class monero_multisig_coordinator {
+public:
+
+  /**
+   * Construct a coordinator over the given wallets.
+   *
+   * @param wallets are the distinct wallets participating in multisig
+   * @param max_threads is the maximum number of wallets to call at once (0 for hardware concurrency)
+   */
+  monero_multisig_coordinator(const std::vector<monero::monero_wallet*>& wallets, size_t max_threads = 0);
+
+  /**
+   * Make every wallet multisig, running the prepare, make and key exchange
+   * rounds until every wallet reports the shared address.
+   *
+   * @param threshold is the number of signatures needed to sign a tx
+   * @param password is the password of every wallet
+   * @return the final init result of each wallet in the order given
+   */
+  std::vector<monero::monero_multisig_init_result> create_group(int threshold, const std::string& password);
+
+  /**
+   * Export multisig hex from every wallet and import the other wallets' hex
+   * into each, so each wallet's import and refresh run concurrently.
+   *
+   * @return the number of outputs signed by each wallet in the order given
+   */
+  std::vector<int> sync_group();
+
+private:
+  std::vector<monero::monero_wallet*> m_wallets;
+  size_t m_max_threads;
+
+  std::vector<std::string> get_others(const std::vector<std::string>& hexes, size_t idx) const;
+};
+
+#endif /* monero_multisig_coordinator_h */
@@ -0,0 +1,167 @@
+/**
+ * Copyright (c) 2017-2019 woodser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "monero_output_cache.h"
+
+using namespace std;
+
+monero_output_cache& monero_output_cache::instance(const string& daemon_uri) {
+  static mutex caches_mutex;
+  static unordered_map<string, unique_ptr<monero_output_cache>> caches;
+  lock_guard<mutex> lock(caches_mutex);
+  unique_ptr<monero_output_cache>& cache = caches[daemon_uri];
+  if (cache == nullptr) cache.reset(new monero_output_cache());
+  return *cache;
+}
+
+monero_output_cache::monero_output_cache(size_t max_outputs, size_t max_distributions) : m_max_outputs(max_outputs), m_max_distributions(max_distributions), m_has_tip(false), m_tip_height(0), m_stats() { }
+
+bool monero_output_cache::get_output(uint64_t amount, uint64_t index, monero_cached_output& output) {
+  lock_guard<mutex> lock(m_mutex);
+  auto iter = m_output_index.find(output_key{amount, index});
+  if (iter == m_output_index.end() || !iter->second->m_unlocked) {
+    m_stats.m_output_misses++;
+    return false;
+  }
+  m_outputs.splice(m_outputs.begin(), m_outputs, iter->second);  // mark most recently used
+  output = *iter->second;
+  m_stats.m_output_hits++;
+  return true;
+}
+
+void monero_output_cache::put_output(const monero_cached_output& output) {
+  lock_guard<mutex> lock(m_mutex);
+  output_key key{output.m_amount, output.m_index};
+  auto iter = m_output_index.find(key);
+  if (iter != m_output_index.end()) {
+    *iter->second = output;
+    m_outputs.splice(m_outputs.begin(), m_outputs, iter->second);
+    return;
+  }
+  m_outputs.push_front(output);
+  m_output_index[key] = m_outputs.begin();
+  trim();
+}
+
+bool monero_output_cache::get_distribution(uint64_t amount, bool cumulative, uint64_t from_height, uint64_t to_height, monero_cached_distribution& distribution) {
+  lock_guard<mutex> lock(m_mutex);
+  auto iter = m_distribution_index.find(distribution_key{amount, cumulative, from_height, to_height});
+  if (iter == m_distribution_index.end()) {
+    m_stats.m_distribution_misses++;
+    return false;
+  }
+  m_distributions.splice(m_distributions.begin(), m_distributions, iter->second);
+  distribution = *iter->second;
+  m_stats.m_distribution_hits++;
+  return true;
+}
+
+void monero_output_cache::put_distribution(const monero_cached_distribution& distribution) {
+  lock_guard<mutex> lock(m_mutex);
+  distribution_key key{distribution.m_amount, distribution.m_cumulative, distribution.m_from_height, distribution.m_to_height};
+  auto iter = m_distribution_index.find(key);
+  if (iter != m_distribution_index.end()) {
+    *iter->second = distribution;
+    m_distributions.splice(m_distributions.begin(), m_distributions, iter->second);
+    return;
+  }
+  m_distributions.push_front(distribution);
+  m_distribution_index[key] = m_distributions.begin();
+  trim();
+}
+
+void monero_output_cache::set_tip(uint64_t height, const string& hash, const string& anchor_hash) {
+  lock_guard<mutex> lock(m_mutex);
+  if (m_has_tip && height == m_tip_height && hash == m_tip_hash) return;
+
+  // clear everything if the previous tip is no longer on the chain
+  if (m_has_tip && (height < m_tip_height || anchor_hash.empty() || anchor_hash != m_tip_hash)) {
+    m_outputs.clear();
+    m_output_index.clear();
+    m_distributions.clear();
+    m_distribution_index.clear();
+    m_stats.m_num_invalidations++;
+  }
+
+  // otherwise only distributions that extend to the tip are stale
+  else if (m_has_tip) {
+    for (auto iter = m_distributions.begin(); iter != m_distributions.end(); ) {
+      if (iter->m_to_height == 0 || iter->m_to_height > m_tip_height) {
+        m_distribution_index.erase(distribution_key{iter->m_amount, iter->m_cumulative, iter->m_from_height, iter->m_to_height});
+        iter = m_distributions.erase(iter);
+      } else {
+        iter++;
+      }
+    }
+  }
+
+  m_has_tip = true;
+  m_tip_height = height;
+  m_tip_hash = hash;
+}
+
+int64_t monero_output_cache::get_tip_height() {
+  lock_guard<mutex> lock(m_mutex);
+  return m_has_tip ? (int64_t) m_tip_height : -1;
+}
+
+void monero_output_cache::set_limits(size_t max_outputs, size_t max_distributions) {
+  lock_guard<mutex> lock(m_mutex);
+  m_max_outputs = max_outputs;
+  m_max_distributions = max_distributions;
+  trim();
+}
+
+monero_output_cache_stats monero_output_cache::get_stats() {
+  lock_guard<mutex> lock(m_mutex);
+  monero_output_cache_stats stats = m_stats;
+  stats.m_num_outputs = m_outputs.size();
+  stats.m_num_distributions = m_distributions.size();
+  return stats;
+}
+
+void monero_output_cache::clear() {
+  lock_guard<mutex> lock(m_mutex);
+  m_outputs.clear();
+  m_output_index.clear();
+  m_distributions.clear();
+  m_distribution_index.clear();
+  m_has_tip = false;
+  m_tip_height = 0;
+  m_tip_hash.clear();
+  m_stats = monero_output_cache_stats();
+}
+
+// ------------------------------- PRIVATE HELPERS ----------------------------
+
+void monero_output_cache::trim() {
+  while (m_outputs.size() > m_max_outputs) {
+    const monero_cached_output& lru = m_outputs.back();
+    m_output_index.erase(output_key{lru.m_amount, lru.m_index});
+    m_outputs.pop_back();
+  }
+  while (m_distributions.size() > m_max_distributions) {
+    const monero_cached_distribution& lru = m_distributions.back();
+    m_distribution_index.erase(distribution_key{lru.m_amount, lru.m_cumulative, lru.m_from_height, lru.m_to_height});
+    m_distributions.pop_back();
+  }
+}
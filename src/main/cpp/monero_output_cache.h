@@ -0,0 +1,188 @@
+/**
+ * Copyright (c) 2017-2019 woodser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef monero_output_cache_h
+#define monero_output_cache_h
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "crypto/crypto.h"
+
+/**
+ * Ring member output as returned by the daemon's get_outs.
+ *
+ * Keys are stored as fixed-size pods so a cached entry costs the same
+ * regardless of how it was fetched.
+ */
+struct monero_cached_output {
+  uint64_t m_amount;
+  uint64_t m_index;
+  crypto::public_key m_key;
+  crypto::public_key m_mask;
+  crypto::hash m_txid;
+  uint64_t m_height;
+  bool m_unlocked;
+};
+
+/**
+ * Output distribution for one amount as returned by get_output_distribution.
+ */
+struct monero_cached_distribution {
+  uint64_t m_amount;
+  bool m_cumulative;
+  uint64_t m_from_height;
+  uint64_t m_to_height;
+  uint64_t m_start_height;
+  uint64_t m_base;
+  std::vector<uint64_t> m_distribution;
+};
+
+/**
+ * Hit/miss counters and sizes of the output cache.
+ */
+struct monero_output_cache_stats {
+  uint64_t m_output_hits;
+  uint64_t m_output_misses;
+  uint64_t m_distribution_hits;
+  uint64_t m_distribution_misses;
+  uint64_t m_num_outputs;
+  uint64_t m_num_distributions;
+  uint64_t m_num_invalidations;
+};
+
+/**
+ * Size-bounded LRU cache of ring member outputs and output distributions
+ * fetched from a daemon.  Global output indices are only meaningful on one
+ * chain, so each daemon gets its own cache.
+ *
+ * Entries are tied to the chain tip reported through set_tip().  A new block
+ * on top of the known tip drops only open-ended distributions; anything else
+ * (a reorg or an unverifiable jump) clears the cache.  Locked outputs are
+ * stored but never served since they may unlock on a later block.
+ */
+class monero_output_cache {
+public:
+
+  static const size_t DEFAULT_MAX_OUTPUTS = 100000;
+  static const size_t DEFAULT_MAX_DISTRIBUTIONS = 64;
+
+  /**
+   * Get the process-wide cache of a daemon's outputs, created on first use.
+   *
+   * @param daemon_uri is the uri of the daemon whose outputs are cached
+   */
+  static monero_output_cache& instance(const std::string& daemon_uri);
+
+  monero_output_cache(size_t max_outputs = DEFAULT_MAX_OUTPUTS, size_t max_distributions = DEFAULT_MAX_DISTRIBUTIONS);
+
+  /**
+   * Get a cached output.
+   *
+   * @param amount is the output's amount (0 for ringct outputs)
+   * @param index is the output's global index for the amount
+   * @param output is assigned the cached output if found
+   * @return true if an unlocked output was found, false otherwise
+   */
+  bool get_output(uint64_t amount, uint64_t index, monero_cached_output& output);
+
+  /**
+   * Add or replace a cached output, evicting the least recently used entry
+   * if the cache is full.
+   */
+  void put_output(const monero_cached_output& output);
+
+  /**
+   * Get a cached output distribution.
+   *
+   * @return true if found, false otherwise
+   */
+  bool get_distribution(uint64_t amount, bool cumulative, uint64_t from_height, uint64_t to_height, monero_cached_distribution& distribution);
+
+  /**
+   * Add or replace a cached output distribution.
+   */
+  void put_distribution(const monero_cached_distribution& distribution);
+
+  /**
+   * Report the daemon's current chain tip.
+   *
+   * @param height is the height of the tip block
+   * @param hash is the hash of the tip block
+   * @param anchor_hash is the hash, as seen on the current chain, of the block
+   *        at the previously reported tip height (empty if unknown)
+   */
+  void set_tip(uint64_t height, const std::string& hash, const std::string& anchor_hash);
+
+  /**
+   * Get the height of the last reported tip, or -1 if none.
+   */
+  int64_t get_tip_height();
+
+  /**
+   * Change the maximum number of cached outputs and distributions.
+   */
+  void set_limits(size_t max_outputs, size_t max_distributions);
+
+  monero_output_cache_stats get_stats();
+  void clear();
+
+private:
+  struct output_key {
+    uint64_t m_amount;
+    uint64_t m_index;
+    bool operator==(const output_key& other) const { return m_amount == other.m_amount && m_index == other.m_index; }
+  };
+  struct output_key_hash {
+    size_t operator()(const output_key& key) const { return std::hash<uint64_t>()(key.m_amount * 0x9e3779b97f4a7c15ULL ^ key.m_index); }
+  };
+  struct distribution_key {
+    uint64_t m_amount;
+    bool m_cumulative;
+    uint64_t m_from_height;
+    uint64_t m_to_height;
+    bool operator==(const distribution_key& other) const { return m_amount == other.m_amount && m_cumulative == other.m_cumulative && m_from_height == other.m_from_height && m_to_height == other.m_to_height; }
+  };
+  struct distribution_key_hash {
+    size_t operator()(const distribution_key& key) const { return std::hash<uint64_t>()((key.m_amount * 31 + key.m_from_height) * 31 + key.m_to_height) ^ key.m_cumulative; }
+  };
+
+  std::mutex m_mutex;
+  size_t m_max_outputs;
+  size_t m_max_distributions;
+  std::list<monero_cached_output> m_outputs;  // most recently used first
+  std::unordered_map<output_key, std::list<monero_cached_output>::iterator, output_key_hash> m_output_index;
+  std::list<monero_cached_distribution> m_distributions;
+  std::unordered_map<distribution_key, std::list<monero_cached_distribution>::iterator, distribution_key_hash> m_distribution_index;
+  bool m_has_tip;
+  uint64_t m_tip_height;
+  std::string m_tip_hash;
+  monero_output_cache_stats m_stats;
+
+  void trim();
+};
+
+#endif /* monero_output_cache_h */
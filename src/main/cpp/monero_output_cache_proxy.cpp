@@ -0,0 +1,356 @@
+/**
+ * Copyright (c) 2017-2019 woodser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "monero_output_cache_proxy.h"
+#include <stdexcept>
+#include "crypto/crypto.h"
+#include "hex.h"
+#include "memwipe.h"
+#include "monero_output_cache.h"
+#include "ringct/rctTypes.h"
+#include "rpc/core_rpc_server_commands_defs.h"
+#include "storages/http_abstract_invoke.h"
+
+using namespace std;
+
+static const chrono::seconds DAEMON_RPC_TIMEOUT = chrono::seconds(60);
+static const size_t NUM_PROXY_THREADS = 2;  // wallet2 serializes its daemon requests
+static const string PROXY_IP = "127.0.0.1";
+static const string PROXY_USERNAME = "wallet";
+static const size_t PROXY_PASSWORD_SIZE = 32;
+
+// daemon requests made by wallet2, which are the only ones forwarded
+static const unordered_set<string> ALLOWED_URIS = {
+  "/json_rpc", "/getblocks.bin", "/get_blocks.bin", "/getblocks_by_height.bin", "/get_blocks_by_height.bin", "/gethashes.bin", "/get_hashes.bin",
+  "/get_o_indexes.bin", "/get_outs.bin", "/get_output_distribution.bin", "/get_transaction_pool_hashes.bin", "/get_transaction_pool_hashes",
+  "/get_transaction_pool", "/get_transactions", "/gettransactions", "/is_key_image_spent", "/sendrawtransaction", "/send_raw_transaction",
+  "/getheight", "/get_height", "/getinfo", "/get_info"
+};
+static const unordered_set<string> ALLOWED_JSON_RPC_METHODS = {
+  "get_version", "get_info", "getinfo", "get_block_count", "getblockcount", "get_last_block_header", "getlastblockheader", "get_block_header_by_height",
+  "getblockheaderbyheight", "get_block_header_by_hash", "getblockheaderbyhash", "get_block_headers_range", "getblockheadersrange", "hard_fork_info",
+  "get_fee_estimate", "get_output_histogram", "get_output_distribution", "get_txpool_backlog"
+};
+
+// method of a json-rpc request
+struct json_rpc_method {
+  string method;
+  BEGIN_KV_SERIALIZE_MAP()
+    KV_SERIALIZE(method)
+  END_KV_SERIALIZE_MAP()
+};
+
+const chrono::milliseconds monero_output_cache_proxy::DEFAULT_TIP_REFRESH_PERIOD = chrono::milliseconds(10000);
+
+monero_output_cache_proxy::monero_output_cache_proxy(const string& uri, const string& username, const string& password) : m_tip_refresh_period(DEFAULT_TIP_REFRESH_PERIOD), m_has_tip_update(false), m_is_started(false) {
+  uint8_t password_bytes[PROXY_PASSWORD_SIZE];
+  crypto::generate_random_bytes_thread_safe(PROXY_PASSWORD_SIZE, password_bytes);
+  m_login = epee::net_utils::http::login(PROXY_USERNAME, epee::to_hex::wipeable_string(epee::span<const uint8_t>(password_bytes, PROXY_PASSWORD_SIZE)));
+  memwipe(password_bytes, PROXY_PASSWORD_SIZE);
+  set_daemon(uri, username, password);
+}
+
+monero_output_cache_proxy::~monero_output_cache_proxy() {
+  if (!m_is_started) return;
+  send_stop_signal();
+  timed_wait_server_stop(5000);
+  deinit();
+}
+
+void monero_output_cache_proxy::start() {
+  if (!init([](size_t size, uint8_t* data) { crypto::generate_random_bytes_thread_safe(size, data); }, "0", PROXY_IP, {}, m_login, epee::net_utils::ssl_support_t::e_ssl_support_disabled)) throw runtime_error("Failed to start output cache proxy");
+  if (!run(NUM_PROXY_THREADS, false)) {
+    deinit();
+    throw runtime_error("Failed to run output cache proxy");
+  }
+  m_is_started = true;
+}
+
+string monero_output_cache_proxy::get_uri() {
+  return "http://" + PROXY_IP + ":" + to_string(get_binded_port());
+}
+
+string monero_output_cache_proxy::get_username() {
+  return m_login.username;
+}
+
+string monero_output_cache_proxy::get_password() {
+  return string(m_login.password.data(), m_login.password.size());
+}
+
+void monero_output_cache_proxy::set_daemon(const string& uri, const string& username, const string& password) {
+  lock_guard<mutex> lock(m_mutex);
+  m_uri = uri;
+  m_username = username;
+  m_password = password;
+  m_http_client.disconnect();
+  boost::optional<epee::net_utils::http::login> login;
+  if (!username.empty()) login = epee::net_utils::http::login(username, password);
+  if (!uri.empty()) m_http_client.set_server(uri, login);
+  m_has_tip_update = false;  // the new daemon may be on another chain
+}
+
+string monero_output_cache_proxy::get_daemon_uri() {
+  lock_guard<mutex> lock(m_mutex);
+  return m_uri;
+}
+
+string monero_output_cache_proxy::get_daemon_username() {
+  lock_guard<mutex> lock(m_mutex);
+  return m_username;
+}
+
+string monero_output_cache_proxy::get_daemon_password() {
+  lock_guard<mutex> lock(m_mutex);
+  return m_password;
+}
+
+void monero_output_cache_proxy::set_tip_refresh_period(chrono::milliseconds period) {
+  lock_guard<mutex> lock(m_mutex);
+  m_tip_refresh_period = period;
+}
+
+void monero_output_cache_proxy::expect_submitted(const string& tx_hex) {
+  lock_guard<mutex> lock(m_submitted_mutex);
+  m_submitted_txs.insert(tx_hex);
+}
+
+void monero_output_cache_proxy::forget_submitted(const string& tx_hex) {
+  lock_guard<mutex> lock(m_submitted_mutex);
+  m_submitted_txs.erase(tx_hex);
+}
+
+void monero_output_cache_proxy::set_sync_stats(shared_ptr<monero_sync_stats> stats) {
+  lock_guard<mutex> lock(m_sync_stats_mutex);
+  m_sync_stats = stats;
+}
+
+bool monero_output_cache_proxy::handle_http_request(const epee::net_utils::http::http_request_info& query_info, epee::net_utils::http::http_response_info& response, connection_context& context) {
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+  serve(query_info, response);
+  shared_ptr<monero_sync_stats> stats;
+  {
+    lock_guard<mutex> lock(m_sync_stats_mutex);
+    stats = m_sync_stats;
+  }
+  if (stats != nullptr) stats->record_request(query_info.m_URI, chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count(), response.m_body.size());
+  return true;
+}
+
+bool monero_output_cache_proxy::is_allowed(const epee::net_utils::http::http_request_info& query_info) {
+  if (ALLOWED_URIS.count(query_info.m_URI) == 0) return false;
+  if (query_info.m_URI != "/json_rpc") return true;
+  json_rpc_method req;
+  return epee::serialization::load_t_from_json(req, query_info.m_body) && ALLOWED_JSON_RPC_METHODS.count(req.method) > 0;
+}
+
+void monero_output_cache_proxy::serve(const epee::net_utils::http::http_request_info& query_info, epee::net_utils::http::http_response_info& response) {
+
+  // refuse requests the wallet does not make
+  if (!is_allowed(query_info)) {
+    response.m_response_code = 403;
+    response.m_response_comment = "Forbidden";
+    return;
+  }
+
+  // serve ring members from the cache, falling back to the daemon for anything the cache cannot answer
+  if (query_info.m_URI == "/get_outs.bin" && handle_get_outs(query_info, response)) return;
+  if (query_info.m_URI == "/get_output_distribution.bin" && handle_get_output_distribution(query_info, response)) return;
+  if ((query_info.m_URI == "/send_raw_transaction" || query_info.m_URI == "/sendrawtransaction") && handle_send_raw_tx(query_info, response)) return;
+  forward(query_info, response);
+}
+
+void monero_output_cache_proxy::forward(const epee::net_utils::http::http_request_info& query_info, epee::net_utils::http::http_response_info& response) {
+  lock_guard<mutex> lock(m_mutex);
+  epee::net_utils::http::fields_list fields;
+  if (!query_info.m_header_info.m_content_type.empty()) fields.push_back(make_pair(string("Content-Type"), query_info.m_header_info.m_content_type));
+  const epee::net_utils::http::http_response_info* daemon_response = nullptr;
+  if (m_uri.empty() || !m_http_client.invoke(query_info.m_URI, query_info.m_http_method_str, query_info.m_body, DAEMON_RPC_TIMEOUT, &daemon_response, fields) || daemon_response == nullptr) {
+    response.m_response_code = 503;
+    response.m_response_comment = "Service Unavailable";
+    return;
+  }
+  response.m_response_code = daemon_response->m_response_code;
+  response.m_response_comment = daemon_response->m_response_comment;
+  response.m_mime_tipe = daemon_response->m_header_info.m_content_type;
+  response.m_body = daemon_response->m_body;
+}
+
+bool monero_output_cache_proxy::handle_get_outs(const epee::net_utils::http::http_request_info& query_info, epee::net_utils::http::http_response_info& response) {
+  cryptonote::COMMAND_RPC_GET_OUTPUTS_BIN::request req;
+  if (!epee::serialization::load_t_from_binary(req, query_info.m_body)) return false;
+  if (!refresh_tip()) return false;
+
+  // collect cached outputs
+  string daemon_uri = get_daemon_uri();
+  monero_output_cache& cache = monero_output_cache::instance(daemon_uri);
+  cryptonote::COMMAND_RPC_GET_OUTPUTS_BIN::response res;
+  res.outs.resize(req.outputs.size());
+  res.untrusted = false;
+  vector<size_t> miss_idxs;
+  cryptonote::COMMAND_RPC_GET_OUTPUTS_BIN::request miss_req;
+  miss_req.get_txid = true;  // cache entries are complete regardless of what was asked
+  for (size_t i = 0; i < req.outputs.size(); i++) {
+    monero_cached_output output;
+    if (!cache.get_output(req.outputs[i].amount, req.outputs[i].index, output)) {
+      miss_idxs.push_back(i);
+      miss_req.outputs.push_back(req.outputs[i]);
+      continue;
+    }
+    res.outs[i].key = output.m_key;
+    res.outs[i].mask = rct::pk2rct(output.m_mask);
+    res.outs[i].unlocked = output.m_unlocked;
+    res.outs[i].height = output.m_height;
+    res.outs[i].txid = output.m_txid;
+  }
+
+  // fetch misses from the daemon in one request and cache them
+  if (!miss_idxs.empty()) {
+    cryptonote::COMMAND_RPC_GET_OUTPUTS_BIN::response miss_res;
+    {
+      lock_guard<mutex> lock(m_mutex);
+      if (m_uri.empty() || m_uri != daemon_uri || !epee::net_utils::invoke_http_bin("/get_outs.bin", miss_req, miss_res, m_http_client, DAEMON_RPC_TIMEOUT)) return false;
+    }
+    if (miss_res.status != CORE_RPC_STATUS_OK || miss_res.outs.size() != miss_idxs.size()) return false;
+    for (size_t i = 0; i < miss_idxs.size(); i++) {
+      const cryptonote::COMMAND_RPC_GET_OUTPUTS_BIN::outkey& out = miss_res.outs[i];
+      res.outs[miss_idxs[i]] = out;
+      cache.put_output(monero_cached_output{miss_req.outputs[i].amount, miss_req.outputs[i].index, out.key, rct::rct2pk(out.mask), out.txid, out.height, out.unlocked});
+    }
+    res.untrusted = miss_res.untrusted;
+  }
+  res.status = CORE_RPC_STATUS_OK;
+  return store_response(res, response);
+}
+
+bool monero_output_cache_proxy::handle_send_raw_tx(const epee::net_utils::http::http_request_info& query_info, epee::net_utils::http::http_response_info& response) {
+  cryptonote::COMMAND_RPC_SEND_RAW_TX::request req;
+  if (!epee::serialization::load_t_from_json(req, query_info.m_body)) return false;
+  {
+    lock_guard<mutex> lock(m_submitted_mutex);
+    if (m_submitted_txs.erase(req.tx_as_hex) == 0) return false;
+  }
+
+  // answer as the daemon did when it accepted the tx
+  cryptonote::COMMAND_RPC_SEND_RAW_TX::response res;
+  res.not_relayed = req.do_not_relay;
+  res.untrusted = false;
+  res.status = CORE_RPC_STATUS_OK;
+  string body;
+  if (!epee::serialization::store_t_to_json(res, body)) return false;
+  response.m_response_code = 200;
+  response.m_response_comment = "Ok";
+  response.m_mime_tipe = "application/json";
+  response.m_body = std::move(body);
+  return true;
+}
+
+bool monero_output_cache_proxy::handle_get_output_distribution(const epee::net_utils::http::http_request_info& query_info, epee::net_utils::http::http_response_info& response) {
+  cryptonote::COMMAND_RPC_GET_OUTPUT_DISTRIBUTION::request req;
+  if (!epee::serialization::load_t_from_binary(req, query_info.m_body)) return false;
+  if (!refresh_tip()) return false;
+
+  // collect cached distributions
+  string daemon_uri = get_daemon_uri();
+  monero_output_cache& cache = monero_output_cache::instance(daemon_uri);
+  cryptonote::COMMAND_RPC_GET_OUTPUT_DISTRIBUTION::response res;
+  res.distributions.resize(req.amounts.size());
+  res.untrusted = false;
+  vector<size_t> miss_idxs;
+  cryptonote::COMMAND_RPC_GET_OUTPUT_DISTRIBUTION::request miss_req = req;
+  miss_req.amounts.clear();
+  for (size_t i = 0; i < req.amounts.size(); i++) {
+    monero_cached_distribution distribution;
+    if (!cache.get_distribution(req.amounts[i], req.cumulative, req.from_height, req.to_height, distribution)) {
+      miss_idxs.push_back(i);
+      miss_req.amounts.push_back(req.amounts[i]);
+      continue;
+    }
+    cryptonote::COMMAND_RPC_GET_OUTPUT_DISTRIBUTION::distribution& entry = res.distributions[i];
+    entry.amount = distribution.m_amount;
+    entry.data.start_height = distribution.m_start_height;
+    entry.data.base = distribution.m_base;
+    entry.data.distribution = std::move(distribution.m_distribution);
+    entry.binary = req.binary;
+    entry.compress = req.compress;
+  }
+
+  // fetch misses from the daemon in one request and cache them
+  if (!miss_idxs.empty()) {
+    cryptonote::COMMAND_RPC_GET_OUTPUT_DISTRIBUTION::response miss_res;
+    {
+      lock_guard<mutex> lock(m_mutex);
+      if (m_uri.empty() || m_uri != daemon_uri || !epee::net_utils::invoke_http_bin("/get_output_distribution.bin", miss_req, miss_res, m_http_client, DAEMON_RPC_TIMEOUT)) return false;
+    }
+    if (miss_res.status != CORE_RPC_STATUS_OK || miss_res.distributions.size() != miss_idxs.size()) return false;
+    for (size_t i = 0; i < miss_idxs.size(); i++) {
+      cryptonote::COMMAND_RPC_GET_OUTPUT_DISTRIBUTION::distribution& entry = miss_res.distributions[i];
+      if (entry.amount != miss_req.amounts[i]) return false;
+      cache.put_distribution(monero_cached_distribution{entry.amount, req.cumulative, req.from_height, req.to_height, entry.data.start_height, entry.data.base, entry.data.distribution});
+      res.distributions[miss_idxs[i]] = std::move(entry);
+    }
+    res.untrusted = miss_res.untrusted;
+  }
+  res.status = CORE_RPC_STATUS_OK;
+  return store_response(res, response);
+}
+
+bool monero_output_cache_proxy::refresh_tip() {
+  lock_guard<mutex> lock(m_mutex);
+  chrono::steady_clock::time_point now = chrono::steady_clock::now();
+  if (m_has_tip_update && now - m_tip_update_time < m_tip_refresh_period) return true;
+  if (m_uri.empty()) return false;
+
+  // fetch the tip
+  cryptonote::COMMAND_RPC_GET_LAST_BLOCK_HEADER::request tip_req;
+  cryptonote::COMMAND_RPC_GET_LAST_BLOCK_HEADER::response tip_res;
+  if (!epee::net_utils::invoke_http_json_rpc("/json_rpc", "get_last_block_header", tip_req, tip_res, m_http_client, DAEMON_RPC_TIMEOUT) || tip_res.status != CORE_RPC_STATUS_OK) return false;
+  const cryptonote::block_header_response& tip = tip_res.block_header;
+
+  // get the hash on the current chain of the block at the cache's previous tip height
+  monero_output_cache& cache = monero_output_cache::instance(m_uri);
+  int64_t cached_height = cache.get_tip_height();
+  string anchor_hash;
+  if (cached_height == static_cast<int64_t>(tip.height)) anchor_hash = tip.hash;
+  else if (cached_height + 1 == static_cast<int64_t>(tip.height)) anchor_hash = tip.prev_hash;
+  else if (cached_height >= 0 && cached_height < static_cast<int64_t>(tip.height)) {
+    cryptonote::COMMAND_RPC_GET_BLOCK_HEADER_BY_HEIGHT::request anchor_req;
+    cryptonote::COMMAND_RPC_GET_BLOCK_HEADER_BY_HEIGHT::response anchor_res;
+    anchor_req.height = cached_height;
+    if (epee::net_utils::invoke_http_json_rpc("/json_rpc", "get_block_header_by_height", anchor_req, anchor_res, m_http_client, DAEMON_RPC_TIMEOUT) && anchor_res.status == CORE_RPC_STATUS_OK) anchor_hash = anchor_res.block_header.hash;
+  }
+  cache.set_tip(tip.height, tip.hash, anchor_hash);
+  m_tip_update_time = now;
+  m_has_tip_update = true;
+  return true;
+}
+
+template <class t_response>
+bool monero_output_cache_proxy::store_response(const t_response& res, epee::net_utils::http::http_response_info& response) {
+  string body;
+  if (!epee::serialization::store_t_to_binary(res, body)) return false;
+  response.m_response_code = 200;
+  response.m_response_comment = "Ok";
+  response.m_mime_tipe = "application/octet-stream";
+  response.m_body = std::move(body);
+  return true;
+}
@@ -0,0 +1,139 @@
+/**
+ * Copyright (c) 2017-2019 woodser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef monero_output_cache_proxy_h
+#define monero_output_cache_proxy_h
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include "net/http_client.h"
+#include "net/http_server_impl_base.h"
+#include "monero_sync_stats.h"
+
+/**
+ * Local HTTP proxy between a wallet and its daemon which answers the ring
+ * member requests made while building a tx from the daemon's output cache.
+ *
+ * wallet2 builds txs against whatever daemon it is connected to, so the
+ * wallet is pointed at this proxy.  get_outs.bin and
+ * get_output_distribution.bin are served from monero_output_cache with only
+ * the misses fetched from the daemon; every other request is forwarded
+ * unchanged.  The cache's tip is refreshed from the daemon at most once per
+ * refresh period.
+ *
+ * Txs already submitted to the daemon by relay_txs_parallel() are expected
+ * with expect_submitted() so the wallet's own submission, which records the
+ * tx in wallet2, is answered here instead of submitting the tx again.
+ *
+ * The proxy only answers clients which log in with its credentials, which
+ * are random per proxy, and only forwards the requests wallet2 makes, so
+ * other local processes cannot use the daemon or its credentials through it.
+ *
+ * Each request is timed into the wallet's sync stats if collected.
+ */
+class monero_output_cache_proxy : public epee::http_server_impl_base<monero_output_cache_proxy> {
+public:
+  typedef epee::net_utils::connection_context_base connection_context;
+
+  static const std::chrono::milliseconds DEFAULT_TIP_REFRESH_PERIOD;
+
+  monero_output_cache_proxy(const std::string& uri, const std::string& username, const std::string& password);
+  ~monero_output_cache_proxy();
+
+  /**
+   * Listen on an ephemeral local port.
+   *
+   * @throws runtime_error if the proxy cannot listen
+   */
+  void start();
+
+  /**
+   * Get the uri the wallet connects to.
+   */
+  std::string get_uri();
+
+  /**
+   * Get the credentials the wallet connects with.
+   */
+  std::string get_username();
+  std::string get_password();
+
+  /**
+   * Change the daemon requests are forwarded to.
+   */
+  void set_daemon(const std::string& uri, const std::string& username, const std::string& password);
+  std::string get_daemon_uri();
+  std::string get_daemon_username();
+  std::string get_daemon_password();
+
+  void set_tip_refresh_period(std::chrono::milliseconds period);
+
+  /**
+   * Answer the next submission of a tx the daemon already accepted as
+   * accepted without forwarding it.
+   *
+   * @param tx_hex is the tx blob as hex as wallet2 submits it
+   */
+  void expect_submitted(const std::string& tx_hex);
+
+  /**
+   * Stop expecting a tx which the wallet did not submit.
+   */
+  void forget_submitted(const std::string& tx_hex);
+
+  /**
+   * Set the sync stats which record each request, or null to stop recording.
+   */
+  void set_sync_stats(std::shared_ptr<monero_sync_stats> stats);
+
+  bool handle_http_request(const epee::net_utils::http::http_request_info& query_info, epee::net_utils::http::http_response_info& response, connection_context& context);
+
+private:
+  epee::net_utils::http::login m_login;
+  std::mutex m_mutex;  // guards the daemon connection and tip refresh time
+  epee::net_utils::http::http_simple_client m_http_client;
+  std::string m_uri;
+  std::string m_username;
+  std::string m_password;
+  std::chrono::milliseconds m_tip_refresh_period;
+  std::chrono::steady_clock::time_point m_tip_update_time;
+  bool m_has_tip_update;
+  bool m_is_started;
+  std::mutex m_submitted_mutex;
+  std::unordered_set<std::string> m_submitted_txs;
+  std::mutex m_sync_stats_mutex;
+  std::shared_ptr<monero_sync_stats> m_sync_stats;
+
+  bool is_allowed(const epee::net_utils::http::http_request_info& query_info);
+  void serve(const epee::net_utils::http::http_request_info& query_info, epee::net_utils::http::http_response_info& response);
+  void forward(const epee::net_utils::http::http_request_info& query_info, epee::net_utils::http::http_response_info& response);
+  bool handle_get_outs(const epee::net_utils::http::http_request_info& query_info, epee::net_utils::http::http_response_info& response);
+  bool handle_send_raw_tx(const epee::net_utils::http::http_request_info& query_info, epee::net_utils::http::http_response_info& response);
+  bool handle_get_output_distribution(const epee::net_utils::http::http_request_info& query_info, epee::net_utils::http::http_response_info& response);
+  bool refresh_tip();
+  template <class t_response> bool store_response(const t_response& res, epee::net_utils::http::http_response_info& response);
+};
+
+#endif /* monero_output_cache_proxy_h */
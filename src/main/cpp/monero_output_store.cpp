@@ -0,0 +1,123 @@
+/**
+ * Copyright (c) 2017-2019 woodser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "monero_output_store.h"
+#include <unordered_map>
+#include "string_tools.h"
+
+using namespace std;
+using namespace monero;
+
+monero_output_store::monero_output_store(monero_wallet& wallet, uint64_t outputs_version) {
+
+  // record wallet state first so changes during the build make the store stale
+  m_wallet_height = wallet.get_height();
+  m_wallet_balance = wallet.get_balance();
+  m_outputs_version = outputs_version;
+  unordered_map<string, uint32_t> tx_positions;
+  size_t num_accounts = wallet.get_accounts().size();
+  for (size_t account_idx = 0; account_idx < num_accounts; account_idx++) {
+
+    // get the account's outputs as an object graph which is freed after copying
+    monero_output_query output_query;
+    output_query.m_account_index = account_idx;
+    vector<shared_ptr<monero_output_wallet>> outputs = wallet.get_outputs(output_query);
+    m_amounts.reserve(m_amounts.size() + outputs.size());
+    m_account_indices.reserve(m_account_indices.size() + outputs.size());
+    m_subaddress_indices.reserve(m_subaddress_indices.size() + outputs.size());
+    m_indices.reserve(m_indices.size() + outputs.size());
+    m_tx_positions.reserve(m_tx_positions.size() + outputs.size());
+    m_flags.reserve(m_flags.size() + outputs.size());
+    m_key_images.reserve(m_key_images.size() + outputs.size());
+
+    // copy fields into arrays and intern tx hashes
+    for (const shared_ptr<monero_output_wallet>& output : outputs) {
+      const string& tx_hash = *output->m_tx->m_hash;
+      boost::optional<uint64_t> height = output->m_tx->get_height();
+      bool is_confirmed = height != boost::none && (output->m_tx->m_is_confirmed == boost::none || *output->m_tx->m_is_confirmed);
+      auto tx_position = tx_positions.find(tx_hash);
+      if (tx_position == tx_positions.end()) {
+        crypto::hash hash;
+        if (!epee::string_tools::hex_to_pod(tx_hash, hash)) throw runtime_error("Invalid tx hash: " + tx_hash);
+        tx_position = tx_positions.insert(make_pair(tx_hash, (uint32_t) m_tx_hashes.size())).first;
+        m_tx_hashes.push_back(hash);
+        m_tx_heights.push_back(is_confirmed ? *height : 0);
+      }
+      crypto::key_image key_image = crypto::key_image();
+      if (output->m_key_image != boost::none && (*output->m_key_image)->m_hex != boost::none) {
+        if (!epee::string_tools::hex_to_pod(*(*output->m_key_image)->m_hex, key_image)) throw runtime_error("Invalid key image: " + *(*output->m_key_image)->m_hex);
+      }
+      m_amounts.push_back(output->m_amount == boost::none ? 0 : *output->m_amount);
+      m_account_indices.push_back(*output->m_account_index);
+      m_subaddress_indices.push_back(*output->m_subaddress_index);
+      m_indices.push_back(output->m_index == boost::none ? 0 : *output->m_index);
+      m_tx_positions.push_back(tx_position->second);
+      m_flags.push_back((output->m_is_spent != boost::none && *output->m_is_spent ? SPENT : 0) | (output->m_is_frozen != boost::none && *output->m_is_frozen ? FROZEN : 0) | (is_confirmed ? 0 : UNCONFIRMED));
+      m_key_images.push_back(key_image);
+    }
+  }
+}
+
+bool monero_output_store::is_stale(monero_wallet& wallet, uint64_t outputs_version) const {
+  return outputs_version != m_outputs_version || wallet.get_height() != m_wallet_height || wallet.get_balance() != m_wallet_balance;
+}
+
+void monero_output_store::refresh(monero_wallet& wallet, uint64_t outputs_version) {
+  if (is_stale(wallet, outputs_version)) *this = monero_output_store(wallet, outputs_version);
+}
+
+vector<uint32_t> monero_output_store::find(const query& q) const {
+  vector<uint32_t> positions;
+  for (uint32_t pos = 0; pos < m_amounts.size(); pos++) {
+    if (matches(pos, q)) positions.push_back(pos);
+  }
+  return positions;
+}
+
+uint64_t monero_output_store::get_amount(const query& q) const {
+  uint64_t amount = 0;
+  for (uint32_t pos = 0; pos < m_amounts.size(); pos++) {
+    if (matches(pos, q)) amount += m_amounts[pos];
+  }
+  return amount;
+}
+
+size_t monero_output_store::get_memory_size() const {
+  return sizeof(*this)
+      + m_amounts.capacity() * sizeof(uint64_t)
+      + m_account_indices.capacity() * sizeof(uint32_t)
+      + m_subaddress_indices.capacity() * sizeof(uint32_t)
+      + m_indices.capacity() * sizeof(uint64_t)
+      + m_tx_positions.capacity() * sizeof(uint32_t)
+      + m_flags.capacity() * sizeof(uint8_t)
+      + m_key_images.capacity() * sizeof(crypto::key_image)
+      + m_tx_hashes.capacity() * sizeof(crypto::hash)
+      + m_tx_heights.capacity() * sizeof(uint64_t);
+}
+
+// ------------------------------- PRIVATE HELPERS ----------------------------
+
+bool monero_output_store::matches(uint32_t pos, const query& q) const {
+  if (q.m_account_idx >= 0 && m_account_indices[pos] != (uint32_t) q.m_account_idx) return false;
+  if (q.m_subaddress_idx >= 0 && m_subaddress_indices[pos] != (uint32_t) q.m_subaddress_idx) return false;
+  return q.m_is_spent < 0 || is_spent(pos) == (q.m_is_spent != 0);
+}
@@ -0,0 +1,144 @@
+/**
+ * Copyright (c) 2017-2019 woodser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef monero_output_store_h
+#define monero_output_store_h
+
+#include <cstdint>
+#include <vector>
+#include "crypto/crypto.h"
+#include "wallet/monero_wallet.h"
+
+/**
+ * Compact snapshot of a wallet's outputs stored as parallel arrays.
+ *
+ * Querying outputs through the wallet builds a block, tx, and output object
+ * graph per result with strings for every key and hash.  This store keeps one
+ * array per field instead, with key images inline as 32 bytes and tx hashes
+ * interned so outputs of the same tx share one entry, so holding and
+ * repeatedly querying outputs takes a small fraction of the memory and scans
+ * sequentially for queries and balances.
+ *
+ * The snapshot is still built from the wallet's output queries, one account
+ * at a time so only one account's object graph exists at once.  It records
+ * the wallet's height and balance when built and is stale once either
+ * changes, as after a sync.  Outputs can also change without either, as when
+ * a tx is relayed or drops from the pool, so the owner also passes a version
+ * of the wallet's outputs which it increments on each call which may change
+ * them.
+ */
+class monero_output_store {
+public:
+
+  /**
+   * Output fields matched by find().  Unset fields match any output.
+   */
+  struct query {
+    int32_t m_account_idx = -1;
+    int32_t m_subaddress_idx = -1;
+    int8_t m_is_spent = -1;
+  };
+
+  /**
+   * Snapshot the outputs of the wallet's accounts.
+   *
+   * @param wallet is the wallet to snapshot
+   * @param outputs_version is the current version of the wallet's outputs
+   */
+  monero_output_store(monero::monero_wallet& wallet, uint64_t outputs_version);
+
+  /**
+   * Indicates if the wallet's height, balance, or outputs version changed
+   * since the snapshot.
+   *
+   * @param wallet is the wallet the store was built from
+   * @param outputs_version is the current version of the wallet's outputs
+   */
+  bool is_stale(monero::monero_wallet& wallet, uint64_t outputs_version) const;
+
+  /**
+   * Rebuild the snapshot if it's stale.
+   *
+   * @param wallet is the wallet the store was built from
+   * @param outputs_version is the current version of the wallet's outputs
+   */
+  void refresh(monero::monero_wallet& wallet, uint64_t outputs_version);
+
+  /**
+   * Find the outputs matching a query.
+   *
+   * @param q specifies the outputs to find
+   * @return the positions of the matching outputs in the store
+   */
+  std::vector<uint32_t> find(const query& q) const;
+
+  /**
+   * Sum the amounts of outputs matching a query.
+   */
+  uint64_t get_amount(const query& q) const;
+
+  size_t size() const { return m_amounts.size(); }
+  size_t get_num_txs() const { return m_tx_hashes.size(); }
+
+  uint64_t get_amount(uint32_t pos) const { return m_amounts[pos]; }
+  uint32_t get_account_idx(uint32_t pos) const { return m_account_indices[pos]; }
+  uint32_t get_subaddress_idx(uint32_t pos) const { return m_subaddress_indices[pos]; }
+  uint64_t get_index(uint32_t pos) const { return m_indices[pos]; }
+  uint64_t get_height(uint32_t pos) const { return m_tx_heights[m_tx_positions[pos]]; } // 0 if unconfirmed
+  bool is_confirmed(uint32_t pos) const { return (m_flags[pos] & UNCONFIRMED) == 0; }
+  bool is_spent(uint32_t pos) const { return (m_flags[pos] & SPENT) != 0; }
+  bool is_frozen(uint32_t pos) const { return (m_flags[pos] & FROZEN) != 0; }
+  const crypto::key_image& get_key_image(uint32_t pos) const { return m_key_images[pos]; }
+  const crypto::hash& get_tx_hash(uint32_t pos) const { return m_tx_hashes[m_tx_positions[pos]]; }
+
+  /**
+   * Get the approximate number of bytes used by the store.
+   */
+  size_t get_memory_size() const;
+
+private:
+  static const uint8_t SPENT = 1;
+  static const uint8_t FROZEN = 2;
+  static const uint8_t UNCONFIRMED = 4;
+
+  // wallet state when built
+  uint64_t m_wallet_height;
+  uint64_t m_wallet_balance;
+  uint64_t m_outputs_version;
+
+  // one entry per output
+  std::vector<uint64_t> m_amounts;
+  std::vector<uint32_t> m_account_indices;
+  std::vector<uint32_t> m_subaddress_indices;
+  std::vector<uint64_t> m_indices;
+  std::vector<uint32_t> m_tx_positions;
+  std::vector<uint8_t> m_flags;
+  std::vector<crypto::key_image> m_key_images;
+
+  // one entry per tx
+  std::vector<crypto::hash> m_tx_hashes;
+  std::vector<uint64_t> m_tx_heights;
+
+  bool matches(uint32_t pos, const query& q) const;
+};
+
+#endif /* monero_output_store_h */
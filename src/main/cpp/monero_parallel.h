@@ -0,0 +1,66 @@
+/**
+ * Copyright (c) 2017-2019 woodser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef monero_parallel_h
+#define monero_parallel_h
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <thread>
+#include <vector>
+
+/**
+ * Run fn(0) ... fn(n - 1) over at most max_threads threads including the
+ * calling thread.  If any call throws, the first exception by index is
+ * rethrown after all calls finish.
+ *
+ * @param n is the number of calls
+ * @param max_threads is the maximum number of threads (0 for hardware concurrency)
+ * @param fn is the function to call with each index
+ */
+inline void monero_parallel_for(size_t n, size_t max_threads, const std::function<void(size_t)>& fn) {
+  if (n == 0) return;
+  if (max_threads == 0) max_threads = std::max(std::thread::hardware_concurrency(), 1u);
+  size_t num_threads = std::min(n, max_threads);
+  std::vector<std::exception_ptr> errors(n);
+  std::atomic<size_t> next_idx(0);
+  auto loop = [&]() {
+    for (size_t i = next_idx++; i < n; i = next_idx++) {
+      try {
+        fn(i);
+      } catch (...) {
+        errors[i] = std::current_exception();
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < num_threads; i++) threads.push_back(std::thread(loop));
+  loop();
+  for (std::thread& thread : threads) thread.join();
+  for (const std::exception_ptr& error : errors) {
+    if (error) std::rethrow_exception(error);
+  }
+}
+
+#endif /* monero_parallel_h */
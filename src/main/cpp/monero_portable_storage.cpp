@@ -0,0 +1,886 @@
+/**
+ * Copyright (c) 2017-2019 woodser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "monero_portable_storage.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <typeinfo>
+#include <vector>
+#include "rapidjson/reader.h"
+#include "cryptonote_basic/cryptonote_format_utils.h"
+
+using namespace std;
+
+namespace {
+
+  // portable storage header and types as defined by epee
+  const uint32_t SIGNATURE_A = 0x01011101;
+  const uint32_t SIGNATURE_B = 0x01020101;
+  const uint8_t FORMAT_VERSION = 1;
+  const uint8_t TYPE_INT64 = 1;
+  const uint8_t TYPE_INT32 = 2;
+  const uint8_t TYPE_INT16 = 3;
+  const uint8_t TYPE_INT8 = 4;
+  const uint8_t TYPE_UINT64 = 5;
+  const uint8_t TYPE_UINT32 = 6;
+  const uint8_t TYPE_UINT16 = 7;
+  const uint8_t TYPE_UINT8 = 8;
+  const uint8_t TYPE_DOUBLE = 9;
+  const uint8_t TYPE_STRING = 10;
+  const uint8_t TYPE_BOOL = 11;
+  const uint8_t TYPE_OBJECT = 12;
+  const uint8_t TYPE_ARRAY = 13;
+  const uint8_t FLAG_ARRAY = 0x80;
+  const size_t MAX_DEPTH = 100;  // same recursion limit as epee
+
+  struct digit_tables {
+    char m_hex[512];      // two hex digits of each byte
+    char m_decimal[200];  // two decimal digits of 0-99
+    digit_tables() {
+      const char* digits = "0123456789abcdef";
+      for (int i = 0; i < 256; i++) {
+        m_hex[i * 2] = digits[i >> 4];
+        m_hex[i * 2 + 1] = digits[i & 15];
+      }
+      for (int i = 0; i < 100; i++) {
+        m_decimal[i * 2] = '0' + i / 10;
+        m_decimal[i * 2 + 1] = '0' + i % 10;
+      }
+    }
+  };
+  const digit_tables DIGITS;
+
+  size_t fixed_width(uint8_t type) {
+    switch (type) {
+      case TYPE_INT64: case TYPE_UINT64: case TYPE_DOUBLE: return 8;
+      case TYPE_INT32: case TYPE_UINT32: return 4;
+      case TYPE_INT16: case TYPE_UINT16: return 2;
+      case TYPE_INT8: case TYPE_UINT8: case TYPE_BOOL: return 1;
+      default: return 0;
+    }
+  }
+
+  uint64_t load_le(const uint8_t* data, size_t width) {
+    uint64_t val = 0;
+    for (size_t i = 0; i < width; i++) val |= (uint64_t) data[i] << (8 * i);
+    return val;
+  }
+
+  void store_le(uint64_t val, size_t width, string& out) {
+    char buf[8];
+    for (size_t i = 0; i < width; i++) buf[i] = (char) (val >> (8 * i));
+    out.append(buf, width);
+  }
+
+  void append_uint64(uint64_t val, string& out) {
+    char buf[20];
+    char* end = buf + sizeof(buf);
+    char* pos = end;
+    while (val >= 100) {
+      pos -= 2;
+      memcpy(pos, DIGITS.m_decimal + (val % 100) * 2, 2);
+      val /= 100;
+    }
+    if (val >= 10) {
+      pos -= 2;
+      memcpy(pos, DIGITS.m_decimal + val * 2, 2);
+    } else {
+      *--pos = '0' + (char) val;
+    }
+    out.append(pos, end - pos);
+  }
+
+  void append_int64(int64_t val, string& out) {
+    if (val >= 0) return append_uint64((uint64_t) val, out);
+    out.push_back('-');
+    append_uint64(0 - (uint64_t) val, out);
+  }
+
+  void append_double(double val, string& out) {
+    if (!std::isfinite(val)) throw runtime_error("Cannot convert non-finite double to json");
+    char buf[32];
+    int size = snprintf(buf, sizeof(buf), "%.17g", val);
+    out.append(buf, size);
+  }
+
+  // each byte is written as one char, escaped unless printable ascii, so text
+  // reads as text and a binary blob is recovered by taking each char as a byte
+  void append_json_string(const char* data, size_t size, string& out) {
+    out.push_back('"');
+    size_t run_start = 0;
+    for (size_t i = 0; i < size; i++) {
+      uint8_t byte = (uint8_t) data[i];
+      if (byte >= 0x20 && byte < 0x7f && byte != '"' && byte != '\\') continue;
+      out.append(data + run_start, i - run_start);
+      run_start = i + 1;
+      switch (byte) {
+        case '"': out.append("\\\""); break;
+        case '\\': out.append("\\\\"); break;
+        case '\n': out.append("\\n"); break;
+        case '\r': out.append("\\r"); break;
+        case '\t': out.append("\\t"); break;
+        default: out.append("\\u00").append(DIGITS.m_hex + byte * 2, 2);
+      }
+    }
+    out.append(data + run_start, size - run_start);
+    out.push_back('"');
+  }
+
+  bool name_is(const char* name, size_t size, const char* expected) {
+    return strlen(expected) == size && memcmp(name, expected, size) == 0;
+  }
+
+  /**
+   * Reads portable storage in place with bounds checks.
+   */
+  class reader {
+  public:
+    reader(const string& bin) : m_pos((const uint8_t*) bin.data()), m_end((const uint8_t*) bin.data() + bin.size()) { }
+
+    size_t remaining() const { return m_end - m_pos; }
+
+    const uint8_t* read_bytes(size_t size) {
+      if (remaining() < size) throw runtime_error("Invalid portable storage: unexpected end of data");
+      const uint8_t* data = m_pos;
+      m_pos += size;
+      return data;
+    }
+
+    uint8_t read_byte() { return *read_bytes(1); }
+
+    uint64_t read_varint() {
+      if (remaining() == 0) throw runtime_error("Invalid portable storage: unexpected end of data");
+      size_t width = size_t(1) << (*m_pos & 0x03);
+      return load_le(read_bytes(width), width) >> 2;
+    }
+
+    void read_header() {
+      if (load_le(read_bytes(4), 4) != SIGNATURE_A || load_le(read_bytes(4), 4) != SIGNATURE_B || read_byte() != FORMAT_VERSION) {
+        throw runtime_error("Invalid portable storage: bad signature");
+      }
+    }
+
+    void read_name(const char*& name, size_t& size) {
+      size = read_byte();
+      name = (const char*) read_bytes(size);
+    }
+
+    void read_string(const char*& data, size_t& size) {
+      uint64_t length = read_varint();
+      if (length > remaining()) throw runtime_error("Invalid portable storage: string exceeds data");
+      size = (size_t) length;
+      data = (const char*) read_bytes(size);
+    }
+
+    // fixed-width elements are bounds checked once for the whole array
+    const uint8_t* read_fixed_array(uint64_t count, size_t width) {
+      if (count > remaining() / width) throw runtime_error("Invalid portable storage: array exceeds data");
+      return read_bytes((size_t) count * width);
+    }
+
+  private:
+    const uint8_t* m_pos;
+    const uint8_t* m_end;
+  };
+
+  void append_fixed(const uint8_t* data, uint8_t type, string& json) {
+    switch (type) {
+      case TYPE_INT64: append_int64((int64_t) load_le(data, 8), json); break;
+      case TYPE_INT32: append_int64((int32_t) load_le(data, 4), json); break;
+      case TYPE_INT16: append_int64((int16_t) load_le(data, 2), json); break;
+      case TYPE_INT8: append_int64((int8_t) data[0], json); break;
+      case TYPE_UINT64: append_uint64(load_le(data, 8), json); break;
+      case TYPE_UINT32: append_uint64(load_le(data, 4), json); break;
+      case TYPE_UINT16: append_uint64(load_le(data, 2), json); break;
+      case TYPE_UINT8: append_uint64(data[0], json); break;
+      case TYPE_BOOL: json.append(data[0] ? "true" : "false"); break;
+      case TYPE_DOUBLE: {
+        uint64_t bits = load_le(data, 8);
+        double val;
+        memcpy(&val, &bits, sizeof(val));
+        append_double(val, json);
+        break;
+      }
+      default: throw runtime_error("Invalid portable storage: unknown type " + to_string(type));
+    }
+  }
+
+  void write_value(reader& r, uint8_t type, string& json, size_t depth);
+
+  void write_section(reader& r, string& json, size_t depth) {
+    if (depth > MAX_DEPTH) throw runtime_error("Invalid portable storage: nested too deeply");
+    uint64_t count = r.read_varint();
+    json.push_back('{');
+    for (uint64_t i = 0; i < count; i++) {
+      if (i > 0) json.push_back(',');
+      const char* name;
+      size_t size;
+      r.read_name(name, size);
+      append_json_string(name, size, json);
+      json.push_back(':');
+      write_value(r, r.read_byte(), json, depth);
+    }
+    json.push_back('}');
+  }
+
+  void write_array(reader& r, uint8_t type, string& json, size_t depth) {
+    if (depth > MAX_DEPTH) throw runtime_error("Invalid portable storage: nested too deeply");
+    uint64_t count = r.read_varint();
+    json.push_back('[');
+    size_t width = fixed_width(type);
+    if (width > 0) {
+      const uint8_t* data = r.read_fixed_array(count, width);
+      for (uint64_t i = 0; i < count; i++) {
+        if (i > 0) json.push_back(',');
+        append_fixed(data + i * width, type, json);
+      }
+    } else {
+      for (uint64_t i = 0; i < count; i++) {
+        if (i > 0) json.push_back(',');
+        if (type == TYPE_STRING) {
+          const char* data;
+          size_t size;
+          r.read_string(data, size);
+          append_json_string(data, size, json);
+        } else if (type == TYPE_OBJECT) {
+          write_section(r, json, depth + 1);
+        } else if (type == TYPE_ARRAY) {
+          uint8_t element_type = r.read_byte();
+          if (!(element_type & FLAG_ARRAY)) throw runtime_error("Invalid portable storage: array element is not an array");
+          write_array(r, element_type & ~FLAG_ARRAY, json, depth + 1);
+        } else {
+          throw runtime_error("Invalid portable storage: unknown type " + to_string(type));
+        }
+      }
+    }
+    json.push_back(']');
+  }
+
+  void write_value(reader& r, uint8_t type, string& json, size_t depth) {
+    if (type & FLAG_ARRAY) return write_array(r, type & ~FLAG_ARRAY, json, depth + 1);
+    if (type == TYPE_OBJECT) return write_section(r, json, depth + 1);
+    if (type == TYPE_ARRAY) {
+      uint8_t array_type = r.read_byte();
+      if (!(array_type & FLAG_ARRAY)) throw runtime_error("Invalid portable storage: array value is not an array");
+      return write_array(r, array_type & ~FLAG_ARRAY, json, depth + 1);
+    }
+    if (type == TYPE_STRING) {
+      const char* data;
+      size_t size;
+      r.read_string(data, size);
+      return append_json_string(data, size, json);
+    }
+    size_t width = fixed_width(type);
+    if (width == 0) throw runtime_error("Invalid portable storage: unknown type " + to_string(type));
+    append_fixed(r.read_bytes(width), type, json);
+  }
+
+  void skip_value(reader& r, uint8_t type, size_t depth);
+
+  void skip_section(reader& r, size_t depth) {
+    if (depth > MAX_DEPTH) throw runtime_error("Invalid portable storage: nested too deeply");
+    uint64_t count = r.read_varint();
+    for (uint64_t i = 0; i < count; i++) {
+      const char* name;
+      size_t size;
+      r.read_name(name, size);
+      skip_value(r, r.read_byte(), depth);
+    }
+  }
+
+  void skip_array(reader& r, uint8_t type, size_t depth) {
+    if (depth > MAX_DEPTH) throw runtime_error("Invalid portable storage: nested too deeply");
+    uint64_t count = r.read_varint();
+    size_t width = fixed_width(type);
+    if (width > 0) {
+      r.read_fixed_array(count, width);
+      return;
+    }
+    for (uint64_t i = 0; i < count; i++) {
+      if (type == TYPE_STRING) {
+        const char* data;
+        size_t size;
+        r.read_string(data, size);
+      } else if (type == TYPE_OBJECT) {
+        skip_section(r, depth + 1);
+      } else if (type == TYPE_ARRAY) {
+        uint8_t element_type = r.read_byte();
+        if (!(element_type & FLAG_ARRAY)) throw runtime_error("Invalid portable storage: array element is not an array");
+        skip_array(r, element_type & ~FLAG_ARRAY, depth + 1);
+      } else {
+        throw runtime_error("Invalid portable storage: unknown type " + to_string(type));
+      }
+    }
+  }
+
+  void skip_value(reader& r, uint8_t type, size_t depth) {
+    if (type & FLAG_ARRAY) return skip_array(r, type & ~FLAG_ARRAY, depth + 1);
+    if (type == TYPE_OBJECT) return skip_section(r, depth + 1);
+    if (type == TYPE_ARRAY) {
+      uint8_t array_type = r.read_byte();
+      if (!(array_type & FLAG_ARRAY)) throw runtime_error("Invalid portable storage: array value is not an array");
+      return skip_array(r, array_type & ~FLAG_ARRAY, depth + 1);
+    }
+    if (type == TYPE_STRING) {
+      const char* data;
+      size_t size;
+      return r.read_string(data, size);
+    }
+    size_t width = fixed_width(type);
+    if (width == 0) throw runtime_error("Invalid portable storage: unknown type " + to_string(type));
+    r.read_bytes(width);
+  }
+
+  void write_varint(uint64_t val, string& out) {
+    if (val <= 0x3f) store_le(val << 2, 1, out);
+    else if (val <= 0x3fff) store_le(val << 2 | 1, 2, out);
+    else if (val <= 0x3fffffff) store_le(val << 2 | 2, 4, out);
+    else if (val <= 0x3fffffffffffffffULL) store_le(val << 2 | 3, 8, out);
+    else throw runtime_error("Portable storage cannot hold size " + to_string(val));
+  }
+
+  bool is_integer(uint8_t type) {
+    return type == TYPE_INT64 || type == TYPE_UINT64;
+  }
+
+  /**
+   * Count and element type of a json object or array, in the order opened.
+   */
+  struct container_info {
+    uint64_t m_count;
+    uint8_t m_element_type;  // 0 until the first element of an array
+    bool m_is_array;
+    uint64_t m_num_omitted;  // empty array members which are not written
+  };
+
+  /**
+   * First pass over json which records the count and element type of each
+   * object and array, since portable storage writes counts before elements.
+   */
+  struct json_counter : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, json_counter> {
+    vector<container_info> m_containers;
+    vector<size_t> m_open;
+    string m_error;
+
+    bool element(uint8_t type) {
+      if (m_open.empty()) {
+        if (type == TYPE_OBJECT && m_containers.empty()) return true;
+        m_error = "Portable storage must be a json object";
+        return false;
+      }
+      container_info& info = m_containers[m_open.back()];
+      if (!info.m_is_array || info.m_element_type == type) return true;
+      if (info.m_element_type == 0) info.m_element_type = type;
+      else if (is_integer(info.m_element_type) && is_integer(type)) info.m_element_type = TYPE_INT64;
+      else {
+        m_error = "Portable storage arrays must have elements of one type";
+        return false;
+      }
+      return true;
+    }
+
+    bool open(uint8_t type) {
+      if (!element(type)) return false;
+      m_open.push_back(m_containers.size());
+      m_containers.push_back(container_info{0, 0, type == TYPE_ARRAY, 0});
+      return true;
+    }
+
+    // empty arrays have no element type so members which are empty arrays are
+    // omitted like epee omits empty containers, rather than given a type
+    bool close(rapidjson::SizeType count) {
+      container_info& info = m_containers[m_open.back()];
+      info.m_count = count - info.m_num_omitted;
+      m_open.pop_back();
+      if (info.m_is_array && count == 0 && !m_open.empty() && !m_containers[m_open.back()].m_is_array) m_containers[m_open.back()].m_num_omitted++;
+      return true;
+    }
+
+    bool Null() { m_error = "Portable storage cannot hold null"; return false; }
+    bool Bool(bool b) { return element(TYPE_BOOL); }
+    bool Int(int i) { return element(i < 0 ? TYPE_INT64 : TYPE_UINT64); }
+    bool Uint(unsigned u) { return element(TYPE_UINT64); }
+    bool Int64(int64_t i) { return element(i < 0 ? TYPE_INT64 : TYPE_UINT64); }
+    bool Uint64(uint64_t u) { return element(TYPE_UINT64); }
+    bool Double(double d) { return element(TYPE_DOUBLE); }
+    bool String(const char* str, rapidjson::SizeType length, bool copy) { return element(TYPE_STRING); }
+    bool StartObject() { return open(TYPE_OBJECT); }
+    bool Key(const char* str, rapidjson::SizeType length, bool copy) {
+      if (length <= 0xff) return true;
+      m_error = "Portable storage names must be at most 255 bytes";
+      return false;
+    }
+    bool EndObject(rapidjson::SizeType count) { return close(count); }
+    bool StartArray() { return open(TYPE_ARRAY); }
+    bool EndArray(rapidjson::SizeType count) { return close(count); }
+  };
+
+  /**
+   * Second pass over json which writes portable storage using the counts
+   * and element types of the first pass.
+   */
+  struct json_writer : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, json_writer> {
+    const vector<container_info>& m_containers;
+    size_t m_next_container;
+    vector<const container_info*> m_open;
+    size_t m_name_offset;  // offset of the last member's name to unwrite it if omitted
+    string& m_bin;
+    string m_error;
+
+    json_writer(const vector<container_info>& containers, string& bin) : m_containers(containers), m_next_container(0), m_name_offset(0), m_bin(bin) { }
+
+    // members are preceded by their type while array elements share their array's type
+    bool is_in_array() const { return !m_open.empty() && m_open.back()->m_is_array; }
+    void begin(uint8_t type) { if (!m_open.empty() && !m_open.back()->m_is_array) m_bin.push_back(type); }
+
+    bool integer(uint64_t val, bool is_negative) {
+      uint8_t type = is_in_array() ? m_open.back()->m_element_type : is_negative ? TYPE_INT64 : TYPE_UINT64;
+      if (type == TYPE_INT64 && !is_negative && val > (uint64_t) INT64_MAX) {
+        m_error = "Integer is out of range of int64: " + to_string(val);
+        return false;
+      }
+      begin(type);
+      store_le(val, 8, m_bin);
+      return true;
+    }
+
+    bool Null() { return false; }  // rejected by the first pass
+    bool Bool(bool b) { begin(TYPE_BOOL); m_bin.push_back(b ? 1 : 0); return true; }
+    bool Int(int i) { return Int64(i); }
+    bool Uint(unsigned u) { return Uint64(u); }
+    bool Int64(int64_t i) { return integer((uint64_t) i, i < 0); }
+    bool Uint64(uint64_t u) { return integer(u, false); }
+    bool Double(double d) {
+      uint64_t bits;
+      memcpy(&bits, &d, sizeof(bits));
+      begin(TYPE_DOUBLE);
+      store_le(bits, 8, m_bin);
+      return true;
+    }
+    bool String(const char* str, rapidjson::SizeType length, bool copy) {
+      begin(TYPE_STRING);
+      write_varint(length, m_bin);
+      m_bin.append(str, length);
+      return true;
+    }
+    bool StartObject() {
+      const container_info& info = m_containers[m_next_container++];
+      if (m_open.empty()) {
+        store_le(SIGNATURE_A, 4, m_bin);
+        store_le(SIGNATURE_B, 4, m_bin);
+        m_bin.push_back(FORMAT_VERSION);
+      } else {
+        begin(TYPE_OBJECT);
+      }
+      write_varint(info.m_count, m_bin);
+      m_open.push_back(&info);
+      return true;
+    }
+    bool Key(const char* str, rapidjson::SizeType length, bool copy) {
+      m_name_offset = m_bin.size();
+      m_bin.push_back((char) length);
+      m_bin.append(str, length);
+      return true;
+    }
+    bool EndObject(rapidjson::SizeType count) { m_open.pop_back(); return true; }
+    bool StartArray() {
+      const container_info& info = m_containers[m_next_container++];
+      if (info.m_count == 0 && !is_in_array()) {
+        m_bin.resize(m_name_offset);
+        m_open.push_back(&info);
+        return true;
+      }
+      m_bin.push_back(FLAG_ARRAY | (info.m_element_type == 0 ? TYPE_UINT64 : info.m_element_type));  // also precedes arrays within arrays
+      write_varint(info.m_count, m_bin);
+      m_open.push_back(&info);
+      return true;
+    }
+    bool EndArray(rapidjson::SizeType count) { m_open.pop_back(); return true; }
+  };
+
+  /**
+   * Writes json values with the commas between them.
+   */
+  class json_builder {
+  public:
+    json_builder(string& json) : m_json(json), m_needs_comma(false) { }
+    void begin_object() { comma(); m_json.push_back('{'); m_needs_comma = false; }
+    void end_object() { m_json.push_back('}'); m_needs_comma = true; }
+    void begin_array() { comma(); m_json.push_back('['); m_needs_comma = false; }
+    void end_array() { m_json.push_back(']'); m_needs_comma = true; }
+    void key(const char* name) {
+      comma();
+      m_json.push_back('"');
+      m_json.append(name);
+      m_json.append("\":");
+      m_needs_comma = false;
+    }
+    void number(uint64_t val) { comma(); append_uint64(val, m_json); m_needs_comma = true; }
+    void blob(const void* data, size_t size) {
+      comma();
+      m_json.push_back('"');
+      monero_portable_storage::append_hex((const uint8_t*) data, size, m_json);
+      m_json.push_back('"');
+      m_needs_comma = true;
+    }
+    template <class T> void pod(const T& val) { blob(&val, sizeof(T)); }
+    template <class T> void pods(const vector<T>& vals) {
+      begin_array();
+      for (const T& val : vals) pod(val);
+      end_array();
+    }
+    void bytes(const vector<uint8_t>& vals) {
+      begin_array();
+      for (uint8_t val : vals) number(val);
+      end_array();
+    }
+  private:
+    string& m_json;
+    bool m_needs_comma;
+    void comma() { if (m_needs_comma) m_json.push_back(','); }
+  };
+
+  // blocks and txs are written in the layout of cryptonote's json serialization
+  // with every key, hash, and signature written as hex
+
+  void write_txout_to_script(json_builder& out, const cryptonote::txout_to_script& script) {
+    out.begin_object();
+    out.key("keys"); out.pods(script.keys);
+    out.key("script"); out.bytes(script.script);
+    out.end_object();
+  }
+
+  void write_txin(json_builder& out, const cryptonote::txin_v& in) {
+    out.begin_object();
+    if (in.type() == typeid(cryptonote::txin_to_key)) {
+      const cryptonote::txin_to_key& to_key = boost::get<cryptonote::txin_to_key>(in);
+      out.key("key");
+      out.begin_object();
+      out.key("amount"); out.number(to_key.amount);
+      out.key("key_offsets");
+      out.begin_array();
+      for (uint64_t offset : to_key.key_offsets) out.number(offset);
+      out.end_array();
+      out.key("k_image"); out.pod(to_key.k_image);
+      out.end_object();
+    } else if (in.type() == typeid(cryptonote::txin_gen)) {
+      out.key("gen");
+      out.begin_object();
+      out.key("height"); out.number(boost::get<cryptonote::txin_gen>(in).height);
+      out.end_object();
+    } else if (in.type() == typeid(cryptonote::txin_to_script)) {
+      const cryptonote::txin_to_script& to_script = boost::get<cryptonote::txin_to_script>(in);
+      out.key("script");
+      out.begin_object();
+      out.key("prev"); out.pod(to_script.prev);
+      out.key("prevout"); out.number(to_script.prevout);
+      out.key("sigset"); out.bytes(to_script.sigset);
+      out.end_object();
+    } else {
+      const cryptonote::txin_to_scripthash& to_scripthash = boost::get<cryptonote::txin_to_scripthash>(in);
+      out.key("scripthash");
+      out.begin_object();
+      out.key("prev"); out.pod(to_scripthash.prev);
+      out.key("prevout"); out.number(to_scripthash.prevout);
+      out.key("script"); write_txout_to_script(out, to_scripthash.script);
+      out.key("sigset"); out.bytes(to_scripthash.sigset);
+      out.end_object();
+    }
+    out.end_object();
+  }
+
+  void write_txout(json_builder& out, const cryptonote::tx_out& tx_out) {
+    out.begin_object();
+    out.key("amount"); out.number(tx_out.amount);
+    out.key("target");
+    out.begin_object();
+    if (tx_out.target.type() == typeid(cryptonote::txout_to_key)) {
+      out.key("key"); out.pod(boost::get<cryptonote::txout_to_key>(tx_out.target).key);
+    } else if (tx_out.target.type() == typeid(cryptonote::txout_to_scripthash)) {
+      out.key("scripthash"); out.pod(boost::get<cryptonote::txout_to_scripthash>(tx_out.target).hash);
+    } else {
+      out.key("script"); write_txout_to_script(out, boost::get<cryptonote::txout_to_script>(tx_out.target));
+    }
+    out.end_object();
+    out.end_object();
+  }
+
+  void write_bulletproof(json_builder& out, const rct::Bulletproof& bp) {
+    out.begin_object();
+    out.key("A"); out.pod(bp.A);
+    out.key("S"); out.pod(bp.S);
+    out.key("T1"); out.pod(bp.T1);
+    out.key("T2"); out.pod(bp.T2);
+    out.key("taux"); out.pod(bp.taux);
+    out.key("mu"); out.pod(bp.mu);
+    out.key("L"); out.pods(bp.L);
+    out.key("R"); out.pods(bp.R);
+    out.key("a"); out.pod(bp.a);
+    out.key("b"); out.pod(bp.b);
+    out.key("t"); out.pod(bp.t);
+    out.end_object();
+  }
+
+  void write_rct_signatures(json_builder& out, const rct::rctSig& rct) {
+    uint8_t type = rct.type;
+    if (type != rct::RCTTypeNull && type != rct::RCTTypeFull && type != rct::RCTTypeSimple && type != rct::RCTTypeBulletproof && type != rct::RCTTypeBulletproof2) {
+      throw runtime_error("Unsupported RingCT type: " + to_string(type));
+    }
+
+    // base
+    out.key("rct_signatures");
+    out.begin_object();
+    out.key("type"); out.number(type);
+    if (type != rct::RCTTypeNull) {
+      out.key("txnFee"); out.number(rct.txnFee);
+      if (type == rct::RCTTypeSimple) { out.key("pseudoOuts"); out.pods(rct.pseudoOuts); }
+      out.key("ecdhInfo");
+      out.begin_array();
+      for (const rct::ecdhTuple& ecdh : rct.ecdhInfo) {
+        out.begin_object();
+        if (type == rct::RCTTypeBulletproof2) {
+          out.key("amount"); out.blob(ecdh.amount.bytes, 8);
+        } else {
+          out.key("mask"); out.pod(ecdh.mask);
+          out.key("amount"); out.pod(ecdh.amount);
+        }
+        out.end_object();
+      }
+      out.end_array();
+      out.key("outPk");
+      out.begin_array();
+      for (const rct::ctkey& out_pk : rct.outPk) out.pod(out_pk.mask);
+      out.end_array();
+    }
+    out.end_object();
+    if (type == rct::RCTTypeNull) return;
+
+    // prunable
+    const rct::rctSigPrunable& prunable = rct.p;
+    out.key("rctsig_prunable");
+    out.begin_object();
+    if (type == rct::RCTTypeBulletproof || type == rct::RCTTypeBulletproof2) {
+      out.key("nbp"); out.number(prunable.bulletproofs.size());
+      out.key("bp");
+      out.begin_array();
+      for (const rct::Bulletproof& bp : prunable.bulletproofs) write_bulletproof(out, bp);
+      out.end_array();
+    } else {
+      out.key("rangeSigs");
+      out.begin_array();
+      for (const rct::rangeSig& range_sig : prunable.rangeSigs) {
+        out.begin_object();
+        out.key("asig"); out.pod(range_sig.asig);
+        out.key("Ci"); out.pod(range_sig.Ci);
+        out.end_object();
+      }
+      out.end_array();
+    }
+    out.key("MGs");
+    out.begin_array();
+    for (const rct::mgSig& mg : prunable.MGs) {
+      out.begin_object();
+      out.key("ss");
+      out.begin_array();
+      for (const rct::keyV& ss : mg.ss) out.pods(ss);
+      out.end_array();
+      out.key("cc"); out.pod(mg.cc);
+      out.end_object();
+    }
+    out.end_array();
+    if (type == rct::RCTTypeBulletproof || type == rct::RCTTypeBulletproof2) { out.key("pseudoOuts"); out.pods(prunable.pseudoOuts); }
+    out.end_object();
+  }
+
+  void write_tx(json_builder& out, const cryptonote::transaction& tx) {
+    out.begin_object();
+    out.key("version"); out.number(tx.version);
+    out.key("unlock_time"); out.number(tx.unlock_time);
+    out.key("vin");
+    out.begin_array();
+    for (const cryptonote::txin_v& in : tx.vin) write_txin(out, in);
+    out.end_array();
+    out.key("vout");
+    out.begin_array();
+    for (const cryptonote::tx_out& tx_out : tx.vout) write_txout(out, tx_out);
+    out.end_array();
+    out.key("extra"); out.bytes(tx.extra);
+    if (tx.version == 1) {
+      out.key("signatures");
+      out.begin_array();
+      for (const vector<crypto::signature>& sigs : tx.signatures) out.pods(sigs);
+      out.end_array();
+    } else if (!tx.vin.empty()) {
+      write_rct_signatures(out, tx.rct_signatures);
+    }
+    out.end_object();
+  }
+
+  void write_block(json_builder& out, const cryptonote::block& block) {
+    out.begin_object();
+    out.key("major_version"); out.number(block.major_version);
+    out.key("minor_version"); out.number(block.minor_version);
+    out.key("timestamp"); out.number(block.timestamp);
+    out.key("prev_id"); out.pod(block.prev_id);
+    out.key("nonce"); out.number(block.nonce);
+    out.key("miner_tx"); write_tx(out, block.miner_tx);
+    out.key("tx_hashes"); out.pods(block.tx_hashes);
+    out.end_object();
+  }
+}
+
+void monero_portable_storage::binary_to_json(const string& bin, string& json) {
+  reader r(bin);
+  r.read_header();
+  json.clear();
+  json.reserve(bin.size() * 2);
+  write_section(r, json, 0);
+}
+
+void monero_portable_storage::json_to_binary(const string& json, string& bin) {
+
+  // count entries of each object and array
+  json_counter counter;
+  rapidjson::Reader json_reader;
+  rapidjson::StringStream counter_stream(json.c_str());
+  if (!json_reader.Parse(counter_stream, counter)) {
+    throw runtime_error(counter.m_error.empty() ? "Invalid json at offset " + to_string(json_reader.GetErrorOffset()) : counter.m_error);
+  }
+
+  // write entries
+  bin.clear();
+  bin.reserve(json.size());
+  json_writer writer(counter.m_containers, bin);
+  rapidjson::StringStream writer_stream(json.c_str());
+  if (!json_reader.Parse(writer_stream, writer)) throw runtime_error(writer.m_error.empty() ? "Failed to convert json to portable storage" : writer.m_error);
+}
+
+void monero_portable_storage::blocks_to_json(const string& bin, string& json) {
+  reader r(bin);
+  r.read_header();
+  string blocks_json;
+  string txs_json;
+  json_builder blocks_out(blocks_json);
+  json_builder txs_out(txs_json);
+  blocks_out.begin_array();
+  txs_out.begin_array();
+  string status_json = "\"\"";
+  bool is_untrusted = false;
+  vector<pair<const char*, size_t>> tx_blobs;
+  uint64_t num_entries = r.read_varint();
+  for (uint64_t i = 0; i < num_entries; i++) {
+    const char* name;
+    size_t name_size;
+    r.read_name(name, name_size);
+    uint8_t type = r.read_byte();
+    if (name_is(name, name_size, "status") && type == TYPE_STRING) {
+      const char* data;
+      size_t size;
+      r.read_string(data, size);
+      status_json.clear();
+      append_json_string(data, size, status_json);
+    } else if (name_is(name, name_size, "untrusted") && type == TYPE_BOOL) {
+      is_untrusted = r.read_byte() != 0;
+    } else if (name_is(name, name_size, "blocks") && type == (FLAG_ARRAY | TYPE_OBJECT)) {
+      uint64_t num_blocks = r.read_varint();
+      for (uint64_t block_idx = 0; block_idx < num_blocks; block_idx++) {
+
+        // collect block and tx blobs which are either strings or sections with a blob
+        const char* block_blob = nullptr;
+        size_t block_blob_size = 0;
+        tx_blobs.clear();
+        uint64_t num_fields = r.read_varint();
+        for (uint64_t j = 0; j < num_fields; j++) {
+          r.read_name(name, name_size);
+          uint8_t field_type = r.read_byte();
+          if (name_is(name, name_size, "block") && field_type == TYPE_STRING) {
+            r.read_string(block_blob, block_blob_size);
+          } else if (name_is(name, name_size, "txs") && field_type == (FLAG_ARRAY | TYPE_STRING)) {
+            uint64_t num_txs = r.read_varint();
+            for (uint64_t k = 0; k < num_txs; k++) {
+              const char* data;
+              size_t size;
+              r.read_string(data, size);
+              tx_blobs.push_back(make_pair(data, size));
+            }
+          } else if (name_is(name, name_size, "txs") && field_type == (FLAG_ARRAY | TYPE_OBJECT)) {
+            uint64_t num_txs = r.read_varint();
+            for (uint64_t k = 0; k < num_txs; k++) {
+              uint64_t num_tx_fields = r.read_varint();
+              for (uint64_t l = 0; l < num_tx_fields; l++) {
+                r.read_name(name, name_size);
+                uint8_t tx_field_type = r.read_byte();
+                if (name_is(name, name_size, "blob") && tx_field_type == TYPE_STRING) {
+                  const char* data;
+                  size_t size;
+                  r.read_string(data, size);
+                  tx_blobs.push_back(make_pair(data, size));
+                } else {
+                  skip_value(r, tx_field_type, 3);
+                }
+              }
+            }
+          } else {
+            skip_value(r, field_type, 2);
+          }
+        }
+        if (block_blob == nullptr) throw runtime_error("Block " + to_string(block_idx) + " has no blob");
+
+        // parse block
+        cryptonote::block block;
+        if (!cryptonote::parse_and_validate_block_from_blob(cryptonote::blobdata(block_blob, block_blob_size), block)) throw runtime_error("Failed to parse block " + to_string(block_idx));
+        write_block(blocks_out, block);
+
+        // parse txs
+        txs_out.begin_array();
+        for (size_t tx_idx = 0; tx_idx < tx_blobs.size(); tx_idx++) {
+          cryptonote::transaction tx;
+          if (!cryptonote::parse_and_validate_tx_from_blob(cryptonote::blobdata(tx_blobs[tx_idx].first, tx_blobs[tx_idx].second), tx)) throw runtime_error("Failed to parse tx " + to_string(tx_idx) + " of block " + to_string(block_idx));
+          write_tx(txs_out, tx);
+        }
+        txs_out.end_array();
+      }
+    } else {
+      skip_value(r, type, 1);
+    }
+  }
+  blocks_out.end_array();
+  txs_out.end_array();
+
+  // assemble response
+  json.clear();
+  json.reserve(blocks_json.size() + txs_json.size() + status_json.size() + 64);
+  json.append("{\"blocks\":").append(blocks_json);
+  json.append(",\"txs\":").append(txs_json);
+  json.append(",\"status\":").append(status_json);
+  json.append(",\"untrusted\":").append(is_untrusted ? "true" : "false");
+  json.push_back('}');
+}
+
+void monero_portable_storage::append_hex(const uint8_t* data, size_t size, string& hex) {
+  size_t offset = hex.size();
+  hex.resize(offset + size * 2);
+  char* out = &hex[offset];
+  for (size_t i = 0; i < size; i++) memcpy(out + i * 2, DIGITS.m_hex + data[i] * 2, 2);
+}
@@ -0,0 +1,89 @@
+/**
+ * Copyright (c) 2017-2019 woodser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef monero_portable_storage_h
+#define monero_portable_storage_h
+
+#include <cstdint>
+#include <string>
+
+/**
+ * Converts between json and epee's portable storage binary format used by the
+ * daemon's .bin endpoints.
+ *
+ * Both directions stream between the input and output buffers without
+ * building epee's section tree: binary is read in one pass with bounds checked
+ * once per value or fixed-width array, and json is read twice by rapidjson's
+ * SAX reader, once to count the entries of each object and array and once to
+ * write them.  Each byte of a string is written to json as one char, escaped
+ * unless printable ascii, so text reads as text and binary blobs are recovered
+ * by taking each char as a byte.
+ */
+class monero_portable_storage {
+public:
+
+  /**
+   * Convert portable storage to json.
+   *
+   * @param bin is the portable storage to convert
+   * @param json is assigned the converted json
+   * @throws runtime_error if the portable storage is invalid
+   */
+  static void binary_to_json(const std::string& bin, std::string& json);
+
+  /**
+   * Convert a json object to portable storage.
+   *
+   * Non-negative integers are stored as uint64, negative integers as int64,
+   * and an array takes the type of its first element.  Members which are
+   * empty arrays are omitted, as epee omits empty containers, since their
+   * element type is unknown.
+   *
+   * @param json is the json object to convert
+   * @param bin is assigned the converted portable storage
+   * @throws runtime_error if the json is invalid or has nulls
+   */
+  static void json_to_binary(const std::string& json, std::string& bin);
+
+  /**
+   * Convert a get_blocks_by_height.bin response to json of the form
+   * {"blocks":[block,...],"txs":[[tx,...],...],"status":...,"untrusted":...}
+   * with each block and tx parsed from its blob and written in the layout of
+   * cryptonote's json serialization, with keys, hashes, and signatures as hex.
+   *
+   * @param bin is the portable storage response
+   * @param json is assigned the converted json
+   * @throws runtime_error if the response, a block, or a tx is invalid
+   */
+  static void blocks_to_json(const std::string& bin, std::string& json);
+
+  /**
+   * Append bytes as lowercase hex.
+   *
+   * @param data are the bytes to encode
+   * @param size is the number of bytes to encode
+   * @param hex is appended the encoded bytes
+   */
+  static void append_hex(const uint8_t* data, size_t size, std::string& hex);
+};
+
+#endif /* monero_portable_storage_h */
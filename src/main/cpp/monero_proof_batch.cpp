@@ -0,0 +1,674 @@
+/**
+ * Copyright (c) 2017-2019 woodser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "monero_proof_batch.h"
+#include "monero_daemon_client.h"
+#include "monero_parallel.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include "common/base58.h"
+#include "cryptonote_basic/cryptonote_format_utils.h"
+#include "ringct/rctOps.h"
+#include "wallet/wallet2.h"
+#include "boost/archive/portable_binary_iarchive.hpp"
+
+using namespace std;
+using namespace monero;
+
+namespace {
+
+  const size_t MAX_ITEMS_PER_REQUEST = 100;    // txs or key images per daemon request
+  const size_t MAX_OUTPUTS_PER_REQUEST = 1000; // ring members per daemon request
+  const string RESERVE_PROOF_HEADER = "ReserveProofV1";
+  const string SPEND_PROOF_HEADER = "SpendProofV1";
+
+  /**
+   * Tx fetched from the daemon to check proofs against.
+   */
+  struct fetched_tx {
+    cryptonote::transaction m_tx;
+    bool m_in_pool;
+    uint64_t m_block_height;
+  };
+
+  /**
+   * Reserve proof parsed for checking, whose outputs and subaddress
+   * signatures are checked as separate tasks.
+   */
+  struct parsed_reserve_proof {
+    cryptonote::account_public_address m_address;
+    crypto::hash m_prefix_hash;
+    vector<tools::wallet2::reserve_proof_entry> m_entries;
+    unordered_map<crypto::public_key, crypto::signature> m_subaddr_spendkeys;
+    vector<pair<crypto::public_key, crypto::signature>> m_subaddr_spendkey_sigs;
+    atomic<bool> m_is_good{false};
+    atomic<uint64_t> m_total_amount{0};
+    atomic<uint64_t> m_spent_amount{0};
+    atomic<size_t> m_num_tasks_left{0};
+  };
+
+  /**
+   * Spend proof parsed for checking, whose rings are checked as separate
+   * tasks.
+   */
+  struct parsed_spend_proof {
+    crypto::hash m_prefix_hash;
+    vector<const cryptonote::txin_to_key*> m_inputs;
+    vector<vector<uint64_t>> m_ring_indices;           // global output indices per input
+    vector<vector<crypto::signature>> m_signatures;    // per ring member per input
+    atomic<bool> m_is_good{false};
+  };
+
+  /**
+   * Run fn(0) ... fn(n - 1) over worker threads while the calling thread
+   * reports progress, so callbacks into the caller never leave its thread.
+   * Each call returns the units of progress it completes, which advance
+   * from num_done to num_total.
+   */
+  void run_with_progress(size_t n, size_t num_done, size_t num_total, size_t max_threads, const function<size_t(size_t)>& fn, const monero_proof_progress_fn& on_progress) {
+    mutex progress_mutex;
+    condition_variable progress_cv;
+    bool finished = false;
+    exception_ptr error;
+    thread runner([&]() {
+      exception_ptr runner_error;
+      try {
+        monero_parallel_for(n, max_threads, [&](size_t i) {
+          size_t num_completed = fn(i);
+          if (num_completed == 0) return;
+          lock_guard<mutex> lock(progress_mutex);
+          num_done += num_completed;
+          progress_cv.notify_one();
+        });
+      } catch (...) {
+        runner_error = current_exception();
+      }
+      lock_guard<mutex> lock(progress_mutex);
+      error = runner_error;
+      finished = true;
+      progress_cv.notify_one();
+    });
+
+    // report progress each time it advances
+    size_t num_reported = 0;
+    while (true) {
+      {
+        unique_lock<mutex> lock(progress_mutex);
+        progress_cv.wait(lock, [&]() { return num_done > num_reported || finished; });
+        if (error != nullptr || num_done == num_reported) break;
+        num_reported = num_done;
+      }
+      if (on_progress) on_progress(num_reported, num_total);
+    }
+    runner.join();
+    if (error) rethrow_exception(error);
+  }
+
+  /**
+   * Run fn(client, 0) ... fn(client, n - 1) over at most max_threads workers
+   * which each own a daemon connection.
+   */
+  void for_each_with_client(const monero_proof_context& context, size_t n, size_t max_threads, const function<void(monero_daemon_client&, size_t)>& fn) {
+    if (max_threads == 0) max_threads = max(thread::hardware_concurrency(), 1u);
+    atomic<size_t> next_idx(0);
+    monero_parallel_for(min(n, max_threads), max_threads, [&](size_t) {
+      monero_daemon_client client(context.m_daemon_uri, context.m_daemon_username, context.m_daemon_password);
+      for (size_t i = next_idx++; i < n; i = next_idx++) fn(client, i);
+    });
+  }
+
+  /**
+   * Fetch txs by hash in batches, omitting txs the daemon does not have.
+   */
+  unordered_map<crypto::hash, fetched_tx> fetch_txs(const monero_proof_context& context, const vector<crypto::hash>& tx_hashes, size_t max_threads) {
+    size_t num_batches = (tx_hashes.size() + MAX_ITEMS_PER_REQUEST - 1) / MAX_ITEMS_PER_REQUEST;
+    vector<vector<pair<crypto::hash, fetched_tx>>> batches(num_batches);
+    for_each_with_client(context, num_batches, max_threads, [&](monero_daemon_client& client, size_t batch_idx) {
+      vector<string> batch_hashes;
+      for (size_t i = batch_idx * MAX_ITEMS_PER_REQUEST; i < min(tx_hashes.size(), (batch_idx + 1) * MAX_ITEMS_PER_REQUEST); i++) batch_hashes.push_back(epee::string_tools::pod_to_hex(tx_hashes[i]));
+      vector<cryptonote::COMMAND_RPC_GET_TRANSACTIONS::entry> entries;
+      string error;
+      if (!client.get_txs(batch_hashes, entries, error)) throw runtime_error("Failed to get transactions from daemon: " + error);
+
+      // key each tx by the hash of its blob so a wrong tx from the daemon is never matched
+      for (const cryptonote::COMMAND_RPC_GET_TRANSACTIONS::entry& entry : entries) {
+        cryptonote::blobdata tx_blob;
+        fetched_tx tx;
+        crypto::hash tx_hash;
+        if (!epee::string_tools::parse_hexstr_to_binbuff(entry.as_hex, tx_blob) || !cryptonote::parse_and_validate_tx_from_blob(tx_blob, tx.m_tx, tx_hash)) {
+          MWARNING("Failed to parse tx " << entry.tx_hash << " from daemon");
+          continue;
+        }
+        tx.m_in_pool = entry.in_pool;
+        tx.m_block_height = entry.block_height;
+        batches[batch_idx].push_back(make_pair(tx_hash, std::move(tx)));
+      }
+    });
+    unordered_map<crypto::hash, fetched_tx> txs;
+    for (vector<pair<crypto::hash, fetched_tx>>& batch : batches) {
+      for (pair<crypto::hash, fetched_tx>& tx : batch) txs.insert(std::move(tx));
+    }
+    return txs;
+  }
+
+  /**
+   * Fetch whether key images are spent in batches.
+   */
+  unordered_map<crypto::key_image, bool> fetch_key_images_spent(const monero_proof_context& context, const vector<crypto::key_image>& key_images, size_t max_threads) {
+    size_t num_batches = (key_images.size() + MAX_ITEMS_PER_REQUEST - 1) / MAX_ITEMS_PER_REQUEST;
+    vector<vector<int>> batches(num_batches);
+    for_each_with_client(context, num_batches, max_threads, [&](monero_daemon_client& client, size_t batch_idx) {
+      vector<string> batch_key_images;
+      for (size_t i = batch_idx * MAX_ITEMS_PER_REQUEST; i < min(key_images.size(), (batch_idx + 1) * MAX_ITEMS_PER_REQUEST); i++) batch_key_images.push_back(epee::string_tools::pod_to_hex(key_images[i]));
+      string error;
+      if (!client.get_key_images_spent(batch_key_images, batches[batch_idx], error)) throw runtime_error("Failed to get key image spent status from daemon: " + error);
+    });
+    unordered_map<crypto::key_image, bool> spent;
+    for (size_t i = 0; i < key_images.size(); i++) spent[key_images[i]] = batches[i / MAX_ITEMS_PER_REQUEST][i % MAX_ITEMS_PER_REQUEST] != 0;
+    return spent;
+  }
+
+  /**
+   * Fetch the keys of outputs by amount and global index in batches.
+   */
+  map<pair<uint64_t, uint64_t>, crypto::public_key> fetch_output_keys(const monero_proof_context& context, const vector<cryptonote::get_outputs_out>& outputs, size_t max_threads) {
+    size_t num_batches = (outputs.size() + MAX_OUTPUTS_PER_REQUEST - 1) / MAX_OUTPUTS_PER_REQUEST;
+    vector<vector<cryptonote::COMMAND_RPC_GET_OUTPUTS_BIN::outkey>> batches(num_batches);
+    for_each_with_client(context, num_batches, max_threads, [&](monero_daemon_client& client, size_t batch_idx) {
+      vector<cryptonote::get_outputs_out> batch_outputs(outputs.begin() + batch_idx * MAX_OUTPUTS_PER_REQUEST, outputs.begin() + min(outputs.size(), (batch_idx + 1) * MAX_OUTPUTS_PER_REQUEST));
+      string error;
+      if (!client.get_outs_bin(batch_outputs, batches[batch_idx], error)) throw runtime_error("Failed to get outputs from daemon: " + error);
+    });
+    map<pair<uint64_t, uint64_t>, crypto::public_key> keys;
+    for (size_t i = 0; i < outputs.size(); i++) keys[make_pair(outputs[i].amount, outputs[i].index)] = batches[i / MAX_OUTPUTS_PER_REQUEST][i % MAX_OUTPUTS_PER_REQUEST].key;
+    return keys;
+  }
+
+  /**
+   * Fetch the daemon's height if any tx is confirmed, to count confirmations.
+   */
+  uint64_t fetch_height(const monero_proof_context& context, const unordered_map<crypto::hash, fetched_tx>& txs) {
+    bool has_confirmed = false;
+    for (const pair<const crypto::hash, fetched_tx>& tx : txs) has_confirmed = has_confirmed || !tx.second.m_in_pool;
+    if (!has_confirmed) return 0;
+    monero_daemon_client client(context.m_daemon_uri, context.m_daemon_username, context.m_daemon_password);
+    uint64_t height;
+    string error;
+    if (!client.get_height(height, error)) throw runtime_error("Failed to get height from daemon: " + error);
+    return height;
+  }
+
+  cryptonote::address_parse_info parse_address(const monero_proof_context& context, const string& address) {
+    cryptonote::address_parse_info info;
+    if (!cryptonote::get_account_address_from_str(info, static_cast<cryptonote::network_type>(context.m_network_type), address)) throw runtime_error("Invalid address");
+    return info;
+  }
+
+  crypto::hash parse_tx_hash(const string& tx_hash_str) {
+    crypto::hash tx_hash;
+    if (!epee::string_tools::hex_to_pod(tx_hash_str, tx_hash)) throw runtime_error("TX hash has invalid format");
+    return tx_hash;
+  }
+
+  // gets the distinct valid tx hashes of requests to fetch
+  vector<crypto::hash> get_tx_hashes(const vector<monero_tx_proof_request>& requests) {
+    vector<crypto::hash> tx_hashes;
+    unordered_set<crypto::hash> tx_hashes_set;
+    for (const monero_tx_proof_request& request : requests) {
+      crypto::hash tx_hash;
+      if (epee::string_tools::hex_to_pod(request.m_tx_hash, tx_hash) && tx_hashes_set.insert(tx_hash).second) tx_hashes.push_back(tx_hash);
+    }
+    return tx_hashes;
+  }
+
+  const fetched_tx& get_fetched_tx(const unordered_map<crypto::hash, fetched_tx>& txs, const crypto::hash& tx_hash) {
+    unordered_map<crypto::hash, fetched_tx>::const_iterator iter = txs.find(tx_hash);
+    if (iter == txs.end()) throw runtime_error("Failed to get transaction from daemon");
+    return iter->second;
+  }
+
+  // gets the number of base58 characters which encode a number of bytes
+  size_t get_base58_size(size_t num_bytes) {
+    return tools::base58::encode(string(num_bytes, '\0')).size();
+  }
+
+  /**
+   * Sum the outputs of a tx received by an address, as
+   * wallet2::check_tx_key_helper() does.
+   */
+  uint64_t get_received_amount(const cryptonote::transaction& tx, const crypto::key_derivation& derivation, const vector<crypto::key_derivation>& additional_derivations, const cryptonote::account_public_address& address) {
+    uint64_t received = 0;
+    for (size_t n = 0; n < tx.vout.size(); n++) {
+      const cryptonote::txout_to_key* const out_key = boost::get<cryptonote::txout_to_key>(std::addressof(tx.vout[n].target));
+      if (!out_key) continue;
+      crypto::public_key derived_out_key;
+      if (!crypto::derive_public_key(derivation, n, address.m_spend_public_key, derived_out_key)) throw runtime_error("Failed to derive public key");
+      bool found = out_key->key == derived_out_key;
+      crypto::key_derivation found_derivation = derivation;
+      if (!found && n < additional_derivations.size()) {
+        if (!crypto::derive_public_key(additional_derivations[n], n, address.m_spend_public_key, derived_out_key)) throw runtime_error("Failed to derive public key");
+        found = out_key->key == derived_out_key;
+        found_derivation = additional_derivations[n];
+      }
+      if (!found) continue;
+
+      // decode the amount if hidden, counting it only if it opens the output's commitment
+      if (tx.version == 1 || tx.rct_signatures.type == rct::RCTTypeNull) {
+        received += tx.vout[n].amount;
+      } else {
+        if (n >= tx.rct_signatures.ecdhInfo.size() || n >= tx.rct_signatures.outPk.size()) throw runtime_error("Missing ringct output info");
+        crypto::secret_key scalar;
+        crypto::derivation_to_scalar(found_derivation, n, scalar);
+        rct::ecdhTuple ecdh_info = tx.rct_signatures.ecdhInfo[n];
+        rct::ecdhDecode(ecdh_info, rct::sk2rct(scalar), tx.rct_signatures.type == rct::RCTTypeBulletproof2);
+        if (sc_check(ecdh_info.mask.bytes) != 0) throw runtime_error("Bad ECDH input mask");
+        if (sc_check(ecdh_info.amount.bytes) != 0) throw runtime_error("Bad ECDH input amount");
+        rct::key commitment;
+        rct::addKeys2(commitment, ecdh_info.mask, ecdh_info.amount, rct::H);
+        if (rct::equalKeys(tx.rct_signatures.outPk[n].mask, commitment)) received += rct::h2d(ecdh_info.amount);
+      }
+    }
+    return received;
+  }
+
+  shared_ptr<monero_check_tx> make_check_tx(const fetched_tx& tx, uint64_t height, uint64_t received_amount) {
+    shared_ptr<monero_check_tx> check = make_shared<monero_check_tx>();
+    check->m_is_good = true;
+    check->m_received_amount = received_amount;
+    check->m_in_tx_pool = tx.m_in_pool;
+    check->m_num_confirmations = tx.m_in_pool || height < tx.m_block_height ? 0 : height - tx.m_block_height;
+    return check;
+  }
+
+  shared_ptr<monero_check_tx> make_bad_check_tx() {
+    shared_ptr<monero_check_tx> check = make_shared<monero_check_tx>();
+    check->m_is_good = false;
+    return check;
+  }
+
+  /**
+   * Check a tx key as wallet2::check_tx_key() does.
+   */
+  shared_ptr<monero_check_tx> check_tx_key(const monero_proof_context& context, const monero_tx_proof_request& request, const unordered_map<crypto::hash, fetched_tx>& txs, uint64_t height) {
+    crypto::hash tx_hash = parse_tx_hash(request.m_tx_hash);
+
+    // parse the tx key followed by any additional tx keys
+    const string& tx_key_str = request.m_signature;
+    if (tx_key_str.size() < 64 || tx_key_str.size() % 64) throw runtime_error("Tx key has invalid format");
+    crypto::secret_key tx_key;
+    if (!epee::string_tools::hex_to_pod(tx_key_str.substr(0, 64), tx_key)) throw runtime_error("Tx key has invalid format");
+    vector<crypto::secret_key> additional_tx_keys(tx_key_str.size() / 64 - 1);
+    for (size_t i = 0; i < additional_tx_keys.size(); i++) {
+      if (!epee::string_tools::hex_to_pod(tx_key_str.substr((i + 1) * 64, 64), additional_tx_keys[i])) throw runtime_error("Tx key has invalid format");
+    }
+    cryptonote::address_parse_info info = parse_address(context, request.m_address);
+    const fetched_tx& tx = get_fetched_tx(txs, tx_hash);
+
+    // derive what the tx shares with the address and sum what the address receives
+    crypto::key_derivation derivation;
+    if (!crypto::generate_key_derivation(info.address.m_view_public_key, tx_key, derivation)) throw runtime_error("Failed to generate key derivation from supplied parameters");
+    vector<crypto::key_derivation> additional_derivations(additional_tx_keys.size());
+    for (size_t i = 0; i < additional_tx_keys.size(); i++) {
+      if (!crypto::generate_key_derivation(info.address.m_view_public_key, additional_tx_keys[i], additional_derivations[i])) throw runtime_error("Failed to generate key derivation from supplied parameters");
+    }
+    return make_check_tx(tx, height, get_received_amount(tx.m_tx, derivation, additional_derivations, info.address));
+  }
+
+  /**
+   * Check a tx proof's signatures and sum what the address receives, as
+   * wallet2::check_tx_proof() does.
+   *
+   * @return true if any signature is good, false otherwise
+   */
+  bool check_tx_proof_signatures(const cryptonote::transaction& tx, const crypto::hash& tx_hash, const cryptonote::address_parse_info& info, const string& message, const string& sig_str, uint64_t& received) {
+
+    // proofs are InProofV1, InProofV2, OutProofV1, or OutProofV2
+    const bool is_out = sig_str.compare(0, 3, "Out") == 0;
+    const size_t header_len = is_out ? 10 : 9;
+    const string header = sig_str.substr(0, header_len);
+    if (header != "InProofV1" && header != "InProofV2" && header != "OutProofV1" && header != "OutProofV2") throw runtime_error("Signature header check error");
+    const int version = header.back() == '1' ? 1 : 2;
+
+    // decode a shared secret and signature per tx public key
+    const size_t pk_len = get_base58_size(sizeof(crypto::public_key));
+    const size_t sig_len = get_base58_size(sizeof(crypto::signature));
+    const size_t num_sigs = (sig_str.size() - header_len) / (pk_len + sig_len);
+    if (sig_str.size() != header_len + num_sigs * (pk_len + sig_len)) throw runtime_error("Wrong signature size");
+    vector<crypto::public_key> shared_secrets(num_sigs);
+    vector<crypto::signature> sigs(num_sigs);
+    for (size_t i = 0; i < num_sigs; i++) {
+      string pk_decoded;
+      string sig_decoded;
+      const size_t offset = header_len + i * (pk_len + sig_len);
+      if (!tools::base58::decode(sig_str.substr(offset, pk_len), pk_decoded) || !tools::base58::decode(sig_str.substr(offset + pk_len, sig_len), sig_decoded)) throw runtime_error("Signature decoding error");
+      if (pk_decoded.size() != sizeof(crypto::public_key) || sig_decoded.size() != sizeof(crypto::signature)) throw runtime_error("Signature decoding error");
+      memcpy(&shared_secrets[i], pk_decoded.data(), sizeof(crypto::public_key));
+      memcpy(&sigs[i], sig_decoded.data(), sizeof(crypto::signature));
+    }
+    const crypto::public_key tx_pub_key = cryptonote::get_tx_pub_key_from_extra(tx);
+    if (tx_pub_key == crypto::null_pkey) throw runtime_error("Tx pubkey was not found");
+    vector<crypto::public_key> tx_pub_keys = cryptonote::get_additional_tx_pub_keys_from_extra(tx);
+    if (tx_pub_keys.size() + 1 != num_sigs) throw runtime_error("Signature size mismatch with additional tx pubkeys");
+    tx_pub_keys.insert(tx_pub_keys.begin(), tx_pub_key);
+
+    // every signature signs the tx hash and message
+    string prefix_data((const char*) &tx_hash, sizeof(crypto::hash));
+    prefix_data += message;
+    crypto::hash prefix_hash;
+    crypto::cn_fast_hash(prefix_data.data(), prefix_data.size(), prefix_hash);
+
+    // check each signature, deriving the shared secret of each good one
+    boost::optional<crypto::public_key> spend_key;
+    if (info.is_subaddress) spend_key = info.address.m_spend_public_key;
+    vector<crypto::key_derivation> derivations(num_sigs);
+    bool any_good = false;
+    for (size_t i = 0; i < num_sigs; i++) {
+      bool good = is_out ?
+          crypto::check_tx_proof(prefix_hash, tx_pub_keys[i], info.address.m_view_public_key, spend_key, shared_secrets[i], sigs[i], version) :
+          crypto::check_tx_proof(prefix_hash, info.address.m_view_public_key, tx_pub_keys[i], spend_key, shared_secrets[i], sigs[i], version);
+      if (!good) continue;
+      any_good = true;
+      if (!crypto::generate_key_derivation(shared_secrets[i], rct::rct2sk(rct::I), derivations[i])) throw runtime_error("Failed to generate key derivation");
+    }
+    if (!any_good) return false;
+    vector<crypto::key_derivation> additional_derivations(derivations.begin() + 1, derivations.end());
+    received = get_received_amount(tx, derivations[0], additional_derivations, info.address);
+    return true;
+  }
+
+  /**
+   * Parse a spend proof of a fetched tx, as wallet2::check_spend_proof() does.
+   */
+  void parse_spend_proof(const monero_tx_proof_request& request, const unordered_map<crypto::hash, fetched_tx>& txs, parsed_spend_proof& proof) {
+    crypto::hash tx_hash = parse_tx_hash(request.m_tx_hash);
+    const string& sig_str = request.m_signature;
+    if (sig_str.compare(0, SPEND_PROOF_HEADER.size(), SPEND_PROOF_HEADER) != 0) throw runtime_error("Signature header check error");
+    const fetched_tx& tx = get_fetched_tx(txs, tx_hash);
+
+    // the proof has a signature per ring member of each input
+    size_t num_sigs = 0;
+    for (const cryptonote::txin_v& in : tx.m_tx.vin) {
+      const cryptonote::txin_to_key* const in_key = boost::get<cryptonote::txin_to_key>(std::addressof(in));
+      if (in_key == nullptr) continue;
+      proof.m_inputs.push_back(in_key);
+      proof.m_ring_indices.push_back(cryptonote::relative_output_offsets_to_absolute(in_key->key_offsets));
+      num_sigs += in_key->key_offsets.size();
+    }
+    const size_t sig_len = get_base58_size(sizeof(crypto::signature));
+    if (sig_str.size() != SPEND_PROOF_HEADER.size() + num_sigs * sig_len) throw runtime_error("Wrong signature size");
+    size_t offset = SPEND_PROOF_HEADER.size();
+    for (const cryptonote::txin_to_key* in_key : proof.m_inputs) {
+      proof.m_signatures.push_back(vector<crypto::signature>(in_key->key_offsets.size()));
+      for (crypto::signature& sig : proof.m_signatures.back()) {
+        string sig_decoded;
+        if (!tools::base58::decode(sig_str.substr(offset, sig_len), sig_decoded) || sig_decoded.size() != sizeof(crypto::signature)) throw runtime_error("Signature decoding error");
+        memcpy(&sig, sig_decoded.data(), sizeof(crypto::signature));
+        offset += sig_len;
+      }
+    }
+
+    // every ring signature signs the tx hash and message
+    string prefix_data((const char*) &tx_hash, sizeof(crypto::hash));
+    prefix_data += request.m_message;
+    crypto::cn_fast_hash(prefix_data.data(), prefix_data.size(), proof.m_prefix_hash);
+  }
+
+  /**
+   * Parse a reserve proof and hash what its signatures sign, as
+   * wallet2::check_reserve_proof() does.
+   */
+  void parse_reserve_proof(const monero_proof_context& context, const monero_reserve_proof_request& request, parsed_reserve_proof& proof) {
+    cryptonote::address_parse_info info = parse_address(context, request.m_address);
+    if (info.is_subaddress) throw runtime_error("Address must not be a subaddress");
+    if (request.m_signature.compare(0, RESERVE_PROOF_HEADER.size(), RESERVE_PROOF_HEADER) != 0) throw runtime_error("Signature header check error");
+    string decoded;
+    if (!tools::base58::decode(request.m_signature.substr(RESERVE_PROOF_HEADER.size()), decoded)) throw runtime_error("Signature decoding error");
+    istringstream iss(decoded);
+    boost::archive::portable_binary_iarchive ar(iss);
+    ar >> proof.m_entries >> proof.m_subaddr_spendkeys;
+    if (proof.m_subaddr_spendkeys.count(info.address.m_spend_public_key) == 0) throw runtime_error("The given address isn't found in the proof");
+    proof.m_address = info.address;
+    proof.m_subaddr_spendkey_sigs.assign(proof.m_subaddr_spendkeys.begin(), proof.m_subaddr_spendkeys.end());
+
+    // every signature signs the message, address, and key images
+    string prefix_data = request.m_message;
+    prefix_data.append((const char*) &info.address, sizeof(cryptonote::account_public_address));
+    for (const tools::wallet2::reserve_proof_entry& entry : proof.m_entries) prefix_data.append((const char*) &entry.key_image, sizeof(crypto::key_image));
+    crypto::cn_fast_hash(prefix_data.data(), prefix_data.size(), proof.m_prefix_hash);
+  }
+
+  /**
+   * Check one output of a reserve proof as wallet2::check_reserve_proof() does.
+   *
+   * @return true with the output's amount if it is proven, false otherwise
+   */
+  bool check_reserve_proof_entry(const parsed_reserve_proof& proof, const tools::wallet2::reserve_proof_entry& entry, const fetched_tx& fetched, uint64_t& amount) {
+    const cryptonote::transaction& tx = fetched.m_tx;
+    if (fetched.m_in_pool || entry.index_in_tx >= tx.vout.size()) return false;
+    const cryptonote::txout_to_key* const out_key = boost::get<cryptonote::txout_to_key>(std::addressof(tx.vout[entry.index_in_tx].target));
+    if (!out_key) return false;
+    const crypto::public_key tx_pub_key = cryptonote::get_tx_pub_key_from_extra(tx);
+    if (tx_pub_key == crypto::null_pkey) return false;
+    const vector<crypto::public_key> additional_tx_pub_keys = cryptonote::get_additional_tx_pub_keys_from_extra(tx);
+
+    // check signature of the shared secret
+    bool ok = crypto::check_tx_proof(proof.m_prefix_hash, proof.m_address.m_view_public_key, tx_pub_key, boost::none, entry.shared_secret, entry.shared_secret_sig, 1);
+    if (!ok && additional_tx_pub_keys.size() == tx.vout.size()) ok = crypto::check_tx_proof(proof.m_prefix_hash, proof.m_address.m_view_public_key, additional_tx_pub_keys[entry.index_in_tx], boost::none, entry.shared_secret, entry.shared_secret_sig, 1);
+    if (!ok) return false;
+
+    // check signature of the key image
+    const crypto::public_key* out_pub_key = &out_key->key;
+    if (!crypto::check_ring_signature(proof.m_prefix_hash, entry.key_image, &out_pub_key, 1, &entry.key_image_sig)) return false;
+
+    // check the output was received by one of the proof's subaddresses
+    crypto::key_derivation derivation;
+    if (!crypto::generate_key_derivation(entry.shared_secret, rct::rct2sk(rct::I), derivation)) return false;
+    crypto::public_key subaddr_spendkey;
+    if (!crypto::derive_subaddress_public_key(out_key->key, derivation, entry.index_in_tx, subaddr_spendkey)) return false;
+    if (proof.m_subaddr_spendkeys.count(subaddr_spendkey) == 0) return false;
+
+    // decode the amount if hidden
+    amount = tx.vout[entry.index_in_tx].amount;
+    if (amount == 0) {
+      if (entry.index_in_tx >= tx.rct_signatures.ecdhInfo.size()) return false;
+      crypto::secret_key shared_secret;
+      crypto::derivation_to_scalar(derivation, entry.index_in_tx, shared_secret);
+      rct::ecdhTuple ecdh_info = tx.rct_signatures.ecdhInfo[entry.index_in_tx];
+      rct::ecdhDecode(ecdh_info, rct::sk2rct(shared_secret), tx.rct_signatures.type == rct::RCTTypeBulletproof2);
+      amount = rct::h2d(ecdh_info.amount);
+    }
+    return true;
+  }
+}
+
+vector<shared_ptr<monero_check_reserve>> check_reserve_proofs(const monero_proof_context& context, const vector<monero_reserve_proof_request>& requests, size_t max_threads, const monero_proof_progress_fn& on_progress) {
+
+  // parse proofs
+  vector<parsed_reserve_proof> proofs(requests.size());
+  monero_parallel_for(requests.size(), max_threads, [&](size_t i) {
+    try {
+      parse_reserve_proof(context, requests[i], proofs[i]);
+      proofs[i].m_is_good = true;
+    } catch (const exception& e) {
+      MWARNING("Failed to check reserve proof " << i << ": " << e.what());
+    }
+  });
+
+  // fetch the txs and key image statuses of all proofs together
+  vector<crypto::hash> tx_hashes;
+  vector<crypto::key_image> key_images;
+  unordered_set<crypto::hash> tx_hashes_set;
+  unordered_set<crypto::key_image> key_images_set;
+  for (const parsed_reserve_proof& proof : proofs) {
+    if (!proof.m_is_good) continue;
+    for (const tools::wallet2::reserve_proof_entry& entry : proof.m_entries) {
+      if (tx_hashes_set.insert(entry.txid).second) tx_hashes.push_back(entry.txid);
+      if (key_images_set.insert(entry.key_image).second) key_images.push_back(entry.key_image);
+    }
+  }
+  unordered_map<crypto::hash, fetched_tx> txs = fetch_txs(context, tx_hashes, max_threads);
+  unordered_map<crypto::key_image, bool> spent = fetch_key_images_spent(context, key_images, max_threads);
+
+  // check each output and subaddress signature of each proof as its own task
+  vector<pair<size_t, size_t>> tasks;
+  size_t num_done = 0;
+  for (size_t i = 0; i < proofs.size(); i++) {
+    if (!proofs[i].m_is_good) {
+      num_done++;
+      continue;
+    }
+    size_t num_tasks = proofs[i].m_entries.size() + proofs[i].m_subaddr_spendkey_sigs.size();
+    proofs[i].m_num_tasks_left = num_tasks;
+    for (size_t j = 0; j < num_tasks; j++) tasks.push_back(make_pair(i, j));
+  }
+  run_with_progress(tasks.size(), num_done, proofs.size(), max_threads, [&](size_t task_idx) -> size_t {
+    size_t proof_idx = tasks[task_idx].first;
+    size_t j = tasks[task_idx].second;
+    parsed_reserve_proof& proof = proofs[proof_idx];
+    if (proof.m_is_good) { // skip the rest of a failed proof
+      try {
+        if (j < proof.m_entries.size()) {
+          const tools::wallet2::reserve_proof_entry& entry = proof.m_entries[j];
+          auto tx_iter = txs.find(entry.txid);
+          uint64_t amount;
+          if (tx_iter == txs.end() || !check_reserve_proof_entry(proof, entry, tx_iter->second, amount)) {
+            proof.m_is_good = false;
+          } else {
+            proof.m_total_amount += amount;
+            if (spent.at(entry.key_image)) proof.m_spent_amount += amount;
+          }
+        } else {
+          const pair<crypto::public_key, crypto::signature>& sig = proof.m_subaddr_spendkey_sigs[j - proof.m_entries.size()];
+          if (!crypto::check_signature(proof.m_prefix_hash, sig.first, sig.second)) proof.m_is_good = false;
+        }
+      } catch (const exception& e) {
+        MWARNING("Failed to check reserve proof " << proof_idx << ": " << e.what());
+        proof.m_is_good = false;
+      }
+    }
+    return --proof.m_num_tasks_left == 0 ? 1 : 0;
+  }, on_progress);
+
+  // collect results
+  vector<shared_ptr<monero_check_reserve>> checks;
+  checks.reserve(proofs.size());
+  for (const parsed_reserve_proof& proof : proofs) {
+    shared_ptr<monero_check_reserve> check = make_shared<monero_check_reserve>();
+    check->m_is_good = proof.m_is_good.load();
+    if (check->m_is_good) {
+      check->m_total_amount = proof.m_total_amount.load();
+      check->m_unconfirmed_spent_amount = proof.m_spent_amount.load();
+    }
+    checks.push_back(check);
+  }
+  return checks;
+}
+
+vector<shared_ptr<monero_check_tx>> check_tx_keys(const monero_proof_context& context, const vector<monero_tx_proof_request>& requests, size_t max_threads) {
+  unordered_map<crypto::hash, fetched_tx> txs = fetch_txs(context, get_tx_hashes(requests), max_threads);
+  uint64_t height = fetch_height(context, txs);
+  vector<shared_ptr<monero_check_tx>> checks(requests.size());
+  monero_parallel_for(requests.size(), max_threads, [&](size_t i) {
+    try {
+      checks[i] = check_tx_key(context, requests[i], txs, height);
+    } catch (const exception& e) {
+      MWARNING("Failed to check tx key " << i << ": " << e.what());
+      checks[i] = make_bad_check_tx();
+    }
+  });
+  return checks;
+}
+
+vector<shared_ptr<monero_check_tx>> check_tx_proofs(const monero_proof_context& context, const vector<monero_tx_proof_request>& requests, size_t max_threads) {
+  unordered_map<crypto::hash, fetched_tx> txs = fetch_txs(context, get_tx_hashes(requests), max_threads);
+  uint64_t height = fetch_height(context, txs);
+  vector<shared_ptr<monero_check_tx>> checks(requests.size());
+  monero_parallel_for(requests.size(), max_threads, [&](size_t i) {
+    try {
+      crypto::hash tx_hash = parse_tx_hash(requests[i].m_tx_hash);
+      cryptonote::address_parse_info info = parse_address(context, requests[i].m_address);
+      const fetched_tx& tx = get_fetched_tx(txs, tx_hash);
+      uint64_t received_amount;
+      checks[i] = check_tx_proof_signatures(tx.m_tx, tx_hash, info, requests[i].m_message, requests[i].m_signature, received_amount) ? make_check_tx(tx, height, received_amount) : make_bad_check_tx();
+    } catch (const exception& e) {
+      MWARNING("Failed to check tx proof " << i << ": " << e.what());
+      checks[i] = make_bad_check_tx();
+    }
+  });
+  return checks;
+}
+
+vector<bool> check_spend_proofs(const monero_proof_context& context, const vector<monero_tx_proof_request>& requests, size_t max_threads) {
+
+  // parse proofs against their txs
+  unordered_map<crypto::hash, fetched_tx> txs = fetch_txs(context, get_tx_hashes(requests), max_threads);
+  vector<parsed_spend_proof> proofs(requests.size());
+  monero_parallel_for(requests.size(), max_threads, [&](size_t i) {
+    try {
+      parse_spend_proof(requests[i], txs, proofs[i]);
+      proofs[i].m_is_good = true;
+    } catch (const exception& e) {
+      MWARNING("Failed to check spend proof " << i << ": " << e.what());
+    }
+  });
+
+  // fetch the ring members of all proofs together
+  vector<cryptonote::get_outputs_out> outputs;
+  set<pair<uint64_t, uint64_t>> outputs_set;
+  vector<pair<size_t, size_t>> tasks;
+  for (size_t i = 0; i < proofs.size(); i++) {
+    if (!proofs[i].m_is_good) continue;
+    for (size_t j = 0; j < proofs[i].m_inputs.size(); j++) {
+      tasks.push_back(make_pair(i, j));
+      for (uint64_t index : proofs[i].m_ring_indices[j]) {
+        if (outputs_set.insert(make_pair(proofs[i].m_inputs[j]->amount, index)).second) outputs.push_back({proofs[i].m_inputs[j]->amount, index});
+      }
+    }
+  }
+  map<pair<uint64_t, uint64_t>, crypto::public_key> output_keys = fetch_output_keys(context, outputs, max_threads);
+
+  // check the ring of each input of each proof as its own task
+  monero_parallel_for(tasks.size(), max_threads, [&](size_t task_idx) {
+    parsed_spend_proof& proof = proofs[tasks[task_idx].first];
+    size_t j = tasks[task_idx].second;
+    if (!proof.m_is_good) return; // skip the rest of a failed proof
+    const cryptonote::txin_to_key* in_key = proof.m_inputs[j];
+    vector<crypto::public_key> ring(proof.m_ring_indices[j].size());
+    vector<const crypto::public_key*> ring_ptrs(ring.size());
+    for (size_t k = 0; k < ring.size(); k++) {
+      ring[k] = output_keys.at(make_pair(in_key->amount, proof.m_ring_indices[j][k]));
+      ring_ptrs[k] = &ring[k];
+    }
+    if (!crypto::check_ring_signature(proof.m_prefix_hash, in_key->k_image, ring_ptrs, proof.m_signatures[j].data())) proof.m_is_good = false;
+  });
+  vector<bool> goods;
+  goods.reserve(proofs.size());
+  for (const parsed_spend_proof& proof : proofs) goods.push_back(proof.m_is_good);
+  return goods;
+}
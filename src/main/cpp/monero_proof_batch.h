@@ -0,0 +1,133 @@
+/**
+ * Copyright (c) 2017-2019 woodser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef monero_proof_batch_h
+#define monero_proof_batch_h
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "wallet/monero_wallet.h"
+
+/**
+ * Network and daemon to check proofs against, copied from a wallet so batch
+ * checks run without it.
+ */
+struct monero_proof_context {
+  monero::monero_network_type m_network_type;
+  std::string m_daemon_uri;
+  std::string m_daemon_username;
+  std::string m_daemon_password;
+};
+
+/**
+ * Reserve proof to check in a batch.
+ */
+struct monero_reserve_proof_request {
+  std::string m_address;
+  std::string m_message;
+  std::string m_signature;
+};
+
+/**
+ * Tx key, tx proof, or spend proof to check in a batch.
+ */
+struct monero_tx_proof_request {
+  std::string m_tx_hash;
+  std::string m_address;    // empty for spend proofs
+  std::string m_message;    // empty for tx keys
+  std::string m_signature;  // the tx key for tx keys
+};
+
+/**
+ * Invoked on the calling thread as proofs in a batch are checked.
+ *
+ * @param num_done is the number of proofs checked
+ * @param num_total is the number of proofs in the batch
+ */
+typedef std::function<void(size_t num_done, size_t num_total)> monero_proof_progress_fn;
+
+/**
+ * Check reserve proofs over a bounded number of worker threads.
+ *
+ * Proofs are checked as wallet2 checks them but without a wallet: the txs
+ * and key images of all proofs are fetched in batches over one daemon
+ * connection per worker, then every output of every proof is checked as its
+ * own task so one large proof is spread over all workers.  A proof which
+ * cannot be checked yields a result which is not good instead of failing
+ * the batch, but the batch fails if the daemon cannot be queried.
+ *
+ * @param context is the network and daemon to check the proofs against
+ * @param requests are the proofs to check
+ * @param max_threads is the maximum number of worker threads (0 for hardware concurrency)
+ * @param on_progress is invoked on the calling thread as proofs are checked (optional)
+ * @return a result per proof in the order given
+ */
+std::vector<std::shared_ptr<monero::monero_check_reserve>> check_reserve_proofs(const monero_proof_context& context, const std::vector<monero_reserve_proof_request>& requests, size_t max_threads, const monero_proof_progress_fn& on_progress);
+
+/**
+ * Check tx keys over a bounded number of worker threads.
+ *
+ * Tx keys are checked as wallet2 checks them but without a wallet: the txs
+ * of all requests are fetched in batches over one daemon connection per
+ * worker, then each tx key is checked as its own task.
+ *
+ * @param context is the network and daemon to check the tx keys against
+ * @param requests are the tx hashes, tx keys, and addresses to check
+ * @param max_threads is the maximum number of worker threads (0 for hardware concurrency)
+ * @return a result per tx key in the order given, not good if it cannot be checked
+ * @throws runtime_error if the daemon cannot be queried
+ */
+std::vector<std::shared_ptr<monero::monero_check_tx>> check_tx_keys(const monero_proof_context& context, const std::vector<monero_tx_proof_request>& requests, size_t max_threads);
+
+/**
+ * Check tx proofs over a bounded number of worker threads.
+ *
+ * Tx proofs are checked as wallet2 checks them but without a wallet, with
+ * the txs of all requests fetched together as for check_tx_keys().
+ *
+ * @param context is the network and daemon to check the tx proofs against
+ * @param requests are the tx hashes, addresses, messages, and signatures to check
+ * @param max_threads is the maximum number of worker threads (0 for hardware concurrency)
+ * @return a result per tx proof in the order given, not good if it cannot be checked
+ * @throws runtime_error if the daemon cannot be queried
+ */
+std::vector<std::shared_ptr<monero::monero_check_tx>> check_tx_proofs(const monero_proof_context& context, const std::vector<monero_tx_proof_request>& requests, size_t max_threads);
+
+/**
+ * Check spend proofs over a bounded number of worker threads.
+ *
+ * Spend proofs are checked as wallet2 checks them but without a wallet: the
+ * txs of all requests and then the ring members of all their inputs are
+ * fetched in batches, then the ring of each input is checked as its own
+ * task.
+ *
+ * @param context is the network and daemon to check the spend proofs against
+ * @param requests are the tx hashes, messages, and signatures to check
+ * @param max_threads is the maximum number of worker threads (0 for hardware concurrency)
+ * @return true for each spend proof in the order given which is good, false otherwise
+ * @throws runtime_error if the daemon cannot be queried
+ */
+std::vector<bool> check_spend_proofs(const monero_proof_context& context, const std::vector<monero_tx_proof_request>& requests, size_t max_threads);
+
+#endif /* monero_proof_batch_h */
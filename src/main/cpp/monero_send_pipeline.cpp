@@ -0,0 +1,298 @@
+/**
+ * Copyright (c) 2017-2019 woodser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <algorithm>
+#include "monero_send_pipeline.h"
+
+using namespace std;
+using namespace monero;
+
+static bool is_finished(const monero_send_pipeline::result& result) {
+  return result.m_state == "relayed" || result.m_state == "failed";
+}
+
+monero_send_pipeline::monero_send_pipeline(monero_wallet* wallet, shared_ptr<recursive_mutex> wallet_mutex, monero_wallet* signer, shared_ptr<recursive_mutex> signer_mutex, relay_function relay, size_t max_relay_batch) : m_wallet(wallet), m_wallet_mutex(wallet_mutex), m_signer(signer), m_signer_mutex(signer_mutex), m_relay(relay), m_max_relay_batch(max_relay_batch == 0 ? 1 : max_relay_batch), m_stopped(false), m_next_id(0) {
+  if (m_wallet_mutex == nullptr || (m_signer != nullptr && m_signer_mutex == nullptr)) throw runtime_error("Send pipeline needs the mutex of each wallet it uses");
+  m_prepare_stats = stage_stats{"prepare", 0, 0, 0, 0, 0};
+  m_sign_stats = stage_stats{"sign", 0, 0, 0, 0, 0};
+  m_relay_stats = stage_stats{"relay", 0, 0, 0, 0, 0};
+  m_threads.push_back(thread(&monero_send_pipeline::prepare_loop, this));
+  if (m_signer != nullptr) m_threads.push_back(thread(&monero_send_pipeline::sign_loop, this));
+  m_threads.push_back(thread(&monero_send_pipeline::relay_loop, this));
+}
+
+monero_send_pipeline::~monero_send_pipeline() {
+  stop();
+}
+
+uint64_t monero_send_pipeline::submit(shared_ptr<monero_send_request> request) {
+  request->m_do_not_relay = true;  // relay is its own stage
+  shared_ptr<ticket> tkt = make_shared<ticket>();
+  tkt->m_request = request;
+  tkt->m_exclusive = m_signer != nullptr;
+  {
+    lock_guard<mutex> lock(m_mutex);
+    if (m_stopped) throw runtime_error("Send pipeline is stopped");
+    tkt->m_result.m_id = m_next_id++;
+    tkt->m_result.m_state = "queued";
+    m_tickets[tkt->m_result.m_id] = tkt;
+  }
+  push(m_prepare_queue, tkt);
+  return tkt->m_result.m_id;
+}
+
+bool monero_send_pipeline::get_result(uint64_t id, bool wait, result& result) {
+  unique_lock<mutex> lock(m_mutex);
+  auto iter = m_tickets.find(id);
+  if (iter == m_tickets.end()) return false;
+  shared_ptr<ticket> tkt = iter->second;
+  if (wait) m_cv.wait(lock, [&]() { return is_finished(tkt->m_result); });
+  result = tkt->m_result;
+  if (is_finished(result)) m_tickets.erase(id);
+  return true;
+}
+
+vector<monero_send_pipeline::stage_stats> monero_send_pipeline::get_stats() {
+  lock_guard<mutex> lock(m_mutex);
+  vector<stage_stats> stats;
+  stats.push_back(m_prepare_stats);
+  stats.back().m_queue_depth = m_prepare_queue.size();
+  if (m_signer != nullptr) {
+    stats.push_back(m_sign_stats);
+    stats.back().m_queue_depth = m_sign_queue.size();
+  }
+  stats.push_back(m_relay_stats);
+  stats.back().m_queue_depth = m_relay_queue.size();
+  return stats;
+}
+
+void monero_send_pipeline::stop() {
+  {
+    lock_guard<mutex> lock(m_mutex);
+    if (m_stopped) return;
+    m_stopped = true;
+    m_cv.notify_all();
+  }
+  for (thread& worker : m_threads) worker.join();
+  m_threads.clear();
+
+  // fail requests which did not finish
+  lock_guard<mutex> lock(m_mutex);
+  for (auto& entry : m_tickets) {
+    if (is_finished(entry.second->m_result)) continue;
+    entry.second->m_result.m_state = "failed";
+    entry.second->m_result.m_error = "Send pipeline stopped";
+  }
+  m_prepare_queue.clear();
+  m_sign_queue.clear();
+  m_relay_queue.clear();
+  m_cv.notify_all();
+}
+
+// ------------------------------- PRIVATE HELPERS ----------------------------
+
+void monero_send_pipeline::prepare_loop() {
+  shared_ptr<ticket> tkt;
+  while (pop_prepare(tkt)) {
+    try {
+      monero_tx_set tx_set;
+      {
+        lock_guard<recursive_mutex> lock(*m_wallet_mutex);
+        tx_set = m_wallet->send_split(*tkt->m_request);
+      }
+      if (!reserve(tkt, tx_set)) continue;
+      bool needs_signer = tx_set.m_unsigned_tx_hex != boost::none && m_signer != nullptr;
+      finish(m_prepare_stats, tkt, "prepared", "");
+      push(needs_signer ? m_sign_queue : m_relay_queue, tkt);
+    } catch (const exception& e) {
+      finish(m_prepare_stats, tkt, "failed", e.what());
+    }
+  }
+}
+
+void monero_send_pipeline::sign_loop() {
+  vector<shared_ptr<ticket>> tickets;
+  while (pop(m_sign_queue, 1, tickets)) {
+    shared_ptr<ticket> tkt = tickets[0];
+    try {
+      lock_guard<recursive_mutex> lock(*m_signer_mutex);
+      tkt->m_signed_tx_hex = m_signer->sign_txs(tkt->m_result.m_tx_set.m_unsigned_tx_hex.get());
+      finish(m_sign_stats, tkt, "signed", "");
+      push(m_relay_queue, tkt);
+    } catch (const exception& e) {
+      finish(m_sign_stats, tkt, "failed", e.what());
+    }
+  }
+}
+
+void monero_send_pipeline::relay_loop() {
+  vector<shared_ptr<ticket>> tickets;
+  while (pop(m_relay_queue, m_max_relay_batch, tickets)) relay(tickets);
+}
+
+void monero_send_pipeline::relay(const vector<shared_ptr<ticket>>& tickets) {
+
+  // submit tx sets signed by the signer and collect metadata of the rest
+  vector<shared_ptr<ticket>> batch;
+  vector<string> tx_metadatas;
+  for (const shared_ptr<ticket>& tkt : tickets) {
+    if (!tkt->m_signed_tx_hex.empty()) {
+      try {
+        vector<string> tx_hashes;
+        {
+          lock_guard<recursive_mutex> lock(*m_wallet_mutex);
+          tx_hashes = m_wallet->submit_txs(tkt->m_signed_tx_hex);
+        }
+        {
+          lock_guard<mutex> lock(m_mutex);
+          tkt->m_result.m_tx_hashes = tx_hashes;
+        }
+        finish(m_relay_stats, tkt, "relayed", "");
+      } catch (const exception& e) {
+        finish(m_relay_stats, tkt, "failed", e.what());
+      }
+      continue;
+    }
+    bool has_metadata = !tkt->m_result.m_tx_set.m_txs.empty();
+    for (const shared_ptr<monero_tx_wallet>& tx : tkt->m_result.m_tx_set.m_txs) {
+      if (tx->m_metadata == boost::none) has_metadata = false;
+    }
+    if (!has_metadata) {
+      finish(m_relay_stats, tkt, "failed", "Tx set has no relayable txs; a view-only wallet needs a signer");
+      continue;
+    }
+    for (const shared_ptr<monero_tx_wallet>& tx : tkt->m_result.m_tx_set.m_txs) tx_metadatas.push_back(tx->m_metadata.get());
+    batch.push_back(tkt);
+  }
+  if (batch.empty()) return;
+
+  // relay the batch, submitting in parallel if the wallet is proxied
+  vector<monero_relay_result> results;
+  try {
+    lock_guard<recursive_mutex> lock(*m_wallet_mutex);
+    results = m_relay(tx_metadatas);
+  } catch (const exception& e) {
+    for (const shared_ptr<ticket>& tkt : batch) finish(m_relay_stats, tkt, "failed", e.what());
+    return;
+  }
+
+  // a request is relayed if all of its txs are relayed
+  size_t offset = 0;
+  for (const shared_ptr<ticket>& tkt : batch) {
+    vector<string> tx_hashes;
+    string error;
+    for (size_t i = offset; i < offset + tkt->m_result.m_tx_set.m_txs.size(); i++) {
+      if (results[i].m_error.empty()) tx_hashes.push_back(results[i].m_tx_hash);
+      else if (error.empty()) error = results[i].m_error;
+    }
+    offset += tkt->m_result.m_tx_set.m_txs.size();
+    {
+      lock_guard<mutex> lock(m_mutex);
+      tkt->m_result.m_tx_hashes = tx_hashes;
+    }
+    finish(m_relay_stats, tkt, error.empty() ? "relayed" : "failed", error);
+  }
+}
+
+bool monero_send_pipeline::pop_prepare(shared_ptr<ticket>& tkt) {
+  unique_lock<mutex> lock(m_mutex);
+  auto next = m_prepare_queue.end();
+  m_cv.wait(lock, [&]() {
+    if (m_stopped) return true;
+
+    // take the first request which can be prepared, keeping each account's requests in order
+    set<uint32_t> waiting_accounts;
+    for (next = m_prepare_queue.begin(); next != m_prepare_queue.end(); next++) {
+      uint32_t account_idx = (*next)->get_account_index();
+      if (waiting_accounts.count(account_idx)) continue;
+      if (!(*next)->m_exclusive || m_accounts_in_flight[account_idx] == 0) return true;
+      waiting_accounts.insert(account_idx);
+    }
+    return false;
+  });
+  if (m_stopped) return false;
+  tkt = *next;
+  m_prepare_queue.erase(next);
+  m_accounts_in_flight[tkt->get_account_index()]++;
+  return true;
+}
+
+bool monero_send_pipeline::reserve(const shared_ptr<ticket>& tkt, const monero_tx_set& tx_set) {
+
+  // collect key images spent by the tx set
+  vector<string> key_images;
+  bool has_key_images = !tx_set.m_txs.empty();
+  for (const shared_ptr<monero_tx_wallet>& tx : tx_set.m_txs) {
+    if (tx->m_metadata == boost::none || !get_tx_metadata_key_images(tx->m_metadata.get(), key_images)) has_key_images = false;
+  }
+
+  // prepare again once the account drains if inputs may be spent by a request in flight
+  lock_guard<mutex> lock(m_mutex);
+  bool conflicts = !tkt->m_exclusive && (has_key_images ? any_of(key_images.begin(), key_images.end(), [&](const string& key_image) { return m_reserved_key_images.count(key_image) > 0; }) : m_accounts_in_flight[tkt->get_account_index()] > 1);
+  if (conflicts) {
+    m_accounts_in_flight[tkt->get_account_index()]--;
+    tkt->m_exclusive = true;
+    m_prepare_queue.push_front(tkt);
+    m_cv.notify_all();
+    return false;
+  }
+  m_reserved_key_images.insert(key_images.begin(), key_images.end());
+  tkt->m_key_images = key_images;
+  tkt->m_result.m_tx_set = tx_set;
+  return true;
+}
+
+bool monero_send_pipeline::pop(deque<shared_ptr<ticket>>& queue, size_t max, vector<shared_ptr<ticket>>& tickets) {
+  unique_lock<mutex> lock(m_mutex);
+  m_cv.wait(lock, [&]() { return m_stopped || !queue.empty(); });
+  if (m_stopped) return false;
+  tickets.clear();
+  while (!queue.empty() && tickets.size() < max) {
+    tickets.push_back(queue.front());
+    queue.pop_front();
+  }
+  return true;
+}
+
+void monero_send_pipeline::push(deque<shared_ptr<ticket>>& queue, const shared_ptr<ticket>& tkt) {
+  lock_guard<mutex> lock(m_mutex);
+  tkt->m_enqueued = chrono::steady_clock::now();
+  queue.push_back(tkt);
+  m_cv.notify_all();
+}
+
+void monero_send_pipeline::finish(stage_stats& stats, const shared_ptr<ticket>& tkt, const string& state, const string& error) {
+  uint64_t latency_us = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - tkt->m_enqueued).count();
+  lock_guard<mutex> lock(m_mutex);
+  stats.m_num_processed++;
+  if (state == "failed") stats.m_num_failed++;
+  stats.m_total_latency_us += latency_us;
+  if (latency_us > stats.m_max_latency_us) stats.m_max_latency_us = latency_us;
+  tkt->m_result.m_state = state;
+  tkt->m_result.m_error = error;
+  if (is_finished(tkt->m_result)) {
+    m_accounts_in_flight[tkt->get_account_index()]--;
+    for (const string& key_image : tkt->m_key_images) m_reserved_key_images.erase(key_image);
+    tkt->m_key_images.clear();
+  }
+  m_cv.notify_all();
+}
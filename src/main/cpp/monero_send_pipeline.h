@@ -0,0 +1,174 @@
+/**
+ * Copyright (c) 2017-2019 woodser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef monero_send_pipeline_h
+#define monero_send_pipeline_h
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include "wallet/monero_wallet.h"
+#include "monero_batch_relay.h"
+
+/**
+ * Queue of send requests which are prepared, signed, and relayed in
+ * overlapped stages with one worker thread per stage.
+ *
+ * Tx sets stay in native memory between stages and relays are batched so
+ * they can be submitted to the daemon in parallel (see
+ * relay_txs_parallel()).  The
+ * prepare and relay stages lock the wallet's mutex, which JNI calls on the
+ * wallet share, so wallet2 is used by one thread at a time.  The sign stage
+ * locks a separate signer wallet (e.g. the offline counterpart of a view-only
+ * wallet) and overlaps with both.
+ *
+ * wallet2 only marks inputs spent when a tx is relayed, so the key images of
+ * prepared txs are reserved until their request finishes.  A request
+ * prepared while an earlier request from its account is in flight is
+ * prepared again once the account drains if it spends a reserved key image,
+ * otherwise it proceeds, so preparing request N+1 overlaps relaying request
+ * N.  Unsigned tx sets of a view-only wallet have no key images, so with a
+ * signer requests from the same account are prepared one at a time.
+ *
+ * The pipeline must outlive callers blocked in get_result(): stop() fails
+ * and wakes them, then the owner waits for them to return before deleting.
+ */
+class monero_send_pipeline {
+public:
+
+  /**
+   * Relays tx metadata with a result per tx, called with the wallet's mutex held.
+   */
+  typedef std::function<std::vector<monero_relay_result>(const std::vector<std::string>& tx_metadatas)> relay_function;
+
+  /**
+   * Result of a request submitted to the pipeline.
+   */
+  struct result {
+    uint64_t m_id;
+    std::string m_state;  // queued, prepared, signed, relayed, or failed
+    monero::monero_tx_set m_tx_set;
+    std::vector<std::string> m_tx_hashes;
+    std::string m_error;
+  };
+
+  /**
+   * Queue depth and latency of a pipeline stage.
+   */
+  struct stage_stats {
+    std::string m_name;
+    uint64_t m_queue_depth;
+    uint64_t m_num_processed;
+    uint64_t m_num_failed;
+    uint64_t m_total_latency_us;
+    uint64_t m_max_latency_us;
+  };
+
+  /**
+   * Start the pipeline's worker threads.
+   *
+   * @param wallet prepares and relays txs
+   * @param wallet_mutex is locked while the pipeline uses the wallet
+   * @param signer signs txs prepared by a view-only wallet (nullptr if the wallet signs)
+   * @param signer_mutex is locked while the pipeline uses the signer (nullptr if no signer)
+   * @param relay relays the wallet's txs (e.g. with relay_txs_parallel())
+   * @param max_relay_batch is the maximum number of requests relayed at once
+   */
+  monero_send_pipeline(monero::monero_wallet* wallet, std::shared_ptr<std::recursive_mutex> wallet_mutex, monero::monero_wallet* signer, std::shared_ptr<std::recursive_mutex> signer_mutex, relay_function relay, size_t max_relay_batch);
+  ~monero_send_pipeline();
+
+  /**
+   * Queue a send request.  The request is never relayed by the prepare stage.
+   *
+   * @return the id to get the request's result
+   */
+  uint64_t submit(std::shared_ptr<monero::monero_send_request> request);
+
+  /**
+   * Get the result of a submitted request.  Finished results are removed
+   * from the pipeline once returned.
+   *
+   * @param id is the id returned by submit()
+   * @param wait specifies if the call blocks until the request is relayed or fails
+   * @param result is assigned the request's result
+   * @return true if the id is known, false otherwise
+   */
+  bool get_result(uint64_t id, bool wait, result& result);
+
+  std::vector<stage_stats> get_stats();
+
+  /**
+   * Stop the worker threads.  Unfinished requests are failed and callers
+   * waiting on their results are woken.
+   */
+  void stop();
+
+private:
+  struct ticket {
+    result m_result;
+    std::shared_ptr<monero::monero_send_request> m_request;
+    std::string m_signed_tx_hex;
+    std::chrono::steady_clock::time_point m_enqueued;
+    std::vector<std::string> m_key_images;  // reserved while in flight
+    bool m_exclusive = false;               // prepare once no other request from the account is in flight
+    uint32_t get_account_index() const { return m_request->m_account_index == boost::none ? 0 : m_request->m_account_index.get(); }
+  };
+
+  monero::monero_wallet* m_wallet;
+  std::shared_ptr<std::recursive_mutex> m_wallet_mutex;
+  monero::monero_wallet* m_signer;
+  std::shared_ptr<std::recursive_mutex> m_signer_mutex;
+  relay_function m_relay;
+  size_t m_max_relay_batch;
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  bool m_stopped;
+  uint64_t m_next_id;
+  std::map<uint64_t, std::shared_ptr<ticket>> m_tickets;
+  std::deque<std::shared_ptr<ticket>> m_prepare_queue;
+  std::deque<std::shared_ptr<ticket>> m_sign_queue;
+  std::deque<std::shared_ptr<ticket>> m_relay_queue;
+  std::map<uint32_t, size_t> m_accounts_in_flight;
+  std::set<std::string> m_reserved_key_images;
+  stage_stats m_prepare_stats;
+  stage_stats m_sign_stats;
+  stage_stats m_relay_stats;
+  std::vector<std::thread> m_threads;
+
+  bool pop_prepare(std::shared_ptr<ticket>& tkt);
+  bool reserve(const std::shared_ptr<ticket>& tkt, const monero::monero_tx_set& tx_set);
+  void prepare_loop();
+  void sign_loop();
+  void relay_loop();
+  bool pop(std::deque<std::shared_ptr<ticket>>& queue, size_t max, std::vector<std::shared_ptr<ticket>>& tickets);
+  void push(std::deque<std::shared_ptr<ticket>>& queue, const std::shared_ptr<ticket>& tkt);
+  void finish(stage_stats& stats, const std::shared_ptr<ticket>& tkt, const std::string& state, const std::string& error);
+  void relay(const std::vector<std::shared_ptr<ticket>>& tickets);
+};
+
+#endif /* monero_send_pipeline_h */
@@ -0,0 +1,73 @@
+/**
+ * Copyright (c) 2017-2019 woodser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "monero_subaddress_deriver.h"
+#include "monero_parallel.h"
+#include <stdexcept>
+#include "cryptonote_basic/cryptonote_basic_impl.h"
+#include "device/device.hpp"
+#include "ringct/rctOps.h"
+#include "string_tools.h"
+
+using namespace std;
+
+monero_subaddress_deriver::monero_subaddress_deriver(cryptonote::network_type network_type, const string& primary_address, const string& private_view_key) : m_network_type(network_type) {
+  cryptonote::address_parse_info info;
+  if (!cryptonote::get_account_address_from_str(info, network_type, primary_address) || info.is_subaddress) throw runtime_error("Invalid primary address: " + primary_address);
+  if (!epee::string_tools::hex_to_pod(private_view_key, m_keys.m_view_secret_key)) throw runtime_error("Invalid private view key");
+  m_keys.m_account_address = info.address;
+}
+
+vector<crypto::public_key> monero_subaddress_deriver::derive_spend_keys(uint32_t account_idx, uint32_t start, uint32_t end, size_t max_threads) const {
+  if (end < start) throw runtime_error("Subaddress range end must not precede its start");
+
+  // derive chunks of the range in parallel, each reusing the device's precomputation for its account
+  vector<crypto::public_key> spend_keys(end - start);
+  size_t num_chunks = (spend_keys.size() + CHUNK_SIZE - 1) / CHUNK_SIZE;
+  monero_parallel_for(num_chunks, max_threads, [&](size_t chunk_idx) {
+    uint32_t chunk_start = start + chunk_idx * CHUNK_SIZE;
+    uint32_t chunk_end = min(end, chunk_start + CHUNK_SIZE);
+    vector<crypto::public_key> chunk = hw::get_device("default").get_subaddress_spend_public_keys(m_keys, account_idx, chunk_start, chunk_end);
+    copy(chunk.begin(), chunk.end(), spend_keys.begin() + (chunk_start - start));
+  });
+
+  // the first subaddress of the first account is the primary address
+  if (account_idx == 0 && start == 0 && end > 0) spend_keys[0] = m_keys.m_account_address.m_spend_public_key;
+  return spend_keys;
+}
+
+vector<string> monero_subaddress_deriver::derive_addresses(uint32_t account_idx, uint32_t start, uint32_t end, size_t max_threads) const {
+  vector<crypto::public_key> spend_keys = derive_spend_keys(account_idx, start, end, max_threads);
+  vector<string> addresses(spend_keys.size());
+  monero_parallel_for(spend_keys.size(), max_threads, [&](size_t i) {
+    bool is_primary = account_idx == 0 && start + i == 0;
+    if (is_primary) {
+      addresses[i] = cryptonote::get_account_address_as_str(m_network_type, false, m_keys.m_account_address);
+    } else {
+      cryptonote::account_public_address address;
+      address.m_spend_public_key = spend_keys[i];
+      address.m_view_public_key = rct::rct2pk(rct::scalarmultKey(rct::pk2rct(spend_keys[i]), rct::sk2rct(m_keys.m_view_secret_key)));
+      addresses[i] = cryptonote::get_account_address_as_str(m_network_type, true, address);
+    }
+  });
+  return addresses;
+}
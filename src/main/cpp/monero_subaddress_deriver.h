@@ -0,0 +1,76 @@
+/**
+ * Copyright (c) 2017-2019 woodser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef monero_subaddress_deriver_h
+#define monero_subaddress_deriver_h
+
+#include <string>
+#include <vector>
+#include "cryptonote_basic/account.h"
+
+/**
+ * Derives subaddresses from a wallet's view key and primary address without
+ * going through the wallet, so ranges of subaddresses can be derived in bulk
+ * and across cores.
+ */
+class monero_subaddress_deriver {
+public:
+
+  /**
+   * Construct a deriver for a wallet.
+   *
+   * @param network_type is the network type of the wallet
+   * @param primary_address is the wallet's primary address
+   * @param private_view_key is the wallet's hex private view key
+   */
+  monero_subaddress_deriver(cryptonote::network_type network_type, const std::string& primary_address, const std::string& private_view_key);
+
+  /**
+   * Derive the spend public keys of subaddresses [start, end) of an account.
+   *
+   * @param account_idx is the index of the account
+   * @param start is the first subaddress index to derive
+   * @param end is one past the last subaddress index to derive
+   * @param max_threads is the maximum number of threads (0 for hardware concurrency)
+   * @return the spend public key of each subaddress in order
+   */
+  std::vector<crypto::public_key> derive_spend_keys(uint32_t account_idx, uint32_t start, uint32_t end, size_t max_threads) const;
+
+  /**
+   * Derive the addresses of subaddresses [start, end) of an account.
+   *
+   * @param account_idx is the index of the account
+   * @param start is the first subaddress index to derive
+   * @param end is one past the last subaddress index to derive
+   * @param max_threads is the maximum number of threads (0 for hardware concurrency)
+   * @return the address of each subaddress in order
+   */
+  std::vector<std::string> derive_addresses(uint32_t account_idx, uint32_t start, uint32_t end, size_t max_threads) const;
+
+private:
+  cryptonote::network_type m_network_type;
+  cryptonote::account_keys m_keys;
+
+  static const uint32_t CHUNK_SIZE = 256;  // subaddresses derived per task
+};
+
+#endif /* monero_subaddress_deriver_h */
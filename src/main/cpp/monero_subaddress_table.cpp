@@ -0,0 +1,89 @@
+/**
+ * Copyright (c) 2017-2019 woodser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "monero_subaddress_table.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include "cryptonote_basic/cryptonote_basic_impl.h"
+
+using namespace std;
+
+namespace {
+  bool is_key_less(const monero_subaddress_table::entry& entry, const crypto::public_key& spend_key) {
+    return memcmp(&entry.m_spend_key, &spend_key, sizeof(crypto::public_key)) < 0;
+  }
+}
+
+monero_subaddress_table::monero_subaddress_table(const monero_subaddress_deriver& deriver, uint32_t num_accounts, uint32_t num_subaddresses, size_t max_threads) {
+  if ((uint64_t) num_accounts * num_subaddresses > UINT32_MAX) throw runtime_error("Subaddress table is too large");
+
+  // derive the spend key of each subaddress
+  m_entries.reserve((size_t) num_accounts * num_subaddresses);
+  for (uint32_t account_idx = 0; account_idx < num_accounts; account_idx++) {
+    vector<crypto::public_key> spend_keys = deriver.derive_spend_keys(account_idx, 0, num_subaddresses, max_threads);
+    for (uint32_t subaddress_idx = 0; subaddress_idx < num_subaddresses; subaddress_idx++) {
+      m_entries.push_back(entry{spend_keys[subaddress_idx], account_idx, subaddress_idx});
+    }
+  }
+
+  // sort by spend key and index the first entry of each two byte prefix
+  sort(m_entries.begin(), m_entries.end(), [](const entry& a, const entry& b) { return is_key_less(a, b.m_spend_key); });
+  m_offsets.assign(65537, 0);
+  for (const entry& entry : m_entries) m_offsets[get_prefix(entry.m_spend_key) + 1]++;
+  for (size_t i = 1; i < m_offsets.size(); i++) m_offsets[i] += m_offsets[i - 1];
+}
+
+const monero_subaddress_table::entry* monero_subaddress_table::find(const crypto::public_key& spend_key) const {
+  uint16_t prefix = get_prefix(spend_key);
+  auto begin = m_entries.begin() + m_offsets[prefix];
+  auto end = m_entries.begin() + m_offsets[prefix + 1];
+  auto iter = lower_bound(begin, end, spend_key, is_key_less);
+  if (iter == end || memcmp(&iter->m_spend_key, &spend_key, sizeof(crypto::public_key)) != 0) return nullptr;
+  return &*iter;
+}
+
+vector<int32_t> monero_subaddress_table::find_addresses(cryptonote::network_type network_type, const vector<string>& addresses) const {
+  vector<int32_t> indices(addresses.size() * 2, -1);
+  for (size_t i = 0; i < addresses.size(); i++) {
+    cryptonote::address_parse_info info;
+    if (!cryptonote::get_account_address_from_str(info, network_type, addresses[i])) continue;
+    const entry* found = find(info.address.m_spend_public_key);
+    if (found == nullptr) continue;
+    bool is_primary = found->m_account_idx == 0 && found->m_subaddress_idx == 0;
+    if (is_primary == info.is_subaddress) continue; // a subaddress can't be encoded as a standard address or vice versa
+    indices[i * 2] = found->m_account_idx;
+    indices[i * 2 + 1] = found->m_subaddress_idx;
+  }
+  return indices;
+}
+
+size_t monero_subaddress_table::get_memory_size() const {
+  return sizeof(*this) + m_entries.capacity() * sizeof(entry) + m_offsets.capacity() * sizeof(uint32_t);
+}
+
+// ------------------------------- PRIVATE HELPERS ----------------------------
+
+uint16_t monero_subaddress_table::get_prefix(const crypto::public_key& spend_key) {
+  const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&spend_key);
+  return (uint16_t) ((bytes[0] << 8) | bytes[1]);
+}
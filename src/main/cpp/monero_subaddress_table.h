@@ -0,0 +1,92 @@
+/**
+ * Copyright (c) 2017-2019 woodser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef monero_subaddress_table_h
+#define monero_subaddress_table_h
+
+#include <cstdint>
+#include <vector>
+#include "monero_subaddress_deriver.h"
+
+/**
+ * Compact reverse lookup from subaddress spend public key to subaddress
+ * index.
+ *
+ * Entries are stored in one flat array sorted by spend key, with a table of
+ * offsets by the first two bytes of the key, so a lookup is one offset read
+ * and a binary search over a few entries instead of chasing hash nodes.  The
+ * table covers an explicit number of accounts and subaddresses per account.
+ */
+class monero_subaddress_table {
+public:
+
+  /**
+   * Subaddress index of a spend key.
+   */
+  struct entry {
+    crypto::public_key m_spend_key;
+    uint32_t m_account_idx;
+    uint32_t m_subaddress_idx;
+  };
+
+  /**
+   * Build a table of subaddresses [0, num_subaddresses) of accounts [0, num_accounts).
+   *
+   * @param deriver derives the spend keys of the wallet's subaddresses
+   * @param num_accounts is the number of accounts to cover
+   * @param num_subaddresses is the number of subaddresses to cover per account
+   * @param max_threads is the maximum number of threads deriving keys (0 for hardware concurrency)
+   */
+  monero_subaddress_table(const monero_subaddress_deriver& deriver, uint32_t num_accounts, uint32_t num_subaddresses, size_t max_threads);
+
+  /**
+   * Look up the subaddress index of a spend key.
+   *
+   * @param spend_key is the spend public key to look up
+   * @return the entry of the spend key or nullptr if not in the table
+   */
+  const entry* find(const crypto::public_key& spend_key) const;
+
+  /**
+   * Look up the subaddress indices of addresses.
+   *
+   * @param network_type is the network type of the addresses
+   * @param addresses are the addresses to look up
+   * @return the account and subaddress index of each address in order, -1 for each if not found or invalid
+   */
+  std::vector<int32_t> find_addresses(cryptonote::network_type network_type, const std::vector<std::string>& addresses) const;
+
+  size_t size() const { return m_entries.size(); }
+
+  /**
+   * Get the approximate number of bytes used by the table.
+   */
+  size_t get_memory_size() const;
+
+private:
+  std::vector<entry> m_entries;       // sorted by spend key
+  std::vector<uint32_t> m_offsets;    // first entry by the first two bytes of the spend key, plus the end
+
+  static uint16_t get_prefix(const crypto::public_key& spend_key);
+};
+
+#endif /* monero_subaddress_table_h */
@@ -0,0 +1,84 @@
+/**
+ * Copyright (c) 2017-2019 woodser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "monero_sync_loop.h"
+#include <exception>
+#include "misc_log_ex.h"
+
+using namespace std;
+
+monero_sync_loop::monero_sync_loop(function<void()> sync, chrono::milliseconds period) : m_sync(sync), m_period(period), m_is_started(false), m_is_closed(false), m_num_starts(0) {
+  m_thread = thread([this]() { run(); });
+}
+
+monero_sync_loop::~monero_sync_loop() {
+  {
+    lock_guard<mutex> lock(m_mutex);
+    m_is_closed = true;
+    m_cv.notify_all();
+  }
+  m_thread.join();
+}
+
+void monero_sync_loop::start() {
+  lock_guard<mutex> lock(m_mutex);
+  if (m_is_started) return;
+  m_is_started = true;
+  m_num_starts++;
+  m_cv.notify_all();
+}
+
+void monero_sync_loop::stop() {
+  lock_guard<mutex> lock(m_mutex);
+  m_is_started = false;
+  m_cv.notify_all();
+}
+
+bool monero_sync_loop::is_started() {
+  lock_guard<mutex> lock(m_mutex);
+  return m_is_started;
+}
+
+// ------------------------------- PRIVATE HELPERS ----------------------------
+
+void monero_sync_loop::run() {
+  unique_lock<mutex> lock(m_mutex);
+  while (true) {
+    m_cv.wait(lock, [this]() { return m_is_closed || m_is_started; });
+    if (m_is_closed) return;
+
+    // sync without holding the loop's mutex so it can be stopped meanwhile
+    lock.unlock();
+    try {
+      m_sync();
+    } catch (const exception& e) {
+      MERROR("Background sync failed: " << e.what());
+    } catch (...) {
+      MERROR("Background sync failed");
+    }
+    lock.lock();
+
+    // wait out the period unless stopped, restarted, or closed
+    uint64_t num_starts = m_num_starts;
+    m_cv.wait_for(lock, m_period, [this, num_starts]() { return m_is_closed || !m_is_started || m_num_starts != num_starts; });
+  }
+}
@@ -0,0 +1,83 @@
+/**
+ * Copyright (c) 2017-2019 woodser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef monero_sync_loop_h
+#define monero_sync_loop_h
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/**
+ * Syncs a wallet from a background thread while started.
+ *
+ * Replaces the wallet's own background sync so each sync can lock the
+ * wallet's mutex, which JNI calls and the send pipeline share, instead of
+ * running while another thread uses wallet2.  A sync runs when started and
+ * then once per period until stopped.  Errors from a sync are logged and the
+ * next sync is tried after the period.
+ */
+class monero_sync_loop {
+public:
+
+  /**
+   * Create a stopped loop.
+   *
+   * @param sync syncs the wallet once, locking the wallet itself
+   * @param period is the time between the end of a sync and the next
+   */
+  monero_sync_loop(std::function<void()> sync, std::chrono::milliseconds period);
+
+  /**
+   * Stop and wait for a sync in progress to finish.  Must not be called from
+   * the sync itself, e.g. by a listener it notifies.
+   */
+  ~monero_sync_loop();
+
+  /**
+   * Start syncing, syncing once immediately unless a sync is in progress.
+   */
+  void start();
+
+  /**
+   * Stop syncing after the sync in progress, without waiting for it.
+   */
+  void stop();
+
+  bool is_started();
+
+private:
+  std::function<void()> m_sync;
+  std::chrono::milliseconds m_period;
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  bool m_is_started;
+  bool m_is_closed;
+  uint64_t m_num_starts;  // wakes a loop waiting out its period when restarted
+  std::thread m_thread;
+
+  void run();
+};
+
+#endif /* monero_sync_loop_h */
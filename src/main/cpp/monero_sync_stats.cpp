@@ -0,0 +1,139 @@
+/**
+ * Copyright (c) 2017-2019 woodser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "monero_sync_stats.h"
+#include <algorithm>
+
+using namespace std;
+
+static const char* STAGE_NAMES[monero_sync_stats::NUM_STAGES] = { "sync", "process", "fetchBlocks", "fetchPool", "checkKeyImages", "otherRequests", "onSyncProgress", "onNewBlock", "onOutputReceived", "onOutputSpent" };
+
+static uint64_t elapsed_us_since(chrono::steady_clock::time_point start) {
+  return chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+}
+
+monero_sync_stats::monero_sync_stats() {
+  reset();
+}
+
+void monero_sync_stats::on_sync_progress(uint64_t height, uint64_t start_height, uint64_t end_height, double percent_done, const string& message) {
+  lock_guard<mutex> lock(m_mutex);
+  m_snapshot.m_height = height;
+
+  // time background syncs, which start and end without a call through the bridge
+  if (m_is_syncing && !m_is_background_sync) return;
+  if (!m_is_syncing || start_height != m_sync_start_height) {
+    m_is_syncing = true;
+    m_is_background_sync = true;
+    m_sync_start_height = start_height;
+    m_sync_start = chrono::steady_clock::now();
+    m_sync_request_us = 0;
+  }
+  if (percent_done >= 1) add_sync(end_height > start_height ? end_height - start_height : 0);
+}
+
+void monero_sync_stats::on_new_block(uint64_t height) {
+  lock_guard<mutex> lock(m_mutex);
+  m_snapshot.m_height = height;
+  m_snapshot.m_num_blocks++;
+}
+
+void monero_sync_stats::on_output_received(const monero::monero_output_wallet& output) {
+  lock_guard<mutex> lock(m_mutex);
+  m_snapshot.m_num_outputs_received++;
+}
+
+void monero_sync_stats::on_output_spent(const monero::monero_output_wallet& output) {
+  lock_guard<mutex> lock(m_mutex);
+  m_snapshot.m_num_outputs_spent++;
+}
+
+void monero_sync_stats::record(stage s, uint64_t elapsed_us) {
+  lock_guard<mutex> lock(m_mutex);
+  add(s, elapsed_us);
+}
+
+void monero_sync_stats::record_request(const string& uri, uint64_t elapsed_us, uint64_t bytes_received) {
+  stage s = OTHER_REQUESTS;
+  if (uri == "/getblocks.bin" || uri == "/get_blocks.bin" || uri == "/gethashes.bin" || uri == "/get_hashes.bin" || uri == "/get_blocks_by_height.bin") s = FETCH_BLOCKS;
+  else if (uri == "/get_transaction_pool_hashes.bin" || uri == "/get_transaction_pool_hashes" || uri == "/gettransactions" || uri == "/get_transactions") s = FETCH_POOL;
+  else if (uri == "/is_key_image_spent") s = CHECK_KEY_IMAGES;
+  lock_guard<mutex> lock(m_mutex);
+  add(s, elapsed_us);
+  m_snapshot.m_bytes_downloaded += bytes_received;
+  if (m_is_syncing) m_sync_request_us += elapsed_us;
+}
+
+void monero_sync_stats::begin_sync() {
+  lock_guard<mutex> lock(m_mutex);
+  m_is_syncing = true;
+  m_is_background_sync = false;
+  m_sync_start = chrono::steady_clock::now();
+  m_sync_request_us = 0;
+}
+
+void monero_sync_stats::end_sync(uint64_t num_blocks_fetched) {
+  lock_guard<mutex> lock(m_mutex);
+  if (m_is_syncing && !m_is_background_sync) add_sync(num_blocks_fetched);
+}
+
+monero_sync_stats::snapshot monero_sync_stats::get_snapshot() {
+  lock_guard<mutex> lock(m_mutex);
+  snapshot snap = m_snapshot;
+  uint64_t sync_us = snap.m_stages[SYNC].m_total_us;
+  snap.m_blocks_per_second = sync_us == 0 ? 0 : snap.m_num_blocks_fetched * 1000000.0 / sync_us;
+  return snap;
+}
+
+void monero_sync_stats::reset() {
+  lock_guard<mutex> lock(m_mutex);
+  m_snapshot = snapshot();
+  m_snapshot.m_height = 0;
+  m_snapshot.m_num_blocks = 0;
+  m_snapshot.m_num_blocks_fetched = 0;
+  m_snapshot.m_num_outputs_received = 0;
+  m_snapshot.m_num_outputs_spent = 0;
+  m_snapshot.m_bytes_downloaded = 0;
+  m_snapshot.m_blocks_per_second = 0;
+  for (size_t i = 0; i < NUM_STAGES; i++) m_snapshot.m_stages.push_back({STAGE_NAMES[i], 0, 0, 0});
+  m_is_syncing = false;
+  m_is_background_sync = false;
+  m_sync_start_height = 0;
+  m_sync_request_us = 0;
+}
+
+void monero_sync_stats::add(stage s, uint64_t elapsed_us) {
+  stage_stats& stats = m_snapshot.m_stages[s];
+  stats.m_count++;
+  stats.m_total_us += elapsed_us;
+  if (elapsed_us > stats.m_max_us) stats.m_max_us = elapsed_us;
+}
+
+// records the sync being timed, whose time not waiting on the daemon is processing
+void monero_sync_stats::add_sync(uint64_t num_blocks_fetched) {
+  uint64_t sync_us = elapsed_us_since(m_sync_start);
+  add(SYNC, sync_us);
+  add(PROCESS, sync_us - min(sync_us, m_sync_request_us));
+  m_snapshot.m_num_blocks_fetched += num_blocks_fetched;
+  m_is_syncing = false;
+  m_is_background_sync = false;
+}
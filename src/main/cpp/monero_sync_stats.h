@@ -0,0 +1,174 @@
+/**
+ * Copyright (c) 2017-2019 woodser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef monero_sync_stats_h
+#define monero_sync_stats_h
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "wallet/monero_wallet.h"
+
+/**
+ * Collects timings and counters of a wallet's syncs.
+ *
+ * Registered as a listener to the wallet, it counts the blocks processed and
+ * outputs received and spent as wallet2 reports them.  Syncs called through
+ * the JNI bridge are timed from call to return and background syncs from
+ * their first to their last progress notification.  The bridge adds the time
+ * spent in each kind of upcall to Java listeners, and the output cache proxy,
+ * when the wallet connects through it, adds the time and bytes of each daemon
+ * request by kind.  Parsing and scanning overlap inside wallet2::refresh()
+ * and are timed together as the process stage: the time of each sync not
+ * spent waiting on the daemon.
+ */
+class monero_sync_stats : public monero::monero_wallet_listener {
+public:
+
+  /**
+   * Kinds of timed work.
+   */
+  enum stage {
+    SYNC,
+    PROCESS,
+    FETCH_BLOCKS,
+    FETCH_POOL,
+    CHECK_KEY_IMAGES,
+    OTHER_REQUESTS,
+    ON_SYNC_PROGRESS,
+    ON_NEW_BLOCK,
+    ON_OUTPUT_RECEIVED,
+    ON_OUTPUT_SPENT,
+    NUM_STAGES
+  };
+
+  /**
+   * Cumulative timing of a stage.
+   */
+  struct stage_stats {
+    std::string m_name;
+    uint64_t m_count;
+    uint64_t m_total_us;
+    uint64_t m_max_us;
+  };
+
+  /**
+   * Counters and stage timings at a point in time.
+   */
+  struct snapshot {
+    uint64_t m_height;                // last height reported by the wallet
+    uint64_t m_num_blocks;            // blocks processed
+    uint64_t m_num_blocks_fetched;    // blocks fetched by completed syncs
+    uint64_t m_num_outputs_received;
+    uint64_t m_num_outputs_spent;
+    uint64_t m_bytes_downloaded;      // daemon response bytes through the output cache proxy
+    double m_blocks_per_second;       // blocks fetched per second of sync
+    std::vector<stage_stats> m_stages;
+  };
+
+  /**
+   * Records the time from construction to destruction as a stage.
+   */
+  class timer {
+  public:
+    timer(monero_sync_stats* stats, stage s) : m_stats(stats), m_stage(s), m_start(std::chrono::steady_clock::now()) { }
+    ~timer() { if (m_stats != nullptr) m_stats->record(m_stage, std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_start).count()); }
+  private:
+    monero_sync_stats* m_stats;
+    stage m_stage;
+    std::chrono::steady_clock::time_point m_start;
+  };
+
+  /**
+   * Times a sync from construction to destruction, including a sync which
+   * throws.
+   */
+  class sync_timer {
+  public:
+    sync_timer(monero_sync_stats* stats) : m_stats(stats), m_num_blocks_fetched(0) { if (m_stats != nullptr) m_stats->begin_sync(); }
+    ~sync_timer() { if (m_stats != nullptr) m_stats->end_sync(m_num_blocks_fetched); }
+    void set_num_blocks_fetched(uint64_t num_blocks_fetched) { m_num_blocks_fetched = num_blocks_fetched; }
+  private:
+    monero_sync_stats* m_stats;
+    uint64_t m_num_blocks_fetched;
+  };
+
+  monero_sync_stats();
+
+  void on_sync_progress(uint64_t height, uint64_t start_height, uint64_t end_height, double percent_done, const std::string& message);
+  void on_new_block(uint64_t height);
+  void on_output_received(const monero::monero_output_wallet& output);
+  void on_output_spent(const monero::monero_output_wallet& output);
+
+  /**
+   * Record work done in a stage.
+   *
+   * @param s is the stage of the work
+   * @param elapsed_us is the duration of the work in microseconds
+   */
+  void record(stage s, uint64_t elapsed_us);
+
+  /**
+   * Record a daemon request made by the wallet, timed as the stage of its
+   * endpoint.
+   *
+   * @param uri is the endpoint requested, e.g. /getblocks.bin
+   * @param elapsed_us is the duration of the request in microseconds
+   * @param bytes_received is the size of the response body
+   */
+  void record_request(const std::string& uri, uint64_t elapsed_us, uint64_t bytes_received);
+
+  /**
+   * Start timing a sync, during which progress notifications are not timed
+   * as a background sync.
+   */
+  void begin_sync();
+
+  /**
+   * Stop timing a sync.
+   *
+   * @param num_blocks_fetched is the number of blocks the sync fetched
+   */
+  void end_sync(uint64_t num_blocks_fetched);
+
+  snapshot get_snapshot();
+
+  /**
+   * Reset all counters and timings to zero.
+   */
+  void reset();
+
+private:
+  std::mutex m_mutex;
+  snapshot m_snapshot;
+  bool m_is_syncing;                                // a sync is being timed
+  bool m_is_background_sync;                        // the sync being timed is known from progress notifications
+  uint64_t m_sync_start_height;                     // start height reported for a background sync
+  std::chrono::steady_clock::time_point m_sync_start;
+  uint64_t m_sync_request_us;                       // time of daemon requests made during the sync being timed
+
+  void add(stage s, uint64_t elapsed_us);
+  void add_sync(uint64_t num_blocks_fetched);
+};
+
+#endif /* monero_sync_stats_h */
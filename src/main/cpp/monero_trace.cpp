@@ -0,0 +1,127 @@
+/**
+ * Copyright (c) 2017-2019 woodser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "monero_trace.h"
+#include <cstdio>
+#include <stdexcept>
+#include <thread>
+
+using namespace std;
+
+// minimum time to calibrate the trace clock over, waited for by a dump soon after starting
+static const chrono::milliseconds MIN_CALIBRATION_TIME = chrono::milliseconds(10);
+
+atomic<bool> monero_trace::s_enabled(false);
+atomic<monero_trace::ring_buffer*> monero_trace::s_buffer(nullptr);
+mutex monero_trace::s_mutex;
+vector<unique_ptr<monero_trace::ring_buffer>> monero_trace::s_buffers;
+atomic<uint32_t> monero_trace::s_next_thread_id(1);
+uint64_t monero_trace::s_start_ticks = 0;
+chrono::steady_clock::time_point monero_trace::s_start_time;
+
+void monero_trace::start(size_t capacity) {
+  if (capacity == 0) throw runtime_error("Trace capacity must be greater than 0");
+  lock_guard<mutex> lock(s_mutex);
+  s_start_time = chrono::steady_clock::now();
+  s_start_ticks = now_ticks();
+  ring_buffer* buffer = s_buffer.load();
+  if (buffer != nullptr && buffer->m_capacity == capacity) {
+    buffer->m_first.store(buffer->m_next.load());  // indices keep increasing so spans of the last trace never match
+  } else {
+    s_buffers.push_back(unique_ptr<ring_buffer>(new ring_buffer(capacity)));
+    s_buffer.store(s_buffers.back().get());
+  }
+  s_enabled.store(true);
+}
+
+void monero_trace::stop() {
+  lock_guard<mutex> lock(s_mutex);
+  s_enabled.store(false);
+}
+
+void monero_trace::record(const char* name, uint64_t begin_ticks, uint64_t end_ticks) {
+  ring_buffer* buffer = s_buffer.load(memory_order_acquire);
+  if (buffer == nullptr) return;
+  uint64_t idx = buffer->m_next.fetch_add(1, memory_order_relaxed);
+  slot& s = buffer->m_slots[idx % buffer->m_capacity];
+  s.m_seq.store(idx * 2 + 1, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+  s.m_name.store(name, memory_order_relaxed);
+  s.m_begin_ticks.store(begin_ticks, memory_order_relaxed);
+  s.m_duration_ticks.store(end_ticks - begin_ticks, memory_order_relaxed);
+  s.m_thread_id.store(get_thread_id(), memory_order_relaxed);
+  s.m_seq.store(idx * 2 + 2, memory_order_release);
+}
+
+void monero_trace::dump(const string& path) {
+  lock_guard<mutex> lock(s_mutex);
+  FILE* file = fopen(path.c_str(), "w");
+  if (file == nullptr) throw runtime_error("Cannot open trace file: " + path);
+
+  // calibrate ticks per nanosecond over the time traced
+  chrono::steady_clock::time_point start_time = s_start_time;
+  uint64_t start_ticks = s_start_ticks;
+  if (chrono::steady_clock::now() - start_time < MIN_CALIBRATION_TIME) this_thread::sleep_until(start_time + MIN_CALIBRATION_TIME);
+  uint64_t elapsed_ticks = now_ticks() - start_ticks;
+  uint64_t elapsed_ns = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start_time).count();
+  double ns_per_tick = elapsed_ticks == 0 ? 1 : (double) elapsed_ns / elapsed_ticks;
+  uint64_t start_ns = chrono::duration_cast<chrono::nanoseconds>(start_time.time_since_epoch()).count();
+
+  // write events from oldest to newest as complete events with microsecond timestamps
+  fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", file);
+  ring_buffer* buffer = s_buffer.load();
+  if (buffer != nullptr) {
+    uint64_t end = buffer->m_next.load();
+    uint64_t begin = end > buffer->m_capacity ? end - buffer->m_capacity : 0;
+    if (begin < buffer->m_first.load()) begin = buffer->m_first.load();
+    bool first = true;
+    for (uint64_t idx = begin; idx < end; idx++) {
+
+      // read the span, skipping it if being written or overwritten
+      slot& s = buffer->m_slots[idx % buffer->m_capacity];
+      if (s.m_seq.load(memory_order_acquire) != idx * 2 + 2) continue;
+      event evt;
+      evt.m_name = s.m_name.load(memory_order_relaxed);
+      int64_t begin_ticks = (int64_t) (s.m_begin_ticks.load(memory_order_relaxed) - start_ticks);
+      uint64_t duration_ticks = s.m_duration_ticks.load(memory_order_relaxed);
+      evt.m_thread_id = s.m_thread_id.load(memory_order_relaxed);
+      atomic_thread_fence(memory_order_acquire);
+      if (s.m_seq.load(memory_order_relaxed) != idx * 2 + 2 || evt.m_name == nullptr) continue;
+      evt.m_begin_ns = start_ns + (int64_t) (begin_ticks * ns_per_tick);
+      evt.m_duration_ns = (uint64_t) (duration_ticks * ns_per_tick);
+
+      fprintf(file, "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%llu.%03llu,\"dur\":%llu.%03llu}", first ? "" : ",", evt.m_name, evt.m_thread_id,
+          (unsigned long long) (evt.m_begin_ns / 1000), (unsigned long long) (evt.m_begin_ns % 1000), (unsigned long long) (evt.m_duration_ns / 1000), (unsigned long long) (evt.m_duration_ns % 1000));
+      first = false;
+    }
+  }
+  fputs("\n]}\n", file);
+  bool failed = ferror(file) != 0;
+  if (fclose(file) != 0 || failed) throw runtime_error("Cannot write trace file: " + path);
+}
+
+// assigned on first use rather than by a dynamic initializer, whose guard is checked on every read
+uint32_t monero_trace::get_thread_id() {
+  static thread_local uint32_t thread_id = 0;
+  if (thread_id == 0) thread_id = s_next_thread_id.fetch_add(1);
+  return thread_id;
+}
@@ -0,0 +1,170 @@
+/**
+ * Copyright (c) 2017-2019 woodser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef monero_trace_h
+#define monero_trace_h
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/**
+ * Records timed spans of native calls in a fixed size ring buffer which can be
+ * dumped in Chrome's trace event format and opened in Perfetto or
+ * chrome://tracing.
+ *
+ * Recording a span takes two reads of the cpu's timestamp counter, one atomic
+ * increment, and relaxed stores into its slot, with no locks, allocation, or
+ * string copies, so tracing can stay enabled on a production host.  The
+ * counter reads dominate: a span costs about 60 ns on a VM where each read
+ * costs about 22 ns, and less where reads are not virtualized (measure with
+ * BM_trace_span).  A span while tracing is disabled is one relaxed load.
+ * Ticks are converted to nanoseconds when dumped, calibrated against
+ * steady_clock over the time traced, which assumes an invariant timestamp
+ * counter as on any x86-64 cpu of the last decade.  Other cpus read
+ * steady_clock instead.
+ *
+ * Once the buffer is full the oldest spans are overwritten.  Each slot has a
+ * sequence word which is odd while the slot is written, so dumping skips slots
+ * being written or overwritten instead of reading torn spans.  Only two spans
+ * a full lap of the buffer apart written at once can still tear, which needs a
+ * capacity below the number of recording threads.  Span names are not copied
+ * so they must be string literals.
+ */
+class monero_trace {
+public:
+
+  /**
+   * A completed span.
+   */
+  struct event {
+    const char* m_name;
+    uint64_t m_begin_ns;
+    uint64_t m_duration_ns;
+    uint32_t m_thread_id;
+  };
+
+  /**
+   * Start recording spans, clearing any recorded spans.
+   *
+   * @param capacity is the number of most recent spans kept
+   */
+  static void start(size_t capacity);
+
+  /**
+   * Stop recording spans.  Recorded spans are kept until the next start.
+   */
+  static void stop();
+
+  static bool is_enabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+  /**
+   * Read the trace clock, in ticks which dump() converts to nanoseconds.
+   */
+  static uint64_t now_ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+  }
+
+  /**
+   * Record a completed span.
+   *
+   * @param name is the span's name, which must outlive the trace
+   * @param begin_ticks is the span's start from now_ticks()
+   * @param end_ticks is the span's end from now_ticks()
+   */
+  static void record(const char* name, uint64_t begin_ticks, uint64_t end_ticks);
+
+  /**
+   * Write the recorded spans to a file as Chrome trace event json.  Spans
+   * being recorded while dumping are skipped.
+   *
+   * @param path is the path of the file to write
+   */
+  static void dump(const std::string& path);
+
+private:
+
+  // fields are atomic so a slot can be read while overwritten, relaxed since the sequence word orders them
+  struct slot {
+    std::atomic<uint64_t> m_seq;  // 2 * index + 1 while writing the span at index, 2 * index + 2 once written
+    std::atomic<const char*> m_name;
+    std::atomic<uint64_t> m_begin_ticks;
+    std::atomic<uint64_t> m_duration_ticks;
+    std::atomic<uint32_t> m_thread_id;
+  };
+
+  struct ring_buffer {
+    ring_buffer(size_t capacity) : m_slots(new slot[capacity]()), m_capacity(capacity), m_next(0), m_first(0) { }
+    std::unique_ptr<slot[]> m_slots;
+    size_t m_capacity;
+    std::atomic<uint64_t> m_next;
+    std::atomic<uint64_t> m_first;  // index of the first span since the trace was started
+  };
+
+  static std::atomic<bool> s_enabled;
+  static std::atomic<ring_buffer*> s_buffer;
+  static std::mutex s_mutex;                                // serializes start, stop, and dump
+  static std::vector<std::unique_ptr<ring_buffer>> s_buffers; // replaced buffers are kept since spans in flight may still write to them
+  static std::atomic<uint32_t> s_next_thread_id;
+  static uint64_t s_start_ticks;                            // trace clock and steady_clock when started, to calibrate ticks
+  static std::chrono::steady_clock::time_point s_start_time;
+
+  static uint32_t get_thread_id();
+};
+
+/**
+ * Records the time from construction to destruction or end() as a span if
+ * tracing is enabled.
+ */
+class monero_trace_span {
+public:
+  monero_trace_span(const char* name) : m_name(monero_trace::is_enabled() ? name : nullptr), m_begin_ticks(m_name == nullptr ? 0 : monero_trace::now_ticks()) { }
+  ~monero_trace_span() { end(); }
+  void end() {
+    if (m_name == nullptr) return;
+    monero_trace::record(m_name, m_begin_ticks, monero_trace::now_ticks());
+    m_name = nullptr;
+  }
+private:
+  const char* m_name;
+  uint64_t m_begin_ticks;
+  monero_trace_span(const monero_trace_span&);
+  monero_trace_span& operator=(const monero_trace_span&);
+};
+
+#define MONERO_TRACE_CONCAT_INNER(a, b) a##b
+#define MONERO_TRACE_CONCAT(a, b) MONERO_TRACE_CONCAT_INNER(a, b)
+
+// records a span from here to the end of the enclosing scope
+#define MONERO_TRACE_SPAN(name) monero_trace_span MONERO_TRACE_CONCAT(_monero_trace_span_, __LINE__)(name)
+
+#endif /* monero_trace_h */
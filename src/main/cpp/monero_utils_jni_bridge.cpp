@@ -23,84 +23,167 @@
 #include <iostream>
 #include "chacha.h" // TODO: explicitly include because wallet2.h #include "crypto/chacha.h" is ignored
 #include "monero_utils_jni_bridge.h"
+#include "monero_address_codec.h"
+#include "monero_block_streamer.h"
+#include "monero_header_cache.h"
+#include "monero_output_cache.h"
+#include "monero_portable_storage.h"
+#include "monero_trace.h"
 #include "utils/monero_utils.h"
+#include "string_tools.h"
 
 using namespace std;
 
-JNIEXPORT jbyteArray JNICALL Java_monero_utils_MoneroUtils_jsonToBinaryJni(JNIEnv *env, jclass clazz, jstring json) {
+// defined in monero_wallet_jni_bridge.cpp
+void rethrow_cpp_exception_as_java_exception(JNIEnv* env);
+vector<string> jstring_array_to_vector(JNIEnv* env, jobjectArray jstrs);
+jbyteArray pack_strings(JNIEnv* env, const vector<string>& strs);
+jbyteArray string_to_jbytes(JNIEnv* env, const string& str);
+string jbytes_to_string(JNIEnv* env, jbyteArray jbytes);
 
-  // convert json jstring to string
-  string json_str = jstring2string(env, json);
-  //string json_str = "{\"heights\":[123456,1234567,870987]}";
+// ----------------------------- OUTPUT CACHE HELPERS -------------------------
 
-  // convert json to monero's portable storage binary format
-  string bin_str;
-  monero_utils::json_to_binary(json_str, bin_str);
+static string jstring_to_utf(JNIEnv* env, jstring jstr) {
+  const char* _str = jstr ? env->GetStringUTFChars(jstr, NULL) : nullptr;
+  string str = string(_str ? _str : "");
+  if (jstr) env->ReleaseStringUTFChars(jstr, _str);
+  return str;
+}
 
-  // convert binary string to jbyteArray
-  jbyteArray result = env->NewByteArray(bin_str.length());
-  if (result == NULL) {
-     return NULL; // out of memory error thrown
-  }
+static void parse_json(const string& json, rapidjson::Document& doc) {
+  doc.Parse(json.c_str());
+  if (doc.HasParseError() || !doc.IsObject()) throw runtime_error("Invalid output cache request: " + json);
+}
 
-  // fill a temp structure to use to populate the java byte array
-  jbyte fill[bin_str.length()];
-  for (int i = 0; i < bin_str.length(); i++) {
-     fill[i] = bin_str[i];
-  }
-  env->SetByteArrayRegion(result, 0, bin_str.length(), fill);
-  return result;
+template <class T>
+static void parse_pod(const rapidjson::Value& val, const char* field, T& pod) {
+  if (!val.HasMember(field) || !val[field].IsString() || !epee::string_tools::hex_to_pod(val[field].GetString(), pod)) throw runtime_error(string("Invalid output field: ") + field);
 }
 
-JNIEXPORT jstring JNICALL Java_monero_utils_MoneroUtils_binaryToJsonJni(JNIEnv *env, jclass clazz, jbyteArray bin) {
+static rapidjson::Value to_hex_val(rapidjson::Document::AllocatorType& allocator, const string& hex) {
+  rapidjson::Value val;
+  val.SetString(hex.c_str(), hex.size(), allocator);
+  return val;
+}
 
-  // convert the jbyteArray to a string
-  int binLength = env->GetArrayLength(bin);
-  jboolean is_copy;
-  jbyte* jbytes = env->GetByteArrayElements(bin, &is_copy);
-  string bin_str = string((char*) jbytes, binLength);
+JNIEXPORT jbyteArray JNICALL Java_monero_utils_MoneroUtils_jsonToBinaryJni(JNIEnv *env, jclass clazz, jbyteArray json) {
+  MONERO_TRACE_SPAN("Java_monero_utils_MoneroUtils_jsonToBinaryJni");
+  try {
 
-  // convert monero's portable storage binary format to json
-  string json_str;
-  monero_utils::binary_to_json(bin_str, json_str);
+    // convert json to monero's portable storage binary format
+    string bin_str;
+    monero_portable_storage::json_to_binary(jbytes_to_string(env, json), bin_str);
 
-  // convert string to jstring
-  return env->NewStringUTF(json_str.c_str());
+    // convert binary string to jbyteArray
+    return string_to_jbytes(env, bin_str);
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+    return 0;
+  }
 }
 
-JNIEXPORT jstring JNICALL Java_monero_utils_MoneroUtils_binaryBlocksToJsonJni(JNIEnv *env, jclass clazz, jbyteArray blocks_bin) {
+JNIEXPORT jbyteArray JNICALL Java_monero_utils_MoneroUtils_binaryToJsonJni(JNIEnv *env, jclass clazz, jbyteArray bin) {
+  MONERO_TRACE_SPAN("Java_monero_utils_MoneroUtils_binaryToJsonJni");
+  try {
+
+    // convert monero's portable storage binary format to json
+    string json_str;
+    monero_portable_storage::binary_to_json(jbytes_to_string(env, bin), json_str);
 
-  // convert the jbyteArray to a string
-  int binLength = env->GetArrayLength(blocks_bin);
-  jboolean is_copy;
-  jbyte* jbytes = env->GetByteArrayElements(blocks_bin, &is_copy);
-  string bin_str = string((char*) jbytes, binLength);
+    // return utf-8 json bytes
+    return string_to_jbytes(env, json_str);
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+    return 0;
+  }
+}
 
-  // convert monero's portable storage binary format to json
-  string json_str;
-  monero_utils::binary_blocks_to_json(bin_str, json_str);
+JNIEXPORT jbyteArray JNICALL Java_monero_utils_MoneroUtils_binaryBlocksToJsonJni(JNIEnv *env, jclass clazz, jbyteArray blocks_bin) {
+  MONERO_TRACE_SPAN("Java_monero_utils_MoneroUtils_binaryBlocksToJsonJni");
+  try {
 
-  // convert string to jstring
-  return env->NewStringUTF(json_str.c_str());
+    // convert monero's portable storage binary format to json
+    string json_str;
+    monero_portable_storage::blocks_to_json(jbytes_to_string(env, blocks_bin), json_str);
+
+    // return utf-8 json bytes
+    return string_to_jbytes(env, json_str);
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+    return 0;
+  }
 }
 
-// credit: https://stackoverflow.com/questions/41820039/jstringjni-to-stdstringc-with-utf8-characters
+// encodes a java string's utf-16 chars as utf-8, including supplementary characters which modified utf-8 splits into surrogates
 std::string jstring2string(JNIEnv *env, jstring jStr) {
   if (!jStr) return "";
 
-  const jclass stringClass = env->GetObjectClass(jStr);
-  const jmethodID getBytes = env->GetMethodID(stringClass, "getBytes", "(Ljava/lang/String;)[B");
-  const jbyteArray stringJbytes = (jbyteArray) env->CallObjectMethod(jStr, getBytes, env->NewStringUTF("UTF-8"));
+  // copy utf-16 chars without pinning the string
+  jsize len = env->GetStringLength(jStr);
+  std::vector<jchar> chars(len);
+  if (len > 0) env->GetStringRegion(jStr, 0, len, chars.data());
+
+  // encode utf-8 with unpaired surrogates replaced by U+FFFD
+  std::string str;
+  str.reserve(len);
+  for (jsize i = 0; i < len; i++) {
+    uint32_t cp = chars[i];
+    if (cp >= 0xD800 && cp <= 0xDFFF) {
+      if (cp <= 0xDBFF && i + 1 < len && chars[i + 1] >= 0xDC00 && chars[i + 1] <= 0xDFFF) cp = 0x10000 + ((cp - 0xD800) << 10) + (chars[++i] - 0xDC00);
+      else cp = 0xFFFD;
+    }
+    if (cp < 0x80) {
+      str.push_back((char) cp);
+    } else if (cp < 0x800) {
+      str.push_back((char) (0xC0 | (cp >> 6)));
+      str.push_back((char) (0x80 | (cp & 0x3F)));
+    } else if (cp < 0x10000) {
+      str.push_back((char) (0xE0 | (cp >> 12)));
+      str.push_back((char) (0x80 | ((cp >> 6) & 0x3F)));
+      str.push_back((char) (0x80 | (cp & 0x3F)));
+    } else {
+      str.push_back((char) (0xF0 | (cp >> 18)));
+      str.push_back((char) (0x80 | ((cp >> 12) & 0x3F)));
+      str.push_back((char) (0x80 | ((cp >> 6) & 0x3F)));
+      str.push_back((char) (0x80 | (cp & 0x3F)));
+    }
+  }
+  return str;
+}
 
-  size_t length = (size_t) env->GetArrayLength(stringJbytes);
-  jbyte* pBytes = env->GetByteArrayElements(stringJbytes, NULL);
+// decodes utf-8 to a java string, unlike NewStringUTF which expects modified utf-8 and rejects 4-byte sequences
+jstring string2jstring(JNIEnv *env, const std::string& str) {
+  std::vector<jchar> chars;
+  chars.reserve(str.size());
+  const unsigned char* bytes = reinterpret_cast<const unsigned char*>(str.data());
+  size_t size = str.size();
+  for (size_t i = 0; i < size; ) {
 
-  std::string ret = std::string((char *)pBytes, length);
-  env->ReleaseByteArrayElements(stringJbytes, pBytes, JNI_ABORT);
+    // decode code point with invalid sequences replaced by U+FFFD
+    uint32_t cp = bytes[i];
+    size_t len = cp < 0x80 ? 1 : cp >= 0xC2 && cp < 0xE0 ? 2 : cp >= 0xE0 && cp < 0xF0 ? 3 : cp >= 0xF0 && cp < 0xF5 ? 4 : 0;
+    size_t j = 1;
+    if (len > 1) {
+      cp &= 0x7F >> len;
+      for (; j < len && i + j < size && (bytes[i + j] & 0xC0) == 0x80; j++) cp = (cp << 6) | (bytes[i + j] & 0x3F);
+    }
+    bool valid = len != 0 && j == len && !(len == 3 && (cp < 0x800 || (cp >= 0xD800 && cp <= 0xDFFF))) && !(len == 4 && (cp < 0x10000 || cp > 0x10FFFF));
+    i += j;
+    if (!valid) {
+      chars.push_back(0xFFFD);
+      continue;
+    }
 
-  env->DeleteLocalRef(stringJbytes);
-  env->DeleteLocalRef(stringClass);
-  return ret;
+    // encode as utf-16
+    if (cp < 0x10000) {
+      chars.push_back((jchar) cp);
+    } else {
+      cp -= 0x10000;
+      chars.push_back((jchar) (0xD800 + (cp >> 10)));
+      chars.push_back((jchar) (0xDC00 + (cp & 0x3FF)));
+    }
+  }
+  return env->NewString(chars.data(), chars.size());
 }
 
 JNIEXPORT void JNICALL Java_monero_utils_MoneroUtils_initLoggingJni(JNIEnv* env, jclass clazz, jstring jpath, jboolean console) {
@@ -113,3 +196,508 @@ JNIEXPORT void JNICALL Java_monero_utils_MoneroUtils_initLoggingJni(JNIEnv* env,
 JNIEXPORT void JNICALL Java_monero_utils_MoneroUtils_setLogLevelJni(JNIEnv* env, jclass clazz, jint level) {
   mlog_set_log_level(level);
 }
+
+JNIEXPORT void JNICALL Java_monero_utils_MoneroUtils_startTraceJni(JNIEnv* env, jclass clazz, jint capacity) {
+  try {
+    if (capacity <= 0) throw runtime_error("Trace capacity must be greater than 0");
+    monero_trace::start(capacity);
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+  }
+}
+
+JNIEXPORT void JNICALL Java_monero_utils_MoneroUtils_stopTraceJni(JNIEnv* env, jclass clazz) {
+  monero_trace::stop();
+}
+
+JNIEXPORT void JNICALL Java_monero_utils_MoneroUtils_dumpTraceJni(JNIEnv* env, jclass clazz, jstring jpath) {
+  try {
+    monero_trace::dump(jstring_to_utf(env, jpath));
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+  }
+}
+
+JNIEXPORT jbyteArray JNICALL Java_monero_utils_MoneroUtils_getCachedOutputsJni(JNIEnv* env, jclass clazz, jstring jdaemon_uri, jbyteArray jrequest) {
+  MONERO_TRACE_SPAN("Java_monero_utils_MoneroUtils_getCachedOutputsJni");
+  try {
+
+    // parse requested amounts and indices
+    rapidjson::Document request;
+    parse_json(jbytes_to_string(env, jrequest), request);
+    const rapidjson::Value& outputs = request["outputs"];
+
+    // collect cached outputs
+    monero_output_cache& cache = monero_output_cache::instance(jstring_to_utf(env, jdaemon_uri));
+    rapidjson::Document doc;
+    doc.SetObject();
+    rapidjson::Document::AllocatorType& allocator = doc.GetAllocator();
+    rapidjson::Value cached(rapidjson::kArrayType);
+    for (rapidjson::SizeType i = 0; i < outputs.Size(); i++) {
+      monero_cached_output output;
+      if (!cache.get_output(outputs[i]["amount"].GetUint64(), outputs[i]["index"].GetUint64(), output)) continue;
+      rapidjson::Value val(rapidjson::kObjectType);
+      val.AddMember("amount", output.m_amount, allocator);
+      val.AddMember("index", output.m_index, allocator);
+      val.AddMember("key", to_hex_val(allocator, epee::string_tools::pod_to_hex(output.m_key)), allocator);
+      val.AddMember("mask", to_hex_val(allocator, epee::string_tools::pod_to_hex(output.m_mask)), allocator);
+      val.AddMember("txid", to_hex_val(allocator, epee::string_tools::pod_to_hex(output.m_txid)), allocator);
+      val.AddMember("height", output.m_height, allocator);
+      val.AddMember("unlocked", output.m_unlocked, allocator);
+      cached.PushBack(val, allocator);
+    }
+    doc.AddMember("outputs", cached, allocator);
+    return string_to_jbytes(env, monero_utils::serialize(doc));
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+    return 0;
+  }
+}
+
+JNIEXPORT void JNICALL Java_monero_utils_MoneroUtils_putCachedOutputsJni(JNIEnv* env, jclass clazz, jstring jdaemon_uri, jbyteArray joutputs) {
+  MONERO_TRACE_SPAN("Java_monero_utils_MoneroUtils_putCachedOutputsJni");
+  try {
+    rapidjson::Document doc;
+    parse_json(jbytes_to_string(env, joutputs), doc);
+    const rapidjson::Value& outputs = doc["outputs"];
+    monero_output_cache& cache = monero_output_cache::instance(jstring_to_utf(env, jdaemon_uri));
+    for (rapidjson::SizeType i = 0; i < outputs.Size(); i++) {
+      const rapidjson::Value& val = outputs[i];
+      monero_cached_output output;
+      output.m_amount = val["amount"].GetUint64();
+      output.m_index = val["index"].GetUint64();
+      parse_pod(val, "key", output.m_key);
+      parse_pod(val, "mask", output.m_mask);
+      parse_pod(val, "txid", output.m_txid);
+      output.m_height = val["height"].GetUint64();
+      output.m_unlocked = val["unlocked"].GetBool();
+      cache.put_output(output);
+    }
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+  }
+}
+
+JNIEXPORT jbyteArray JNICALL Java_monero_utils_MoneroUtils_getCachedOutputDistributionsJni(JNIEnv* env, jclass clazz, jstring jdaemon_uri, jbyteArray jrequest) {
+  MONERO_TRACE_SPAN("Java_monero_utils_MoneroUtils_getCachedOutputDistributionsJni");
+  try {
+
+    // parse request which mirrors get_output_distribution params
+    rapidjson::Document request;
+    parse_json(jbytes_to_string(env, jrequest), request);
+    bool cumulative = request["cumulative"].GetBool();
+    uint64_t from_height = request["from_height"].GetUint64();
+    uint64_t to_height = request["to_height"].GetUint64();
+    const rapidjson::Value& amounts = request["amounts"];
+
+    // collect cached distributions
+    monero_output_cache& cache = monero_output_cache::instance(jstring_to_utf(env, jdaemon_uri));
+    rapidjson::Document doc;
+    doc.SetObject();
+    rapidjson::Document::AllocatorType& allocator = doc.GetAllocator();
+    rapidjson::Value cached(rapidjson::kArrayType);
+    for (rapidjson::SizeType i = 0; i < amounts.Size(); i++) {
+      monero_cached_distribution distribution;
+      if (!cache.get_distribution(amounts[i].GetUint64(), cumulative, from_height, to_height, distribution)) continue;
+      rapidjson::Value val(rapidjson::kObjectType);
+      val.AddMember("amount", distribution.m_amount, allocator);
+      val.AddMember("start_height", distribution.m_start_height, allocator);
+      val.AddMember("base", distribution.m_base, allocator);
+      rapidjson::Value counts(rapidjson::kArrayType);
+      counts.Reserve(distribution.m_distribution.size(), allocator);
+      for (uint64_t count : distribution.m_distribution) counts.PushBack(count, allocator);
+      val.AddMember("distribution", counts, allocator);
+      cached.PushBack(val, allocator);
+    }
+    doc.AddMember("distributions", cached, allocator);
+    return string_to_jbytes(env, monero_utils::serialize(doc));
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+    return 0;
+  }
+}
+
+JNIEXPORT void JNICALL Java_monero_utils_MoneroUtils_putCachedOutputDistributionsJni(JNIEnv* env, jclass clazz, jstring jdaemon_uri, jbyteArray jdistributions) {
+  MONERO_TRACE_SPAN("Java_monero_utils_MoneroUtils_putCachedOutputDistributionsJni");
+  try {
+    rapidjson::Document doc;
+    parse_json(jbytes_to_string(env, jdistributions), doc);
+    bool cumulative = doc["cumulative"].GetBool();
+    uint64_t from_height = doc["from_height"].GetUint64();
+    uint64_t to_height = doc["to_height"].GetUint64();
+    const rapidjson::Value& distributions = doc["distributions"];
+    monero_output_cache& cache = monero_output_cache::instance(jstring_to_utf(env, jdaemon_uri));
+    for (rapidjson::SizeType i = 0; i < distributions.Size(); i++) {
+      const rapidjson::Value& val = distributions[i];
+      monero_cached_distribution distribution;
+      distribution.m_amount = val["amount"].GetUint64();
+      distribution.m_cumulative = cumulative;
+      distribution.m_from_height = from_height;
+      distribution.m_to_height = to_height;
+      distribution.m_start_height = val["start_height"].GetUint64();
+      distribution.m_base = val["base"].GetUint64();
+      const rapidjson::Value& counts = val["distribution"];
+      distribution.m_distribution.reserve(counts.Size());
+      for (rapidjson::SizeType j = 0; j < counts.Size(); j++) distribution.m_distribution.push_back(counts[j].GetUint64());
+      cache.put_distribution(distribution);
+    }
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+  }
+}
+
+JNIEXPORT void JNICALL Java_monero_utils_MoneroUtils_setOutputCacheTipJni(JNIEnv* env, jclass clazz, jstring jdaemon_uri, jlong height, jstring jhash, jstring janchor_hash) {
+  MONERO_TRACE_SPAN("Java_monero_utils_MoneroUtils_setOutputCacheTipJni");
+  try {
+    if (height < 0) throw runtime_error("Tip height must be >= 0");
+    monero_output_cache::instance(jstring_to_utf(env, jdaemon_uri)).set_tip(height, jstring_to_utf(env, jhash), jstring_to_utf(env, janchor_hash));
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+  }
+}
+
+JNIEXPORT jlong JNICALL Java_monero_utils_MoneroUtils_getOutputCacheTipHeightJni(JNIEnv* env, jclass clazz, jstring jdaemon_uri) {
+  MONERO_TRACE_SPAN("Java_monero_utils_MoneroUtils_getOutputCacheTipHeightJni");
+  try {
+    return monero_output_cache::instance(jstring_to_utf(env, jdaemon_uri)).get_tip_height();
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+    return -1;
+  }
+}
+
+JNIEXPORT void JNICALL Java_monero_utils_MoneroUtils_setOutputCacheLimitsJni(JNIEnv* env, jclass clazz, jstring jdaemon_uri, jint max_outputs, jint max_distributions) {
+  MONERO_TRACE_SPAN("Java_monero_utils_MoneroUtils_setOutputCacheLimitsJni");
+  try {
+    if (max_outputs < 0 || max_distributions < 0) throw runtime_error("Output cache limits must be >= 0");
+    monero_output_cache::instance(jstring_to_utf(env, jdaemon_uri)).set_limits(static_cast<size_t>(max_outputs), static_cast<size_t>(max_distributions));
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+  }
+}
+
+JNIEXPORT jstring JNICALL Java_monero_utils_MoneroUtils_getOutputCacheStatsJni(JNIEnv* env, jclass clazz, jstring jdaemon_uri) {
+  MONERO_TRACE_SPAN("Java_monero_utils_MoneroUtils_getOutputCacheStatsJni");
+  try {
+    monero_output_cache_stats stats = monero_output_cache::instance(jstring_to_utf(env, jdaemon_uri)).get_stats();
+    rapidjson::Document doc;
+    doc.SetObject();
+    rapidjson::Document::AllocatorType& allocator = doc.GetAllocator();
+    doc.AddMember("outputHits", stats.m_output_hits, allocator);
+    doc.AddMember("outputMisses", stats.m_output_misses, allocator);
+    doc.AddMember("distributionHits", stats.m_distribution_hits, allocator);
+    doc.AddMember("distributionMisses", stats.m_distribution_misses, allocator);
+    doc.AddMember("numOutputs", stats.m_num_outputs, allocator);
+    doc.AddMember("numDistributions", stats.m_num_distributions, allocator);
+    doc.AddMember("numInvalidations", stats.m_num_invalidations, allocator);
+    return env->NewStringUTF(monero_utils::serialize(doc).c_str());
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+    return 0;
+  }
+}
+
+JNIEXPORT void JNICALL Java_monero_utils_MoneroUtils_clearOutputCacheJni(JNIEnv* env, jclass clazz, jstring jdaemon_uri) {
+  MONERO_TRACE_SPAN("Java_monero_utils_MoneroUtils_clearOutputCacheJni");
+  try {
+    monero_output_cache::instance(jstring_to_utf(env, jdaemon_uri)).clear();
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+  }
+}
+
+// ------------------------------- HEADER CACHE -------------------------------
+
+// packed header layout shared with MoneroUtils
+static const int NUM_HEADER_LONGS = 13;
+static const int NUM_HEADER_HASHES = 3;
+
+JNIEXPORT jboolean JNICALL Java_monero_utils_MoneroUtils_putCachedBlockHeadersJni(JNIEnv* env, jclass clazz, jstring jdaemon_uri, jstring jtip_hash, jlongArray jnumbers, jobjectArray jhashes) {
+  MONERO_TRACE_SPAN("Java_monero_utils_MoneroUtils_putCachedBlockHeadersJni");
+  try {
+    jsize num_numbers = env->GetArrayLength(jnumbers);
+    if (num_numbers % NUM_HEADER_LONGS != 0) throw runtime_error("Header numbers do not match headers");
+    size_t num_headers = num_numbers / NUM_HEADER_LONGS;
+    vector<jlong> numbers(num_numbers);
+    env->GetLongArrayRegion(jnumbers, 0, num_numbers, numbers.data());
+    vector<string> hashes = jstring_array_to_vector(env, jhashes);
+    if (hashes.size() != num_headers * NUM_HEADER_HASHES) throw runtime_error("Header hashes do not match headers");
+    vector<monero_cached_header> headers(num_headers);
+    for (size_t i = 0; i < num_headers; i++) {
+      const jlong* n = &numbers[i * NUM_HEADER_LONGS];
+      monero_cached_header& header = headers[i];
+      if (n[0] < 0) throw runtime_error("Header height must be >= 0");
+      header.m_height = n[0];
+      header.m_timestamp = n[1];
+      header.m_size = n[2];
+      header.m_weight = n[3];
+      header.m_long_term_weight = n[4];
+      header.m_reward = n[5];
+      header.m_difficulty_lo = n[6];
+      header.m_difficulty_hi = n[7];
+      header.m_cumulative_difficulty_lo = n[8];
+      header.m_cumulative_difficulty_hi = n[9];
+      header.m_nonce = (uint32_t) n[10];
+      header.m_num_txs = (uint32_t) n[11];
+      header.m_major_version = (uint8_t) (n[12] & 0xff);
+      header.m_minor_version = (uint8_t) ((n[12] >> 8) & 0xff);
+      header.m_orphan_status = ((n[12] >> 16) & 1) != 0;
+      const string* h = &hashes[i * NUM_HEADER_HASHES];
+      if (!epee::string_tools::hex_to_pod(h[0], header.m_hash)) throw runtime_error("Invalid header hash: " + h[0]);
+      if (!epee::string_tools::hex_to_pod(h[1], header.m_prev_hash)) throw runtime_error("Invalid header prev hash: " + h[1]);
+      if (h[2].empty()) header.m_miner_tx_hash = crypto::null_hash;
+      else if (!epee::string_tools::hex_to_pod(h[2], header.m_miner_tx_hash)) throw runtime_error("Invalid header miner tx hash: " + h[2]);
+    }
+    return monero_header_cache::instance(jstring_to_utf(env, jdaemon_uri)).put_headers(headers, jstring_to_utf(env, jtip_hash));
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+    return false;
+  }
+}
+
+JNIEXPORT jboolean JNICALL Java_monero_utils_MoneroUtils_getCachedBlockHeaderJni(JNIEnv* env, jclass clazz, jstring jdaemon_uri, jlong height, jlongArray jnumbers, jobjectArray jhashes) {
+  MONERO_TRACE_SPAN("Java_monero_utils_MoneroUtils_getCachedBlockHeaderJni");
+  try {
+    if (height < 0) throw runtime_error("Height must be >= 0");
+    if (env->GetArrayLength(jnumbers) < NUM_HEADER_LONGS || env->GetArrayLength(jhashes) < NUM_HEADER_HASHES) throw runtime_error("Header arrays are too small");
+    monero_cached_header header;
+    if (!monero_header_cache::instance(jstring_to_utf(env, jdaemon_uri)).get_header(height, header)) return false;
+    jlong numbers[NUM_HEADER_LONGS] = {
+      (jlong) header.m_height,
+      (jlong) header.m_timestamp,
+      (jlong) header.m_size,
+      (jlong) header.m_weight,
+      (jlong) header.m_long_term_weight,
+      (jlong) header.m_reward,
+      (jlong) header.m_difficulty_lo,
+      (jlong) header.m_difficulty_hi,
+      (jlong) header.m_cumulative_difficulty_lo,
+      (jlong) header.m_cumulative_difficulty_hi,
+      (jlong) header.m_nonce,
+      (jlong) header.m_num_txs,
+      (jlong) (header.m_major_version | header.m_minor_version << 8 | (header.m_orphan_status ? 1 : 0) << 16)
+    };
+    env->SetLongArrayRegion(jnumbers, 0, NUM_HEADER_LONGS, numbers);
+    env->SetObjectArrayElement(jhashes, 0, env->NewStringUTF(epee::string_tools::pod_to_hex(header.m_hash).c_str()));
+    env->SetObjectArrayElement(jhashes, 1, env->NewStringUTF(epee::string_tools::pod_to_hex(header.m_prev_hash).c_str()));
+    env->SetObjectArrayElement(jhashes, 2, header.m_miner_tx_hash == crypto::null_hash ? nullptr : env->NewStringUTF(epee::string_tools::pod_to_hex(header.m_miner_tx_hash).c_str()));
+    return true;
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+    return false;
+  }
+}
+
+JNIEXPORT jint JNICALL Java_monero_utils_MoneroUtils_getCachedBlockSizesJni(JNIEnv* env, jclass clazz, jstring jdaemon_uri, jlong start_height, jlongArray jsizes) {
+  MONERO_TRACE_SPAN("Java_monero_utils_MoneroUtils_getCachedBlockSizesJni");
+  try {
+    if (start_height < 0) throw runtime_error("Start height must be >= 0");
+
+    // reuse this thread's buffer so repeated lookups do not allocate
+    static thread_local vector<uint64_t> sizes;
+    size_t max_sizes = env->GetArrayLength(jsizes);
+    if (sizes.size() < max_sizes) sizes.resize(max_sizes);
+    size_t num_sizes = monero_header_cache::instance(jstring_to_utf(env, jdaemon_uri)).get_sizes(start_height, sizes.data(), max_sizes);
+    env->SetLongArrayRegion(jsizes, 0, num_sizes, reinterpret_cast<const jlong*>(sizes.data()));
+    return num_sizes;
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+    return 0;
+  }
+}
+
+JNIEXPORT void JNICALL Java_monero_utils_MoneroUtils_setBlockHeaderCacheTipJni(JNIEnv* env, jclass clazz, jstring jdaemon_uri, jlong height, jstring jhash, jstring janchor_hash) {
+  MONERO_TRACE_SPAN("Java_monero_utils_MoneroUtils_setBlockHeaderCacheTipJni");
+  try {
+    if (height < 0) throw runtime_error("Tip height must be >= 0");
+    if (jhash == nullptr) throw runtime_error("Must provide tip hash");
+    monero_header_cache::instance(jstring_to_utf(env, jdaemon_uri)).set_tip(height, jstring_to_utf(env, jhash), jstring_to_utf(env, janchor_hash));
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+  }
+}
+
+JNIEXPORT jlong JNICALL Java_monero_utils_MoneroUtils_getBlockHeaderCacheTipHeightJni(JNIEnv* env, jclass clazz, jstring jdaemon_uri) {
+  MONERO_TRACE_SPAN("Java_monero_utils_MoneroUtils_getBlockHeaderCacheTipHeightJni");
+  try {
+    return monero_header_cache::instance(jstring_to_utf(env, jdaemon_uri)).get_tip_height();
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+    return -1;
+  }
+}
+
+JNIEXPORT void JNICALL Java_monero_utils_MoneroUtils_setBlockHeaderCacheLimitJni(JNIEnv* env, jclass clazz, jstring jdaemon_uri, jint max_headers) {
+  MONERO_TRACE_SPAN("Java_monero_utils_MoneroUtils_setBlockHeaderCacheLimitJni");
+  try {
+    if (max_headers < 1) throw runtime_error("Header cache limit must be > 0");
+    monero_header_cache::instance(jstring_to_utf(env, jdaemon_uri)).set_max_headers((size_t) max_headers);
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+  }
+}
+
+JNIEXPORT jstring JNICALL Java_monero_utils_MoneroUtils_getBlockHeaderCacheStatsJni(JNIEnv* env, jclass clazz, jstring jdaemon_uri) {
+  MONERO_TRACE_SPAN("Java_monero_utils_MoneroUtils_getBlockHeaderCacheStatsJni");
+  try {
+    monero_header_cache_stats stats = monero_header_cache::instance(jstring_to_utf(env, jdaemon_uri)).get_stats();
+    rapidjson::Document doc;
+    doc.SetObject();
+    rapidjson::Document::AllocatorType& allocator = doc.GetAllocator();
+    doc.AddMember("hits", stats.m_hits, allocator);
+    doc.AddMember("misses", stats.m_misses, allocator);
+    doc.AddMember("numHeaders", stats.m_num_headers, allocator);
+    doc.AddMember("maxHeaders", stats.m_max_headers, allocator);
+    doc.AddMember("numInvalidations", stats.m_num_invalidations, allocator);
+    doc.AddMember("numRejected", stats.m_num_rejected, allocator);
+    return env->NewStringUTF(monero_utils::serialize(doc).c_str());
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+    return 0;
+  }
+}
+
+JNIEXPORT void JNICALL Java_monero_utils_MoneroUtils_clearBlockHeaderCacheJni(JNIEnv* env, jclass clazz, jstring jdaemon_uri) {
+  MONERO_TRACE_SPAN("Java_monero_utils_MoneroUtils_clearBlockHeaderCacheJni");
+  try {
+    monero_header_cache::instance(jstring_to_utf(env, jdaemon_uri)).clear();
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+  }
+}
+
+// ------------------------------ ADDRESS UTILS -------------------------------
+
+JNIEXPORT jbooleanArray JNICALL Java_monero_utils_MoneroUtils_validateAddressesJni(JNIEnv* env, jclass clazz, jobjectArray jaddresses, jint network_type) {
+  MONERO_TRACE_SPAN("Java_monero_utils_MoneroUtils_validateAddressesJni");
+  try {
+    vector<string> addresses = jstring_array_to_vector(env, jaddresses);
+    vector<jboolean> valids(addresses.size());
+    monero_decoded_address decoded;
+    for (size_t i = 0; i < addresses.size(); i++) {
+      valids[i] = monero_address_codec::decode(addresses[i], decoded) && (network_type < 0 || decoded.m_network_type == network_type);
+    }
+    jbooleanArray jvalids = env->NewBooleanArray(valids.size());
+    env->SetBooleanArrayRegion(jvalids, 0, valids.size(), valids.data());
+    return jvalids;
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+    return 0;
+  }
+}
+
+JNIEXPORT jintArray JNICALL Java_monero_utils_MoneroUtils_decodeAddressesJni(JNIEnv* env, jclass clazz, jobjectArray jaddresses) {
+  MONERO_TRACE_SPAN("Java_monero_utils_MoneroUtils_decodeAddressesJni");
+  try {
+    vector<string> addresses = jstring_array_to_vector(env, jaddresses);
+    vector<jint> types(addresses.size() * 2, -1);
+    monero_decoded_address decoded;
+    for (size_t i = 0; i < addresses.size(); i++) {
+      if (!monero_address_codec::decode(addresses[i], decoded)) continue;
+      types[i * 2] = decoded.m_network_type;
+      types[i * 2 + 1] = decoded.m_address_type;
+    }
+    jintArray jtypes = env->NewIntArray(types.size());
+    env->SetIntArrayRegion(jtypes, 0, types.size(), types.data());
+    return jtypes;
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+    return 0;
+  }
+}
+
+JNIEXPORT jbyteArray JNICALL Java_monero_utils_MoneroUtils_getIntegratedAddressesJni(JNIEnv* env, jclass clazz, jobjectArray jstandard_addresses, jobjectArray jpayment_ids, jint network_type) {
+  MONERO_TRACE_SPAN("Java_monero_utils_MoneroUtils_getIntegratedAddressesJni");
+  try {
+    vector<string> standard_addresses = jstring_array_to_vector(env, jstandard_addresses);
+    vector<string> payment_ids = jstring_array_to_vector(env, jpayment_ids);
+    vector<string> integrateds(standard_addresses.size() * 2);
+    monero_decoded_address decoded;
+    for (size_t i = 0; i < standard_addresses.size(); i++) {
+
+      // standard address must be a primary address of the network
+      if (!monero_address_codec::decode(standard_addresses[i], decoded)) continue;
+      if (decoded.m_address_type != PRIMARY_ADDRESS || decoded.m_network_type != network_type) continue;
+
+      // use given payment id or else a random one
+      const string payment_id = i < payment_ids.size() ? payment_ids[i] : "";
+      if (payment_id.empty()) decoded.m_payment_id = crypto::rand<crypto::hash8>();
+      else if (!epee::string_tools::hex_to_pod(payment_id, decoded.m_payment_id)) continue;
+      decoded.m_address_type = INTEGRATED_ADDRESS;
+      integrateds[i * 2] = monero_address_codec::encode(decoded);
+      integrateds[i * 2 + 1] = epee::string_tools::pod_to_hex(decoded.m_payment_id);
+    }
+    return pack_strings(env, integrateds);
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+    return 0;
+  }
+}
+
+JNIEXPORT jbyteArray JNICALL Java_monero_utils_MoneroUtils_decodeIntegratedAddressesJni(JNIEnv* env, jclass clazz, jobjectArray jintegrated_addresses, jint network_type) {
+  MONERO_TRACE_SPAN("Java_monero_utils_MoneroUtils_decodeIntegratedAddressesJni");
+  try {
+    vector<string> integrated_addresses = jstring_array_to_vector(env, jintegrated_addresses);
+    vector<string> decodeds(integrated_addresses.size() * 2);
+    monero_decoded_address decoded;
+    for (size_t i = 0; i < integrated_addresses.size(); i++) {
+      if (!monero_address_codec::decode(integrated_addresses[i], decoded)) continue;
+      if (decoded.m_address_type != INTEGRATED_ADDRESS || decoded.m_network_type != network_type) continue;
+      decodeds[i * 2 + 1] = epee::string_tools::pod_to_hex(decoded.m_payment_id);
+      decoded.m_address_type = PRIMARY_ADDRESS;
+      decodeds[i * 2] = monero_address_codec::encode(decoded);
+    }
+    return pack_strings(env, decodeds);
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+    return 0;
+  }
+}
+
+// ------------------------------- BLOCK STREAM -------------------------------
+
+JNIEXPORT jlong JNICALL Java_monero_utils_MoneroUtils_startBlockStreamJni(JNIEnv* env, jclass clazz, jstring juri, jstring jusername, jstring jpassword, jlongArray jstart_heights, jlongArray jend_heights, jint max_in_flight) {
+  MTRACE("Java_monero_utils_MoneroUtils_startBlockStreamJni");
+  MONERO_TRACE_SPAN("Java_monero_utils_MoneroUtils_startBlockStreamJni");
+  try {
+
+    // collect chunks
+    jsize num_chunks = env->GetArrayLength(jstart_heights);
+    vector<jlong> start_heights(num_chunks);
+    vector<jlong> end_heights(num_chunks);
+    env->GetLongArrayRegion(jstart_heights, 0, num_chunks, start_heights.data());
+    env->GetLongArrayRegion(jend_heights, 0, num_chunks, end_heights.data());
+    vector<monero_block_streamer::chunk> chunks(num_chunks);
+    for (jsize i = 0; i < num_chunks; i++) {
+      chunks[i].m_start_height = (uint64_t) start_heights[i];
+      chunks[i].m_end_height = (uint64_t) end_heights[i];
+    }
+
+    // start streaming
+    monero_block_streamer* streamer = new monero_block_streamer(jstring_to_utf(env, juri), jstring_to_utf(env, jusername), jstring_to_utf(env, jpassword), chunks, max_in_flight < 1 ? 1 : max_in_flight);
+    return reinterpret_cast<jlong>(streamer);
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+    return 0;
+  }
+}
+
+JNIEXPORT jbyteArray JNICALL Java_monero_utils_MoneroUtils_nextBlockStreamChunkJni(JNIEnv* env, jclass clazz, jlong jstreamer) {
+  MTRACE("Java_monero_utils_MoneroUtils_nextBlockStreamChunkJni");
+  MONERO_TRACE_SPAN("Java_monero_utils_MoneroUtils_nextBlockStreamChunkJni");
+  monero_block_streamer* streamer = reinterpret_cast<monero_block_streamer*>(jstreamer);
+  try {
+    string blocks_json;
+    if (!streamer->next(blocks_json)) return 0;
+    return string_to_jbytes(env, blocks_json);
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+    return 0;
+  }
+}
+
+JNIEXPORT void JNICALL Java_monero_utils_MoneroUtils_stopBlockStreamJni(JNIEnv* env, jclass clazz, jlong jstreamer) {
+  MTRACE("Java_monero_utils_MoneroUtils_stopBlockStreamJni");
+  MONERO_TRACE_SPAN("Java_monero_utils_MoneroUtils_stopBlockStreamJni");
+  delete reinterpret_cast<monero_block_streamer*>(jstreamer);
+}
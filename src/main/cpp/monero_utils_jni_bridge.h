@@ -27,21 +27,76 @@
 
 // TODO: this causes warning
 std::string jstring2string(JNIEnv *env, jstring jStr);
+jstring string2jstring(JNIEnv *env, const std::string& str);
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-JNIEXPORT jbyteArray JNICALL Java_monero_utils_MoneroUtils_jsonToBinaryJni(JNIEnv *, jclass, jstring);
+JNIEXPORT jbyteArray JNICALL Java_monero_utils_MoneroUtils_jsonToBinaryJni(JNIEnv *, jclass, jbyteArray);
 
-JNIEXPORT jstring JNICALL Java_monero_utils_MoneroUtils_binaryToJsonJni(JNIEnv *, jclass, jbyteArray);
+JNIEXPORT jbyteArray JNICALL Java_monero_utils_MoneroUtils_binaryToJsonJni(JNIEnv *, jclass, jbyteArray);
 
-JNIEXPORT jstring JNICALL Java_monero_utils_MoneroUtils_binaryBlocksToJsonJni(JNIEnv *, jclass, jbyteArray);
+JNIEXPORT jbyteArray JNICALL Java_monero_utils_MoneroUtils_binaryBlocksToJsonJni(JNIEnv *, jclass, jbyteArray);
 
 JNIEXPORT void JNICALL Java_monero_utils_MoneroUtils_initLoggingJni(JNIEnv *, jclass, jstring jpath, jboolean);
 
 JNIEXPORT void JNICALL Java_monero_utils_MoneroUtils_setLogLevelJni(JNIEnv *, jclass, jint);
 
+JNIEXPORT void JNICALL Java_monero_utils_MoneroUtils_startTraceJni(JNIEnv *, jclass, jint);
+
+JNIEXPORT void JNICALL Java_monero_utils_MoneroUtils_stopTraceJni(JNIEnv *, jclass);
+
+JNIEXPORT void JNICALL Java_monero_utils_MoneroUtils_dumpTraceJni(JNIEnv *, jclass, jstring);
+
+JNIEXPORT jbyteArray JNICALL Java_monero_utils_MoneroUtils_getCachedOutputsJni(JNIEnv *, jclass, jstring, jbyteArray);
+
+JNIEXPORT void JNICALL Java_monero_utils_MoneroUtils_putCachedOutputsJni(JNIEnv *, jclass, jstring, jbyteArray);
+
+JNIEXPORT jbyteArray JNICALL Java_monero_utils_MoneroUtils_getCachedOutputDistributionsJni(JNIEnv *, jclass, jstring, jbyteArray);
+
+JNIEXPORT void JNICALL Java_monero_utils_MoneroUtils_putCachedOutputDistributionsJni(JNIEnv *, jclass, jstring, jbyteArray);
+
+JNIEXPORT void JNICALL Java_monero_utils_MoneroUtils_setOutputCacheTipJni(JNIEnv *, jclass, jstring, jlong, jstring, jstring);
+
+JNIEXPORT jlong JNICALL Java_monero_utils_MoneroUtils_getOutputCacheTipHeightJni(JNIEnv *, jclass, jstring);
+
+JNIEXPORT void JNICALL Java_monero_utils_MoneroUtils_setOutputCacheLimitsJni(JNIEnv *, jclass, jstring, jint, jint);
+
+JNIEXPORT jstring JNICALL Java_monero_utils_MoneroUtils_getOutputCacheStatsJni(JNIEnv *, jclass, jstring);
+
+JNIEXPORT void JNICALL Java_monero_utils_MoneroUtils_clearOutputCacheJni(JNIEnv *, jclass, jstring);
+
+JNIEXPORT jboolean JNICALL Java_monero_utils_MoneroUtils_putCachedBlockHeadersJni(JNIEnv *, jclass, jstring, jstring, jlongArray, jobjectArray);
+
+JNIEXPORT jboolean JNICALL Java_monero_utils_MoneroUtils_getCachedBlockHeaderJni(JNIEnv *, jclass, jstring, jlong, jlongArray, jobjectArray);
+
+JNIEXPORT jint JNICALL Java_monero_utils_MoneroUtils_getCachedBlockSizesJni(JNIEnv *, jclass, jstring, jlong, jlongArray);
+
+JNIEXPORT void JNICALL Java_monero_utils_MoneroUtils_setBlockHeaderCacheTipJni(JNIEnv *, jclass, jstring, jlong, jstring, jstring);
+
+JNIEXPORT jlong JNICALL Java_monero_utils_MoneroUtils_getBlockHeaderCacheTipHeightJni(JNIEnv *, jclass, jstring);
+
+JNIEXPORT void JNICALL Java_monero_utils_MoneroUtils_setBlockHeaderCacheLimitJni(JNIEnv *, jclass, jstring, jint);
+
+JNIEXPORT jstring JNICALL Java_monero_utils_MoneroUtils_getBlockHeaderCacheStatsJni(JNIEnv *, jclass, jstring);
+
+JNIEXPORT void JNICALL Java_monero_utils_MoneroUtils_clearBlockHeaderCacheJni(JNIEnv *, jclass, jstring);
+
+JNIEXPORT jbooleanArray JNICALL Java_monero_utils_MoneroUtils_validateAddressesJni(JNIEnv *, jclass, jobjectArray, jint);
+
+JNIEXPORT jintArray JNICALL Java_monero_utils_MoneroUtils_decodeAddressesJni(JNIEnv *, jclass, jobjectArray);
+
+JNIEXPORT jbyteArray JNICALL Java_monero_utils_MoneroUtils_getIntegratedAddressesJni(JNIEnv *, jclass, jobjectArray, jobjectArray, jint);
+
+JNIEXPORT jbyteArray JNICALL Java_monero_utils_MoneroUtils_decodeIntegratedAddressesJni(JNIEnv *, jclass, jobjectArray, jint);
+
+JNIEXPORT jlong JNICALL Java_monero_utils_MoneroUtils_startBlockStreamJni(JNIEnv *, jclass, jstring, jstring, jstring, jlongArray, jlongArray, jint);
+
+JNIEXPORT jbyteArray JNICALL Java_monero_utils_MoneroUtils_nextBlockStreamChunkJni(JNIEnv *, jclass, jlong);
+
+JNIEXPORT void JNICALL Java_monero_utils_MoneroUtils_stopBlockStreamJni(JNIEnv *, jclass, jlong);
+
 #ifdef __cplusplus
 }
 #endif
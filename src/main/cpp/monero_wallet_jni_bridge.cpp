@@ -34,21 +34,161 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <sys/stat.h>
 #include "chacha.h" // TODO: explicitly include because wallet2.h #include "crypto/chacha.h" is ignored
 #include "monero_wallet_jni_bridge.h"
+#include "monero_batch_relay.h"
+#include "monero_json_arena.h"
+#include "monero_lazy_wallet.h"
+#include "monero_byte_throttle.h"
+#include "monero_message_signer.h"
+#include "monero_multisig_coordinator.h"
+#include "monero_output_cache_proxy.h"
+#include "monero_output_store.h"
+#include "monero_parallel.h"
+#include "monero_proof_batch.h"
+#include "monero_subaddress_deriver.h"
+#include "monero_subaddress_table.h"
+#include "monero_send_pipeline.h"
+#include "monero_sync_loop.h"
+#include "monero_sync_stats.h"
+#include "monero_trace.h"
 #include "wallet/monero_wallet_core.h"
 #include "utils/monero_utils.h"
+#include "string_tools.h"
+#include "memwipe.h"
 
 using namespace std;
 using namespace monero;
 
+// logs entry to a JNI function, returning its name for its span
+static const char* log_jni_entry(const char* name) {
+  MTRACE(name);
+  return name;
+}
+
+// logs entry to a JNI function and records its span if tracing is enabled, as a single declaration
+#define MTRACE_SPAN(name) monero_trace_span MONERO_TRACE_CONCAT(_monero_trace_span_, __LINE__)(log_jni_entry(name))
+
+// defined in monero_utils_jni_bridge.cpp
+string jstring2string(JNIEnv* env, jstring jstr);
+jstring string2jstring(JNIEnv* env, const string& str);
+
 // initialize names of private instance variables used in Java JNI wallet which contain memory references to native wallet and listener
 static const char* JNI_WALLET_HANDLE = "jniWalletHandle";
 static const char* JNI_LISTENER_HANDLE = "jniListenerHandle";
+static const char* JNI_SEND_PIPELINE_HANDLE = "jniSendPipelineHandle";
+static const char* JNI_SUBADDRESS_TABLE_HANDLE = "jniSubaddressTableHandle";
+static const char* JNI_LAZY_WALLET_HANDLE = "jniLazyWalletHandle";
+static const char* JNI_OUTPUT_STORE_HANDLE = "jniOutputStoreHandle";
+static const char* JNI_SYNC_STATS_HANDLE = "jniSyncStatsHandle";
+static const char* JNI_OUTPUT_CACHE_PROXY_HANDLE = "jniOutputCacheProxyHandle";
+static const char* JNI_SYNC_LOOP_HANDLE = "jniSyncLoopHandle";
+
+// time between background syncs
+static const std::chrono::milliseconds SYNC_PERIOD(10000);
 
 // ----------------------------- COMMON HELPERS -------------------------------
 
+// mutex of each open wallet which serializes calls into it from java threads and native workers like the send pipeline
+static std::mutex _walletMutexesMutex;
+static std::unordered_map<monero_wallet*, shared_ptr<std::recursive_mutex>> _walletMutexes;
+static std::unordered_map<monero_wallet*, monero_output_cache_proxy*> _walletProxies;
+static std::unordered_map<monero_wallet*, uint64_t> _walletOutputsVersions;
+
+shared_ptr<std::recursive_mutex> get_wallet_mutex(monero_wallet* wallet) {
+  std::lock_guard<std::mutex> lock(_walletMutexesMutex);
+  shared_ptr<std::recursive_mutex>& wallet_mutex = _walletMutexes[wallet];
+  if (wallet_mutex == nullptr) wallet_mutex = make_shared<std::recursive_mutex>();
+  return wallet_mutex;
+}
+
+void remove_wallet_mutex(monero_wallet* wallet) {
+  std::lock_guard<std::mutex> lock(_walletMutexesMutex);
+  _walletMutexes.erase(wallet);
+  _walletProxies.erase(wallet);
+  _walletOutputsVersions.erase(wallet);
+}
+
+// version of each wallet's outputs, incremented by calls which may change them without changing the wallet's height or balance, so the output store rebuilds
+void touch_wallet_outputs(monero_wallet* wallet) {
+  std::lock_guard<std::mutex> lock(_walletMutexesMutex);
+  _walletOutputsVersions[wallet]++;
+}
+
+uint64_t get_wallet_outputs_version(monero_wallet* wallet) {
+  std::lock_guard<std::mutex> lock(_walletMutexesMutex);
+  auto iter = _walletOutputsVersions.find(wallet);
+  return iter == _walletOutputsVersions.end() ? 0 : iter->second;
+}
+
+// output cache proxy of each proxied wallet, for native workers which use the wallet under its mutex
+void set_wallet_proxy(monero_wallet* wallet, monero_output_cache_proxy* proxy) {
+  std::lock_guard<std::mutex> lock(_walletMutexesMutex);
+  if (proxy == nullptr) _walletProxies.erase(wallet);
+  else _walletProxies[wallet] = proxy;
+}
+
+monero_output_cache_proxy* get_wallet_proxy(monero_wallet* wallet) {
+  std::lock_guard<std::mutex> lock(_walletMutexesMutex);
+  auto iter = _walletProxies.find(wallet);
+  return iter == _walletProxies.end() ? nullptr : iter->second;
+}
+
+/**
+ * Holds a wallet's mutex for the duration of a JNI call.
+ *
+ * The mutex is recursive so listeners notified during a call may call back
+ * into the wallet.  Syncs hold it too, including background syncs which the
+ * bridge runs instead of the wallet (see monero_sync_loop), so listeners
+ * notified during a sync must not wait on other threads which call the
+ * wallet.
+ */
+class wallet_lock {
+public:
+  wallet_lock(monero_wallet* wallet) : m_mutex(wallet == nullptr ? nullptr : get_wallet_mutex(wallet)) {
+    if (m_mutex != nullptr) m_mutex->lock();
+  }
+  ~wallet_lock() {
+    if (m_mutex != nullptr) m_mutex->unlock();
+  }
+private:
+  shared_ptr<std::recursive_mutex> m_mutex;
+};
+
+// locks wallets in address order so calls on overlapping wallets cannot deadlock
+vector<unique_ptr<wallet_lock>> lock_wallets(vector<monero_wallet*> wallets) {
+  sort(wallets.begin(), wallets.end());
+  wallets.erase(unique(wallets.begin(), wallets.end()), wallets.end());
+  vector<unique_ptr<wallet_lock>> locks;
+  for (monero_wallet* wallet : wallets) locks.push_back(unique_ptr<wallet_lock>(new wallet_lock(wallet)));
+  return locks;
+}
+
+// gets the keys of a lazily opened wallet while it loads, otherwise null with the wallet to call, which keys missing from the keys file wait for
+const monero_lazy_keys* get_lazy_keys(JNIEnv* env, jobject instance, monero_wallet*& wallet) {
+  wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  if (wallet != nullptr) return nullptr;
+  monero_lazy_wallet* lazy_wallet = get_handle<monero_lazy_wallet>(env, instance, JNI_LAZY_WALLET_HANDLE);
+  if (lazy_wallet == nullptr) return nullptr;
+  if (lazy_wallet->get_keys() != nullptr) return lazy_wallet->get_keys();
+  wallet = lazy_wallet->await();
+  return nullptr;
+}
+
+// get the output store rebuilt if the wallet changed since it was built, or throw if not built
+monero_output_store* get_output_store(JNIEnv* env, jobject instance, monero_wallet* wallet) {
+  monero_output_store* store = get_handle<monero_output_store>(env, instance, JNI_OUTPUT_STORE_HANDLE);
+  if (store == nullptr) throw runtime_error("Output store is not built");
+  store->refresh(*wallet, get_wallet_outputs_version(wallet));
+  return store;
+}
+
 // Based on: https://stackoverflow.com/questions/2054598/how-to-catch-jni-java-exception/2125673#2125673
 void rethrow_cpp_exception_as_java_exception(JNIEnv* env) {
   try {
@@ -89,7 +229,7 @@ void rethrow_java_exception_as_cpp_exception(JNIEnv* env, jthrowable jexception)
   throw runtime_error(msg);
 }
 
-void set_daemon_connection(JNIEnv *env, monero_wallet* wallet, jstring juri, jstring jusername, jstring jpassword) {
+void set_daemon_connection(JNIEnv *env, monero_wallet* wallet, monero_output_cache_proxy* proxy, jstring juri, jstring jusername, jstring jpassword) {
 
   // collect and release string params
   const char* _uri = juri ? env->GetStringUTFChars(juri, NULL) : nullptr;
@@ -102,9 +242,14 @@ void set_daemon_connection(JNIEnv *env, monero_wallet* wallet, jstring juri, jst
   env->ReleaseStringUTFChars(jusername, _username);
   env->ReleaseStringUTFChars(jpassword, _password);
 
-  // set daemon connection
+  // set daemon connection, through the output cache proxy if enabled
   try {
-    wallet->set_daemon_connection(uri, username, password);
+    if (proxy == nullptr) wallet->set_daemon_connection(uri, username, password);
+    else {
+      proxy->set_daemon(uri, username, password);
+      if (uri.empty()) wallet->set_daemon_connection("", "", "");
+      else wallet->set_daemon_connection(proxy->get_uri(), proxy->get_username(), proxy->get_password());
+    }
   } catch (...) {
     rethrow_cpp_exception_as_java_exception(env);
   }
@@ -114,6 +259,101 @@ string strip_last_char(const string& str) {
   return str.substr(0, str.size() - 1);
 }
 
+vector<string> jstring_array_to_vector(JNIEnv* env, jobjectArray jstrs) {
+  vector<string> strs;
+  if (jstrs == nullptr) return strs;
+  jsize size = env->GetArrayLength(jstrs);
+  strs.reserve(size);
+  for (int idx = 0; idx < size; idx++) {
+    jstring jstr = (jstring) env->GetObjectArrayElement(jstrs, idx);
+    const char* _str = jstr ? env->GetStringUTFChars(jstr, NULL) : nullptr;
+    strs.push_back(string(_str ? _str : ""));
+    if (jstr) env->ReleaseStringUTFChars(jstr, _str);
+    env->DeleteLocalRef(jstr);
+  }
+  return strs;
+}
+
+// copies a string, e.g. utf-8 json, to a jbyteArray which java parses without transcoding to utf-16
+jbyteArray string_to_jbytes(JNIEnv* env, const char* str, size_t size) {
+  jbyteArray jbytes = env->NewByteArray(size);
+  if (jbytes == nullptr) return nullptr; // out of memory error thrown
+  env->SetByteArrayRegion(jbytes, 0, size, reinterpret_cast<const jbyte*>(str));
+  return jbytes;
+}
+
+jbyteArray string_to_jbytes(JNIEnv* env, const string& str) {
+  return string_to_jbytes(env, str.data(), str.size());
+}
+
+jbyteArray string_to_jbytes(JNIEnv* env, const rapidjson::StringBuffer& buffer) {
+  return string_to_jbytes(env, buffer.GetString(), buffer.GetSize());
+}
+
+// copies a jbyteArray to a string without pinning the array
+string jbytes_to_string(JNIEnv* env, jbyteArray jbytes) {
+  if (jbytes == nullptr) return "";
+  string str(env->GetArrayLength(jbytes), '\0');
+  env->GetByteArrayRegion(jbytes, 0, str.size(), reinterpret_cast<jbyte*>(&str[0]));
+  return str;
+}
+
+// packs strings into bytes each terminated by a newline
+jbyteArray pack_strings(JNIEnv* env, const vector<string>& strs) {
+  string packed;
+  size_t size = 0;
+  for (const string& str : strs) size += str.size() + 1;
+  packed.reserve(size);
+  for (const string& str : strs) {
+    packed.append(str);
+    packed.push_back('\n');
+  }
+  return string_to_jbytes(env, packed);
+}
+
+// gets the size of a wallet's cache file, which weighs its open when throttling concurrent opens
+uint64_t get_wallet_cache_bytes(const string& path) {
+  struct stat cache_stat;
+  if (stat(path.c_str(), &cache_stat) != 0) return 0;
+  return (uint64_t) cache_stat.st_size;
+}
+
+// packs checks as [is_good, in_tx_pool, num_confirmations, received_amount] per check
+jlongArray pack_check_txs(JNIEnv* env, const vector<shared_ptr<monero_check_tx>>& checks) {
+  vector<jlong> packed;
+  packed.reserve(checks.size() * 4);
+  for (const shared_ptr<monero_check_tx>& check : checks) {
+    packed.push_back(check->m_is_good ? 1 : 0);
+    packed.push_back(check->m_in_tx_pool != boost::none && *check->m_in_tx_pool ? 1 : 0);
+    packed.push_back(check->m_num_confirmations == boost::none ? 0 : (jlong) *check->m_num_confirmations);
+    packed.push_back(check->m_received_amount == boost::none ? 0 : (jlong) *check->m_received_amount);
+  }
+  jlongArray jpacked = env->NewLongArray(packed.size());
+  env->SetLongArrayRegion(jpacked, 0, packed.size(), packed.data());
+  return jpacked;
+}
+
+// gets the network and daemon to check proofs against, which is the proxied daemon if the output cache proxy is enabled
+monero_proof_context get_proof_context(monero_wallet* wallet, monero_output_cache_proxy* proxy) {
+  wallet_lock wallet_guard(wallet);
+  monero_proof_context context;
+  context.m_network_type = wallet->get_network_type();
+  if (proxy != nullptr) {
+    context.m_daemon_uri = proxy->get_daemon_uri();
+    context.m_daemon_username = proxy->get_daemon_username();
+    context.m_daemon_password = proxy->get_daemon_password();
+  } else {
+    boost::optional<monero_rpc_connection> daemon_connection = wallet->get_daemon_connection();
+    if (daemon_connection != boost::none) {
+      if (daemon_connection->m_uri != boost::none) context.m_daemon_uri = daemon_connection->m_uri.get();
+      if (daemon_connection->m_username != boost::none) context.m_daemon_username = daemon_connection->m_username.get();
+      if (daemon_connection->m_password != boost::none) context.m_daemon_password = daemon_connection->m_password.get();
+    }
+  }
+  if (context.m_daemon_uri.empty()) throw runtime_error("Wallet is not connected to daemon");
+  return context;
+}
+
 // ---------------------------- WALLET LISTENER -------------------------------
 
 #ifdef __cplusplus
@@ -176,11 +416,13 @@ struct wallet_jni_listener : public monero_wallet_listener {
 
   jobject jlistener;
   JNIEnv* m_env;
+  shared_ptr<monero_sync_stats> m_stats;  // times upcalls if not null, guarded by _listenerMutex
 
   // TODO: use this env instead of attaching each time? performance improvement?
   wallet_jni_listener(JNIEnv* env, jobject listener) {
     jlistener = env->NewGlobalRef(listener);
     m_env = env;
+    m_stats = nullptr;
   }
 
   ~wallet_jni_listener() {
@@ -190,8 +432,10 @@ struct wallet_jni_listener : public monero_wallet_listener {
   };
 
   void on_sync_progress(uint64_t height, uint64_t start_height, uint64_t end_height, double percent_done, const string& message) {
+    MONERO_TRACE_SPAN("wallet_jni_listener::on_sync_progress");
     std::lock_guard<std::mutex> lock(_listenerMutex);
     if (jlistener == nullptr) return;
+    monero_sync_stats::timer timer(m_stats.get(), monero_sync_stats::ON_SYNC_PROGRESS);
     JNIEnv *env;
     int envStat = attachJVM(&env);	// TODO: necessary to attach every time?
     if (envStat == JNI_ERR) return;
@@ -216,8 +460,10 @@ struct wallet_jni_listener : public monero_wallet_listener {
   }
 
   void on_new_block(uint64_t height) {
+    MONERO_TRACE_SPAN("wallet_jni_listener::on_new_block");
     std::lock_guard<std::mutex> lock(_listenerMutex);
     if (jlistener == nullptr) return;
+    monero_sync_stats::timer timer(m_stats.get(), monero_sync_stats::ON_NEW_BLOCK);
     JNIEnv *env;
     int envStat = attachJVM(&env);
     if (envStat == JNI_ERR) return;
@@ -235,8 +481,10 @@ struct wallet_jni_listener : public monero_wallet_listener {
   }
 
   void on_output_received(const monero_output_wallet& output) {
+    MONERO_TRACE_SPAN("wallet_jni_listener::on_output_received");
     std::lock_guard<std::mutex> lock(_listenerMutex);
     if (jlistener == nullptr) return;
+    monero_sync_stats::timer timer(m_stats.get(), monero_sync_stats::ON_OUTPUT_RECEIVED);
     JNIEnv *env;
     int envStat = attachJVM(&env);
     if (envStat == JNI_ERR) return;
@@ -258,8 +506,10 @@ struct wallet_jni_listener : public monero_wallet_listener {
   }
 
   void on_output_spent(const monero_output_wallet& output) {
+    MONERO_TRACE_SPAN("wallet_jni_listener::on_output_spent");
     std::lock_guard<std::mutex> lock(_listenerMutex);
     if (jlistener == nullptr) return;
+    monero_sync_stats::timer timer(m_stats.get(), monero_sync_stats::ON_OUTPUT_SPENT);
     JNIEnv *env;
     int envStat = attachJVM(&env);
     if (envStat == JNI_ERR) return;
@@ -281,6 +531,57 @@ struct wallet_jni_listener : public monero_wallet_listener {
   }
 };
 
+/**
+ * Forwards wallet notifications to the wallet's sync stats while collected.
+ *
+ * Stays registered until the wallet is closed so a notification from a
+ * background sync never reaches a deleted listener.  Disabling stats only
+ * detaches them, and everything which records into them holds its own
+ * reference, so stats outlive being disabled in the middle of a sync.
+ */
+struct wallet_sync_stats_listener : public monero_wallet_listener {
+
+  shared_ptr<monero_sync_stats> get_stats() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+  }
+
+  void set_stats(shared_ptr<monero_sync_stats> stats) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats = stats;
+  }
+
+  void on_sync_progress(uint64_t height, uint64_t start_height, uint64_t end_height, double percent_done, const string& message) {
+    shared_ptr<monero_sync_stats> stats = get_stats();
+    if (stats != nullptr) stats->on_sync_progress(height, start_height, end_height, percent_done, message);
+  }
+
+  void on_new_block(uint64_t height) {
+    shared_ptr<monero_sync_stats> stats = get_stats();
+    if (stats != nullptr) stats->on_new_block(height);
+  }
+
+  void on_output_received(const monero_output_wallet& output) {
+    shared_ptr<monero_sync_stats> stats = get_stats();
+    if (stats != nullptr) stats->on_output_received(output);
+  }
+
+  void on_output_spent(const monero_output_wallet& output) {
+    shared_ptr<monero_sync_stats> stats = get_stats();
+    if (stats != nullptr) stats->on_output_spent(output);
+  }
+
+private:
+  std::mutex m_mutex;
+  shared_ptr<monero_sync_stats> m_stats;
+};
+
+// sync stats of a wallet if collected, held by the caller so they outlive being disabled
+shared_ptr<monero_sync_stats> get_sync_stats(JNIEnv* env, jobject instance) {
+  wallet_sync_stats_listener* stats_listener = get_handle<wallet_sync_stats_listener>(env, instance, JNI_SYNC_STATS_HANDLE);
+  return stats_listener == nullptr ? nullptr : stats_listener->get_stats();
+}
+
 // ------------------------------- JNI STATIC ---------------------------------
 
 #ifdef __cplusplus
@@ -289,7 +590,7 @@ extern "C"
 #endif
 
 JNIEXPORT jboolean JNICALL Java_monero_wallet_MoneroWalletJni_walletExistsJni(JNIEnv *env, jclass clazz, jstring jpath) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_walletExistsJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_walletExistsJni");
   const char* _path = env->GetStringUTFChars(jpath, NULL);
   string path = string(_path);
   env->ReleaseStringUTFChars(jpath, _path);
@@ -298,7 +599,7 @@ JNIEXPORT jboolean JNICALL Java_monero_wallet_MoneroWalletJni_walletExistsJni(JN
 }
 
 JNIEXPORT jlong JNICALL Java_monero_wallet_MoneroWalletJni_openWalletJni(JNIEnv *env, jclass clazz, jstring jpath, jstring jpassword, jint jnetwork_type) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_openWalletJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_openWalletJni");
   const char* _path = env->GetStringUTFChars(jpath, NULL);
   const char* _password = env->GetStringUTFChars(jpassword, NULL);
   string path = string(_path);
@@ -316,8 +617,72 @@ JNIEXPORT jlong JNICALL Java_monero_wallet_MoneroWalletJni_openWalletJni(JNIEnv
   }
 }
 
+JNIEXPORT jlong JNICALL Java_monero_wallet_MoneroWalletJni_openWalletLazyJni(JNIEnv *env, jclass clazz, jstring jpath, jstring jpassword, jint jnetwork_type) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_openWalletLazyJni");
+  const char* _path = env->GetStringUTFChars(jpath, NULL);
+  const char* _password = env->GetStringUTFChars(jpassword, NULL);
+  string path = string(_path);
+  string password = string(_password);
+  env->ReleaseStringUTFChars(jpath, _path);
+  env->ReleaseStringUTFChars(jpassword, _password);
+
+  // read keys from file and load the rest of the wallet in the background
+  try {
+    monero_lazy_wallet* lazy_wallet = new monero_lazy_wallet(path, password, static_cast<monero_network_type>(jnetwork_type));
+    return reinterpret_cast<jlong>(lazy_wallet);
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+    return 0;
+  }
+}
+
+JNIEXPORT jlongArray JNICALL Java_monero_wallet_MoneroWalletJni_openWalletsJni(JNIEnv *env, jclass clazz, jobjectArray jpaths, jobjectArray jpasswords, jintArray jnetwork_types, jint max_threads, jlong max_open_cache_bytes, jobjectArray jerrors) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_openWalletsJni");
+  vector<jlong> handles;
+  try {
+    vector<string> paths = jstring_array_to_vector(env, jpaths);
+    vector<string> passwords = jstring_array_to_vector(env, jpasswords);
+    if (passwords.size() != paths.size() || (size_t) env->GetArrayLength(jnetwork_types) != paths.size() || (size_t) env->GetArrayLength(jerrors) != paths.size()) throw runtime_error("Must provide a password, network type, and error slot for each wallet");
+    vector<jint> network_types(paths.size());
+    env->GetIntArrayRegion(jnetwork_types, 0, paths.size(), network_types.data());
+
+    // open wallets in parallel since each open is bound by the key derivation and cache decryption, throttled by cache size
+    handles.resize(paths.size(), 0);
+    vector<string> errors(paths.size());
+    monero_byte_throttle throttle(max_open_cache_bytes < 0 ? 0 : max_open_cache_bytes);
+    monero_parallel_for(paths.size(), max_threads < 0 ? 0 : max_threads, [&](size_t i) {
+      try {
+        monero_byte_throttle::reservation reservation(throttle, get_wallet_cache_bytes(paths[i]));
+        MONERO_TRACE_SPAN("monero_wallet_core::open_wallet");
+        monero_wallet* wallet = monero_wallet_core::open_wallet(paths[i], passwords[i], static_cast<monero_network_type>(network_types[i]));
+        handles[i] = reinterpret_cast<jlong>(wallet);
+      } catch (exception& e) {
+        errors[i] = e.what();
+        if (errors[i].empty()) errors[i] = "Failed to open wallet";
+      } catch (...) {
+        errors[i] = "Failed to open wallet";
+      }
+    });
+
+    // return handles and set error of each wallet which failed to open
+    for (size_t i = 0; i < errors.size(); i++) {
+      if (!errors[i].empty()) env->SetObjectArrayElement(jerrors, i, env->NewStringUTF(errors[i].c_str()));
+    }
+    jlongArray jhandles = env->NewLongArray(handles.size());
+    if (jhandles == nullptr) throw bad_alloc();
+    env->SetLongArrayRegion(jhandles, 0, handles.size(), handles.data());
+    return jhandles;
+  } catch (...) {
+
+    // wallets opened before the failure have no owner in java
+    for (jlong handle : handles) delete reinterpret_cast<monero_wallet*>(handle);
+    rethrow_cpp_exception_as_java_exception(env);
+    return 0;
+  }
+}
+
 JNIEXPORT jlong JNICALL Java_monero_wallet_MoneroWalletJni_createWalletRandomJni(JNIEnv *env, jclass clazz, jstring jpath, jstring jpassword, jint jnetwork_type, jstring jdaemon_uri, jstring jdaemon_username, jstring jdaemon_password, jstring jlanguage) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_createWalletRandomJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_createWalletRandomJni");
 
   // collect and release string params
   const char* _path = jpath ? env->GetStringUTFChars(jpath, NULL) : nullptr;
@@ -351,7 +716,7 @@ JNIEXPORT jlong JNICALL Java_monero_wallet_MoneroWalletJni_createWalletRandomJni
 }
 
 JNIEXPORT jlong JNICALL Java_monero_wallet_MoneroWalletJni_createWalletFromMnemonicJni(JNIEnv *env, jclass clazz, jstring jpath, jstring jpassword, jint jnetwork_type, jstring jmnemonic, jlong jrestore_height, jstring joffset) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_createWalletFromMnemonicJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_createWalletFromMnemonicJni");
 
   // collect and release string params
   const char* _path = jpath ? env->GetStringUTFChars(jpath, NULL) : nullptr;
@@ -379,7 +744,7 @@ JNIEXPORT jlong JNICALL Java_monero_wallet_MoneroWalletJni_createWalletFromMnemo
 }
 
 JNIEXPORT jlong JNICALL Java_monero_wallet_MoneroWalletJni_createWalletFromKeysJni(JNIEnv *env, jclass clazz, jstring jpath, jstring jpassword, jint network_type, jstring jaddress, jstring jview_key, jstring jspend_key, jlong restore_height, jstring jlanguage) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_createWalletFromKeysJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_createWalletFromKeysJni");
 
   // collect and release string params
   const char* _path = jpath ? env->GetStringUTFChars(jpath, NULL) : nullptr;
@@ -413,7 +778,7 @@ JNIEXPORT jlong JNICALL Java_monero_wallet_MoneroWalletJni_createWalletFromKeysJ
 }
 
 JNIEXPORT jobjectArray JNICALL Java_monero_wallet_MoneroWalletJni_getMnemonicLanguagesJni(JNIEnv *env, jclass clazz) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_getLanguagesJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getLanguagesJni");
 
   // get languages
   vector<string> languages;
@@ -434,16 +799,36 @@ JNIEXPORT jobjectArray JNICALL Java_monero_wallet_MoneroWalletJni_getMnemonicLan
 
 //  ------------------------------- JNI INSTANCE ------------------------------
 
+JNIEXPORT jboolean JNICALL Java_monero_wallet_MoneroWalletJni_isWalletLoadedJni(JNIEnv *env, jobject instance) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_isWalletLoadedJni");
+  monero_lazy_wallet* lazy_wallet = get_handle<monero_lazy_wallet>(env, instance, JNI_LAZY_WALLET_HANDLE);
+  return static_cast<jboolean>(lazy_wallet == nullptr || lazy_wallet->is_loaded());
+}
+
+JNIEXPORT jlong JNICALL Java_monero_wallet_MoneroWalletJni_awaitWalletJni(JNIEnv *env, jobject instance) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_awaitWalletJni");
+  monero_lazy_wallet* lazy_wallet = get_handle<monero_lazy_wallet>(env, instance, JNI_LAZY_WALLET_HANDLE);
+  try {
+    return reinterpret_cast<jlong>(lazy_wallet->await());
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+    return 0;
+  }
+}
+
 JNIEXPORT jobjectArray JNICALL Java_monero_wallet_MoneroWalletJni_getDaemonConnectionJni(JNIEnv *env, jobject instance) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_getDaemonConnectionJni()");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getDaemonConnectionJni()");
 
   // get wallet
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
 
-  // get daemon connection
+  // get daemon connection, which is the proxied daemon if the output cache proxy is enabled
   try {
     boost::optional<monero_rpc_connection> daemon_connection = wallet->get_daemon_connection();
     if (daemon_connection == boost::none) return 0;
+    monero_output_cache_proxy* proxy = get_handle<monero_output_cache_proxy>(env, instance, JNI_OUTPUT_CACHE_PROXY_HANDLE);
+    if (proxy != nullptr) daemon_connection = monero_rpc_connection(proxy->get_daemon_uri(), proxy->get_daemon_username(), proxy->get_daemon_password());
 
     // return string[uri, username, password]
     jobjectArray vals = env->NewObjectArray(3, env->FindClass("java/lang/String"), nullptr);
@@ -458,17 +843,55 @@ JNIEXPORT jobjectArray JNICALL Java_monero_wallet_MoneroWalletJni_getDaemonConne
 }
 
 JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_setDaemonConnectionJni(JNIEnv *env, jobject instance, jstring juri, jstring jusername, jstring jpassword) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_setDaemonConnectionJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_setDaemonConnectionJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
+  monero_output_cache_proxy* proxy = get_handle<monero_output_cache_proxy>(env, instance, JNI_OUTPUT_CACHE_PROXY_HANDLE);
   try {
-    set_daemon_connection(env, wallet, juri, jusername, jpassword);
+    set_daemon_connection(env, wallet, proxy, juri, jusername, jpassword);
   } catch (...) {
     rethrow_cpp_exception_as_java_exception(env);
   }
 }
 
+JNIEXPORT jlong JNICALL Java_monero_wallet_MoneroWalletJni_setOutputCacheProxyJni(JNIEnv *env, jobject instance, jboolean enabled) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_setOutputCacheProxyJni");
+  monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
+  monero_output_cache_proxy* proxy = get_handle<monero_output_cache_proxy>(env, instance, JNI_OUTPUT_CACHE_PROXY_HANDLE);
+  try {
+    if (enabled) {
+      if (proxy != nullptr) return reinterpret_cast<jlong>(proxy);
+
+      // start proxy to the wallet's daemon and connect the wallet through it
+      boost::optional<monero_rpc_connection> daemon_connection = wallet->get_daemon_connection();
+      string uri = daemon_connection == boost::none || daemon_connection->m_uri == boost::none ? "" : daemon_connection->m_uri.get();
+      string username = daemon_connection == boost::none || daemon_connection->m_username == boost::none ? "" : daemon_connection->m_username.get();
+      string password = daemon_connection == boost::none || daemon_connection->m_password == boost::none ? "" : daemon_connection->m_password.get();
+      std::unique_ptr<monero_output_cache_proxy> new_proxy(new monero_output_cache_proxy(uri, username, password));
+      new_proxy->set_sync_stats(get_sync_stats(env, instance));
+      new_proxy->start();
+      if (!uri.empty()) wallet->set_daemon_connection(new_proxy->get_uri(), new_proxy->get_username(), new_proxy->get_password());
+      set_wallet_proxy(wallet, new_proxy.get());
+      return reinterpret_cast<jlong>(new_proxy.release());
+    }
+
+    // reconnect the wallet to the proxied daemon and stop the proxy
+    if (proxy == nullptr) return 0;
+    string uri = proxy->get_daemon_uri();
+    wallet->set_daemon_connection(uri, proxy->get_daemon_username(), proxy->get_daemon_password());
+    set_wallet_proxy(wallet, nullptr);
+    delete proxy;
+    return 0;
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+    return reinterpret_cast<jlong>(proxy);
+  }
+}
+
 JNIEXPORT jboolean JNICALL Java_monero_wallet_MoneroWalletJni_isConnectedJni(JNIEnv* env, jobject instance) {
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
   try {
     return static_cast<jboolean>(wallet->is_connected());
   } catch (...) {
@@ -479,6 +902,7 @@ JNIEXPORT jboolean JNICALL Java_monero_wallet_MoneroWalletJni_isConnectedJni(JNI
 
 JNIEXPORT jboolean JNICALL Java_monero_wallet_MoneroWalletJni_isDaemonSyncedJni(JNIEnv* env, jobject instance) {
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
   try {
     return wallet->is_daemon_synced();
   } catch (...) {
@@ -489,6 +913,7 @@ JNIEXPORT jboolean JNICALL Java_monero_wallet_MoneroWalletJni_isDaemonSyncedJni(
 
 JNIEXPORT jboolean JNICALL Java_monero_wallet_MoneroWalletJni_isSyncedJni(JNIEnv* env, jobject instance) {
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
   try {
     return wallet->is_synced();
   } catch (...) {
@@ -498,10 +923,12 @@ JNIEXPORT jboolean JNICALL Java_monero_wallet_MoneroWalletJni_isSyncedJni(JNIEnv
 }
 
 JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getVersionJni(JNIEnv *env, jobject instance) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_getVersionJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getVersionJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
   try {
-    return env->NewStringUTF(wallet->get_version().serialize().c_str());
+    monero_json_arena arena;
+    return env->NewStringUTF(arena.serialize(wallet->get_version()).GetString());
   } catch (...) {
     rethrow_cpp_exception_as_java_exception(env);
     return 0;
@@ -509,21 +936,33 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getVersionJni(JNIEn
 }
 
 JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getPathJni(JNIEnv *env, jobject instance) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_getPathJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getPathJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
   return env->NewStringUTF(wallet->get_path().c_str());
 }
 
 JNIEXPORT jint JNICALL Java_monero_wallet_MoneroWalletJni_getNetworkTypeJni(JNIEnv *env, jobject instance) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_getNetworkTypeJni");
-  monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
-  return wallet->get_network_type();
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getNetworkTypeJni");
+  try {
+    monero_wallet* wallet;
+    const monero_lazy_keys* keys = get_lazy_keys(env, instance, wallet);
+    if (keys != nullptr) return keys->get_network_type();
+    wallet_lock wallet_guard(wallet);
+    return wallet->get_network_type();
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+    return 0;
+  }
 }
 
 JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getMnemonicJni(JNIEnv *env, jobject instance) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_getMnemonicJni");
-  monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getMnemonicJni");
   try {
+    monero_wallet* wallet;
+    const monero_lazy_keys* keys = get_lazy_keys(env, instance, wallet);
+    if (keys != nullptr) return env->NewStringUTF(keys->get_mnemonic().c_str());
+    wallet_lock wallet_guard(wallet);
     return env->NewStringUTF(wallet->get_mnemonic().c_str());
   } catch (...) {
     rethrow_cpp_exception_as_java_exception(env);
@@ -532,9 +971,12 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getMnemonicJni(JNIE
 }
 
 JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getMnemonicLanguageJni(JNIEnv *env, jobject instance) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_getMnemonicLanguageJni");
-  monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getMnemonicLanguageJni");
   try {
+    monero_wallet* wallet;
+    const monero_lazy_keys* keys = get_lazy_keys(env, instance, wallet);
+    if (keys != nullptr) return env->NewStringUTF(keys->get_mnemonic_language().c_str());
+    wallet_lock wallet_guard(wallet);
     return env->NewStringUTF(wallet->get_mnemonic_language().c_str());
   } catch (...) {
     rethrow_cpp_exception_as_java_exception(env);
@@ -543,38 +985,190 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getMnemonicLanguage
 }
 
 JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getPublicViewKeyJni(JNIEnv *env, jobject instance) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_getPublicViewKeyJni");
-  monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
-  return env->NewStringUTF(wallet->get_public_view_key().c_str());
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getPublicViewKeyJni");
+  try {
+    monero_wallet* wallet;
+    const monero_lazy_keys* keys = get_lazy_keys(env, instance, wallet);
+    if (keys != nullptr) return env->NewStringUTF(keys->get_public_view_key().c_str());
+    wallet_lock wallet_guard(wallet);
+    return env->NewStringUTF(wallet->get_public_view_key().c_str());
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+    return 0;
+  }
 }
 
 JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getPrivateViewKeyJni(JNIEnv *env, jobject instance) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_getPrivateViewKeyJni");
-  monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
-  return env->NewStringUTF(wallet->get_private_view_key().c_str());
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getPrivateViewKeyJni");
+  try {
+    monero_wallet* wallet;
+    const monero_lazy_keys* keys = get_lazy_keys(env, instance, wallet);
+    if (keys != nullptr) return env->NewStringUTF(keys->get_private_view_key().c_str());
+    wallet_lock wallet_guard(wallet);
+    return env->NewStringUTF(wallet->get_private_view_key().c_str());
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+    return 0;
+  }
 }
 
 JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getPublicSpendKeyJni(JNIEnv *env, jobject instance) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_getPublicSpendKeyJni");
-  monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
-  return env->NewStringUTF(wallet->get_public_spend_key().c_str());
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getPublicSpendKeyJni");
+  try {
+    monero_wallet* wallet;
+    const monero_lazy_keys* keys = get_lazy_keys(env, instance, wallet);
+    if (keys != nullptr) return env->NewStringUTF(keys->get_public_spend_key().c_str());
+    wallet_lock wallet_guard(wallet);
+    return env->NewStringUTF(wallet->get_public_spend_key().c_str());
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+    return 0;
+  }
 }
 
 JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getPrivateSpendKeyJni(JNIEnv *env, jobject instance) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_getPrivateSpendKeyJni");
-  monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
-  return env->NewStringUTF(wallet->get_private_spend_key().c_str());
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getPrivateSpendKeyJni");
+  try {
+    monero_wallet* wallet;
+    const monero_lazy_keys* keys = get_lazy_keys(env, instance, wallet);
+    if (keys != nullptr) return env->NewStringUTF(keys->get_private_spend_key().c_str());
+    wallet_lock wallet_guard(wallet);
+    return env->NewStringUTF(wallet->get_private_spend_key().c_str());
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+    return 0;
+  }
 }
 
 JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getAddressJni(JNIEnv *env, jobject instance, jint account_idx, jint subaddress_idx) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_getAddressJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getAddressJni");
+  try {
+    monero_wallet* wallet;
+    const monero_lazy_keys* keys = get_lazy_keys(env, instance, wallet);
+    if (keys != nullptr) return env->NewStringUTF(keys->get_address((uint32_t) account_idx, (uint32_t) subaddress_idx).c_str());
+    wallet_lock wallet_guard(wallet);
+    return env->NewStringUTF(wallet->get_address((uint32_t) account_idx, (uint32_t) subaddress_idx).c_str());
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+    return 0;
+  }
+}
+
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_getAddressesJni(JNIEnv *env, jobject instance, jint account_idx, jint start_idx, jint end_idx, jint max_threads) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getAddressesJni");
+  monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
+  try {
+    if (account_idx < 0) throw runtime_error("Account index must be >= 0");
+    if (start_idx < 0 || start_idx > end_idx) throw runtime_error("Subaddress range must satisfy 0 <= start <= end");
+    monero_subaddress_deriver deriver(static_cast<cryptonote::network_type>(wallet->get_network_type()), wallet->get_address(0, 0), wallet->get_private_view_key());
+    return pack_strings(env, deriver.derive_addresses((uint32_t) account_idx, (uint32_t) start_idx, (uint32_t) end_idx, max_threads));
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+    return 0;
+  }
+}
+
+JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_buildOutputStoreJni(JNIEnv *env, jobject instance) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_buildOutputStoreJni");
+  monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
+  try {
+    monero_output_store* store = new monero_output_store(*wallet, get_wallet_outputs_version(wallet));
+
+    // replace previous store, publishing the new handle before the wallet is unlocked
+    monero_output_store* prev_store = get_handle<monero_output_store>(env, instance, JNI_OUTPUT_STORE_HANDLE);
+    set_handle(env, instance, JNI_OUTPUT_STORE_HANDLE, store);
+    if (prev_store != nullptr) delete prev_store;
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+  }
+}
+
+JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_freeOutputStoreJni(JNIEnv *env, jobject instance) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_freeOutputStoreJni");
+  monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
+  monero_output_store* store = get_handle<monero_output_store>(env, instance, JNI_OUTPUT_STORE_HANDLE);
+  set_handle<monero_output_store>(env, instance, JNI_OUTPUT_STORE_HANDLE, nullptr);
+  if (store != nullptr) delete store;
+}
+
+JNIEXPORT jlongArray JNICALL Java_monero_wallet_MoneroWalletJni_getOutputStoreStatsJni(JNIEnv *env, jobject instance) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getOutputStoreStatsJni");
+  monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
+  try {
+    monero_output_store* store = get_handle<monero_output_store>(env, instance, JNI_OUTPUT_STORE_HANDLE);
+    jlong stats[3] = { 0, 0, 0 };
+    if (store != nullptr) {
+      store->refresh(*wallet, get_wallet_outputs_version(wallet));
+      stats[0] = store->size();
+      stats[1] = store->get_num_txs();
+      stats[2] = store->get_memory_size();
+    }
+    jlongArray jstats = env->NewLongArray(3);
+    env->SetLongArrayRegion(jstats, 0, 3, stats);
+    return jstats;
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+    return 0;
+  }
+}
+
+JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getOutputStoreBalanceJni(JNIEnv *env, jobject instance, jint account_idx, jint subaddress_idx) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getOutputStoreBalanceJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
-  string address = wallet->get_address((uint32_t) account_idx, (uint32_t) subaddress_idx);
-  return env->NewStringUTF(address.c_str());
+  wallet_lock wallet_guard(wallet);
+  try {
+    monero_output_store* store = get_output_store(env, instance, wallet);
+    monero_output_store::query query;
+    query.m_account_idx = account_idx;
+    query.m_subaddress_idx = subaddress_idx;
+    query.m_is_spent = 0;
+    uint64_t balance = store->get_amount(query);
+    return env->NewStringUTF(boost::lexical_cast<std::string>(balance).c_str());
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+    return 0;
+  }
+}
+
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_getOutputStoreOutputsJni(JNIEnv *env, jobject instance, jint account_idx, jint subaddress_idx, jint is_spent) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getOutputStoreOutputsJni");
+  monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
+  try {
+    monero_output_store* store = get_output_store(env, instance, wallet);
+    monero_output_store::query query;
+    query.m_account_idx = account_idx;
+    query.m_subaddress_idx = subaddress_idx;
+    query.m_is_spent = is_spent;
+    vector<uint32_t> positions = store->find(query);
+
+    // pack fields of each output as account, subaddress, amount, index, height (empty if unconfirmed), is spent, is frozen, tx hash, key image
+    vector<string> fields;
+    fields.reserve(positions.size() * 9);
+    for (uint32_t pos : positions) {
+      fields.push_back(to_string(store->get_account_idx(pos)));
+      fields.push_back(to_string(store->get_subaddress_idx(pos)));
+      fields.push_back(to_string(store->get_amount(pos)));
+      fields.push_back(to_string(store->get_index(pos)));
+      fields.push_back(store->is_confirmed(pos) ? to_string(store->get_height(pos)) : "");
+      fields.push_back(store->is_spent(pos) ? "1" : "0");
+      fields.push_back(store->is_frozen(pos) ? "1" : "0");
+      fields.push_back(epee::string_tools::pod_to_hex(store->get_tx_hash(pos)));
+      fields.push_back(epee::string_tools::pod_to_hex(store->get_key_image(pos)));
+    }
+    return pack_strings(env, fields);
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+    return 0;
+  }
 }
 
-JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getAddressIndexJni(JNIEnv *env, jobject instance, jstring jaddress) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_getAddressIndexJni");
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_getAddressIndexJni(JNIEnv *env, jobject instance, jstring jaddress) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getAddressIndexJni");
 
   // collect and release string param
   const char* _address = jaddress ? env->GetStringUTFChars(jaddress, NULL) : nullptr;
@@ -584,9 +1178,89 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getAddressIndexJni(
   // get indices of addresse's subaddress
   try {
     monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+    wallet_lock wallet_guard(wallet);
     monero_subaddress subaddress = wallet->get_address_index(address);
-    string subaddress_json = subaddress.serialize();
-    return env->NewStringUTF(subaddress_json.c_str());
+    monero_json_arena arena;
+    return string_to_jbytes(env, arena.serialize(subaddress));
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+    return 0;
+  }
+}
+
+JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_buildSubaddressTableJni(JNIEnv *env, jobject instance, jint num_accounts, jint num_subaddresses, jint max_threads) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_buildSubaddressTableJni");
+  monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
+  try {
+    if (num_accounts < 1) throw runtime_error("Number of accounts must be > 0");
+    if (num_subaddresses < 1) throw runtime_error("Number of subaddresses must be > 0");
+    monero_subaddress_deriver deriver(static_cast<cryptonote::network_type>(wallet->get_network_type()), wallet->get_address(0, 0), wallet->get_private_view_key());
+    monero_subaddress_table* table = new monero_subaddress_table(deriver, (uint32_t) num_accounts, (uint32_t) num_subaddresses, max_threads);
+
+    // replace previous table, publishing the new handle before the wallet is unlocked
+    monero_subaddress_table* prev_table = get_handle<monero_subaddress_table>(env, instance, JNI_SUBADDRESS_TABLE_HANDLE);
+    set_handle(env, instance, JNI_SUBADDRESS_TABLE_HANDLE, table);
+    if (prev_table != nullptr) delete prev_table;
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+  }
+}
+
+JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_freeSubaddressTableJni(JNIEnv *env, jobject instance) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_freeSubaddressTableJni");
+  monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
+  monero_subaddress_table* table = get_handle<monero_subaddress_table>(env, instance, JNI_SUBADDRESS_TABLE_HANDLE);
+  set_handle<monero_subaddress_table>(env, instance, JNI_SUBADDRESS_TABLE_HANDLE, nullptr);
+  if (table != nullptr) delete table;
+}
+
+JNIEXPORT jlongArray JNICALL Java_monero_wallet_MoneroWalletJni_getSubaddressTableStatsJni(JNIEnv *env, jobject instance) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getSubaddressTableStatsJni");
+  monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
+  monero_subaddress_table* table = get_handle<monero_subaddress_table>(env, instance, JNI_SUBADDRESS_TABLE_HANDLE);
+  jlong stats[2] = { 0, 0 };
+  if (table != nullptr) {
+    stats[0] = table->size();
+    stats[1] = table->get_memory_size();
+  }
+  jlongArray jstats = env->NewLongArray(2);
+  env->SetLongArrayRegion(jstats, 0, 2, stats);
+  return jstats;
+}
+
+JNIEXPORT jintArray JNICALL Java_monero_wallet_MoneroWalletJni_getAddressIndicesJni(JNIEnv *env, jobject instance, jobjectArray jaddresses) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getAddressIndicesJni");
+  monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
+  monero_subaddress_table* table = get_handle<monero_subaddress_table>(env, instance, JNI_SUBADDRESS_TABLE_HANDLE);
+  vector<string> addresses = jstring_array_to_vector(env, jaddresses);
+  try {
+
+    // look up the account and subaddress index of each address in the table or else the wallet
+    vector<int32_t> indices;
+    if (table != nullptr) {
+      indices = table->find_addresses(static_cast<cryptonote::network_type>(wallet->get_network_type()), addresses);
+    } else {
+      indices.assign(addresses.size() * 2, -1);
+      for (int i = 0; i < addresses.size(); i++) {
+        try {
+          monero_subaddress subaddress = wallet->get_address_index(addresses[i]);
+          indices[i * 2] = *subaddress.m_account_index;
+          indices[i * 2 + 1] = *subaddress.m_index;
+        } catch (...) {
+          // address is not in the wallet
+        }
+      }
+    }
+
+    // return packed indices
+    vector<jint> jindices_vals(indices.begin(), indices.end());
+    jintArray jindices = env->NewIntArray(jindices_vals.size());
+    env->SetIntArrayRegion(jindices, 0, jindices_vals.size(), jindices_vals.data());
+    return jindices;
   } catch (...) {
     rethrow_cpp_exception_as_java_exception(env);
     return 0;
@@ -598,8 +1272,9 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getAddressIndexJni(
  * and registers the new listener.
  */
 JNIEXPORT jlong JNICALL Java_monero_wallet_MoneroWalletJni_setListenerJni(JNIEnv *env, jobject instance, jobject jlistener) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_setListenerJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_setListenerJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
 
   // remove old listener
   wallet_jni_listener* old_listener = get_handle<wallet_jni_listener>(env, instance, JNI_LISTENER_HANDLE);
@@ -608,16 +1283,18 @@ JNIEXPORT jlong JNICALL Java_monero_wallet_MoneroWalletJni_setListenerJni(JNIEnv
     delete old_listener;
   }
 
-  // add new listener
+  // add new listener which times upcalls if collecting sync stats
   if (jlistener == nullptr) return 0;
   wallet_jni_listener* listener = new wallet_jni_listener(env, jlistener);
+  listener->m_stats = get_sync_stats(env, instance);
   wallet->add_listener(*listener);
   return reinterpret_cast<jlong>(listener);
 }
 
 JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getIntegratedAddressJni(JNIEnv *env, jobject instance, jstring jstandard_address, jstring jpayment_id) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_getIntegratedAddressJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getIntegratedAddressJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
 
   // collect and release string params
   const char* _standardAddress = jstandard_address ? env->GetStringUTFChars(jstandard_address, NULL) : nullptr;
@@ -630,8 +1307,8 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getIntegratedAddres
   // get and serialize integrated address
   try {
     monero_integrated_address integrated_address = wallet->get_integrated_address(standard_address, payment_id);
-    string integrated_address_json = integrated_address.serialize();
-    return env->NewStringUTF(integrated_address_json.c_str());
+    monero_json_arena arena;
+    return env->NewStringUTF(arena.serialize(integrated_address).GetString());
   } catch (...) {
     rethrow_cpp_exception_as_java_exception(env);
     return 0;
@@ -639,8 +1316,9 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getIntegratedAddres
 }
 
 JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_decodeIntegratedAddressJni(JNIEnv *env, jobject instance, jstring jintegrated_address) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_decodeIntegratedAddressJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_decodeIntegratedAddressJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
   const char* _integratedAddress = jintegrated_address ? env->GetStringUTFChars(jintegrated_address, NULL) : nullptr;
   string integrated_address = string(_integratedAddress ? _integratedAddress : "");
   env->ReleaseStringUTFChars(jintegrated_address, _integratedAddress);
@@ -648,8 +1326,8 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_decodeIntegratedAdd
   // serialize and return decoded integrated address
   try {
     monero_integrated_address integrated_address = wallet->decode_integrated_address(string(_integratedAddress ? _integratedAddress : ""));
-    string integrated_address_json = integrated_address.serialize();
-    return env->NewStringUTF(integrated_address_json.c_str());
+    monero_json_arena arena;
+    return env->NewStringUTF(arena.serialize(integrated_address).GetString());
   } catch (...) {
     rethrow_cpp_exception_as_java_exception(env);
     return 0;
@@ -657,14 +1335,16 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_decodeIntegratedAdd
 }
 
 JNIEXPORT jlong JNICALL Java_monero_wallet_MoneroWalletJni_getHeightJni(JNIEnv *env, jobject instance) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_getHeightJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getHeightJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
   return wallet->get_height();
 }
 
 JNIEXPORT jlong JNICALL Java_monero_wallet_MoneroWalletJni_getChainHeightJni(JNIEnv *env, jobject instance) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_getChainHeightJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getChainHeightJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
   try {
     return wallet->get_daemon_height();
   } catch (...) {
@@ -674,14 +1354,16 @@ JNIEXPORT jlong JNICALL Java_monero_wallet_MoneroWalletJni_getChainHeightJni(JNI
 }
 
 JNIEXPORT jlong JNICALL Java_monero_wallet_MoneroWalletJni_getRestoreHeightJni(JNIEnv *env, jobject instance) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_getRestoreHeightJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getRestoreHeightJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
   return wallet->get_restore_height();
 }
 
 JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_setRestoreHeightJni(JNIEnv *env, jobject instance, jlong restore_height) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_setRestoreHeightJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_setRestoreHeightJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
   try {
     wallet->set_restore_height(restore_height);
   } catch (...) {
@@ -691,6 +1373,7 @@ JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_setRestoreHeightJni(JN
 
 JNIEXPORT jlong JNICALL Java_monero_wallet_MoneroWalletJni_getDaemonHeightJni(JNIEnv* env, jobject instance) {
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
   try {
     return wallet->get_daemon_height();
   } catch (...) {
@@ -701,6 +1384,7 @@ JNIEXPORT jlong JNICALL Java_monero_wallet_MoneroWalletJni_getDaemonHeightJni(JN
 
 JNIEXPORT jlong JNICALL Java_monero_wallet_MoneroWalletJni_getDaemonMaxPeerHeightJni(JNIEnv* env, jobject instance) {
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
   try {
     return wallet->get_daemon_max_peer_height();
   } catch (...) {
@@ -710,12 +1394,21 @@ JNIEXPORT jlong JNICALL Java_monero_wallet_MoneroWalletJni_getDaemonMaxPeerHeigh
 }
 
 JNIEXPORT jobjectArray JNICALL Java_monero_wallet_MoneroWalletJni_syncJni(JNIEnv *env, jobject instance, jlong start_height) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_syncJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_syncJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
+  touch_wallet_outputs(wallet);
   try {
 
-    // sync wallet
-    monero_sync_result result = wallet->sync(start_height);
+    // sync wallet, timing the sync if collecting sync stats
+    shared_ptr<monero_sync_stats> stats = get_sync_stats(env, instance);
+    monero_sync_result result;
+    {
+      monero_sync_stats::sync_timer timer(stats.get());
+      MONERO_TRACE_SPAN("monero_wallet::sync");
+      result = wallet->sync(start_height);
+      timer.set_num_blocks_fetched(result.m_num_blocks_fetched);
+    }
 
     // build and return results as Object[2]{(long) num_blocks_fetched, (boolean) received_money}
     jobjectArray results = env->NewObjectArray(2, env->FindClass("java/lang/Object"), nullptr);
@@ -734,29 +1427,138 @@ JNIEXPORT jobjectArray JNICALL Java_monero_wallet_MoneroWalletJni_syncJni(JNIEnv
   }
 }
 
-JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_startSyncingJni(JNIEnv *env, jobject instance) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_startSyncingJni");
-  monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+/**
+ * Starts or stops collecting sync stats.  The stats are fed by a listener to
+ * the wallet which is kept until the wallet is closed and returned as the
+ * handle, and are shared with the JNI listener to time upcalls to Java and
+ * with the output cache proxy to time daemon requests.
+ */
+JNIEXPORT jlong JNICALL Java_monero_wallet_MoneroWalletJni_setSyncStatsJni(JNIEnv *env, jobject instance, jboolean enabled) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_setSyncStatsJni");
+  monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
+  wallet_sync_stats_listener* stats_listener = get_handle<wallet_sync_stats_listener>(env, instance, JNI_SYNC_STATS_HANDLE);
+  try {
+    shared_ptr<monero_sync_stats> stats;
+    if (enabled) {
+      if (stats_listener != nullptr && stats_listener->get_stats() != nullptr) return reinterpret_cast<jlong>(stats_listener);
+      if (stats_listener == nullptr) {
+        stats_listener = new wallet_sync_stats_listener();
+        wallet->add_listener(*stats_listener);
+      }
+      stats = make_shared<monero_sync_stats>();
+    } else if (stats_listener == nullptr) {
+      return 0;
+    }
+
+    // attach or detach the stats everywhere they are recorded
+    stats_listener->set_stats(stats);
+    monero_output_cache_proxy* proxy = get_handle<monero_output_cache_proxy>(env, instance, JNI_OUTPUT_CACHE_PROXY_HANDLE);
+    if (proxy != nullptr) proxy->set_sync_stats(stats);
+    wallet_jni_listener* listener = get_handle<wallet_jni_listener>(env, instance, JNI_LISTENER_HANDLE);
+    if (listener != nullptr) {
+      std::lock_guard<std::mutex> lock(_listenerMutex);
+      listener->m_stats = stats;
+    }
+    return reinterpret_cast<jlong>(stats_listener);
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+    return reinterpret_cast<jlong>(stats_listener);
+  }
+}
+
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_getSyncStatsJni(JNIEnv *env, jobject instance) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getSyncStatsJni");
+  try {
+    shared_ptr<monero_sync_stats> stats = get_sync_stats(env, instance);
+    if (stats == nullptr) throw runtime_error("Sync stats are not enabled");
+    monero_sync_stats::snapshot snapshot = stats->get_snapshot();
+
+    // serialize counters and timings of each stage
+    monero_json_arena arena;
+    rapidjson::Document& doc = arena.doc();
+    doc.SetObject();
+    rapidjson::Document::AllocatorType& allocator = doc.GetAllocator();
+    doc.AddMember("height", snapshot.m_height, allocator);
+    doc.AddMember("numBlocks", snapshot.m_num_blocks, allocator);
+    doc.AddMember("numBlocksFetched", snapshot.m_num_blocks_fetched, allocator);
+    doc.AddMember("numOutputsReceived", snapshot.m_num_outputs_received, allocator);
+    doc.AddMember("numOutputsSpent", snapshot.m_num_outputs_spent, allocator);
+    doc.AddMember("bytesDownloaded", snapshot.m_bytes_downloaded, allocator);
+    doc.AddMember("blocksPerSecond", snapshot.m_blocks_per_second, allocator);
+    rapidjson::Value stages(rapidjson::kArrayType);
+    for (const monero_sync_stats::stage_stats& stage_stats : snapshot.m_stages) {
+      rapidjson::Value stage(rapidjson::kObjectType);
+      rapidjson::Value name;
+      name.SetString(stage_stats.m_name.c_str(), stage_stats.m_name.size(), allocator);
+      stage.AddMember("name", name, allocator);
+      stage.AddMember("count", stage_stats.m_count, allocator);
+      stage.AddMember("totalMs", stage_stats.m_total_us / 1000.0, allocator);
+      stage.AddMember("avgMs", stage_stats.m_count == 0 ? 0.0 : stage_stats.m_total_us / 1000.0 / stage_stats.m_count, allocator);
+      stage.AddMember("maxMs", stage_stats.m_max_us / 1000.0, allocator);
+      stages.PushBack(stage, allocator);
+    }
+    doc.AddMember("stages", stages, allocator);
+    return string_to_jbytes(env, arena.serialize());
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+    return 0;
+  }
+}
+
+JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_resetSyncStatsJni(JNIEnv *env, jobject instance) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_resetSyncStatsJni");
   try {
-    wallet->start_syncing();
+    shared_ptr<monero_sync_stats> stats = get_sync_stats(env, instance);
+    if (stats == nullptr) throw runtime_error("Sync stats are not enabled");
+    stats->reset();
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+  }
+}
+
+JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_startSyncingJni(JNIEnv *env, jobject instance) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_startSyncingJni");
+  monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
+  try {
+    if (!wallet->is_connected()) throw runtime_error("Wallet is not connected to daemon");
+
+    // sync in a loop which locks the wallet around each sync
+    monero_sync_loop* loop = get_handle<monero_sync_loop>(env, instance, JNI_SYNC_LOOP_HANDLE);
+    if (loop == nullptr) {
+      shared_ptr<std::recursive_mutex> wallet_mutex = get_wallet_mutex(wallet);
+      loop = new monero_sync_loop([wallet, wallet_mutex]() {
+        std::lock_guard<std::recursive_mutex> lock(*wallet_mutex);
+        MONERO_TRACE_SPAN("monero_wallet::sync");
+        touch_wallet_outputs(wallet);
+        wallet->sync();
+      }, SYNC_PERIOD);
+      set_handle(env, instance, JNI_SYNC_LOOP_HANDLE, loop);
+    }
+    loop->start();
   } catch (...) {
     rethrow_cpp_exception_as_java_exception(env);
   }
 }
 
 JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_stopSyncingJni(JNIEnv *env, jobject instance) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_stopSyncingJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_stopSyncingJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
   try {
-    wallet->stop_syncing();
+    monero_sync_loop* loop = get_handle<monero_sync_loop>(env, instance, JNI_SYNC_LOOP_HANDLE);
+    if (loop != nullptr) loop->stop();
   } catch (...) {
     rethrow_cpp_exception_as_java_exception(env);
   }
 }
 
 JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_rescanSpentJni(JNIEnv *env, jobject instance) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_rescanSpentJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_rescanSpentJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
+  touch_wallet_outputs(wallet);
   try {
     wallet->rescan_spent();
   } catch (...) {
@@ -765,8 +1567,10 @@ JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_rescanSpentJni(JNIEnv
 }
 
 JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_rescanBlockchainJni(JNIEnv *env, jobject instance) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_rescanBlockchainJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_rescanBlockchainJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
+  touch_wallet_outputs(wallet);
   try {
     wallet->rescan_blockchain();
   } catch (...) {
@@ -775,95 +1579,101 @@ JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_rescanBlockchainJni(JN
 }
 
 JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getBalanceWalletJni(JNIEnv *env, jobject instance) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_getBalanceWalletJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getBalanceWalletJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
   uint64_t balance = wallet->get_balance();
   return env->NewStringUTF(boost::lexical_cast<std::string>(balance).c_str());
 }
 
 JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getBalanceAccountJni(JNIEnv *env, jobject instance, jint account_idx) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_getBalanceAccountJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getBalanceAccountJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
   uint64_t balance = wallet->get_balance(account_idx);
   return env->NewStringUTF(boost::lexical_cast<std::string>(balance).c_str());
 }
 
 JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getBalanceSubaddressJni(JNIEnv *env, jobject instance, jint account_idx, jint subaddress_idx) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_getBalanceSubaddressJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getBalanceSubaddressJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
   uint64_t balance = wallet->get_balance(account_idx, subaddress_idx);
   return env->NewStringUTF(boost::lexical_cast<std::string>(balance).c_str());
 }
 
 JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getUnlockedBalanceWalletJni(JNIEnv *env, jobject instance) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_getUnlockedBalanceWalletJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getUnlockedBalanceWalletJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
   uint64_t balance = wallet->get_unlocked_balance();
   return env->NewStringUTF(boost::lexical_cast<std::string>(balance).c_str());
 }
 
 JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getUnlockedBalanceAccountJni(JNIEnv *env, jobject instance, jint account_idx) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_getUnlockedBalanceAccountJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getUnlockedBalanceAccountJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
   uint64_t balance = wallet->get_unlocked_balance(account_idx);
   return env->NewStringUTF(boost::lexical_cast<std::string>(balance).c_str());
 }
 
 JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getUnlockedBalanceSubaddressJni(JNIEnv *env, jobject instance, jint account_idx, jint subaddress_idx) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_getUnlockedBalanceSubaddressJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getUnlockedBalanceSubaddressJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
   uint64_t balance = wallet->get_unlocked_balance(account_idx, subaddress_idx);
   return env->NewStringUTF(boost::lexical_cast<std::string>(balance).c_str());
 }
 
-JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getAccountsJni(JNIEnv* env, jobject instance, jboolean include_subaddresses, jstring jtag) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_getAccountsJni");
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_getAccountsJni(JNIEnv* env, jobject instance, jboolean include_subaddresses, jstring jtag) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getAccountsJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
-  const char* _tag = jtag ? env->GetStringUTFChars(jtag, NULL) : nullptr;
-  string tag = string(_tag ? _tag : "");
-  env->ReleaseStringUTFChars(jtag, _tag);
+  wallet_lock wallet_guard(wallet);
+  string tag = jstring2string(env, jtag);
 
   // get accounts
   vector<monero_account> accounts = wallet->get_accounts(include_subaddresses, tag);
 
   // wrap and serialize accounts
-  rapidjson::Document doc;
+  monero_json_arena arena;
+  rapidjson::Document& doc = arena.doc();
   doc.SetObject();
   doc.AddMember("accounts", monero_utils::to_rapidjson_val(doc.GetAllocator(), accounts), doc.GetAllocator());
-  string accounts_json = monero_utils::serialize(doc);
-  return env->NewStringUTF(accounts_json.c_str());
+  return string_to_jbytes(env, arena.serialize());
 }
 
-JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getAccountJni(JNIEnv* env, jobject instance, jint account_idx, jboolean include_subaddresses) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_getAccountJni");
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_getAccountJni(JNIEnv* env, jobject instance, jint account_idx, jboolean include_subaddresses) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getAccountJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
 
   // get account
   monero_account account = wallet->get_account(account_idx, include_subaddresses);
 
   // serialize and return account
-  string account_json = account.serialize();
-  return env->NewStringUTF(account_json.c_str());
+  monero_json_arena arena;
+  return string_to_jbytes(env, arena.serialize(account));
 }
 
-JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_createAccountJni(JNIEnv* env, jobject instance, jstring jlabel) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_createAccountJni");
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_createAccountJni(JNIEnv* env, jobject instance, jstring jlabel) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_createAccountJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
-  const char* _label = jlabel ? env->GetStringUTFChars(jlabel, NULL) : nullptr;
-  string label = string(_label ? _label : "");
-  env->ReleaseStringUTFChars(jlabel, _label);
+  wallet_lock wallet_guard(wallet);
+  string label = jstring2string(env, jlabel);
 
   // create account
   monero_account account = wallet->create_account(label);
 
   // serialize and return account
-  string account_json = account.serialize();
-  return env->NewStringUTF(account_json.c_str());
+  monero_json_arena arena;
+  return string_to_jbytes(env, arena.serialize(account));
 }
 
-JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getSubaddressesJni(JNIEnv* env, jobject instance, jint account_idx, jintArray jsubaddressIndices) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_getSubaddressesJni");
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_getSubaddressesJni(JNIEnv* env, jobject instance, jint account_idx, jintArray jsubaddressIndices) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getSubaddressesJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
 
   // convert subaddress indices from jintArray to vector<uint32_t>
   vector<uint32_t> subaddress_indices;
@@ -879,34 +1689,60 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getSubaddressesJni(
   vector<monero_subaddress> subaddresses = wallet->get_subaddresses(account_idx, subaddress_indices);
 
   // wrap and serialize subaddresses
-  rapidjson::Document doc;
+  monero_json_arena arena;
+  rapidjson::Document& doc = arena.doc();
   doc.SetObject();
   doc.AddMember("subaddresses", monero_utils::to_rapidjson_val(doc.GetAllocator(), subaddresses), doc.GetAllocator());
-  string subaddresses_json = monero_utils::serialize(doc);
-  return env->NewStringUTF(subaddresses_json.c_str());
+  return string_to_jbytes(env, arena.serialize());
 }
 
-JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_createSubaddressJni(JNIEnv* env, jobject instance, jint account_idx, jstring jlabel) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_createSubaddressJni");
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_createSubaddressJni(JNIEnv* env, jobject instance, jint account_idx, jstring jlabel) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_createSubaddressJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
-  const char* _label = jlabel ? env->GetStringUTFChars(jlabel, NULL) : nullptr;
-  string label = string(_label ? _label : "");
-  env->ReleaseStringUTFChars(jlabel, _label);
+  wallet_lock wallet_guard(wallet);
+  string label = jstring2string(env, jlabel);
 
   // create subaddress
   monero_subaddress subaddress = wallet->create_subaddress(account_idx, label);
 
   // serialize and return subaddress
-  string subaddress_json = subaddress.serialize();
-  return env->NewStringUTF(subaddress_json.c_str());
+  monero_json_arena arena;
+  return string_to_jbytes(env, arena.serialize(subaddress));
+}
+
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_createSubaddressesJni(JNIEnv* env, jobject instance, jint account_idx, jint num_subaddresses, jstring jlabel, jintArray jfirst_idx) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_createSubaddressesJni");
+  monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
+  try {
+    if (account_idx < 0) throw runtime_error("Account index must be >= 0");
+    if (num_subaddresses < 0) throw runtime_error("Number of subaddresses must be >= 0");
+    string label = jstring2string(env, jlabel);
+
+    // create subaddresses under one hold of the wallet, which extends its lookahead by one subaddress per creation and saves nothing
+    vector<string> addresses;
+    addresses.reserve(num_subaddresses);
+    jint first_idx = 0;
+    for (jint i = 0; i < num_subaddresses; i++) {
+      monero_subaddress subaddress = wallet->create_subaddress(static_cast<uint32_t>(account_idx), label);
+      if (i == 0) first_idx = static_cast<jint>(*subaddress.m_index);
+      addresses.push_back(*subaddress.m_address);
+    }
+
+    // return the index of the first subaddress and the packed addresses
+    if (jfirst_idx != nullptr) env->SetIntArrayRegion(jfirst_idx, 0, 1, &first_idx);
+    return pack_strings(env, addresses);
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+    return 0;
+  }
 }
 
-JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getTxsJni(JNIEnv* env, jobject instance, jstring jtx_query) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_getTxsJni");
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_getTxsJni(JNIEnv* env, jobject instance, jbyteArray jtx_query) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getTxsJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
-  const char* _tx_query = jtx_query ? env->GetStringUTFChars(jtx_query, NULL) : nullptr;
-  string tx_query_json = string(_tx_query ? _tx_query : "");
-  env->ReleaseStringUTFChars(jtx_query, _tx_query);
+  wallet_lock wallet_guard(wallet);
+  string tx_query_json = jbytes_to_string(env, jtx_query);
   try {
 
     // deserialize tx query
@@ -914,7 +1750,9 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getTxsJni(JNIEnv* e
     MTRACE("Fetching txs with query: " << tx_query->serialize());
 
     // get txs
+    monero_trace_span wallet_span("monero_wallet::get_txs");
     vector<shared_ptr<monero_tx_wallet>> txs = wallet->get_txs(*tx_query);
+    wallet_span.end();
     MTRACE("Got " << txs.size() << " txs");
 
     // return unique blocks to preserve model relationships as tree
@@ -936,23 +1774,24 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getTxsJni(JNIEnv* e
     MTRACE("Returning " << blocks.size() << " blocks");
 
     // wrap and serialize blocks
-    rapidjson::Document doc;
+    monero_json_arena arena;
+    rapidjson::Document& doc = arena.doc();
     doc.SetObject();
+    monero_trace_span build_span("monero_utils::to_rapidjson_val");
     doc.AddMember("blocks", monero_utils::to_rapidjson_val(doc.GetAllocator(), blocks), doc.GetAllocator());
-    string blocks_json = monero_utils::serialize(doc);
-    return env->NewStringUTF(blocks_json.c_str());
+    build_span.end();
+    return string_to_jbytes(env, arena.serialize());
   } catch (...) {
     rethrow_cpp_exception_as_java_exception(env);
     return 0;
   }
 }
 
-JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getTransfersJni(JNIEnv* env, jobject instance, jstring jtransfer_query) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_getTransfersJni");
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_getTransfersJni(JNIEnv* env, jobject instance, jbyteArray jtransfer_query) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getTransfersJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
-  const char* _transfer_query = jtransfer_query ? env->GetStringUTFChars(jtransfer_query, NULL) : nullptr;
-  string transfer_query_json = string(_transfer_query ? _transfer_query : "");
-  env->ReleaseStringUTFChars(jtransfer_query, _transfer_query);
+  wallet_lock wallet_guard(wallet);
+  string transfer_query_json = jbytes_to_string(env, jtransfer_query);
   try {
 
     // deserialize transfer query
@@ -960,7 +1799,9 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getTransfersJni(JNI
     MTRACE("Fetching transfers with query: " << transfer_query->serialize());
 
     // get transfers
+    monero_trace_span wallet_span("monero_wallet::get_transfers");
     vector<shared_ptr<monero_transfer>> transfers = wallet->get_transfers(*transfer_query);
+    wallet_span.end();
     MTRACE("Got " << transfers.size() << " transfers");
 
     // return unique blocks to preserve model relationships as tree
@@ -982,23 +1823,24 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getTransfersJni(JNI
     }
 
     // wrap and serialize blocks
-    rapidjson::Document doc;
+    monero_json_arena arena;
+    rapidjson::Document& doc = arena.doc();
     doc.SetObject();
+    monero_trace_span build_span("monero_utils::to_rapidjson_val");
     doc.AddMember("blocks", monero_utils::to_rapidjson_val(doc.GetAllocator(), blocks), doc.GetAllocator());
-    string blocks_json = monero_utils::serialize(doc);
-    return env->NewStringUTF(blocks_json.c_str());
+    build_span.end();
+    return string_to_jbytes(env, arena.serialize());
   } catch (...) {
     rethrow_cpp_exception_as_java_exception(env);
     return 0;
   }
 }
 
-JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getOutputsJni(JNIEnv* env, jobject instance, jstring joutput_query) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_getOutputsJni");
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_getOutputsJni(JNIEnv* env, jobject instance, jbyteArray joutput_query) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getOutputsJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
-  const char* _output_query = joutput_query ? env->GetStringUTFChars(joutput_query, NULL) : nullptr;
-  string output_query_json = string(_output_query ? _output_query : "");
-  env->ReleaseStringUTFChars(joutput_query, _output_query);
+  wallet_lock wallet_guard(wallet);
+  string output_query_json = jbytes_to_string(env, joutput_query);
   try {
 
     // deserialize output query
@@ -1006,29 +1848,29 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getOutputsJni(JNIEn
     MTRACE("Fetching outputs with request: " << output_query->serialize());
 
     // get outputs
+    monero_trace_span wallet_span("monero_wallet::get_outputs");
     vector<shared_ptr<monero_output_wallet>> outputs = wallet->get_outputs(*output_query);
+    wallet_span.end();
     MTRACE("Got " << outputs.size() << " outputs");
 
     // return unique blocks to preserve model relationships as tree
-    vector<monero_block> blocks;
+    vector<shared_ptr<monero_block>> blocks;
     unordered_set<shared_ptr<monero_block>> seen_block_ptrs;
     for (auto const& output : outputs) {
       shared_ptr<monero_tx_wallet> tx = static_pointer_cast<monero_tx_wallet>(output->m_tx);
       if (tx->m_block == boost::none) throw runtime_error("Need to handle unconfirmed output");
-      unordered_set<shared_ptr<monero_block>>::const_iterator got = seen_block_ptrs.find(*tx->m_block);
-      if (got == seen_block_ptrs.end()) {
-        seen_block_ptrs.insert(*tx->m_block);
-        blocks.push_back(**tx->m_block);
-      }
+      if (seen_block_ptrs.insert(*tx->m_block).second) blocks.push_back(*tx->m_block);
     }
     MTRACE("Returning " << blocks.size() << " blocks");
 
     // wrap and serialize blocks
-    rapidjson::Document doc;
+    monero_json_arena arena;
+    rapidjson::Document& doc = arena.doc();
     doc.SetObject();
+    monero_trace_span build_span("monero_utils::to_rapidjson_val");
     doc.AddMember("blocks", monero_utils::to_rapidjson_val(doc.GetAllocator(), blocks), doc.GetAllocator());
-    string blocks_json = monero_utils::serialize(doc);
-    return env->NewStringUTF(blocks_json.c_str());
+    build_span.end();
+    return string_to_jbytes(env, arena.serialize());
   } catch (...) {
     rethrow_cpp_exception_as_java_exception(env);
     return 0;
@@ -1036,8 +1878,9 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getOutputsJni(JNIEn
 }
 
 JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getOutputsHexJni(JNIEnv* env, jobject instance) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_getOutputsHexJni()");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getOutputsHexJni()");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
   try {
     return env->NewStringUTF(wallet->get_outputs_hex().c_str());
   } catch (...) {
@@ -1047,8 +1890,10 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getOutputsHexJni(JN
 }
 
 JNIEXPORT jint JNICALL Java_monero_wallet_MoneroWalletJni_importOutputsHexJni(JNIEnv* env, jobject instance, jstring joutputs_hex) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_getOutputsHexJni()");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getOutputsHexJni()");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
+  touch_wallet_outputs(wallet);
   const char* _outputs_hex = joutputs_hex ? env->GetStringUTFChars(joutputs_hex, NULL) : nullptr;
   string outputs_hex = string(_outputs_hex ? _outputs_hex : "");
   env->ReleaseStringUTFChars(joutputs_hex, _outputs_hex);
@@ -1060,28 +1905,29 @@ JNIEXPORT jint JNICALL Java_monero_wallet_MoneroWalletJni_importOutputsHexJni(JN
   }
 }
 
-JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getKeyImagesJni(JNIEnv* env, jobject instance) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_getKeyImagesJni");
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_getKeyImagesJni(JNIEnv* env, jobject instance) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getKeyImagesJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
 
   // fetch key images
   vector<shared_ptr<monero_key_image>> key_images = wallet->get_key_images();
   MTRACE("Fetched " << key_images.size() << " key images");
 
   // wrap and serialize key images
-  rapidjson::Document doc;
+  monero_json_arena arena;
+  rapidjson::Document& doc = arena.doc();
   doc.SetObject();
   doc.AddMember("keyImages", monero_utils::to_rapidjson_val(doc.GetAllocator(), key_images), doc.GetAllocator());
-  string key_images_json = monero_utils::serialize(doc);
-  return env->NewStringUTF(key_images_json.c_str());
+  return string_to_jbytes(env, arena.serialize());
 }
 
-JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_importKeyImagesJni(JNIEnv* env, jobject instance, jstring jkey_images_json) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_importKeyImagesJni");
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_importKeyImagesJni(JNIEnv* env, jobject instance, jbyteArray jkey_images_json) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_importKeyImagesJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
-  const char* _key_images_json = jkey_images_json ? env->GetStringUTFChars(jkey_images_json, NULL) : nullptr;
-  string key_images_json = string(_key_images_json ? _key_images_json : "");
-  env->ReleaseStringUTFChars(jkey_images_json, _key_images_json);
+  wallet_lock wallet_guard(wallet);
+  touch_wallet_outputs(wallet);
+  string key_images_json = jbytes_to_string(env, jkey_images_json);
 
   // deserialize key images to import
   vector<shared_ptr<monero_key_image>> key_images = monero_key_image::deserialize_key_images(key_images_json);
@@ -1091,19 +1937,20 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_importKeyImagesJni(
   shared_ptr<monero_key_image_import_result> result;
   try {
     result = wallet->import_key_images(key_images);
-    return env->NewStringUTF(result->serialize().c_str());
+    monero_json_arena arena;
+    return string_to_jbytes(env, arena.serialize(*result));
   } catch (...) {
     rethrow_cpp_exception_as_java_exception(env);
     return 0;
   }
 }
 
-JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_sendSplitJni(JNIEnv* env, jobject instance, jstring jsend_request) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_sendSplitJni(request)");
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_sendSplitJni(JNIEnv* env, jobject instance, jbyteArray jsend_request) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_sendSplitJni(request)");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
-  const char* _send_request = jsend_request ? env->GetStringUTFChars(jsend_request, NULL) : nullptr;
-  string send_request_json = string(_send_request ? _send_request : "");
-  env->ReleaseStringUTFChars(jsend_request, _send_request);
+  wallet_lock wallet_guard(wallet);
+  touch_wallet_outputs(wallet);
+  string send_request_json = jbytes_to_string(env, jsend_request);
 
   // deserialize send request
   shared_ptr<monero_send_request> send_request = monero_send_request::deserialize(send_request_json);
@@ -1120,15 +1967,16 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_sendSplitJni(JNIEnv
   }
 
   // serialize and return tx set
-  return env->NewStringUTF(tx_set.serialize().c_str());
+  monero_json_arena arena;
+  return string_to_jbytes(env, arena.serialize(tx_set));
 }
 
-JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_sweepUnlockedJni(JNIEnv* env, jobject instance, jstring jsend_request) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_sweepUnlockedJni(request)");
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_sweepUnlockedJni(JNIEnv* env, jobject instance, jbyteArray jsend_request) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_sweepUnlockedJni(request)");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
-  const char* _send_request = jsend_request ? env->GetStringUTFChars(jsend_request, NULL) : nullptr;
-  string send_request_json = string(_send_request ? _send_request : "");
-  env->ReleaseStringUTFChars(jsend_request, _send_request);
+  wallet_lock wallet_guard(wallet);
+  touch_wallet_outputs(wallet);
+  string send_request_json = jbytes_to_string(env, jsend_request);
 
   // deserialize send request
   shared_ptr<monero_send_request> send_request = monero_send_request::deserialize(send_request_json);
@@ -1145,19 +1993,19 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_sweepUnlockedJni(JN
   }
 
   // wrap and serialize tx sets
-  rapidjson::Document doc;
+  monero_json_arena arena;
+  rapidjson::Document& doc = arena.doc();
   doc.SetObject();
   doc.AddMember("txSets", monero_utils::to_rapidjson_val(doc.GetAllocator(), tx_sets), doc.GetAllocator());
-  string tx_sets_json = monero_utils::serialize(doc);
-  return env->NewStringUTF(tx_sets_json.c_str());
+  return string_to_jbytes(env, arena.serialize());
 }
 
-JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_sweepOutputJni(JNIEnv* env, jobject instance, jstring jsend_request) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_sweepOutputJni(request)");
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_sweepOutputJni(JNIEnv* env, jobject instance, jbyteArray jsend_request) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_sweepOutputJni(request)");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
-  const char* _send_request = jsend_request ? env->GetStringUTFChars(jsend_request, NULL) : nullptr;
-  string send_request_json = string(_send_request);
-  env->ReleaseStringUTFChars(jsend_request, _send_request);
+  wallet_lock wallet_guard(wallet);
+  touch_wallet_outputs(wallet);
+  string send_request_json = jbytes_to_string(env, jsend_request);
 
   MTRACE("Send request json: " << send_request_json);
 
@@ -1175,12 +2023,15 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_sweepOutputJni(JNIE
   }
 
   // serialize and return tx set
-  return env->NewStringUTF(tx_set.serialize().c_str());
+  monero_json_arena arena;
+  return string_to_jbytes(env, arena.serialize(tx_set));
 }
 
-JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_sweepDustJni(JNIEnv* env, jobject instance, jboolean do_not_relay) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_sweepDustJni(request)");
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_sweepDustJni(JNIEnv* env, jobject instance, jboolean do_not_relay) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_sweepDustJni(request)");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
+  touch_wallet_outputs(wallet);
 
   // sweep dust
   monero_tx_set tx_set;
@@ -1192,17 +2043,17 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_sweepDustJni(JNIEnv
   }
 
   // serialize and return tx set
-  return env->NewStringUTF(tx_set.serialize().c_str());
+  monero_json_arena arena;
+  return string_to_jbytes(env, arena.serialize(tx_set));
 }
 
-JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_parseTxSetJni(JNIEnv* env, jobject instance, jstring jtx_set_json) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_parseTxSetJson(tx_set_json)");
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_parseTxSetJni(JNIEnv* env, jobject instance, jbyteArray jtx_set_json) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_parseTxSetJson(tx_set_json)");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
 
   // get tx set json string
-  const char* _tx_set_json = jtx_set_json ? env->GetStringUTFChars(jtx_set_json, NULL) : nullptr;
-  string tx_set_json = string(_tx_set_json);
-  env->ReleaseStringUTFChars(jtx_set_json, _tx_set_json);
+  string tx_set_json = jbytes_to_string(env, jtx_set_json);
 
   try {
 
@@ -1213,7 +2064,8 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_parseTxSetJni(JNIEn
     monero_tx_set parsed_tx_set = wallet->parse_tx_set(tx_set);
 
     // serialize and return parsed tx set
-    return env->NewStringUTF(parsed_tx_set.serialize().c_str());
+    monero_json_arena arena;
+    return string_to_jbytes(env, arena.serialize(parsed_tx_set));
   } catch (...) {
     rethrow_cpp_exception_as_java_exception(env);
     return 0;
@@ -1221,8 +2073,9 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_parseTxSetJni(JNIEn
 }
 
 JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_signTxsJni(JNIEnv* env, jobject instance, jstring junsigned_tx_hex) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_signTxsJni()");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_signTxsJni()");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
 
   // get unsigned tx set as string
   const char* _unsigned_tx_hex = junsigned_tx_hex ? env->GetStringUTFChars(junsigned_tx_hex, NULL) : nullptr;
@@ -1239,8 +2092,10 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_signTxsJni(JNIEnv*
 }
 
 JNIEXPORT jobjectArray JNICALL Java_monero_wallet_MoneroWalletJni_submitTxsJni(JNIEnv* env, jobject instance, jstring jsigned_tx_hex) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_submitTxsJni()");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_submitTxsJni()");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
+  touch_wallet_outputs(wallet);
 
   // get signed tx set as string
   const char* _signed_tx_hex = jsigned_tx_hex ? env->GetStringUTFChars(jsigned_tx_hex, NULL) : nullptr;
@@ -1262,9 +2117,11 @@ JNIEXPORT jobjectArray JNICALL Java_monero_wallet_MoneroWalletJni_submitTxsJni(J
   }
 }
 
-JNIEXPORT jobjectArray JNICALL Java_monero_wallet_MoneroWalletJni_relayTxsJni(JNIEnv* env, jobject instance, jobjectArray jtx_metadatas) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_relayTxsJni");
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_relayTxsJni(JNIEnv* env, jobject instance, jobjectArray jtx_metadatas, jint max_in_flight, jboolean stop_on_error) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_relayTxsJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
+  touch_wallet_outputs(wallet);
 
   // get tx metadatas from jobjectArray to vector<string>
   vector<string> tx_metadatas;
@@ -1279,23 +2136,156 @@ JNIEXPORT jobjectArray JNICALL Java_monero_wallet_MoneroWalletJni_relayTxsJni(JN
     }
   }
 
-  // relay tx metadata
-  vector<string> tx_hashes;
+  // relay tx metadata with a result per tx
+  vector<monero_relay_result> results;
+  try {
+    monero_output_cache_proxy* proxy = get_handle<monero_output_cache_proxy>(env, instance, JNI_OUTPUT_CACHE_PROXY_HANDLE);
+    results = relay_txs_parallel(wallet, proxy, tx_metadatas, max_in_flight < 1 ? 1 : max_in_flight, stop_on_error);
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+    return 0;
+  }
+
+  // serialize and return results
+  monero_json_arena arena;
+  rapidjson::Document& doc = arena.doc();
+  doc.SetObject();
+  rapidjson::Document::AllocatorType& allocator = doc.GetAllocator();
+  rapidjson::Value results_val(rapidjson::kArrayType);
+  for (const monero_relay_result& result : results) {
+    rapidjson::Value result_val(rapidjson::kObjectType);
+    if (!result.m_tx_hash.empty()) result_val.AddMember("txHash", rapidjson::Value().SetString(result.m_tx_hash.c_str(), result.m_tx_hash.size(), allocator), allocator);
+    if (!result.m_error.empty()) result_val.AddMember("error", rapidjson::Value().SetString(result.m_error.c_str(), result.m_error.size(), allocator), allocator);
+    results_val.PushBack(result_val, allocator);
+  }
+  doc.AddMember("results", results_val, allocator);
+  return string_to_jbytes(env, arena.serialize());
+}
+
+JNIEXPORT jlong JNICALL Java_monero_wallet_MoneroWalletJni_startSendPipelineJni(JNIEnv* env, jobject instance, jlong signer_handle, jint max_relay_batch) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_startSendPipelineJni");
+  monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
+  monero_wallet* signer = reinterpret_cast<monero_wallet*>(signer_handle);
+
+  // start pipeline which shares the mutex of each wallet it uses with their jni calls
+  try {
+    size_t max_in_flight = max_relay_batch < 1 ? 1 : max_relay_batch;
+    monero_send_pipeline::relay_function relay = [wallet, max_in_flight](const vector<string>& tx_metadatas) {
+      touch_wallet_outputs(wallet);
+      return relay_txs_parallel(wallet, get_wallet_proxy(wallet), tx_metadatas, max_in_flight, false);
+    };
+    monero_send_pipeline* pipeline = new monero_send_pipeline(wallet, get_wallet_mutex(wallet), signer, signer == nullptr ? nullptr : get_wallet_mutex(signer), relay, max_in_flight);
+    return reinterpret_cast<jlong>(pipeline);
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+    return 0;
+  }
+}
+
+JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_stopSendPipelineJni(JNIEnv* env, jobject instance) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_stopSendPipelineJni");
+  monero_send_pipeline* pipeline = get_handle<monero_send_pipeline>(env, instance, JNI_SEND_PIPELINE_HANDLE);
+  try {
+    if (pipeline != nullptr) pipeline->stop();
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+  }
+}
+
+JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_deleteSendPipelineJni(JNIEnv* env, jobject instance) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_deleteSendPipelineJni");
+  monero_send_pipeline* pipeline = get_handle<monero_send_pipeline>(env, instance, JNI_SEND_PIPELINE_HANDLE);
+  if (pipeline != nullptr) delete pipeline;
+}
+
+JNIEXPORT jlong JNICALL Java_monero_wallet_MoneroWalletJni_submitToSendPipelineJni(JNIEnv* env, jobject instance, jbyteArray jsend_request) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_submitToSendPipelineJni(request)");
+  monero_send_pipeline* pipeline = get_handle<monero_send_pipeline>(env, instance, JNI_SEND_PIPELINE_HANDLE);
+  string send_request_json = jbytes_to_string(env, jsend_request);
+
+  // deserialize and queue send request
   try {
-    tx_hashes = wallet->relay_txs(tx_metadatas);
+    shared_ptr<monero_send_request> send_request = monero_send_request::deserialize(send_request_json);
+    return pipeline->submit(send_request);
   } catch (...) {
     rethrow_cpp_exception_as_java_exception(env);
     return 0;
   }
+}
+
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_getSendPipelineResultJni(JNIEnv* env, jobject instance, jlong id, jboolean wait) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getSendPipelineResultJni");
+  monero_send_pipeline* pipeline = get_handle<monero_send_pipeline>(env, instance, JNI_SEND_PIPELINE_HANDLE);
+
+  try {
 
-  // return tx hashes as jobjectArray
-  jobjectArray jtx_hashes = env->NewObjectArray(tx_hashes.size(), env->FindClass("java/lang/String"), nullptr);
-  for (int i = 0; i < tx_hashes.size(); i++) env->SetObjectArrayElement(jtx_hashes, i, env->NewStringUTF(tx_hashes[i].c_str()));
-  return jtx_hashes;
+    // get result
+    monero_send_pipeline::result result;
+    if (!pipeline->get_result(id, wait, result)) return 0;
+
+    // serialize result, including the tx set once the request is prepared
+    monero_json_arena arena;
+    rapidjson::Document& doc = arena.doc();
+    doc.SetObject();
+    rapidjson::Document::AllocatorType& allocator = doc.GetAllocator();
+    doc.AddMember("id", result.m_id, allocator);
+    rapidjson::Value state;
+    state.SetString(result.m_state.c_str(), result.m_state.size(), allocator);
+    doc.AddMember("state", state, allocator);
+    if (!result.m_error.empty()) {
+      rapidjson::Value error;
+      error.SetString(result.m_error.c_str(), result.m_error.size(), allocator);
+      doc.AddMember("error", error, allocator);
+    }
+    if (!result.m_tx_hashes.empty()) {
+      rapidjson::Value tx_hashes(rapidjson::kArrayType);
+      for (const string& tx_hash : result.m_tx_hashes) tx_hashes.PushBack(rapidjson::Value().SetString(tx_hash.c_str(), tx_hash.size(), allocator), allocator);
+      doc.AddMember("txHashes", tx_hashes, allocator);
+    }
+    if (result.m_state != "queued") doc.AddMember("txSet", result.m_tx_set.to_rapidjson_val(allocator), allocator);
+    return string_to_jbytes(env, arena.serialize());
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+    return 0;
+  }
+}
+
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_getSendPipelineStatsJni(JNIEnv* env, jobject instance) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getSendPipelineStatsJni");
+  monero_send_pipeline* pipeline = get_handle<monero_send_pipeline>(env, instance, JNI_SEND_PIPELINE_HANDLE);
+
+  // serialize stats of each stage
+  try {
+    monero_json_arena arena;
+    rapidjson::Document& doc = arena.doc();
+    doc.SetObject();
+    rapidjson::Document::AllocatorType& allocator = doc.GetAllocator();
+    rapidjson::Value stages(rapidjson::kArrayType);
+    for (const monero_send_pipeline::stage_stats& stats : pipeline->get_stats()) {
+      rapidjson::Value stage(rapidjson::kObjectType);
+      rapidjson::Value name;
+      name.SetString(stats.m_name.c_str(), stats.m_name.size(), allocator);
+      stage.AddMember("name", name, allocator);
+      stage.AddMember("queueDepth", stats.m_queue_depth, allocator);
+      stage.AddMember("numProcessed", stats.m_num_processed, allocator);
+      stage.AddMember("numFailed", stats.m_num_failed, allocator);
+      stage.AddMember("avgLatencyMs", stats.m_num_processed == 0 ? 0.0 : stats.m_total_latency_us / 1000.0 / stats.m_num_processed, allocator);
+      stage.AddMember("maxLatencyMs", stats.m_max_latency_us / 1000.0, allocator);
+      stages.PushBack(stage, allocator);
+    }
+    doc.AddMember("stages", stages, allocator);
+    return string_to_jbytes(env, arena.serialize());
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+    return 0;
+  }
 }
+
 JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_signJni(JNIEnv* env, jobject instance, jstring jmsg) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_signJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_signJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
   const char* _msg = jmsg ? env->GetStringUTFChars(jmsg, NULL) : nullptr;
   string msg = string(_msg ? _msg : "");
   env->ReleaseStringUTFChars(jmsg, _msg);
@@ -1309,8 +2299,9 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_signJni(JNIEnv* env
 }
 
 JNIEXPORT jboolean JNICALL Java_monero_wallet_MoneroWalletJni_verifyJni(JNIEnv* env, jobject instance, jstring jmsg, jstring jaddress, jstring jsignature) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_verifyJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_verifyJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
   const char* _msg = jmsg ? env->GetStringUTFChars(jmsg, NULL) : nullptr;
   const char* _address = jaddress ? env->GetStringUTFChars(jaddress, NULL) : nullptr;
   const char* _signature = jsignature ? env->GetStringUTFChars(jsignature, NULL) : nullptr;
@@ -1329,9 +2320,63 @@ JNIEXPORT jboolean JNICALL Java_monero_wallet_MoneroWalletJni_verifyJni(JNIEnv*
   }
 }
 
+JNIEXPORT jobjectArray JNICALL Java_monero_wallet_MoneroWalletJni_signBatchJni(JNIEnv* env, jobject instance, jobjectArray jmsgs, jint max_threads) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_signBatchJni");
+  monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  try {
+    vector<string> msgs = jstring_array_to_vector(env, jmsgs);
+
+    // copy the spend key under the wallet's lock and sign without it
+    epee::wipeable_string private_spend_key;
+    {
+      wallet_lock wallet_guard(wallet);
+      string key = wallet->get_private_spend_key();
+      private_spend_key = key;
+      memwipe(&key[0], key.size());
+    }
+    vector<string> signatures = monero_message_signer::sign(private_spend_key, msgs, max_threads);
+    jobjectArray jsignatures = env->NewObjectArray(signatures.size(), env->FindClass("java/lang/String"), nullptr);
+    for (size_t i = 0; i < signatures.size(); i++) {
+      jstring jsignature = env->NewStringUTF(signatures[i].c_str());
+      env->SetObjectArrayElement(jsignatures, i, jsignature);
+      env->DeleteLocalRef(jsignature);
+    }
+    return jsignatures;
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+    return 0;
+  }
+}
+
+JNIEXPORT jbooleanArray JNICALL Java_monero_wallet_MoneroWalletJni_verifyBatchJni(JNIEnv* env, jobject instance, jobjectArray jmsgs, jobjectArray jaddresses, jobjectArray jsignatures, jint max_threads) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_verifyBatchJni");
+  monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  try {
+    vector<string> msgs = jstring_array_to_vector(env, jmsgs);
+    vector<string> addresses = jstring_array_to_vector(env, jaddresses);
+    vector<string> signatures = jstring_array_to_vector(env, jsignatures);
+
+    // verify without holding the wallet's lock, which only guards the network type
+    cryptonote::network_type network_type;
+    {
+      wallet_lock wallet_guard(wallet);
+      network_type = static_cast<cryptonote::network_type>(wallet->get_network_type());
+    }
+    vector<bool> goods = monero_message_signer::verify(network_type, msgs, addresses, signatures, max_threads);
+    vector<jboolean> jgoods_vals(goods.begin(), goods.end());
+    jbooleanArray jgoods = env->NewBooleanArray(jgoods_vals.size());
+    env->SetBooleanArrayRegion(jgoods, 0, jgoods_vals.size(), jgoods_vals.data());
+    return jgoods;
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+    return 0;
+  }
+}
+
 JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getTxKeyJni(JNIEnv* env, jobject instance, jstring jtx_hash) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_getTxKeyJniJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getTxKeyJniJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
   const char* _tx_hash = jtx_hash ? env->GetStringUTFChars(jtx_hash, NULL) : nullptr;
   string tx_hash = string(_tx_hash == nullptr ? "" : _tx_hash);
   env->ReleaseStringUTFChars(jtx_hash, _tx_hash);
@@ -1344,8 +2389,9 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getTxKeyJni(JNIEnv*
 }
 
 JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_checkTxKeyJni(JNIEnv* env, jobject instance, jstring jtx_hash, jstring jtx_key, jstring jaddress) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_checktx_keyJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_checktx_keyJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
   const char* _tx_hash = jtx_hash ? env->GetStringUTFChars(jtx_hash, NULL) : nullptr;
   const char* _tx_key = jtx_key ? env->GetStringUTFChars(jtx_key, NULL) : nullptr;
   const char* _address = jaddress ? env->GetStringUTFChars(jaddress, NULL) : nullptr;
@@ -1360,7 +2406,8 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_checkTxKeyJni(JNIEn
       cout << tx_hash << endl;
       cout << tx_key << endl;
       cout << address << endl;
-    return env->NewStringUTF(wallet->check_tx_key(tx_hash, tx_key, address)->serialize().c_str());
+    monero_json_arena arena;
+    return env->NewStringUTF(arena.serialize(*wallet->check_tx_key(tx_hash, tx_key, address)).GetString());
   } catch (...) {
     rethrow_cpp_exception_as_java_exception(env);
     return 0;
@@ -1368,8 +2415,9 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_checkTxKeyJni(JNIEn
 }
 
 JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getTxProofJni(JNIEnv* env, jobject instance, jstring jtx_hash, jstring jaddress, jstring jmessage) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_getTxProofJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getTxProofJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
   const char* _tx_hash = jtx_hash ? env->GetStringUTFChars(jtx_hash, NULL) : nullptr;
   const char* _address = jaddress ? env->GetStringUTFChars(jaddress, NULL) : nullptr;
   const char* _message = jmessage ? env->GetStringUTFChars(jmessage, NULL) : nullptr;
@@ -1388,8 +2436,9 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getTxProofJni(JNIEn
 }
 
 JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_checkTxProofJni(JNIEnv* env, jobject instance, jstring jtx_hash, jstring jaddress, jstring jmessage, jstring jsignature) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_checkTxProofJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_checkTxProofJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
   const char* _tx_hash = jtx_hash ? env->GetStringUTFChars(jtx_hash, NULL) : nullptr;
   const char* _address = jaddress ? env->GetStringUTFChars(jaddress, NULL) : nullptr;
   const char* _message = jmessage ? env->GetStringUTFChars(jmessage, NULL) : nullptr;
@@ -1403,7 +2452,8 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_checkTxProofJni(JNI
   env->ReleaseStringUTFChars(jmessage, _message);
   env->ReleaseStringUTFChars(jsignature, _signature);
   try {
-    return env->NewStringUTF(wallet->check_tx_proof(tx_hash, address, message, signature)->serialize().c_str());
+    monero_json_arena arena;
+    return env->NewStringUTF(arena.serialize(*wallet->check_tx_proof(tx_hash, address, message, signature)).GetString());
   } catch (...) {
     rethrow_cpp_exception_as_java_exception(env);
     return 0;
@@ -1411,8 +2461,9 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_checkTxProofJni(JNI
 }
 
 JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getSpendProofJni(JNIEnv* env, jobject instance, jstring jtx_hash, jstring jmessage) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_getSpendProofJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getSpendProofJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
   const char* _tx_hash = jtx_hash ? env->GetStringUTFChars(jtx_hash, NULL) : nullptr;
   const char* _message = jmessage ? env->GetStringUTFChars(jmessage, NULL) : nullptr;
   string tx_hash = string(_tx_hash == nullptr ? "" : _tx_hash);
@@ -1428,8 +2479,9 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getSpendProofJni(JN
 }
 
 JNIEXPORT jboolean JNICALL Java_monero_wallet_MoneroWalletJni_checkSpendProofJni(JNIEnv* env, jobject instance, jstring jtx_hash, jstring jmessage, jstring jsignature) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_checkSpendProofJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_checkSpendProofJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
   const char* _tx_hash = jtx_hash ? env->GetStringUTFChars(jtx_hash, NULL) : nullptr;
   const char* _message = jmessage ? env->GetStringUTFChars(jmessage, NULL) : nullptr;
   const char* _signature = jsignature ? env->GetStringUTFChars(jsignature, NULL) : nullptr;
@@ -1447,9 +2499,94 @@ JNIEXPORT jboolean JNICALL Java_monero_wallet_MoneroWalletJni_checkSpendProofJni
   }
 }
 
+JNIEXPORT jlongArray JNICALL Java_monero_wallet_MoneroWalletJni_checkTxKeysJni(JNIEnv* env, jobject instance, jobjectArray jtx_hashes, jobjectArray jtx_keys, jobjectArray jaddresses, jint max_threads) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_checkTxKeysJni");
+  monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  monero_output_cache_proxy* proxy = get_handle<monero_output_cache_proxy>(env, instance, JNI_OUTPUT_CACHE_PROXY_HANDLE);
+  try {
+
+    // collect tx keys to check
+    vector<string> tx_hashes = jstring_array_to_vector(env, jtx_hashes);
+    vector<string> tx_keys = jstring_array_to_vector(env, jtx_keys);
+    vector<string> addresses = jstring_array_to_vector(env, jaddresses);
+    if (tx_keys.size() != tx_hashes.size() || addresses.size() != tx_hashes.size()) throw runtime_error("Must provide a tx key and address for each tx hash");
+    vector<monero_tx_proof_request> requests(tx_hashes.size());
+    for (size_t i = 0; i < tx_hashes.size(); i++) {
+      requests[i].m_tx_hash = tx_hashes[i];
+      requests[i].m_signature = tx_keys[i];
+      requests[i].m_address = addresses[i];
+    }
+
+    // check tx keys without the wallet and return packed results
+    return pack_check_txs(env, check_tx_keys(get_proof_context(wallet, proxy), requests, max_threads));
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+    return 0;
+  }
+}
+
+JNIEXPORT jlongArray JNICALL Java_monero_wallet_MoneroWalletJni_checkTxProofsJni(JNIEnv* env, jobject instance, jobjectArray jtx_hashes, jobjectArray jaddresses, jobjectArray jmessages, jobjectArray jsignatures, jint max_threads) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_checkTxProofsJni");
+  monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  monero_output_cache_proxy* proxy = get_handle<monero_output_cache_proxy>(env, instance, JNI_OUTPUT_CACHE_PROXY_HANDLE);
+  try {
+
+    // collect tx proofs to check
+    vector<string> tx_hashes = jstring_array_to_vector(env, jtx_hashes);
+    vector<string> addresses = jstring_array_to_vector(env, jaddresses);
+    vector<string> messages = jstring_array_to_vector(env, jmessages);
+    vector<string> signatures = jstring_array_to_vector(env, jsignatures);
+    if (addresses.size() != tx_hashes.size() || messages.size() != tx_hashes.size() || signatures.size() != tx_hashes.size()) throw runtime_error("Must provide an address, message, and signature for each tx hash");
+    vector<monero_tx_proof_request> requests(tx_hashes.size());
+    for (size_t i = 0; i < tx_hashes.size(); i++) {
+      requests[i].m_tx_hash = tx_hashes[i];
+      requests[i].m_address = addresses[i];
+      requests[i].m_message = messages[i];
+      requests[i].m_signature = signatures[i];
+    }
+
+    // check tx proofs without the wallet and return packed results
+    return pack_check_txs(env, check_tx_proofs(get_proof_context(wallet, proxy), requests, max_threads));
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+    return 0;
+  }
+}
+
+JNIEXPORT jbooleanArray JNICALL Java_monero_wallet_MoneroWalletJni_checkSpendProofsJni(JNIEnv* env, jobject instance, jobjectArray jtx_hashes, jobjectArray jmessages, jobjectArray jsignatures, jint max_threads) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_checkSpendProofsJni");
+  monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  monero_output_cache_proxy* proxy = get_handle<monero_output_cache_proxy>(env, instance, JNI_OUTPUT_CACHE_PROXY_HANDLE);
+  try {
+
+    // collect spend proofs to check
+    vector<string> tx_hashes = jstring_array_to_vector(env, jtx_hashes);
+    vector<string> messages = jstring_array_to_vector(env, jmessages);
+    vector<string> signatures = jstring_array_to_vector(env, jsignatures);
+    if (messages.size() != tx_hashes.size() || signatures.size() != tx_hashes.size()) throw runtime_error("Must provide a message and signature for each tx hash");
+    vector<monero_tx_proof_request> requests(tx_hashes.size());
+    for (size_t i = 0; i < tx_hashes.size(); i++) {
+      requests[i].m_tx_hash = tx_hashes[i];
+      requests[i].m_message = messages[i];
+      requests[i].m_signature = signatures[i];
+    }
+
+    // check spend proofs without the wallet and return whether each is good
+    vector<bool> goods = check_spend_proofs(get_proof_context(wallet, proxy), requests, max_threads);
+    vector<jboolean> jgoods_vals(goods.begin(), goods.end());
+    jbooleanArray jgoods = env->NewBooleanArray(jgoods_vals.size());
+    env->SetBooleanArrayRegion(jgoods, 0, jgoods_vals.size(), jgoods_vals.data());
+    return jgoods;
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+    return 0;
+  }
+}
+
 JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getReserveProofWalletJni(JNIEnv* env, jobject instance, jstring jmessage) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_getReserveProofWalletJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getReserveProofWalletJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
   const char* _message = jmessage ? env->GetStringUTFChars(jmessage, NULL) : nullptr;
   string message = string(_message == nullptr ? "" : _message);
   env->ReleaseStringUTFChars(jmessage, _message);
@@ -1462,8 +2599,9 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getReserveProofWall
 }
 
 JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getReserveProofAccountJni(JNIEnv* env, jobject instance, jint account_idx, jstring jamount_str, jstring jmessage) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_getReserveProofWalletJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getReserveProofWalletJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
   const char* _amount_str = jamount_str ? env->GetStringUTFChars(jamount_str, NULL) : nullptr;
   const char* _message = jmessage ? env->GetStringUTFChars(jmessage, NULL) : nullptr;
   string amount_str = string(_amount_str == nullptr ? "" : _amount_str);
@@ -1480,8 +2618,9 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getReserveProofAcco
 }
 
 JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_checkReserveProofJni(JNIEnv* env, jobject instance, jstring jaddress, jstring jmessage, jstring jsignature) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_checkReserveProofAccountJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_checkReserveProofAccountJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
   const char* _address = jaddress ? env->GetStringUTFChars(jaddress, NULL) : nullptr;
   const char* _message = jmessage ? env->GetStringUTFChars(jmessage, NULL) : nullptr;
   const char* _signature = jsignature ? env->GetStringUTFChars(jsignature, NULL) : nullptr;
@@ -1492,7 +2631,54 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_checkReserveProofJn
   env->ReleaseStringUTFChars(jmessage, _message);
   env->ReleaseStringUTFChars(jsignature, _signature);
   try {
-    return env->NewStringUTF(wallet->check_reserve_proof(address, message, signature)->serialize().c_str());
+    monero_json_arena arena;
+    return env->NewStringUTF(arena.serialize(*wallet->check_reserve_proof(address, message, signature)).GetString());
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+    return 0;
+  }
+}
+
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_checkReserveProofsJni(JNIEnv* env, jobject instance, jobjectArray jaddresses, jobjectArray jmessages, jobjectArray jsignatures, jint max_threads, jobject jlistener) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_checkReserveProofsJni");
+  monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  monero_output_cache_proxy* proxy = get_handle<monero_output_cache_proxy>(env, instance, JNI_OUTPUT_CACHE_PROXY_HANDLE);
+  try {
+
+    // collect reserve proofs to check
+    if (jaddresses == nullptr || jmessages == nullptr || jsignatures == nullptr) throw runtime_error("Must provide addresses, messages, and signatures");
+    vector<string> addresses = jstring_array_to_vector(env, jaddresses);
+    vector<string> messages = jstring_array_to_vector(env, jmessages);
+    vector<string> signatures = jstring_array_to_vector(env, jsignatures);
+    if (addresses.size() != signatures.size() || messages.size() != signatures.size()) throw runtime_error("Must provide an address and message for each signature");
+    vector<monero_reserve_proof_request> requests(signatures.size());
+    for (size_t i = 0; i < signatures.size(); i++) {
+      requests[i].m_address = addresses[i];
+      requests[i].m_message = messages[i];
+      requests[i].m_signature = signatures[i];
+    }
+
+    // notify the listener on this thread until it throws
+    monero_proof_progress_fn on_progress;
+    if (jlistener != nullptr) {
+      jmethodID listenerClass_onProgress = env->GetMethodID(env->GetObjectClass(jlistener), "onProgress", "(JJ)V");
+      on_progress = [env, jlistener, listenerClass_onProgress](size_t num_done, size_t num_total) {
+        if (env->ExceptionCheck()) return;
+        env->CallVoidMethod(jlistener, listenerClass_onProgress, (jlong) num_done, (jlong) num_total);
+      };
+    }
+
+    // check proofs without the wallet and serialize a result per proof
+    vector<shared_ptr<monero_check_reserve>> checks = check_reserve_proofs(get_proof_context(wallet, proxy), requests, max_threads, on_progress);
+    if (env->ExceptionCheck()) return 0; // listener threw
+    monero_json_arena arena;
+    rapidjson::Document& doc = arena.doc();
+    doc.SetObject();
+    rapidjson::Document::AllocatorType& allocator = doc.GetAllocator();
+    rapidjson::Value jchecks(rapidjson::kArrayType);
+    for (const shared_ptr<monero_check_reserve>& check : checks) jchecks.PushBack(check->to_rapidjson_val(allocator), allocator);
+    doc.AddMember("checks", jchecks, allocator);
+    return string_to_jbytes(env, arena.serialize());
   } catch (...) {
     rethrow_cpp_exception_as_java_exception(env);
     return 0;
@@ -1500,8 +2686,9 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_checkReserveProofJn
 }
 
 JNIEXPORT jobjectArray JNICALL Java_monero_wallet_MoneroWalletJni_getTxNotesJni(JNIEnv* env, jobject instance, jobjectArray jtx_hashes) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_getTxNotesJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getTxNotesJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
 
   // get tx hashes from jobjectArray to vector<string>
   vector<string> tx_hashes;
@@ -1528,14 +2715,15 @@ JNIEXPORT jobjectArray JNICALL Java_monero_wallet_MoneroWalletJni_getTxNotesJni(
   // convert and return tx notes as jobjectArray
   jobjectArray jtx_notes = env->NewObjectArray(notes.size(), env->FindClass("java/lang/String"), nullptr);
   for (int i = 0; i < notes.size(); i++) {
-    env->SetObjectArrayElement(jtx_notes, i, env->NewStringUTF(notes[i].c_str()));
+    env->SetObjectArrayElement(jtx_notes, i, string2jstring(env, notes[i]));
   }
   return jtx_notes;
 }
 
 JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_setTxNotesJni(JNIEnv* env, jobject instance, jobjectArray jtx_hashes, jobjectArray jtx_notes) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_setTxNotesJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_setTxNotesJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
 
   // get tx hashes from jobjectArray to vector<string>
   vector<string> tx_hashes;
@@ -1556,10 +2744,8 @@ JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_setTxNotesJni(JNIEnv*
     jsize size = env->GetArrayLength(jtx_notes);
     for (int idx = 0; idx < size; idx++) {
       jstring jstr = (jstring) env->GetObjectArrayElement(jtx_notes, idx);
-      const char* _str = jstr ? env->GetStringUTFChars(jstr, NULL) : nullptr;
-      string str = string(_str ? _str : "");
-      env->ReleaseStringUTFChars(jstr, _str);
-      notes.push_back(str);
+      notes.push_back(jstring2string(env, jstr));
+      env->DeleteLocalRef(jstr);
     }
   }
 
@@ -1571,9 +2757,10 @@ JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_setTxNotesJni(JNIEnv*
   }
 }
 
-JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getAddressBookEntriesJni(JNIEnv* env, jobject instance, jintArray jindices) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_getAddressBookEntriesJni");
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_getAddressBookEntriesJni(JNIEnv* env, jobject instance, jintArray jindices) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getAddressBookEntriesJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
 
   // convert subaddress indices from jintArray to vector<uint32_t>
   vector<uint64_t> indices;
@@ -1591,11 +2778,11 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getAddressBookEntri
     vector<monero_address_book_entry> entries = wallet->get_address_book_entries(indices);
 
     // wrap and serialize entries
-    rapidjson::Document doc;
+    monero_json_arena arena;
+    rapidjson::Document& doc = arena.doc();
     doc.SetObject();
     doc.AddMember("entries", monero_utils::to_rapidjson_val(doc.GetAllocator(), entries), doc.GetAllocator());
-    string entries_json = monero_utils::serialize(doc);
-    return env->NewStringUTF(entries_json.c_str());
+    return string_to_jbytes(env, arena.serialize());
   } catch (...) {
     rethrow_cpp_exception_as_java_exception(env);
     return 0;
@@ -1604,16 +2791,15 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getAddressBookEntri
 
 // TODO: return jlong for uint64_t
 JNIEXPORT jint JNICALL Java_monero_wallet_MoneroWalletJni_addAddressBookEntryJni(JNIEnv* env, jobject instance, jstring jaddress, jstring jdescription) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_addAddressBookEntryJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_addAddressBookEntryJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
 
   // collect string params
   const char* _address = jaddress ? env->GetStringUTFChars(jaddress, NULL) : nullptr;
-  const char* _description = jdescription ? env->GetStringUTFChars(jdescription, NULL) : nullptr;
   string address = string(_address == nullptr ? "" : _address);
-  string description = string(_description == nullptr ? "" : _description);
   env->ReleaseStringUTFChars(jaddress, _address);
-  env->ReleaseStringUTFChars(jdescription, _description);
+  string description = jstring2string(env, jdescription);
 
   // add address book entry
   try {
@@ -1625,16 +2811,15 @@ JNIEXPORT jint JNICALL Java_monero_wallet_MoneroWalletJni_addAddressBookEntryJni
 }
 
 JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_editAddressBookEntryJni(JNIEnv* env, jobject instance, jint index, jboolean set_address, jstring jaddress, jboolean set_description, jstring jdescription) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_editAddressBookEntryJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_editAddressBookEntryJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
 
   // collect string params
   const char* _address = jaddress ? env->GetStringUTFChars(jaddress, NULL) : nullptr;
-  const char* _description = jdescription ? env->GetStringUTFChars(jdescription, NULL) : nullptr;
   string address = string(_address == nullptr ? "" : _address);
-  string description = string(_description == nullptr ? "" : _description);
   env->ReleaseStringUTFChars(jaddress, _address);
-  env->ReleaseStringUTFChars(jdescription, _description);
+  string description = jstring2string(env, jdescription);
 
   // edit address book entry
   try {
@@ -1645,8 +2830,9 @@ JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_editAddressBookEntryJn
 }
 
 JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_deleteAddressBookEntryJni(JNIEnv* env, jobject instance, jint index) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_deleteAddressBookEntryJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_deleteAddressBookEntryJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
 
   // delete address book entry
   try {
@@ -1656,12 +2842,11 @@ JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_deleteAddressBookEntry
   }
 }
 
-JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_createPaymentUriJni(JNIEnv* env, jobject instance, jstring jsend_request) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_createPaymentUriJni()");
+JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_createPaymentUriJni(JNIEnv* env, jobject instance, jbyteArray jsend_request) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_createPaymentUriJni()");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
-  const char* _send_request = jsend_request ? env->GetStringUTFChars(jsend_request, NULL) : nullptr;
-  string send_request_json = string(_send_request ? _send_request : "");
-  env->ReleaseStringUTFChars(jsend_request, _send_request);
+  wallet_lock wallet_guard(wallet);
+  string send_request_json = jbytes_to_string(env, jsend_request);
 
   // deserialize send request
   shared_ptr<monero_send_request> send_request = monero_send_request::deserialize(send_request_json);
@@ -1680,9 +2865,10 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_createPaymentUriJni
   return env->NewStringUTF(payment_uri.c_str());
 }
 
-JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_parsePaymentUriJni(JNIEnv* env, jobject instance, jstring juri) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_parsePaymentUriJni()");
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_parsePaymentUriJni(JNIEnv* env, jobject instance, jstring juri) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_parsePaymentUriJni()");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
   const char* _uri = juri ? env->GetStringUTFChars(juri, NULL) : nullptr;
   string uri = string(_uri ? _uri : "");
   env->ReleaseStringUTFChars(juri, _uri);
@@ -1697,19 +2883,19 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_parsePaymentUriJni(
   }
 
   // return serialized request
-  return env->NewStringUTF(send_request->serialize().c_str());
+  monero_json_arena arena;
+  return string_to_jbytes(env, arena.serialize(*send_request));
 }
 
 JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getAttributeJni(JNIEnv* env, jobject instance, jstring jkey) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_getAttribute()");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getAttribute()");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
-  const char* _key = jkey ? env->GetStringUTFChars(jkey, NULL) : nullptr;
-  string key = string(_key);
-  env->ReleaseStringUTFChars(jkey, _key);
+  wallet_lock wallet_guard(wallet);
+  string key = jstring2string(env, jkey);
   try {
     string value;
     if (!wallet->get_attribute(key, value)) return 0;
-    return env->NewStringUTF(value.c_str());
+    return string2jstring(env, value);
   } catch (...) {
     rethrow_cpp_exception_as_java_exception(env);
     return 0;
@@ -1717,14 +2903,11 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getAttributeJni(JNI
 }
 
 JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_setAttributeJni(JNIEnv* env, jobject instance, jstring jkey, jstring jval) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_setAttribute()");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_setAttribute()");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
-  const char* _key = jkey ? env->GetStringUTFChars(jkey, NULL) : nullptr;
-  const char* _val = jval ? env->GetStringUTFChars(jval, NULL) : nullptr;
-  string key = string(_key);
-  string val = string(_val);
-  env->ReleaseStringUTFChars(jkey, _key);
-  env->ReleaseStringUTFChars(jval, _val);
+  wallet_lock wallet_guard(wallet);
+  string key = jstring2string(env, jkey);
+  string val = jstring2string(env, jval);
   try {
     wallet->set_attribute(key, val);
   } catch (...) {
@@ -1733,8 +2916,9 @@ JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_setAttributeJni(JNIEnv
 }
 
 JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_startMiningJni(JNIEnv* env, jobject instance, jlong num_threads, jboolean background_mining, jboolean ignore_battery) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_startMiningJni()");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_startMiningJni()");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
   try {
     wallet->start_mining(num_threads, background_mining, ignore_battery);
   } catch (...) {
@@ -1743,8 +2927,9 @@ JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_startMiningJni(JNIEnv*
 }
 
 JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_stopMiningJni(JNIEnv* env, jobject instance) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_startMiningJni()");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_startMiningJni()");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
   try {
     wallet->stop_mining();
   } catch (...) {
@@ -1753,10 +2938,11 @@ JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_stopMiningJni(JNIEnv*
 }
 
 JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_saveJni(JNIEnv* env, jobject instance) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_saveJni(path, password)");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_saveJni(path, password)");
 
   // save wallet
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
   try {
     wallet->save();
   } catch (...) {
@@ -1765,7 +2951,7 @@ JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_saveJni(JNIEnv* env, j
 }
 
 JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_moveToJni(JNIEnv* env, jobject instance, jstring jpath, jstring jpassword) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_moveToJni(path, password)");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_moveToJni(path, password)");
   const char* _path = jpath ? env->GetStringUTFChars(jpath, NULL) : nullptr;
   const char* _password = jpath ? env->GetStringUTFChars(jpassword, NULL) : nullptr;
   string path = string(_path ? _path : "");
@@ -1775,6 +2961,7 @@ JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_moveToJni(JNIEnv* env,
 
   // move wallet
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
   try {
     wallet->move_to(path, password);
   } catch (...) {
@@ -1783,16 +2970,58 @@ JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_moveToJni(JNIEnv* env,
 }
 
 JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_closeJni(JNIEnv* env, jobject instance, jboolean save) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_CloseJni");
-  monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
-  if (save) wallet->save();
-  delete wallet;
-  wallet = nullptr;
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_CloseJni");
+  monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+
+  // a lazily opened wallet owns its full wallet until closed, which waits for it to load
+  monero_lazy_wallet* lazy_wallet = get_handle<monero_lazy_wallet>(env, instance, JNI_LAZY_WALLET_HANDLE);
+  if (lazy_wallet != nullptr) wallet = lazy_wallet->release();
+  monero_wallet* wallet_handle = wallet;
+
+  // the send pipeline's workers lock the wallet so the pipeline is deleted first
+  monero_send_pipeline* pipeline = get_handle<monero_send_pipeline>(env, instance, JNI_SEND_PIPELINE_HANDLE);
+  if (pipeline != nullptr) delete pipeline;
+
+  // a background sync holds the wallet's mutex so the sync loop is deleted before locking, waiting for the sync
+  monero_sync_loop* loop = get_handle<monero_sync_loop>(env, instance, JNI_SYNC_LOOP_HANDLE);
+  if (loop != nullptr) delete loop;
+  wallet_lock wallet_guard(wallet);
+  monero_subaddress_table* table = get_handle<monero_subaddress_table>(env, instance, JNI_SUBADDRESS_TABLE_HANDLE);
+  if (table != nullptr) delete table;
+  monero_output_store* store = get_handle<monero_output_store>(env, instance, JNI_OUTPUT_STORE_HANDLE);
+  if (store != nullptr) delete store;
+  wallet_sync_stats_listener* stats_listener = get_handle<wallet_sync_stats_listener>(env, instance, JNI_SYNC_STATS_HANDLE);
+  if (stats_listener != nullptr) {
+    if (wallet != nullptr) wallet->remove_listener(*stats_listener);
+    wallet_jni_listener* listener = get_handle<wallet_jni_listener>(env, instance, JNI_LISTENER_HANDLE);
+    if (listener != nullptr) {
+      std::lock_guard<std::mutex> lock(_listenerMutex);
+      listener->m_stats = nullptr;
+    }
+  }
+
+  if (wallet != nullptr) {
+    if (save) wallet->save();
+    delete wallet;
+    wallet = nullptr;
+  }
+  remove_wallet_mutex(wallet_handle);
+
+  // a background sync may notify the stats listener until the wallet is deleted
+  if (stats_listener != nullptr) delete stats_listener;
+
+  // keys of a lazily opened wallet go last since calls which read its handle while loading may still use them
+  if (lazy_wallet != nullptr) delete lazy_wallet;
+
+  // the wallet may use the proxy until it is deleted
+  monero_output_cache_proxy* proxy = get_handle<monero_output_cache_proxy>(env, instance, JNI_OUTPUT_CACHE_PROXY_HANDLE);
+  if (proxy != nullptr) delete proxy;
 }
 
 JNIEXPORT jboolean JNICALL Java_monero_wallet_MoneroWalletJni_isMultisigImportNeededJni(JNIEnv* env, jobject instance) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_isMultisigImportNeededJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_isMultisigImportNeededJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
   try {
     bool is_multisig_import_needed = wallet->is_multisig_import_needed();
     return static_cast<jboolean>(is_multisig_import_needed);
@@ -1803,11 +3032,13 @@ JNIEXPORT jboolean JNICALL Java_monero_wallet_MoneroWalletJni_isMultisigImportNe
 }
 
 JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getMultisigInfoJni(JNIEnv* env, jobject instance) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_getMultisigInfoJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getMultisigInfoJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
   try {
     monero_multisig_info info = wallet->get_multisig_info();
-    return env->NewStringUTF(info.serialize().c_str());
+    monero_json_arena arena;
+    return env->NewStringUTF(arena.serialize(info).GetString());
   } catch (...) {
     rethrow_cpp_exception_as_java_exception(env);
     return 0;
@@ -1815,8 +3046,9 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getMultisigInfoJni(
 }
 
 JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_prepareMultisigJni(JNIEnv* env, jobject instance) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_prepareMultisigJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_prepareMultisigJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
   try {
     string multisig_hex = wallet->prepare_multisig();
     return env->NewStringUTF(multisig_hex.c_str());
@@ -1827,7 +3059,7 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_prepareMultisigJni(
 }
 
 JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_makeMultisigJni(JNIEnv* env, jobject instance, jobjectArray jmultisig_hexes, jint threshold, jstring jpassword) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_makeMultisigJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_makeMultisigJni");
 
   // get multisig hex as vector<string>
   vector<string> multisig_hexes;
@@ -1849,9 +3081,11 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_makeMultisigJni(JNI
 
   // make the wallet multisig and return result
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
   try {
     monero_multisig_init_result result = wallet->make_multisig(multisig_hexes, threshold, password);
-    return env->NewStringUTF(result.serialize().c_str());
+    monero_json_arena arena;
+    return env->NewStringUTF(arena.serialize(result).GetString());
   } catch (...) {
     rethrow_cpp_exception_as_java_exception(env);
     return 0;
@@ -1859,7 +3093,7 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_makeMultisigJni(JNI
 }
 
 JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_exchangeMultisigKeysJni(JNIEnv* env, jobject instance, jobjectArray jmultisig_hexes, jstring jpassword) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_exchangeMultisigKeysJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_exchangeMultisigKeysJni");
 
   // get multisig hex as vector<string>
   vector<string> multisig_hexes;
@@ -1881,9 +3115,11 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_exchangeMultisigKey
 
   // import peer multisig keys and export result with address xor multisig hex for next round
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
   try {
     monero_multisig_init_result result = wallet->exchange_multisig_keys(multisig_hexes, password);
-    return env->NewStringUTF(result.serialize().c_str());
+    monero_json_arena arena;
+    return env->NewStringUTF(arena.serialize(result).GetString());
   } catch (...) {
     rethrow_cpp_exception_as_java_exception(env);
     return 0;
@@ -1891,8 +3127,9 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_exchangeMultisigKey
 }
 
 JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getMultisigHexJni(JNIEnv* env, jobject instance) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_getMultisigHexJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_getMultisigHexJni");
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
   try {
     string multisig_hex = wallet->get_multisig_hex();
     return env->NewStringUTF(multisig_hex.c_str());
@@ -1903,7 +3140,7 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getMultisigHexJni(J
 }
 
 JNIEXPORT jint JNICALL Java_monero_wallet_MoneroWalletJni_importMultisigHexJni(JNIEnv* env, jobject instance, jobjectArray jmultisig_hexes) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_importMultisigHexJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_importMultisigHexJni");
 
   // get peer multisig hex as vector<string>
   vector<string> multisig_hexes;
@@ -1920,6 +3157,8 @@ JNIEXPORT jint JNICALL Java_monero_wallet_MoneroWalletJni_importMultisigHexJni(J
 
   // import peer multisig hex and return the number of outputs they signed
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
+  touch_wallet_outputs(wallet);
   try {
     int num_outputs = wallet->import_multisig_hex(multisig_hexes);
     return num_outputs;
@@ -1930,7 +3169,7 @@ JNIEXPORT jint JNICALL Java_monero_wallet_MoneroWalletJni_importMultisigHexJni(J
 }
 
 JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_signMultisigTxHexJni(JNIEnv* env, jobject instance, jstring jmultisig_tx_hex) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_signMultisigTxHexJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_signMultisigTxHexJni");
 
   // get multisig tx hex as string
   const char* _multisig_tx_hex = jmultisig_tx_hex ? env->GetStringUTFChars(jmultisig_tx_hex, NULL) : nullptr;
@@ -1939,9 +3178,11 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_signMultisigTxHexJn
 
   // sign multisig tx hex and return result
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
   try {
     monero_multisig_sign_result result = wallet->sign_multisig_tx_hex(multisig_tx_hex);
-    return env->NewStringUTF(result.serialize().c_str());
+    monero_json_arena arena;
+    return env->NewStringUTF(arena.serialize(result).GetString());
   } catch (...) {
     rethrow_cpp_exception_as_java_exception(env);
     return 0;
@@ -1949,7 +3190,7 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_signMultisigTxHexJn
 }
 
 JNIEXPORT jobjectArray JNICALL Java_monero_wallet_MoneroWalletJni_submitMultisigTxHexJni(JNIEnv* env, jobject instance, jstring jsigned_multisig_tx_hex) {
-  MTRACE("Java_monero_wallet_MoneroWalletJni_submitMultisigTxHexJni");
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_submitMultisigTxHexJni");
 
   // get signed multisig tx hex as string
   const char* _signed_multisig_tx_hex = jsigned_multisig_tx_hex ? env->GetStringUTFChars(jsigned_multisig_tx_hex, NULL) : nullptr;
@@ -1958,6 +3199,8 @@ JNIEXPORT jobjectArray JNICALL Java_monero_wallet_MoneroWalletJni_submitMultisig
 
   // submit signed multisig tx hex and return the resulting tx hashes
   monero_wallet* wallet = get_handle<monero_wallet>(env, instance, JNI_WALLET_HANDLE);
+  wallet_lock wallet_guard(wallet);
+  touch_wallet_outputs(wallet);
   try {
     vector<string> tx_hashes = wallet->submit_multisig_tx_hex(signed_multisig_tx_hex);
     jobjectArray jtx_hashes = env->NewObjectArray(tx_hashes.size(), env->FindClass("java/lang/String"), nullptr);
@@ -1969,6 +3212,70 @@ JNIEXPORT jobjectArray JNICALL Java_monero_wallet_MoneroWalletJni_submitMultisig
   }
 }
 
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_createMultisigGroupJni(JNIEnv* env, jclass clazz, jlongArray jwallet_handles, jint threshold, jstring jpassword) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_createMultisigGroupJni");
+
+  // get wallets from their handles
+  vector<monero_wallet*> wallets;
+  if (jwallet_handles != nullptr) {
+    jsize size = env->GetArrayLength(jwallet_handles);
+    vector<jlong> handles(size);
+    env->GetLongArrayRegion(jwallet_handles, 0, size, handles.data());
+    for (jlong handle : handles) wallets.push_back(reinterpret_cast<monero_wallet*>(handle));
+  }
+  vector<unique_ptr<wallet_lock>> wallet_guards = lock_wallets(wallets);
+
+  // get password as string
+  const char* _password = jpassword ? env->GetStringUTFChars(jpassword, NULL) : nullptr;
+  string password = string(_password ? _password : "");
+  env->ReleaseStringUTFChars(jpassword, _password);
+
+  // make the wallets multisig together and serialize each wallet's result
+  try {
+    monero_multisig_coordinator coordinator(wallets);
+    vector<monero_multisig_init_result> results = coordinator.create_group(threshold, password);
+    monero_json_arena arena;
+    rapidjson::Document& doc = arena.doc();
+    doc.SetObject();
+    rapidjson::Document::AllocatorType& allocator = doc.GetAllocator();
+    rapidjson::Value jresults(rapidjson::kArrayType);
+    for (const monero_multisig_init_result& result : results) jresults.PushBack(result.to_rapidjson_val(allocator), allocator);
+    doc.AddMember("results", jresults, allocator);
+    return string_to_jbytes(env, arena.serialize());
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+    return 0;
+  }
+}
+
+JNIEXPORT jintArray JNICALL Java_monero_wallet_MoneroWalletJni_syncMultisigGroupJni(JNIEnv* env, jclass clazz, jlongArray jwallet_handles) {
+  MTRACE_SPAN("Java_monero_wallet_MoneroWalletJni_syncMultisigGroupJni");
+
+  // get wallets from their handles
+  vector<monero_wallet*> wallets;
+  if (jwallet_handles != nullptr) {
+    jsize size = env->GetArrayLength(jwallet_handles);
+    vector<jlong> handles(size);
+    env->GetLongArrayRegion(jwallet_handles, 0, size, handles.data());
+    for (jlong handle : handles) wallets.push_back(reinterpret_cast<monero_wallet*>(handle));
+  }
+  vector<unique_ptr<wallet_lock>> wallet_guards = lock_wallets(wallets);
+  for (monero_wallet* wallet : wallets) touch_wallet_outputs(wallet);
+
+  // exchange multisig hex between the wallets and return the number of outputs each signed
+  try {
+    monero_multisig_coordinator coordinator(wallets);
+    vector<int> num_outputs = coordinator.sync_group();
+    vector<jint> jnum_outputs_vals(num_outputs.begin(), num_outputs.end());
+    jintArray jnum_outputs = env->NewIntArray(jnum_outputs_vals.size());
+    env->SetIntArrayRegion(jnum_outputs, 0, jnum_outputs_vals.size(), jnum_outputs_vals.data());
+    return jnum_outputs;
+  } catch (...) {
+    rethrow_cpp_exception_as_java_exception(env);
+    return 0;
+  }
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -36,6 +36,11 @@ T *get_handle(JNIEnv *env, jobject obj, const char *field_name) {
   return reinterpret_cast<T *>(handle);
 }
 
+template<typename T>
+void set_handle(JNIEnv *env, jobject obj, const char *field_name, T *t) {
+  env->SetLongField(obj, get_handle_field(env, obj, field_name), reinterpret_cast<jlong>(t));
+}
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -46,6 +51,10 @@ JNIEXPORT jboolean JNICALL Java_monero_wallet_MoneroWalletJni_walletExistsJni(JN
 
 JNIEXPORT jlong JNICALL Java_monero_wallet_MoneroWalletJni_openWalletJni(JNIEnv *, jclass, jstring, jstring, jint);
 
+JNIEXPORT jlong JNICALL Java_monero_wallet_MoneroWalletJni_openWalletLazyJni(JNIEnv *, jclass, jstring, jstring, jint);
+
+JNIEXPORT jlongArray JNICALL Java_monero_wallet_MoneroWalletJni_openWalletsJni(JNIEnv *, jclass, jobjectArray, jobjectArray, jintArray, jint, jlong, jobjectArray);
+
 JNIEXPORT jlong JNICALL Java_monero_wallet_MoneroWalletJni_createWalletRandomJni(JNIEnv *, jclass, jstring, jstring, jint, jstring, jstring, jstring, jstring);
 
 JNIEXPORT jlong JNICALL Java_monero_wallet_MoneroWalletJni_createWalletFromMnemonicJni(JNIEnv *, jclass, jstring, jstring, jint, jstring, jlong, jstring);
@@ -56,6 +65,10 @@ JNIEXPORT jobjectArray JNICALL Java_monero_wallet_MoneroWalletJni_getMnemonicLan
 
 // ----------------------------- INSTANCE METHODS -----------------------------
 
+JNIEXPORT jboolean JNICALL Java_monero_wallet_MoneroWalletJni_isWalletLoadedJni(JNIEnv *, jobject);
+
+JNIEXPORT jlong JNICALL Java_monero_wallet_MoneroWalletJni_awaitWalletJni(JNIEnv *, jobject);
+
 JNIEXPORT jobjectArray JNICALL Java_monero_wallet_MoneroWalletJni_getDaemonConnectionJni(JNIEnv *, jobject);
 
 JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_setDaemonConnectionJni(JNIEnv *, jobject, jstring, jstring, jstring);
@@ -86,7 +99,27 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getPrivateSpendKeyJ
 
 JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getAddressJni(JNIEnv *, jobject, jint, jint);
 
-JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getAddressIndexJni(JNIEnv *, jobject, jstring);
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_getAddressesJni(JNIEnv *, jobject, jint, jint, jint, jint);
+
+JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_buildSubaddressTableJni(JNIEnv *, jobject, jint, jint, jint);
+
+JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_freeSubaddressTableJni(JNIEnv *, jobject);
+
+JNIEXPORT jlongArray JNICALL Java_monero_wallet_MoneroWalletJni_getSubaddressTableStatsJni(JNIEnv *, jobject);
+
+JNIEXPORT jintArray JNICALL Java_monero_wallet_MoneroWalletJni_getAddressIndicesJni(JNIEnv *, jobject, jobjectArray);
+
+JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_buildOutputStoreJni(JNIEnv *, jobject);
+
+JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_freeOutputStoreJni(JNIEnv *, jobject);
+
+JNIEXPORT jlongArray JNICALL Java_monero_wallet_MoneroWalletJni_getOutputStoreStatsJni(JNIEnv *, jobject);
+
+JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getOutputStoreBalanceJni(JNIEnv *, jobject, jint, jint);
+
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_getOutputStoreOutputsJni(JNIEnv *, jobject, jint, jint, jint);
+
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_getAddressIndexJni(JNIEnv *, jobject, jstring);
 
 JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getIntegratedAddressJni(JNIEnv *, jobject, jstring, jstring);
 
@@ -106,6 +139,12 @@ JNIEXPORT jlong JNICALL Java_monero_wallet_MoneroWalletJni_setListenerJni(JNIEnv
 
 JNIEXPORT jobjectArray JNICALL Java_monero_wallet_MoneroWalletJni_syncJni(JNIEnv *, jobject, jlong);
 
+JNIEXPORT jlong JNICALL Java_monero_wallet_MoneroWalletJni_setSyncStatsJni(JNIEnv *, jobject, jboolean);
+
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_getSyncStatsJni(JNIEnv *, jobject);
+
+JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_resetSyncStatsJni(JNIEnv *, jobject);
+
 JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_startSyncing(JNIEnv *, jobject);
 
 JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_stopSyncing(JNIEnv *, jobject);
@@ -126,46 +165,64 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getUnlockedBalanceA
 
 JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getUnlockedBalanceSubaddressJni(JNIEnv *, jobject, jint, jint);
 
-JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getAccountsJni(JNIEnv *, jobject, jboolean, jstring);
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_getAccountsJni(JNIEnv *, jobject, jboolean, jstring);
+
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_getAccountJni(JNIEnv *, jobject, jint, jboolean);
 
-JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getAccountJni(JNIEnv *, jobject, jint, jboolean);
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_createAccountJni(JNIEnv *, jobject, jstring);
 
-JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_createAccountJni(JNIEnv *, jobject, jstring);
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_getSubaddressesJni(JNIEnv *, jobject, jint, jintArray);
 
-JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getSubaddressesJni(JNIEnv *, jobject, jint, jintArray);
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_createSubaddressJni(JNIEnv *, jobject, jint, jstring);
 
-JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_createSubaddressJni(JNIEnv *, jobject, jint, jstring);
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_createSubaddressesJni(JNIEnv *, jobject, jint, jint, jstring, jintArray);
 
-JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getTxsJni(JNIEnv *, jobject, jstring);
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_getTxsJni(JNIEnv *, jobject, jbyteArray);
 
-JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getTransfersJni(JNIEnv *, jobject, jstring);
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_getTransfersJni(JNIEnv *, jobject, jbyteArray);
 
-JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getOutputsJni(JNIEnv *, jobject, jstring);
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_getOutputsJni(JNIEnv *, jobject, jbyteArray);
 
-JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getKeyImagesJni(JNIEnv *, jobject);
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_getKeyImagesJni(JNIEnv *, jobject);
 
-JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_importKeyImagesJni(JNIEnv *, jobject, jstring);
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_importKeyImagesJni(JNIEnv *, jobject, jbyteArray);
 
-JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_sendSplitJni(JNIEnv *, jobject, jstring);
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_sendSplitJni(JNIEnv *, jobject, jbyteArray);
 
-JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_sweepUnlockedJni(JNIEnv *, jobject, jstring);
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_sweepUnlockedJni(JNIEnv *, jobject, jbyteArray);
 
-JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_sweepOutputJni(JNIEnv *, jobject, jstring);
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_sweepOutputJni(JNIEnv *, jobject, jbyteArray);
 
-JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_sweepDustJni(JNIEnv *, jobject, jboolean);
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_sweepDustJni(JNIEnv *, jobject, jboolean);
 
-JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_parseTxSetJni(JNIEnv *, jobject, jstring);
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_parseTxSetJni(JNIEnv *, jobject, jbyteArray);
 
 JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_signTxsJni(JNIEnv *, jobject, jstring);
 
 JNIEXPORT jobjectArray JNICALL Java_monero_wallet_MoneroWalletJni_submitTxsJni(JNIEnv *, jobject, jstring);
 
-JNIEXPORT jobjectArray JNICALL Java_monero_wallet_MoneroWalletJni_relayTxsJni(JNIEnv *, jobject, jobjectArray);
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_relayTxsJni(JNIEnv *, jobject, jobjectArray, jint, jboolean);
+
+JNIEXPORT jlong JNICALL Java_monero_wallet_MoneroWalletJni_startSendPipelineJni(JNIEnv *, jobject, jlong, jint);
+
+JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_stopSendPipelineJni(JNIEnv *, jobject);
+
+JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_deleteSendPipelineJni(JNIEnv *, jobject);
+
+JNIEXPORT jlong JNICALL Java_monero_wallet_MoneroWalletJni_submitToSendPipelineJni(JNIEnv *, jobject, jbyteArray);
+
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_getSendPipelineResultJni(JNIEnv *, jobject, jlong, jboolean);
+
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_getSendPipelineStatsJni(JNIEnv *, jobject);
 
 JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_signJni(JNIEnv *, jobject, jstring);
 
 JNIEXPORT jboolean JNICALL Java_monero_wallet_MoneroWalletJni_verifyJni(JNIEnv *, jobject, jstring, jstring, jstring);
 
+JNIEXPORT jobjectArray JNICALL Java_monero_wallet_MoneroWalletJni_signBatchJni(JNIEnv *, jobject, jobjectArray, jint);
+
+JNIEXPORT jbooleanArray JNICALL Java_monero_wallet_MoneroWalletJni_verifyBatchJni(JNIEnv *, jobject, jobjectArray, jobjectArray, jobjectArray, jint);
+
 JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getTxKeyJni(JNIEnv *, jobject, jstring);
 
 JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_checkTxKeyJni(JNIEnv *, jobject, jstring, jstring, jstring);
@@ -178,15 +235,23 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getSpendProofJni(JN
 
 JNIEXPORT jboolean JNICALL Java_monero_wallet_MoneroWalletJni_checkSpendProofJni(JNIEnv *, jobject, jstring, jstring, jstring);
 
+JNIEXPORT jlongArray JNICALL Java_monero_wallet_MoneroWalletJni_checkTxKeysJni(JNIEnv *, jobject, jobjectArray, jobjectArray, jobjectArray, jint);
+
+JNIEXPORT jlongArray JNICALL Java_monero_wallet_MoneroWalletJni_checkTxProofsJni(JNIEnv *, jobject, jobjectArray, jobjectArray, jobjectArray, jobjectArray, jint);
+
+JNIEXPORT jbooleanArray JNICALL Java_monero_wallet_MoneroWalletJni_checkSpendProofsJni(JNIEnv *, jobject, jobjectArray, jobjectArray, jobjectArray, jint);
+
 JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getReserveProofWalletJni(JNIEnv *, jobject, jstring);
 
 JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getReserveProofAccountJni(JNIEnv *, jobject, jint, jstring, jstring);
 
 JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_checkReserveProofJni(JNIEnv *, jobject, jstring, jstring, jstring);
 
-JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_createPaymentUriJni(JNIEnv *, jobject, jstring);
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_checkReserveProofsJni(JNIEnv *, jobject, jobjectArray, jobjectArray, jobjectArray, jint, jobject);
+
+JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_createPaymentUriJni(JNIEnv *, jobject, jbyteArray);
 
-JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_parsePaymentUriJni(JNIEnv *, jobject, jstring);
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_parsePaymentUriJni(JNIEnv *, jobject, jstring);
 
 JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getOutputsHexJni(JNIEnv *, jobject);
 
@@ -196,7 +261,7 @@ JNIEXPORT jobjectArray JNICALL Java_monero_wallet_MoneroWalletJni_getTxNotesJni(
 
 JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_setTxNotesJni(JNIEnv *, jobject, jobjectArray, jobjectArray);
 
-JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_getAddressBookEntriesJni(JNIEnv *, jobject, jintArray);
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_getAddressBookEntriesJni(JNIEnv *, jobject, jintArray);
 
 JNIEXPORT jint JNICALL Java_monero_wallet_MoneroWalletJni_addAddressBookEntryJni(JNIEnv *, jobject, jstring, jstring);
 
@@ -230,6 +295,10 @@ JNIEXPORT jstring JNICALL Java_monero_wallet_MoneroWalletJni_signMultisigTxHexJn
 
 JNIEXPORT jobjectArray JNICALL Java_monero_wallet_MoneroWalletJni_submitMultisigTxHexJni(JNIEnv *, jobject, jstring);
 
+JNIEXPORT jbyteArray JNICALL Java_monero_wallet_MoneroWalletJni_createMultisigGroupJni(JNIEnv *, jclass, jlongArray, jint, jstring);
+
+JNIEXPORT jintArray JNICALL Java_monero_wallet_MoneroWalletJni_syncMultisigGroupJni(JNIEnv *, jclass, jlongArray);
+
 JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_saveJni(JNIEnv *, jobject);
 
 JNIEXPORT void JNICALL Java_monero_wallet_MoneroWalletJni_moveToJni(JNIEnv *, jobject, jstring, jstring);
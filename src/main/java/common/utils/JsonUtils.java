@@ -47,6 +47,31 @@ public class JsonUtils {
     }
   }
   
+  /**
+   * Serializes an object to UTF-8 JSON bytes.
+   * 
+   * @param obj is the object to serialize
+   * @return byte[] is the object serialized to UTF-8 JSON bytes
+   */
+  public static byte[] serializeBytes(Object obj) {
+    return serializeBytes(DEFAULT_MAPPER, obj);
+  }
+  
+  /**
+   * Serializes an object to UTF-8 JSON bytes.
+   * 
+   * @param mapper is the jackson object mapper to use
+   * @param obj is the object to serialize
+   * @return byte[] is the object serialized to UTF-8 JSON bytes
+   */
+  public static byte[] serializeBytes(ObjectMapper mapper, Object obj) {
+    try {
+      return mapper.writeValueAsBytes(obj);
+    } catch (Exception e) {
+      throw new JsonException("Error serializing object", e);
+    }
+  }
+  
   /**
    * Deserializes JSON to a specific class.
    * 
@@ -101,6 +126,60 @@ public class JsonUtils {
     }
   }
 
+  /**
+   * Deserializes UTF-8 JSON bytes to a specific class.
+   * 
+   * @param json is the UTF-8 JSON to deserialize
+   * @param clazz specifies the class to deserialize to
+   * @return T is the object deserialized from JSON to the given class
+   */
+  public static <T> T deserialize(byte[] json, Class<T> clazz) {
+    return deserialize(DEFAULT_MAPPER, json, clazz);
+  }
+  
+  /**
+   * Deserializes UTF-8 JSON bytes to a specific class.
+   * 
+   * @param mapper is the jackson object mapper to use
+   * @param json is the UTF-8 JSON to deserialize
+   * @param clazz specifies the class to deserialize to
+   * @return T is the object deserialized from JSON to the given class
+   */
+  public static <T> T deserialize(ObjectMapper mapper, byte[] json, Class<T> clazz) {
+    try {
+      return mapper.readValue(json, clazz);
+    } catch (Exception e) {
+      throw new JsonException("Error deserializing json to class", e);
+    }
+  }
+  
+  /**
+   * Deserializes UTF-8 JSON bytes to a parameterized type.
+   * 
+   * @param json is the UTF-8 JSON to deserialize
+   * @param type is the parameterized type to deserialize to (e.g. new TypeReference<Map<String, Object>>(){})
+   * @return T is the object deserialized from JSON to the given parameterized type
+   */
+  public static <T> T deserialize(byte[] json, TypeReference<T> type) {
+    return deserialize(DEFAULT_MAPPER, json, type);
+  }
+  
+  /**
+   * Deserializes UTF-8 JSON bytes to a parameterized type.
+   * 
+   * @param mapper is the jackson object mapper to use
+   * @param json is the UTF-8 JSON to deserialize
+   * @param type is the parameterized type to deserialize to (e.g. new TypeReference<Map<String, Object>>(){})
+   * @return T is the object deserialized from JSON to the given parameterized type
+   */
+  public static <T> T deserialize(ObjectMapper mapper, byte[] json, TypeReference<T> type) {
+    try {
+      return (T) mapper.readValue(json, type);
+    } catch (Exception e) {
+      throw new JsonException("Error deserializing json to type " + type.getType(), e);
+    }
+  }
+  
   /**
    * Converts a JSON string to a map.
    * 
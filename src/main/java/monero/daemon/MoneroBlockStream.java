@@ -0,0 +1,105 @@
+/**
+ * Copyright (c) 2017-2019 woodser
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+package monero.daemon;
+
+import java.util.ArrayList;
+import java.util.List;
+import java.util.Map;
+
+import monero.daemon.model.MoneroBlock;
+import monero.rpc.MoneroRpcConnection;
+import monero.utils.MoneroException;
+import monero.utils.MoneroUtils;
+
+/**
+ * Stream of block chunks which are fetched and decoded natively ahead of
+ * the consumer and delivered in order.
+ * 
+ * The stream holds native resources until it is closed.
+ */
+public class MoneroBlockStream implements AutoCloseable {
+  
+  private long handle;
+  private List<Long> startHeights;
+  private List<Long> endHeights;
+  private int chunkIdx;
+  
+  MoneroBlockStream(MoneroRpcConnection rpc, List<Long> startHeights, List<Long> endHeights, int maxRequestsInFlight) {
+    this.startHeights = startHeights;
+    this.endHeights = endHeights;
+    long[] starts = new long[startHeights.size()];
+    long[] ends = new long[endHeights.size()];
+    for (int i = 0; i < starts.length; i++) {
+      starts[i] = startHeights.get(i);
+      ends[i] = endHeights.get(i);
+    }
+    try {
+      this.handle = MoneroUtils.startBlockStream(rpc.getUri(), rpc.getUsername(), rpc.getPassword(), starts, ends, maxRequestsInFlight);
+    } catch (Exception e) {
+      throw new MoneroException(e.getMessage());
+    }
+  }
+  
+  /**
+   * Get the number of chunks in the stream.
+   * 
+   * @return the number of chunks
+   */
+  public int getNumChunks() {
+    return startHeights.size();
+  }
+  
+  /**
+   * Get the next chunk of blocks in order, waiting until it is fetched.
+   * 
+   * @return the next chunk of blocks with their txs, null if all chunks are taken
+   */
+  public synchronized List<MoneroBlock> next() {
+    if (handle == 0) throw new MoneroException("Block stream is closed");
+    if (chunkIdx == startHeights.size()) return null;
+    
+    // take the chunk natively, which consumes it even if it failed
+    List<Long> heights = new ArrayList<Long>();
+    for (long height = startHeights.get(chunkIdx); height <= endHeights.get(chunkIdx); height++) heights.add(height);
+    Map<String, Object> rpcResp;
+    try {
+      rpcResp = MoneroUtils.getNextBlockStreamChunk(handle);
+    } catch (Exception e) {
+      throw new MoneroException(e.getMessage());
+    } finally {
+      chunkIdx++;
+    }
+    if (rpcResp == null) return null;
+    return MoneroDaemonRpc.convertRpcBlocks(rpcResp, heights);
+  }
+  
+  /**
+   * Stop fetching chunks and free the stream's native resources.
+   */
+  @Override
+  public synchronized void close() {
+    if (handle == 0) return;
+    MoneroUtils.stopBlockStream(handle);
+    handle = 0;
+  }
+}
@@ -82,11 +82,18 @@ public class MoneroDaemonRpc extends MoneroDaemonDefault {
   private static final String DEFAULT_ID = "0000000000000000000000000000000000000000000000000000000000000000";
   private static long MAX_REQ_SIZE = 3000000;  // max request size when fetching blocks from daemon
   private static int NUM_HEADERS_PER_REQ = 750;
+  private static final long DEFAULT_OUTPUT_CACHE_REFRESH_MS = 10000; // refresh the output and header cache tips at most every X ms
   
   // instance variables
   private MoneroRpcConnection rpc;
   private MoneroDaemonPoller daemonPoller;
-  private Map<Long, MoneroBlockHeader> cachedHeaders;
+  private long[] cachedSizes;       // window of block sizes last read from the shared header cache
+  private long cachedSizesStart;
+  private int numCachedSizes;
+  private long outputCacheRefreshMs;
+  private long outputCacheTipUpdateMs;  // time the output cache tip was last reported by this client, 0 if never
+  private volatile long headerCacheTipUpdateMs;  // time the header cache tip was last reported by this client, 0 if never
+  private volatile String headerCacheTipHash;    // hash of the tip last reported to the header cache by this client
   
   public MoneroDaemonRpc(URI uri) {
     this(new MoneroRpcConnection(uri));
@@ -108,7 +115,8 @@ public class MoneroDaemonRpc extends MoneroDaemonDefault {
     GenUtils.assertNotNull(rpc);
     this.rpc = rpc;
     this.daemonPoller = new MoneroDaemonPoller(this);
-    this.cachedHeaders = new HashMap<Long, MoneroBlockHeader>();
+    this.cachedSizes = new long[NUM_HEADERS_PER_REQ];
+    this.outputCacheRefreshMs = DEFAULT_OUTPUT_CACHE_REFRESH_MS;
   }
   
   /**
@@ -120,6 +128,19 @@ public class MoneroDaemonRpc extends MoneroDaemonDefault {
     return this.rpc;
   }
   
+  /**
+   * Set how often the chain tip is re-read to invalidate the shared output
+   * and header caches.  Between refreshes, outputs, open-ended distributions,
+   * and block sizes are served as of the last known tip; new blocks seen by a
+   * daemon listener refresh the tip immediately.
+   * 
+   * @param refreshMs is the minimum time between tip refreshes in ms, 0 to refresh on every call
+   */
+  public void setOutputCacheRefreshPeriod(long refreshMs) {
+    GenUtils.assertTrue("Refresh period must be >= 0", refreshMs >= 0);
+    this.outputCacheRefreshMs = refreshMs;
+  }
+  
   /**
    * Indicates if the client is connected to the daemon via RPC.
    * 
@@ -251,7 +272,6 @@ public class MoneroDaemonRpc extends MoneroDaemonDefault {
     return block;
   }
 
-  @SuppressWarnings({ "unchecked" })
   @Override
   public List<MoneroBlock> getBlocksByHeight(List<Long> heights) {
     
@@ -262,47 +282,7 @@ public class MoneroDaemonRpc extends MoneroDaemonDefault {
     
     // convert binary blocks to map
     Map<String, Object> rpcResp = MoneroUtils.binaryBlocksToMap(respBin);
-    checkResponseStatus(rpcResp);
-    
-    // build blocks with transactions
-    List<MoneroBlock> blocks = new ArrayList<MoneroBlock>();
-    List<Map<String, Object>> rpcBlocks = (List<Map<String, Object>>) rpcResp.get("blocks");
-    List<List<Map<String, Object>>> rpcTxs = (List<List<Map<String, Object>>>) rpcResp.get("txs");
-    GenUtils.assertEquals(rpcBlocks.size(), rpcTxs.size());
-    for (int blockIdx = 0; blockIdx < rpcBlocks.size(); blockIdx++) {
-      
-      // build block
-      MoneroBlock block = convertRpcBlock(rpcBlocks.get(blockIdx));
-      block.setHeight(heights.get(blockIdx));
-      blocks.add(block);
-
-      // build transactions
-      List<MoneroTx> txs = new ArrayList<MoneroTx>();
-      for (int txIdx = 0; txIdx < rpcTxs.get(blockIdx).size(); txIdx++) {
-        MoneroTx tx = new MoneroTx();
-        txs.add(tx);
-        List<String> txHashes = (List<String>) rpcBlocks.get(blockIdx).get("tx_hashes");
-        tx.setHash(txHashes.get(txIdx));
-        tx.setIsConfirmed(true);
-        tx.setInTxPool(false);
-        tx.setIsMinerTx(false);
-        tx.setDoNotRelay(false);
-        tx.setIsRelayed(true);
-        tx.setIsFailed(false);
-        tx.setIsDoubleSpendSeen(false);
-        List<Map<String, Object>> blockTxs = (List<Map<String, Object>>) rpcTxs.get(blockIdx);
-        convertRpcTx(blockTxs.get(txIdx), tx);
-      }
-      
-      // merge into one block
-      block.setTxs(new ArrayList<MoneroTx>());
-      for (MoneroTx tx : txs) {
-        if (tx.getBlock() != null) block.merge(tx.getBlock());
-        else block.getTxs().add(tx.setBlock(block));
-      }
-    }
-    
-    return blocks;
+    return convertRpcBlocks(rpcResp, heights);
   }
   
   @Override
@@ -318,6 +298,7 @@ public class MoneroDaemonRpc extends MoneroDaemonDefault {
   public List<MoneroBlock> getBlocksByRangeChunked(Long startHeight, Long endHeight, Long maxChunkSize) {
     if (startHeight == null) startHeight = 0l;
     if (endHeight == null) endHeight = getHeight() - 1;
+    updateBlockHeaderCacheTip();
     long lastHeight = startHeight - 1;
     List<MoneroBlock> blocks = new ArrayList<MoneroBlock>();
     while (lastHeight < endHeight) {
@@ -327,6 +308,38 @@ public class MoneroDaemonRpc extends MoneroDaemonDefault {
     return blocks;
   }
   
+  /**
+   * Stream blocks in a range as chunks up to a maximum chunk size which are
+   * fetched and decoded natively, up to the given number of chunks at once,
+   * while earlier chunks are consumed.
+   * 
+   * @param startHeight is the start height to retrieve blocks (default 0)
+   * @param endHeight is the end height to retrieve blocks (default blockchain height)
+   * @param maxChunkSize is the maximum chunk size in any one request (default 3,000,000 bytes)
+   * @param maxRequestsInFlight is the maximum number of chunks fetched at once
+   * @return the stream of chunks in order which must be closed
+   */
+  public MoneroBlockStream streamBlocksByRange(Long startHeight, Long endHeight, Long maxChunkSize, int maxRequestsInFlight) {
+    if (!MoneroUtils.isJniLoaded()) throw new MoneroException("Streaming blocks requires the native monero-java library");
+    if (startHeight == null) startHeight = 0l;
+    if (endHeight == null) endHeight = getHeight() - 1;
+    updateBlockHeaderCacheTip();
+    
+    // divide range into chunks using cached header sizes
+    List<Long> startHeights = new ArrayList<Long>();
+    List<Long> endHeights = new ArrayList<Long>();
+    long lastHeight = startHeight - 1;
+    while (lastHeight < endHeight) {
+      long chunkEndHeight = getMaxEndHeight(lastHeight + 1, endHeight, maxChunkSize);
+      startHeights.add(lastHeight + 1);
+      endHeights.add(chunkEndHeight);
+      lastHeight = chunkEndHeight;
+    }
+    
+    // start streaming chunks
+    return new MoneroBlockStream(rpc, startHeights, endHeights, maxRequestsInFlight);
+  }
+  
   @Override
   public List<String> getBlockHashes(List<String> blockHashes, Long startHeight) {
     throw new RuntimeException("Not implemented");
@@ -528,9 +541,54 @@ public class MoneroDaemonRpc extends MoneroDaemonDefault {
     return statuses;
   }
 
+  @SuppressWarnings("unchecked")
   @Override
   public List<MoneroOutput> getOutputs(Collection<MoneroOutput> outputs) {
-    throw new RuntimeException("Not implemented");
+    
+    // build request entries by amount and global index
+    List<Map<String, Object>> rpcRequests = new ArrayList<Map<String, Object>>();
+    for (MoneroOutput output : outputs) {
+      GenUtils.assertNotNull("Output index is not defined", output.getIndex());
+      Map<String, Object> rpcRequest = new HashMap<String, Object>();
+      rpcRequest.put("amount", output.getAmount() == null ? BigInteger.valueOf(0) : output.getAmount());
+      rpcRequest.put("index", output.getIndex());
+      rpcRequests.add(rpcRequest);
+    }
+    
+    // collect cached outputs
+    boolean useCache = MoneroUtils.isJniLoaded();
+    Map<String, Map<String, Object>> rpcOutputs = new HashMap<String, Map<String, Object>>();
+    if (useCache) {
+      updateOutputCacheTip();
+      for (Map<String, Object> rpcOutput : MoneroUtils.getCachedOutputs(rpc.getUri(), rpcRequests)) rpcOutputs.put(getOutputKey(rpcOutput), rpcOutput);
+    }
+    
+    // fetch remaining outputs from the daemon
+    List<Map<String, Object>> misses = new ArrayList<Map<String, Object>>();
+    for (Map<String, Object> rpcRequest : rpcRequests) {
+      if (!rpcOutputs.containsKey(getOutputKey(rpcRequest))) misses.add(rpcRequest);
+    }
+    if (!misses.isEmpty()) {
+      Map<String, Object> params = new HashMap<String, Object>();
+      params.put("outputs", misses);
+      params.put("get_txid", true);
+      Map<String, Object> resp = rpc.sendPathRequest("get_outs", params);
+      checkResponseStatus(resp);
+      List<Map<String, Object>> rpcOuts = (List<Map<String, Object>>) resp.get("outs");
+      GenUtils.assertEquals(misses.size(), rpcOuts.size());
+      for (int i = 0; i < misses.size(); i++) {
+        Map<String, Object> rpcOutput = rpcOuts.get(i);
+        rpcOutput.put("amount", misses.get(i).get("amount"));
+        rpcOutput.put("index", misses.get(i).get("index"));
+        rpcOutputs.put(getOutputKey(rpcOutput), rpcOutput);
+      }
+      if (useCache) MoneroUtils.putCachedOutputs(rpc.getUri(), rpcOuts);
+    }
+    
+    // build outputs in requested order
+    List<MoneroOutput> result = new ArrayList<MoneroOutput>();
+    for (Map<String, Object> rpcRequest : rpcRequests) result.add(convertRpcOutsEntry(rpcOutputs.get(getOutputKey(rpcRequest))));
+    return result;
   }
 
   @SuppressWarnings("unchecked")
@@ -559,37 +617,48 @@ public class MoneroDaemonRpc extends MoneroDaemonDefault {
     return entries;
   }
 
+  @SuppressWarnings("unchecked")
   @Override
   public List<MoneroOutputDistributionEntry> getOutputDistribution(Collection<BigInteger> amounts, Boolean isCumulative, Long startHeight, Long endHeight) {
-    throw new RuntimeException("Not implemented (response 'distribution' field is binary)");
-//  let amountStrs = [];
-//  for (let amount of amounts) amountStrs.push(amount.toJSValue());
-//  console.log(amountStrs);
-//  console.log(cumulative);
-//  console.log(startHeight);
-//  console.log(endHeight);
-//  
-//  // send rpc request
-//  console.log("*********** SENDING REQUEST *************");
-//  if (startHeight === undefined) startHeight = 0;
-//  let resp = await this.config.rpc.sendJsonRequest("get_output_distribution", {
-//    amounts: amountStrs,
-//    cumulative: cumulative,
-//    from_height: startHeight,
-//    to_height: endHeight
-//  });
-//  
-//  console.log("RESPONSE");
-//  console.log(resp);
-//  
-//  // build distribution entries from response
-//  let entries = [];
-//  if (!resp.result.distributions) return entries; 
-//  for (let rpcEntry of resp.result.distributions) {
-//    let entry = MoneroDaemonRpc._convertRpcOutputDistributionEntry(rpcEntry);
-//    entries.push(entry);
-//  }
-//  return entries;
+    
+    // build request params with distributions returned as json rather than binary
+    Map<String, Object> params = new HashMap<String, Object>();
+    params.put("amounts", amounts);
+    params.put("cumulative", Boolean.TRUE.equals(isCumulative));
+    params.put("from_height", startHeight == null ? 0l : startHeight);
+    params.put("to_height", endHeight == null ? 0l : endHeight);
+    params.put("binary", false);
+    
+    // collect cached distributions
+    boolean useCache = MoneroUtils.isJniLoaded();
+    Map<BigInteger, Map<String, Object>> rpcEntries = new HashMap<BigInteger, Map<String, Object>>();
+    if (useCache) {
+      updateOutputCacheTip();
+      for (Map<String, Object> rpcEntry : MoneroUtils.getCachedOutputDistributions(rpc.getUri(), params)) rpcEntries.put((BigInteger) rpcEntry.get("amount"), rpcEntry);
+    }
+    
+    // fetch remaining distributions from the daemon
+    List<BigInteger> misses = new ArrayList<BigInteger>();
+    for (BigInteger amount : amounts) if (!rpcEntries.containsKey(amount)) misses.add(amount);
+    if (!misses.isEmpty()) {
+      params.put("amounts", misses);
+      Map<String, Object> resp = rpc.sendJsonRequest("get_output_distribution", params);
+      Map<String, Object> result = (Map<String, Object>) resp.get("result");
+      checkResponseStatus(result);
+      if (result.containsKey("distributions")) {
+        List<Map<String, Object>> rpcDistributions = (List<Map<String, Object>>) result.get("distributions");
+        for (Map<String, Object> rpcEntry : rpcDistributions) rpcEntries.put((BigInteger) rpcEntry.get("amount"), rpcEntry);
+        if (useCache) MoneroUtils.putCachedOutputDistributions(rpc.getUri(), params, rpcDistributions);
+      }
+    }
+    
+    // build distribution entries in requested order
+    List<MoneroOutputDistributionEntry> entries = new ArrayList<MoneroOutputDistributionEntry>();
+    for (BigInteger amount : amounts) {
+      Map<String, Object> rpcEntry = rpcEntries.get(amount);
+      if (rpcEntry != null) entries.add(convertRpcOutputDistributionEntry(rpcEntry));
+    }
+    return entries;
   }
 
   @SuppressWarnings("unchecked")
@@ -922,6 +991,20 @@ public class MoneroDaemonRpc extends MoneroDaemonDefault {
   private List<MoneroBlock> getMaxBlocks(Long startHeight, Long maxHeight, Long chunkSize) {
     if (startHeight == null) startHeight = 0l;
     if (maxHeight == null) maxHeight = getHeight() - 1;
+    long endHeight = getMaxEndHeight(startHeight, maxHeight, chunkSize);
+    return endHeight >= startHeight ? getBlocksByRange(startHeight, endHeight) : new ArrayList<MoneroBlock>();
+  }
+  
+  /**
+   * Get the end height of a contiguous chunk of blocks starting from a given height
+   * up to a maximum height or maximum amount of block data, whichever comes first.
+   * 
+   * @param startHeight is the start height of the chunk
+   * @param maxHeight is the maximum end height of the chunk
+   * @param chunkSize is the maximum chunk size in bytes (default 3,000,000 bytes)
+   * @return the end height of the chunk, startHeight - 1 if empty
+   */
+  private long getMaxEndHeight(long startHeight, long maxHeight, Long chunkSize) {
     if (chunkSize == null) chunkSize = MAX_REQ_SIZE;
     
     // determine end height to fetch
@@ -929,48 +1012,98 @@ public class MoneroDaemonRpc extends MoneroDaemonDefault {
     long endHeight = startHeight - 1;
     while (reqSize < chunkSize && endHeight < maxHeight) {
       
-      // get header of next block
-      MoneroBlockHeader header = getBlockHeaderByHeightCached(endHeight + 1, maxHeight);
+      // get size of next block
+      long size = getBlockSizeCached(endHeight + 1, maxHeight);
       
       // block cannot be bigger than max request size
-      GenUtils.assertTrue("Block exceeds maximum request size: " + header.getSize(), header.getSize() <= chunkSize);
+      GenUtils.assertTrue("Block exceeds maximum request size: " + size, size <= chunkSize);
       
       // done iterating if fetching block would exceed max request size
-      if (reqSize + header.getSize() > chunkSize) break;
+      if (reqSize + size > chunkSize) break;
       
       // otherwise block is included
-      reqSize += header.getSize();
+      reqSize += size;
       endHeight++;
     }
-    return endHeight >= startHeight ? getBlocksByRange(startHeight, endHeight) : new ArrayList<MoneroBlock>();
+    return endHeight;
   }
   
   /**
-   * Retrieves a header by height from the cache or fetches and caches a header
-   * range if not already in the cache.
+   * Retrieves a block's size from the shared header cache or fetches and caches
+   * a header range if not already in the cache.
    * 
-   * @param height is the height of the header to retrieve from the cache
+   * @param height is the height of the block whose size to retrieve
    * @param maxHeight is the maximum height of headers to cache
    */
-  private MoneroBlockHeader getBlockHeaderByHeightCached(long height, long maxHeight) {
+  private long getBlockSizeCached(long height, long maxHeight) {
     
-    // get header from cache
-    MoneroBlockHeader cachedHeader = cachedHeaders.get(height);
-    if (cachedHeader != null) return cachedHeader;
+    // get size from the window last read from the cache
+    if (height >= cachedSizesStart && height < cachedSizesStart + numCachedSizes) return cachedSizes[(int) (height - cachedSizesStart)];
+    
+    // read the next window from the cache
+    cachedSizesStart = height;
+    numCachedSizes = MoneroUtils.getCachedBlockSizes(rpc.getUri(), height, cachedSizes);
+    if (numCachedSizes > 0) return cachedSizes[0];
     
     // fetch and cache headers if not in cache
     long endHeight = Math.min(maxHeight, height + NUM_HEADERS_PER_REQ - 1);  // TODO: could specify end height to cache to optimize small requests (would like to have time profiling in place though)
     List<MoneroBlockHeader> headers = getBlockHeadersByRange(height, endHeight);
-    for (MoneroBlockHeader header : headers) {
-      cachedHeaders.put(header.getHeight(), header);
-    }
-    
-    // return the cached header
-    return cachedHeaders.get(height);
+    MoneroUtils.putCachedBlockHeaders(rpc.getUri(), headerCacheTipHash, headers);
+    for (MoneroBlockHeader header : headers) cachedSizes[numCachedSizes++] = header.getSize();
+    return cachedSizes[0];
   }
   
   //---------------------------------- PRIVATE STATIC -------------------------------
   
+  /**
+   * Reports the current chain tip to the native output cache so entries
+   * invalidated by new blocks or a reorg are not served.
+   */
+  private void updateOutputCacheTip() {
+    if (outputCacheTipUpdateMs != 0 && System.currentTimeMillis() - outputCacheTipUpdateMs < outputCacheRefreshMs) return;
+    setOutputCacheTip(getLastBlockHeader());
+  }
+  
+  private void setOutputCacheTip(MoneroBlockHeader tip) {
+    MoneroUtils.setOutputCacheTip(rpc.getUri(), tip.getHeight(), tip.getHash(), getAnchorHash(tip, MoneroUtils.getOutputCacheTipHeight(rpc.getUri())));
+    outputCacheTipUpdateMs = System.currentTimeMillis();
+  }
+  
+  /**
+   * Reports the current chain tip to the daemon's shared header cache so
+   * headers replaced by a reorg are not served.
+   */
+  private void updateBlockHeaderCacheTip() {
+    if (headerCacheTipUpdateMs != 0 && System.currentTimeMillis() - headerCacheTipUpdateMs < outputCacheRefreshMs) return;
+    setBlockHeaderCacheTip(getLastBlockHeader());
+    numCachedSizes = 0;
+  }
+  
+  private void setBlockHeaderCacheTip(MoneroBlockHeader tip) {
+    MoneroUtils.setBlockHeaderCacheTip(rpc.getUri(), tip.getHeight(), tip.getHash(), getAnchorHash(tip, MoneroUtils.getBlockHeaderCacheTipHeight(rpc.getUri())));
+    headerCacheTipHash = tip.getHash();
+    headerCacheTipUpdateMs = System.currentTimeMillis();
+  }
+  
+  /**
+   * Get the hash on the current chain of the block at a cache's previously
+   * reported tip height.
+   * 
+   * @param tip is the current chain tip
+   * @param cachedHeight is the cache's previously reported tip height, -1 if none
+   * @return the hash of the block at the height, null if unknown
+   */
+  private String getAnchorHash(MoneroBlockHeader tip, long cachedHeight) {
+    if (cachedHeight == tip.getHeight()) return tip.getHash();
+    if (cachedHeight == tip.getHeight() - 1) return tip.getPrevHash();
+    if (cachedHeight >= 0 && cachedHeight < tip.getHeight()) return getBlockHash(cachedHeight);
+    return null;
+  }
+  
+  private static String getOutputKey(Map<String, Object> rpcOutput) {
+    return rpcOutput.get("amount") + ":" + rpcOutput.get("index");
+  }
+  
   private static void checkResponseStatus(Map<String, Object> resp) {
     String status = (String) resp.get("status");
     if (!"OK".equals(status)) throw new MoneroRpcException(status, null, null, null);
@@ -1038,6 +1171,58 @@ public class MoneroDaemonRpc extends MoneroDaemonDefault {
     return header;
   }
   
+  /**
+   * Build blocks with their txs from a get_blocks_by_height.bin response.
+   * 
+   * @param rpcResp is the response converted to a map
+   * @param heights are the heights of the requested blocks
+   * @return the blocks with their txs
+   */
+  @SuppressWarnings("unchecked")
+  static List<MoneroBlock> convertRpcBlocks(Map<String, Object> rpcResp, List<Long> heights) {
+    checkResponseStatus(rpcResp);
+    
+    // build blocks with transactions
+    List<MoneroBlock> blocks = new ArrayList<MoneroBlock>();
+    List<Map<String, Object>> rpcBlocks = (List<Map<String, Object>>) rpcResp.get("blocks");
+    List<List<Map<String, Object>>> rpcTxs = (List<List<Map<String, Object>>>) rpcResp.get("txs");
+    GenUtils.assertEquals(rpcBlocks.size(), rpcTxs.size());
+    for (int blockIdx = 0; blockIdx < rpcBlocks.size(); blockIdx++) {
+      
+      // build block
+      MoneroBlock block = convertRpcBlock(rpcBlocks.get(blockIdx));
+      block.setHeight(heights.get(blockIdx));
+      blocks.add(block);
+
+      // build transactions
+      List<MoneroTx> txs = new ArrayList<MoneroTx>();
+      for (int txIdx = 0; txIdx < rpcTxs.get(blockIdx).size(); txIdx++) {
+        MoneroTx tx = new MoneroTx();
+        txs.add(tx);
+        List<String> txHashes = (List<String>) rpcBlocks.get(blockIdx).get("tx_hashes");
+        tx.setHash(txHashes.get(txIdx));
+        tx.setIsConfirmed(true);
+        tx.setInTxPool(false);
+        tx.setIsMinerTx(false);
+        tx.setDoNotRelay(false);
+        tx.setIsRelayed(true);
+        tx.setIsFailed(false);
+        tx.setIsDoubleSpendSeen(false);
+        List<Map<String, Object>> blockTxs = (List<Map<String, Object>>) rpcTxs.get(blockIdx);
+        convertRpcTx(blockTxs.get(txIdx), tx);
+      }
+      
+      // merge into one block
+      block.setTxs(new ArrayList<MoneroTx>());
+      for (MoneroTx tx : txs) {
+        if (tx.getBlock() != null) block.merge(tx.getBlock());
+        else block.getTxs().add(tx.setBlock(block));
+      }
+    }
+    
+    return blocks;
+  }
+  
   @SuppressWarnings("unchecked")
   private static MoneroBlock convertRpcBlock(Map<String, Object> rpcBlock) {
     
@@ -1175,7 +1360,7 @@ public class MoneroDaemonRpc extends MoneroDaemonDefault {
     if (tx.getOutputIndices() != null && tx.getOutputs() != null)  {
       GenUtils.assertEquals(tx.getOutputIndices().size(), (int) tx.getOutputs().size());
       for (int i = 0; i < tx.getOutputs().size(); i++) {
-        tx.getOutputs().get(i).setIndex(tx.getOutputIndices().get(i));  // transfer output indices to outputs
+        tx.getOutputs().get(i).setIndex(Long.valueOf(tx.getOutputIndices().get(i)));  // transfer output indices to outputs
       }
     }
     if (rpcTx.containsKey("as_json") && !"".equals(rpcTx.get("as_json"))) convertRpcTx(JsonUtils.deserialize(MoneroRpcConnection.MAPPER, (String) rpcTx.get("as_json"), new TypeReference<Map<String, Object>>(){}), tx);
@@ -1208,6 +1393,29 @@ public class MoneroDaemonRpc extends MoneroDaemonDefault {
     return output;
   }
   
+  private static MoneroOutput convertRpcOutsEntry(Map<String, Object> rpcOutput) {
+    MoneroOutput output = new MoneroOutput();
+    MoneroTx tx = new MoneroTx();
+    tx.setOutputs(new ArrayList<MoneroOutput>(Arrays.asList(output)));
+    output.setTx(tx);
+    for (String key : rpcOutput.keySet()) {
+      Object val = rpcOutput.get(key);
+      if (key.equals("amount")) output.setAmount((BigInteger) val);
+      else if (key.equals("index")) output.setIndex(((Number) val).longValue());
+      else if (key.equals("key")) output.setStealthPublicKey((String) val);
+      else if (key.equals("mask")) output.setCommitment((String) val);
+      else if (key.equals("txid")) tx.setHash((String) val);
+      else if (key.equals("height")) {
+        MoneroBlock block = new MoneroBlock().setHeight(((BigInteger) val).longValue());
+        block.setTxs(tx);
+        tx.setBlock(block);
+      }
+      else if (key.equals("unlocked")) { }  // only unlocked outputs are usable as ring members
+      else LOGGER.warning("WARNING: ignoring unexpected field in outs entry: " + key + ": " + val);
+    }
+    return output;
+  }
+  
   private static MoneroDaemonUpdateCheckResult convertRpcUpdateCheckResult(Map<String, Object> rpcResult) {
     MoneroDaemonUpdateCheckResult result = new MoneroDaemonUpdateCheckResult();
     for (String key : rpcResult.keySet()) {
@@ -1337,6 +1545,25 @@ public class MoneroDaemonRpc extends MoneroDaemonDefault {
     return entry;
   }
   
+  @SuppressWarnings("unchecked")
+  private static MoneroOutputDistributionEntry convertRpcOutputDistributionEntry(Map<String, Object> rpcEntry) {
+    MoneroOutputDistributionEntry entry = new MoneroOutputDistributionEntry();
+    for (String key : rpcEntry.keySet()) {
+      Object val = rpcEntry.get(key);
+      if (key.equals("amount")) entry.setAmount((BigInteger) val);
+      else if (key.equals("base")) entry.setBase(((BigInteger) val).intValue());
+      else if (key.equals("start_height")) entry.setStartHeight(((BigInteger) val).longValue());
+      else if (key.equals("distribution")) {
+        List<Integer> distribution = new ArrayList<Integer>();
+        for (BigInteger count : (List<BigInteger>) val) distribution.add(count.intValue());
+        entry.setDistribution(distribution);
+      }
+      else if (key.equals("binary") || key.equals("compress")) { }  // distribution is requested as json
+      else LOGGER.warning("WARNING: ignoring unexpected field in output distribution: " + key + ": " + val);
+    }
+    return entry;
+  }
+  
   private static MoneroDaemonInfo convertRpcInfo(Map<String, Object> rpcInfo) {
     if (rpcInfo == null) return null;
     MoneroDaemonInfo info = new MoneroDaemonInfo();
@@ -1588,6 +1815,10 @@ public class MoneroDaemonRpc extends MoneroDaemonDefault {
           MoneroBlockHeader header = daemon.getLastBlockHeader();
           if (!header.getHash().equals(lastHeader.getHash())) {
             lastHeader = header;
+            if (MoneroUtils.isJniLoaded()) {
+              setOutputCacheTip(header);
+              setBlockHeaderCacheTip(header);
+            }
             for (MoneroDaemonListener listener : listeners) {
               listener.onBlockHeader(header); // notify listener
             }
@@ -0,0 +1,62 @@
+package monero.daemon.model;
+
+/**
+ * Statistics of a daemon's native cache of block headers shared by its clients.
+ */
+public class MoneroBlockHeaderCacheStats {
+  
+  private Long hits;
+  private Long misses;
+  private Long numHeaders;
+  private Long maxHeaders;
+  private Long numInvalidations;
+  private Long numRejected;
+  
+  public Long getHits() {
+    return hits;
+  }
+  
+  public void setHits(Long hits) {
+    this.hits = hits;
+  }
+  
+  public Long getMisses() {
+    return misses;
+  }
+  
+  public void setMisses(Long misses) {
+    this.misses = misses;
+  }
+  
+  public Long getNumHeaders() {
+    return numHeaders;
+  }
+  
+  public void setNumHeaders(Long numHeaders) {
+    this.numHeaders = numHeaders;
+  }
+  
+  public Long getMaxHeaders() {
+    return maxHeaders;
+  }
+  
+  public void setMaxHeaders(Long maxHeaders) {
+    this.maxHeaders = maxHeaders;
+  }
+  
+  public Long getNumInvalidations() {
+    return numInvalidations;
+  }
+  
+  public void setNumInvalidations(Long numInvalidations) {
+    this.numInvalidations = numInvalidations;
+  }
+  
+  public Long getNumRejected() {
+    return numRejected;
+  }
+  
+  public void setNumRejected(Long numRejected) {
+    this.numRejected = numRejected;
+  }
+}
@@ -16,9 +16,10 @@ public class MoneroOutput {
   private MoneroTx tx;
   private MoneroKeyImage keyImage;
   private BigInteger amount;
-  private Integer index;
+  private Long index;
   private List<Integer> ringOutputIndices;
   private String stealthPublicKey;
+  private String commitment;
   
   public MoneroOutput() {
     // nothing to build
@@ -30,6 +31,7 @@ public class MoneroOutput {
     this.index = output.index;
     if (output.ringOutputIndices != null) this.ringOutputIndices = new ArrayList<Integer>(output.ringOutputIndices);
     this.stealthPublicKey = output.stealthPublicKey;
+    this.commitment = output.commitment;
   }
   
   public MoneroOutput copy() {
@@ -64,11 +66,11 @@ public class MoneroOutput {
     return this;
   }
   
-  public Integer getIndex() {
+  public Long getIndex() {
     return index;
   }
   
-  public MoneroOutput setIndex(Integer index) {
+  public MoneroOutput setIndex(Long index) {
     this.index = index;
     return this;
   }
@@ -91,6 +93,15 @@ public class MoneroOutput {
     return this;
   }
   
+  public String getCommitment() {
+    return commitment;
+  }
+  
+  public MoneroOutput setCommitment(String commitment) {
+    this.commitment = commitment;
+    return this;
+  }
+  
   public String toString() {
     return toString(0);
   }
@@ -108,6 +119,7 @@ public class MoneroOutput {
       else if (output.getKeyImage() != null) this.getKeyImage().merge(output.getKeyImage());
       this.setAmount(GenUtils.reconcile(this.getAmount(), output.getAmount()));
       this.setIndex(GenUtils.reconcile(this.getIndex(), output.getIndex()));
+      this.setCommitment(GenUtils.reconcile(this.getCommitment(), output.getCommitment()));
     }
 
     return this;
@@ -123,6 +135,7 @@ public class MoneroOutput {
     sb.append(GenUtils.kvLine("Index", getIndex(), indent));
     sb.append(GenUtils.kvLine("Ring output indices", getRingOutputIndices(), indent));
     sb.append(GenUtils.kvLine("Stealth public key", getStealthPublicKey(), indent));
+    sb.append(GenUtils.kvLine("Commitment", getCommitment(), indent));
     String str = sb.toString();
     return str.isEmpty() ? str : str.substring(0, str.length() - 1);  // strip newline
   }
@@ -132,6 +145,7 @@ public class MoneroOutput {
     final int prime = 31;
     int result = 1;
     result = prime * result + ((amount == null) ? 0 : amount.hashCode());
+    result = prime * result + ((commitment == null) ? 0 : commitment.hashCode());
     result = prime * result + ((index == null) ? 0 : index.hashCode());
     result = prime * result + ((keyImage == null) ? 0 : keyImage.hashCode());
     result = prime * result + ((ringOutputIndices == null) ? 0 : ringOutputIndices.hashCode());
@@ -148,6 +162,9 @@ public class MoneroOutput {
     if (amount == null) {
       if (other.amount != null) return false;
     } else if (!amount.equals(other.amount)) return false;
+    if (commitment == null) {
+      if (other.commitment != null) return false;
+    } else if (!commitment.equals(other.commitment)) return false;
     if (index == null) {
       if (other.index != null) return false;
     } else if (!index.equals(other.index)) return false;
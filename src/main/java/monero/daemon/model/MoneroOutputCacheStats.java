@@ -0,0 +1,71 @@
+package monero.daemon.model;
+
+/**
+ * Statistics of the native cache of ring member outputs and output distributions.
+ */
+public class MoneroOutputCacheStats {
+  
+  private Long outputHits;
+  private Long outputMisses;
+  private Long distributionHits;
+  private Long distributionMisses;
+  private Long numOutputs;
+  private Long numDistributions;
+  private Long numInvalidations;
+  
+  public Long getOutputHits() {
+    return outputHits;
+  }
+  
+  public void setOutputHits(Long outputHits) {
+    this.outputHits = outputHits;
+  }
+  
+  public Long getOutputMisses() {
+    return outputMisses;
+  }
+  
+  public void setOutputMisses(Long outputMisses) {
+    this.outputMisses = outputMisses;
+  }
+  
+  public Long getDistributionHits() {
+    return distributionHits;
+  }
+  
+  public void setDistributionHits(Long distributionHits) {
+    this.distributionHits = distributionHits;
+  }
+  
+  public Long getDistributionMisses() {
+    return distributionMisses;
+  }
+  
+  public void setDistributionMisses(Long distributionMisses) {
+    this.distributionMisses = distributionMisses;
+  }
+  
+  public Long getNumOutputs() {
+    return numOutputs;
+  }
+  
+  public void setNumOutputs(Long numOutputs) {
+    this.numOutputs = numOutputs;
+  }
+  
+  public Long getNumDistributions() {
+    return numDistributions;
+  }
+  
+  public void setNumDistributions(Long numDistributions) {
+    this.numDistributions = numDistributions;
+  }
+  
+  public Long getNumInvalidations() {
+    return numInvalidations;
+  }
+  
+  public void setNumInvalidations(Long numInvalidations) {
+    this.numInvalidations = numInvalidations;
+  }
+}
@@ -1,7 +1,9 @@
 package monero.utils;
 
 import java.math.BigDecimal;
+import java.math.BigInteger;
 import java.net.URI;
+import java.nio.charset.StandardCharsets;
 import java.util.ArrayList;
 import java.util.HashMap;
 import java.util.List;
@@ -15,20 +17,26 @@ import com.fasterxml.jackson.core.type.TypeReference;
 
 import common.utils.GenUtils;
 import common.utils.JsonUtils;
+import monero.daemon.model.MoneroBlockHeader;
+import monero.daemon.model.MoneroBlockHeaderCacheStats;
 import monero.daemon.model.MoneroNetworkType;
+import monero.daemon.model.MoneroOutputCacheStats;
 import monero.daemon.model.MoneroTx;
 import monero.rpc.MoneroRpcConnection;
 import monero.wallet.model.MoneroAddressType;
 import monero.wallet.model.MoneroDecodedAddress;
+import monero.wallet.model.MoneroIntegratedAddress;
 
 /**
  * Collection of Monero utilities.
  */
 public class MoneroUtils {
   
+  private static boolean JNI_LOADED = false;
   static {
     try {
       System.loadLibrary("monero-java");
+      JNI_LOADED = true;
     } catch (UnsatisfiedLinkError e) {
       // OK, but JNI utils will not work
     }
@@ -39,6 +47,8 @@ public class MoneroUtils {
 
   private static final int NUM_MNEMONIC_WORDS = 25;
   private static final int VIEW_KEY_LENGTH = 64;
+  private static final int NUM_HEADER_LONGS = 13;   // packed header layout shared with the native header cache
+  private static final int NUM_HEADER_HASHES = 3;
   private static final String ALPHABET = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
   private static final List<Character> CHARS = new ArrayList<Character>();
   static {
@@ -249,45 +259,35 @@ public class MoneroUtils {
     txs.add(tx);
   }
   
+  /**
+   * Indicates if the native monero-java library is loaded.
+   * 
+   * @return true if JNI utils are available, false otherwise
+   */
+  public static boolean isJniLoaded() {
+    return JNI_LOADED;
+  }
+  
   public static byte[] mapToBinary(Map<String, Object> map) {
-    return jsonToBinaryJni(JsonUtils.serialize(map));
+    return jsonToBinaryJni(JsonUtils.serializeBytes(map));
   }
   
   public static Map<String, Object> binaryToMap(byte[] bin) {
     return JsonUtils.deserialize(binaryToJsonJni(bin), new TypeReference<Map<String, Object>>(){});
   }
   
-  @SuppressWarnings("unchecked")
   public static Map<String, Object> binaryBlocksToMap(byte[] binBlocks) {
-    
-    // convert binary blocks to json then to map
-    Map<String, Object> map = JsonUtils.deserialize(MoneroRpcConnection.MAPPER, binaryBlocksToJsonJni(binBlocks), new TypeReference<Map<String, Object>>(){});
-    
-    // parse blocks to maps
-    List<Map<String, Object>> blockMaps = new ArrayList<Map<String, Object>>();
-    for (String blockStr : (List<String>) map.get("blocks")) {
-      blockMaps.add(JsonUtils.deserialize(MoneroRpcConnection.MAPPER, blockStr, new TypeReference<Map<String, Object>>(){}));
-    }
-    map.put("blocks", blockMaps); // overwrite block strings
-    
-    // parse txs to maps, one array of txs per block
-    List<List<Map<String, Object>>> allTxs = new ArrayList<List<Map<String, Object>>>();
-    List<Object> rpcAllTxs = (List<Object>) map.get("txs");
-    for (Object rpcTxs : rpcAllTxs) {
-      if ("".equals(rpcTxs)) {
-        allTxs.add(new ArrayList<Map<String, Object>>());
-      } else {
-        List<Map<String, Object>> txs = new ArrayList<Map<String, Object>>();
-        allTxs.add(txs);
-        for (String rpcTx : (List<String>) rpcTxs) {
-          txs.add(JsonUtils.deserialize(MoneroRpcConnection.MAPPER, rpcTx.replaceFirst(",", "{") + "}", new TypeReference<Map<String, Object>>(){})); // modify tx string to proper json and parse // TODO: more efficient way than this json manipulation?
-        }
-      }
-    }
-    map.put("txs", allTxs); // overwrite tx strings
-
-    // return map containing blocks and txs as maps
-    return map;
+    return blocksJsonToMap(binaryBlocksToJsonJni(binBlocks));
+  }
+  
+  /**
+   * Convert blocks decoded from get_blocks_by_height.bin to a map.
+   * 
+   * @param blocksJson is the UTF-8 json of the decoded blocks and their txs, one array of txs per block
+   * @return a map containing the blocks and txs as maps
+   */
+  public static Map<String, Object> blocksJsonToMap(byte[] blocksJson) {
+    return JsonUtils.deserialize(MoneroRpcConnection.MAPPER, blocksJson, new TypeReference<Map<String, Object>>(){});
   }
   
   public static void initJniLogging(String path, int level, boolean console) {
@@ -299,17 +299,496 @@ public class MoneroUtils {
     setLogLevelJni(level);
   }
   
+  /**
+   * Start recording timed spans of native calls in a ring buffer, clearing
+   * any recorded spans.  Spans cover JNI entry points, wallet calls,
+   * serialization, and listener upcalls.
+   * 
+   * @param capacity is the number of most recent spans to keep
+   */
+  public static void startJniTrace(int capacity) {
+    try {
+      startTraceJni(capacity);
+    } catch (Exception e) {
+      throw new MoneroException(e.getMessage());
+    }
+  }
+  
+  /**
+   * Stop recording spans of native calls.  Recorded spans are kept until the
+   * trace is restarted.
+   */
+  public static void stopJniTrace() {
+    stopTraceJni();
+  }
+  
+  /**
+   * Write the recorded spans of native calls to a file in Chrome's trace
+   * event format, which can be opened in Perfetto or chrome://tracing.
+   * 
+   * @param path is the path of the file to write
+   */
+  public static void dumpJniTrace(String path) {
+    try {
+      dumpTraceJni(path);
+    } catch (Exception e) {
+      throw new MoneroException(e.getMessage());
+    }
+  }
+  
+  /**
+   * Get ring member outputs from a daemon's native output cache.
+   * 
+   * @param daemonUri is the uri of the daemon whose outputs are cached
+   * @param outputs are maps with the amount and index of each output to get
+   * @return the cached outputs in get_outs format with their amount and index, omitting misses
+   */
+  @SuppressWarnings("unchecked")
+  public static List<Map<String, Object>> getCachedOutputs(String daemonUri, List<Map<String, Object>> outputs) {
+    Map<String, Object> request = new HashMap<String, Object>();
+    request.put("outputs", outputs);
+    Map<String, Object> resp = JsonUtils.deserialize(MoneroRpcConnection.MAPPER, getCachedOutputsJni(daemonUri, JsonUtils.serializeBytes(request)), new TypeReference<Map<String, Object>>(){});
+    return (List<Map<String, Object>>) resp.get("outputs");
+  }
+  
+  /**
+   * Add ring member outputs to a daemon's native output cache.
+   * 
+   * @param daemonUri is the uri of the daemon the outputs were fetched from
+   * @param outputs are outputs in get_outs format with their amount and index
+   */
+  public static void putCachedOutputs(String daemonUri, List<Map<String, Object>> outputs) {
+    Map<String, Object> request = new HashMap<String, Object>();
+    request.put("outputs", outputs);
+    putCachedOutputsJni(daemonUri, JsonUtils.serializeBytes(request));
+  }
+  
+  /**
+   * Get output distributions from a daemon's native output cache.
+   * 
+   * @param daemonUri is the uri of the daemon whose outputs are cached
+   * @param params are get_output_distribution request params
+   * @return the cached distributions in get_output_distribution format, omitting misses
+   */
+  @SuppressWarnings("unchecked")
+  public static List<Map<String, Object>> getCachedOutputDistributions(String daemonUri, Map<String, Object> params) {
+    Map<String, Object> resp = JsonUtils.deserialize(MoneroRpcConnection.MAPPER, getCachedOutputDistributionsJni(daemonUri, JsonUtils.serializeBytes(params)), new TypeReference<Map<String, Object>>(){});
+    return (List<Map<String, Object>>) resp.get("distributions");
+  }
+  
+  /**
+   * Add output distributions to a daemon's native output cache.
+   * 
+   * @param daemonUri is the uri of the daemon the distributions were fetched from
+   * @param params are the get_output_distribution request params the distributions were fetched with
+   * @param distributions are distributions in get_output_distribution format
+   */
+  public static void putCachedOutputDistributions(String daemonUri, Map<String, Object> params, List<Map<String, Object>> distributions) {
+    Map<String, Object> request = new HashMap<String, Object>(params);
+    request.remove("amounts");
+    request.put("distributions", distributions);
+    putCachedOutputDistributionsJni(daemonUri, JsonUtils.serializeBytes(request));
+  }
+  
+  /**
+   * Report a daemon's chain tip to its native output cache which
+   * invalidates stale entries.
+   * 
+   * @param daemonUri is the uri of the daemon whose outputs are cached
+   * @param height is the height of the tip block
+   * @param hash is the hash of the tip block
+   * @param anchorHash is the hash of the block at the previously reported tip height, null if unknown
+   */
+  public static void setOutputCacheTip(String daemonUri, long height, String hash, String anchorHash) {
+    try {
+      setOutputCacheTipJni(daemonUri, height, hash, anchorHash);
+    } catch (Exception e) {
+      throw new MoneroException(e.getMessage());
+    }
+  }
+  
+  /**
+   * Get the height of the tip last reported to a daemon's native output cache.
+   * 
+   * @param daemonUri is the uri of the daemon whose outputs are cached
+   * @return the tip height or -1 if no tip has been reported
+   */
+  public static long getOutputCacheTipHeight(String daemonUri) {
+    return getOutputCacheTipHeightJni(daemonUri);
+  }
+  
+  /**
+   * Set the maximum number of entries kept by a daemon's native output cache.
+   * 
+   * @param daemonUri is the uri of the daemon whose outputs are cached
+   * @param maxOutputs is the maximum number of cached outputs
+   * @param maxDistributions is the maximum number of cached distributions
+   */
+  public static void setOutputCacheLimits(String daemonUri, int maxOutputs, int maxDistributions) {
+    try {
+      setOutputCacheLimitsJni(daemonUri, maxOutputs, maxDistributions);
+    } catch (Exception e) {
+      throw new MoneroException(e.getMessage());
+    }
+  }
+  
+  public static MoneroOutputCacheStats getOutputCacheStats(String daemonUri) {
+    try {
+      return JsonUtils.deserialize(getOutputCacheStatsJni(daemonUri), MoneroOutputCacheStats.class);
+    } catch (Exception e) {
+      throw new MoneroException(e.getMessage());
+    }
+  }
+  
+  public static void clearOutputCache(String daemonUri) {
+    try {
+      clearOutputCacheJni(daemonUri);
+    } catch (Exception e) {
+      throw new MoneroException(e.getMessage());
+    }
+  }
+  
+  /**
+   * Add consecutive block headers to the native header cache of a daemon
+   * which is shared by the daemon's clients.
+   * 
+   * The headers are rejected if another tip was reported since they were
+   * fetched, or if they are above the tip or do not link to each other and
+   * to the cached headers next to them.
+   * 
+   * @param daemonUri is the uri of the daemon the headers are from
+   * @param tipHash is the hash of the tip reported before fetching the headers
+   * @param headers are consecutive headers in ascending height
+   * @return true if the headers are cached, false if rejected
+   */
+  public static boolean putCachedBlockHeaders(String daemonUri, String tipHash, List<MoneroBlockHeader> headers) {
+    long[] numbers = new long[headers.size() * NUM_HEADER_LONGS];
+    String[] hashes = new String[headers.size() * NUM_HEADER_HASHES];
+    for (int i = 0; i < headers.size(); i++) {
+      MoneroBlockHeader header = headers.get(i);
+      int n = i * NUM_HEADER_LONGS;
+      numbers[n] = header.getHeight();
+      numbers[n + 1] = toLong(header.getTimestamp());
+      numbers[n + 2] = toLong(header.getSize());
+      numbers[n + 3] = toLong(header.getWeight());
+      numbers[n + 4] = toLong(header.getLongTermWeight());
+      numbers[n + 5] = header.getReward() == null ? 0 : header.getReward().longValue();
+      numbers[n + 6] = header.getDifficulty() == null ? 0 : header.getDifficulty().longValue();
+      numbers[n + 7] = header.getDifficulty() == null ? 0 : header.getDifficulty().shiftRight(64).longValue();
+      numbers[n + 8] = header.getCumulativeDifficulty() == null ? 0 : header.getCumulativeDifficulty().longValue();
+      numbers[n + 9] = header.getCumulativeDifficulty() == null ? 0 : header.getCumulativeDifficulty().shiftRight(64).longValue();
+      numbers[n + 10] = header.getNonce() == null ? 0 : header.getNonce() & 0xffffffffl;
+      numbers[n + 11] = header.getNumTxs() == null ? 0 : header.getNumTxs();
+      numbers[n + 12] = (header.getMajorVersion() == null ? 0 : header.getMajorVersion()) | (header.getMinorVersion() == null ? 0 : header.getMinorVersion()) << 8 | (Boolean.TRUE.equals(header.getOrphanStatus()) ? 1 : 0) << 16;
+      hashes[i * NUM_HEADER_HASHES] = header.getHash();
+      hashes[i * NUM_HEADER_HASHES + 1] = header.getPrevHash();
+      hashes[i * NUM_HEADER_HASHES + 2] = header.getMinerTxHash();
+    }
+    try {
+      return putCachedBlockHeadersJni(daemonUri, tipHash, numbers, hashes);
+    } catch (Exception e) {
+      throw new MoneroException(e.getMessage());
+    }
+  }
+  
+  /**
+   * Get a block header from the native header cache of a daemon.
+   * 
+   * @param daemonUri is the uri of the daemon whose headers are cached
+   * @param height is the height of the header to get
+   * @return the cached header without its depth, null if not cached
+   */
+  public static MoneroBlockHeader getCachedBlockHeader(String daemonUri, long height) {
+    long[] numbers = new long[NUM_HEADER_LONGS];
+    String[] hashes = new String[NUM_HEADER_HASHES];
+    try {
+      if (!getCachedBlockHeaderJni(daemonUri, height, numbers, hashes)) return null;
+    } catch (Exception e) {
+      throw new MoneroException(e.getMessage());
+    }
+    MoneroBlockHeader header = new MoneroBlockHeader();
+    header.setHeight(numbers[0]);
+    header.setTimestamp(numbers[1]);
+    header.setSize(numbers[2]);
+    header.setWeight(numbers[3]);
+    header.setLongTermWeight(numbers[4]);
+    header.setReward(toUnsignedBigInteger(0, numbers[5]));
+    header.setDifficulty(toUnsignedBigInteger(numbers[7], numbers[6]));
+    header.setCumulativeDifficulty(toUnsignedBigInteger(numbers[9], numbers[8]));
+    header.setNonce((int) numbers[10]);
+    header.setNumTxs((int) numbers[11]);
+    header.setMajorVersion((int) (numbers[12] & 0xff));
+    header.setMinorVersion((int) ((numbers[12] >> 8) & 0xff));
+    header.setOrphanStatus(((numbers[12] >> 16) & 1) != 0);
+    header.setHash(hashes[0]);
+    header.setPrevHash(hashes[1]);
+    header.setMinerTxHash(hashes[2]);
+    return header;
+  }
+  
+  /**
+   * Get the sizes of consecutive blocks from the native header cache of a
+   * daemon without allocating.
+   * 
+   * @param daemonUri is the uri of the daemon whose headers are cached
+   * @param startHeight is the height of the first block
+   * @param sizes is assigned the size of each consecutive block which is cached
+   * @return the number of sizes assigned, stopping at the first block not cached
+   */
+  public static int getCachedBlockSizes(String daemonUri, long startHeight, long[] sizes) {
+    try {
+      return getCachedBlockSizesJni(daemonUri, startHeight, sizes);
+    } catch (Exception e) {
+      throw new MoneroException(e.getMessage());
+    }
+  }
+  
+  /**
+   * Report a daemon's chain tip to its native header cache which is cleared
+   * if the previously reported tip is no longer on the chain.
+   * 
+   * @param daemonUri is the uri of the daemon whose headers are cached
+   * @param height is the height of the tip block
+   * @param hash is the hash of the tip block
+   * @param anchorHash is the hash of the block at the previously reported tip height, null if unknown
+   */
+  public static void setBlockHeaderCacheTip(String daemonUri, long height, String hash, String anchorHash) {
+    try {
+      setBlockHeaderCacheTipJni(daemonUri, height, hash, anchorHash);
+    } catch (Exception e) {
+      throw new MoneroException(e.getMessage());
+    }
+  }
+  
+  /**
+   * Get the height of the tip last reported to a daemon's native header cache.
+   * 
+   * @param daemonUri is the uri of the daemon whose headers are cached
+   * @return the tip height or -1 if no tip has been reported
+   */
+  public static long getBlockHeaderCacheTipHeight(String daemonUri) {
+    return getBlockHeaderCacheTipHeightJni(daemonUri);
+  }
+  
+  /**
+   * Set the number of headers kept by a daemon's native header cache, which
+   * clears it.
+   * 
+   * @param daemonUri is the uri of the daemon whose headers are cached
+   * @param maxHeaders is the maximum number of cached headers, at least 1
+   */
+  public static void setBlockHeaderCacheLimit(String daemonUri, int maxHeaders) {
+    try {
+      setBlockHeaderCacheLimitJni(daemonUri, maxHeaders);
+    } catch (Exception e) {
+      throw new MoneroException(e.getMessage());
+    }
+  }
+  
+  public static MoneroBlockHeaderCacheStats getBlockHeaderCacheStats(String daemonUri) {
+    return JsonUtils.deserialize(getBlockHeaderCacheStatsJni(daemonUri), MoneroBlockHeaderCacheStats.class);
+  }
+  
+  public static void clearBlockHeaderCache(String daemonUri) {
+    clearBlockHeaderCacheJni(daemonUri);
+  }
+  
+  /**
+   * Validate addresses natively without a wallet.
+   * 
+   * @param addresses are the addresses to validate
+   * @param networkType is the network type the addresses must belong to (null for any)
+   * @return true for each address in the order given which is valid, false otherwise
+   */
+  public static boolean[] validateAddresses(List<String> addresses, MoneroNetworkType networkType) {
+    return validateAddressesJni(addresses.toArray(new String[addresses.size()]), networkType == null ? -1 : networkType.ordinal());
+  }
+  
+  /**
+   * Decode the network and address types of addresses natively without a wallet.
+   * 
+   * @param addresses are the addresses to decode
+   * @return the decoded address in the order given, null for each invalid address
+   */
+  public static List<MoneroDecodedAddress> decodeAddresses(List<String> addresses) {
+    int[] types = decodeAddressesJni(addresses.toArray(new String[addresses.size()]));
+    List<MoneroDecodedAddress> decodedAddresses = new ArrayList<MoneroDecodedAddress>();
+    for (int i = 0; i < addresses.size(); i++) {
+      if (types[i * 2] < 0) decodedAddresses.add(null);
+      else decodedAddresses.add(new MoneroDecodedAddress(addresses.get(i), MoneroAddressType.values()[types[i * 2 + 1]], MoneroNetworkType.values()[types[i * 2]]));
+    }
+    return decodedAddresses;
+  }
+  
+  /**
+   * Build integrated addresses natively without a wallet.
+   * 
+   * @param standardAddresses are the primary addresses to integrate payment ids into
+   * @param paymentIds are the 16 character hex payment ids, a random payment id is generated for each which is null or empty
+   * @param networkType is the network type of the addresses
+   * @return the integrated address in the order given, null for each invalid standard address or payment id
+   */
+  public static List<MoneroIntegratedAddress> getIntegratedAddresses(List<String> standardAddresses, List<String> paymentIds, MoneroNetworkType networkType) {
+    GenUtils.assertNotNull("Network type is null", networkType);
+    List<String> integrateds = unpackStrings(getIntegratedAddressesJni(standardAddresses.toArray(new String[standardAddresses.size()]), paymentIds == null ? new String[0] : paymentIds.toArray(new String[paymentIds.size()]), networkType.ordinal()));
+    List<MoneroIntegratedAddress> results = new ArrayList<MoneroIntegratedAddress>();
+    for (int i = 0; i < standardAddresses.size(); i++) {
+      String integratedAddress = integrateds.get(i * 2);
+      if (integratedAddress.isEmpty()) results.add(null);
+      else results.add(new MoneroIntegratedAddress(standardAddresses.get(i), integrateds.get(i * 2 + 1), integratedAddress));
+    }
+    return results;
+  }
+  
+  /**
+   * Decode integrated addresses natively without a wallet.
+   * 
+   * @param integratedAddresses are the integrated addresses to decode
+   * @param networkType is the network type of the addresses
+   * @return the decoded integrated address in the order given, null for each invalid integrated address
+   */
+  public static List<MoneroIntegratedAddress> decodeIntegratedAddresses(List<String> integratedAddresses, MoneroNetworkType networkType) {
+    GenUtils.assertNotNull("Network type is null", networkType);
+    List<String> decodeds = unpackStrings(decodeIntegratedAddressesJni(integratedAddresses.toArray(new String[integratedAddresses.size()]), networkType.ordinal()));
+    List<MoneroIntegratedAddress> results = new ArrayList<MoneroIntegratedAddress>();
+    for (int i = 0; i < integratedAddresses.size(); i++) {
+      String standardAddress = decodeds.get(i * 2);
+      if (standardAddress.isEmpty()) results.add(null);
+      else results.add(new MoneroIntegratedAddress(standardAddress, decodeds.get(i * 2 + 1), integratedAddresses.get(i)));
+    }
+    return results;
+  }
+  
+  /**
+   * Start fetching chunks of blocks from a daemon natively, up to the given
+   * number of chunks at once, to be taken in order with getNextBlockStreamChunk().
+   * 
+   * @param uri is the uri of the daemon
+   * @param username is the daemon's rpc username (null if none)
+   * @param password is the daemon's rpc password (null if none)
+   * @param startHeights are the start height of each chunk
+   * @param endHeights are the inclusive end height of each chunk
+   * @param maxRequestsInFlight is the maximum number of chunks fetched at once
+   * @return the handle of the stream which must be stopped with stopBlockStream()
+   */
+  public static long startBlockStream(String uri, String username, String password, long[] startHeights, long[] endHeights, int maxRequestsInFlight) {
+    GenUtils.assertEquals("Start and end heights differ in length", startHeights.length, endHeights.length);
+    return startBlockStreamJni(uri, username, password, startHeights, endHeights, maxRequestsInFlight);
+  }
+  
+  /**
+   * Take the next chunk of a block stream, waiting until it is fetched.
+   * 
+   * @param handle is the handle of the stream
+   * @return a map containing the chunk's blocks and txs as maps, null if all chunks are taken
+   */
+  public static Map<String, Object> getNextBlockStreamChunk(long handle) {
+    byte[] blocksJson = nextBlockStreamChunkJni(handle);
+    return blocksJson == null ? null : blocksJsonToMap(blocksJson);
+  }
+  
+  /**
+   * Stop a block stream and free its resources.
+   * 
+   * @param handle is the handle of the stream
+   */
+  public static void stopBlockStream(long handle) {
+    stopBlockStreamJni(handle);
+  }
+  
+  /**
+   * Unpack ASCII strings which are each terminated by a newline.
+   * 
+   * @param packed are the packed strings
+   * @return the unpacked strings
+   */
+  public static List<String> unpackStrings(byte[] packed) {
+    List<String> strs = new ArrayList<String>();
+    int start = 0;
+    for (int i = 0; i < packed.length; i++) {
+      if (packed[i] != '\n') continue;
+      strs.add(new String(packed, start, i - start, StandardCharsets.US_ASCII));
+      start = i + 1;
+    }
+    return strs;
+  }
+  
   // ---------------------------- PRIVATE HELPERS -----------------------------
   
-  private native static byte[] jsonToBinaryJni(String json);
+  private static long toLong(Long val) {
+    return val == null ? 0 : val;
+  }
+  
+  private static BigInteger toUnsignedBigInteger(long hi, long lo) {
+    return new BigInteger(1, new byte[] {
+      (byte) (hi >>> 56), (byte) (hi >>> 48), (byte) (hi >>> 40), (byte) (hi >>> 32), (byte) (hi >>> 24), (byte) (hi >>> 16), (byte) (hi >>> 8), (byte) hi,
+      (byte) (lo >>> 56), (byte) (lo >>> 48), (byte) (lo >>> 40), (byte) (lo >>> 32), (byte) (lo >>> 24), (byte) (lo >>> 16), (byte) (lo >>> 8), (byte) lo
+    });
+  }
   
-  private native static String binaryToJsonJni(byte[] bin);
+  private native static byte[] jsonToBinaryJni(byte[] json);
   
-  private native static String binaryBlocksToJsonJni(byte[] binBlocks);
+  private native static byte[] binaryToJsonJni(byte[] bin);
+  
+  private native static byte[] binaryBlocksToJsonJni(byte[] binBlocks);
   
   private native static void initLoggingJni(String path, boolean console);
 
   private native static void setLogLevelJni(int level);
+  
+  private native static void startTraceJni(int capacity);
+  
+  private native static void stopTraceJni();
+  
+  private native static void dumpTraceJni(String path);
+  
+  private native static byte[] getCachedOutputsJni(String daemonUri, byte[] outputsJson);
+  
+  private native static void putCachedOutputsJni(String daemonUri, byte[] outputsJson);
+  
+  private native static byte[] getCachedOutputDistributionsJni(String daemonUri, byte[] paramsJson);
+  
+  private native static void putCachedOutputDistributionsJni(String daemonUri, byte[] distributionsJson);
+  
+  private native static void setOutputCacheTipJni(String daemonUri, long height, String hash, String anchorHash);
+  
+  private native static long getOutputCacheTipHeightJni(String daemonUri);
+  
+  private native static void setOutputCacheLimitsJni(String daemonUri, int maxOutputs, int maxDistributions);
+  
+  private native static String getOutputCacheStatsJni(String daemonUri);
+  
+  private native static void clearOutputCacheJni(String daemonUri);
+  
+  private native static boolean putCachedBlockHeadersJni(String daemonUri, String tipHash, long[] numbers, String[] hashes);
+  
+  private native static boolean getCachedBlockHeaderJni(String daemonUri, long height, long[] numbers, String[] hashes);
+  
+  private native static int getCachedBlockSizesJni(String daemonUri, long startHeight, long[] sizes);
+  
+  private native static void setBlockHeaderCacheTipJni(String daemonUri, long height, String hash, String anchorHash);
+  
+  private native static long getBlockHeaderCacheTipHeightJni(String daemonUri);
+  
+  private native static void setBlockHeaderCacheLimitJni(String daemonUri, int maxHeaders);
+  
+  private native static String getBlockHeaderCacheStatsJni(String daemonUri);
+  
+  private native static void clearBlockHeaderCacheJni(String daemonUri);
+  
+  private native static boolean[] validateAddressesJni(String[] addresses, int networkType);
+  
+  private native static int[] decodeAddressesJni(String[] addresses);
+  
+  private native static byte[] getIntegratedAddressesJni(String[] standardAddresses, String[] paymentIds, int networkType);
+  
+  private native static byte[] decodeIntegratedAddressesJni(String[] integratedAddresses, int networkType);
+  
+  private native static long startBlockStreamJni(String uri, String username, String password, long[] startHeights, long[] endHeights, int maxRequestsInFlight);
+  
+  private native static byte[] nextBlockStreamChunkJni(long handle);
+  
+  private native static void stopBlockStreamJni(long handle);
 
   private static boolean isValidAddressHash(String decodedAddrStr) {
     String checksumCheck = decodedAddrStr.substring(decodedAddrStr.length() - 8);
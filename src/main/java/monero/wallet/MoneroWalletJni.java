@@ -31,6 +31,8 @@ import java.util.LinkedHashSet;
 import java.util.List;
 import java.util.Map;
 import java.util.Set;
+import java.util.concurrent.locks.ReadWriteLock;
+import java.util.concurrent.locks.ReentrantReadWriteLock;
 import java.util.logging.Logger;
 
 import com.fasterxml.jackson.annotation.JsonProperty;
@@ -40,10 +42,12 @@ import common.utils.JsonUtils;
 import monero.daemon.model.MoneroBlock;
 import monero.daemon.model.MoneroKeyImage;
 import monero.daemon.model.MoneroNetworkType;
+import monero.daemon.model.MoneroOutput;
 import monero.daemon.model.MoneroTx;
 import monero.daemon.model.MoneroVersion;
 import monero.rpc.MoneroRpcConnection;
 import monero.utils.MoneroException;
+import monero.utils.MoneroUtils;
 import monero.wallet.model.MoneroAccount;
 import monero.wallet.model.MoneroAccountTag;
 import monero.wallet.model.MoneroAddressBookEntry;
@@ -57,13 +61,19 @@ import monero.wallet.model.MoneroMultisigInitResult;
 import monero.wallet.model.MoneroMultisigSignResult;
 import monero.wallet.model.MoneroOutputQuery;
 import monero.wallet.model.MoneroOutputWallet;
+import monero.wallet.model.MoneroProgressListener;
+import monero.wallet.model.MoneroSendPipelineResult;
+import monero.wallet.model.MoneroSendPipelineStageStats;
 import monero.wallet.model.MoneroSendRequest;
 import monero.wallet.model.MoneroSubaddress;
 import monero.wallet.model.MoneroSyncListener;
 import monero.wallet.model.MoneroSyncResult;
+import monero.wallet.model.MoneroSyncStats;
+import monero.wallet.model.MoneroSyncStatsListener;
 import monero.wallet.model.MoneroTransfer;
 import monero.wallet.model.MoneroTransferQuery;
 import monero.wallet.model.MoneroTxQuery;
+import monero.wallet.model.MoneroTxRelayResult;
 import monero.wallet.model.MoneroTxSet;
 import monero.wallet.model.MoneroTxWallet;
 import monero.wallet.model.MoneroWalletListener;
@@ -84,12 +94,37 @@ public class MoneroWalletJni extends MoneroWalletBase {
   // logger
   private static final Logger LOGGER = Logger.getLogger(MoneroWalletJni.class.getName());
   
+  // maximum number of txs submitted to the daemon concurrently by relayTxs()
+  private static final int DEFAULT_MAX_RELAYS_IN_FLIGHT = 8;
+  
+  // maximum number of threads checking proofs or signatures concurrently, 0 for the number of cores
+  private static final int DEFAULT_MAX_PROOF_THREADS = 0;
+  
+  // maximum number of threads deriving subaddresses concurrently, 0 for the number of cores
+  private static final int DEFAULT_MAX_DERIVATION_THREADS = 0;
+  
+  // maximum number of threads opening wallets concurrently, 0 for the number of cores
+  private static final int DEFAULT_MAX_OPEN_THREADS = 0;
+  
   // instance variables
-  private long jniWalletHandle;                 // memory address of the wallet in c++; this variable is read directly by name in c++
+  private volatile long jniWalletHandle;        // memory address of the wallet in c++, 0 while a lazily opened wallet loads; this variable is read directly by name in c++
   private long jniListenerHandle;               // memory address of the wallet listener in c++; this variable is read directly by name in c++
+  private long jniSendPipelineHandle;           // memory address of the send pipeline in c++; this variable is read directly by name in c++
+  private long jniSubaddressTableHandle;        // memory address of the subaddress lookup table in c++, set in c++; this variable is read directly by name in c++
+  private long jniLazyWalletHandle;             // memory address of the lazily opened wallet in c++; this variable is read directly by name in c++
+  private long jniOutputStoreHandle;            // memory address of the compact output store in c++, set in c++; this variable is read directly by name in c++
+  private long jniSyncStatsHandle;              // memory address of the sync stats listener in c++, kept until closed; this variable is read directly by name in c++
+  private volatile boolean isSyncStatsEnabled;  // whether or not sync stats are collected
+  private long jniOutputCacheProxyHandle;       // memory address of the output cache proxy in c++; this variable is read directly by name in c++
+  private long jniSyncLoopHandle;               // memory address of the background sync loop in c++, set in c++; this variable is read directly by name in c++
+  private volatile boolean isLoading;           // whether or not the wallet's cache is loading after its keys
+  private MoneroRpcConnection loadingDaemonConnection; // daemon connection to set once the wallet is loaded
   private WalletJniListener jniListener;        // receives notifications from jni c++
   private Set<MoneroWalletListenerI> listeners; // externally subscribed wallet listeners
   private boolean isClosed;                     // whether or not wallet is closed
+  private ReadWriteLock sendPipelineLock;       // read locked while a call uses the send pipeline, write locked to delete it
+  private MoneroWalletJni sendPipelineSigner;   // wallet signing for this wallet's send pipeline
+  private Set<MoneroWalletJni> signedPipelines; // wallets whose send pipelines this wallet signs for
   
   /**
    * Private constructor with a handle to the memory address of the wallet in c++.
@@ -101,6 +136,8 @@ public class MoneroWalletJni extends MoneroWalletBase {
     this.jniListener = new WalletJniListener(this);
     this.listeners = new LinkedHashSet<MoneroWalletListenerI>();
     this.isClosed = false;
+    this.sendPipelineLock = new ReentrantReadWriteLock();
+    this.signedPipelines = new LinkedHashSet<MoneroWalletJni>();
   }
   
   // --------------------- WALLET MANAGEMENT UTILITIES ------------------------
@@ -135,6 +172,92 @@ public class MoneroWalletJni extends MoneroWalletBase {
     return wallet;
   }
   
+  /**
+   * Open an existing wallet and load its cache in the background.
+   * 
+   * The wallet's keys file is decrypted in memory before returning so its
+   * mnemonic, keys, addresses, and network type are available right away.
+   * Any other call waits until the rest of the wallet is loaded, as do key
+   * calls of hardware and multisig wallets whose keys are not all in the
+   * keys file.
+   * 
+   * @param path is the path to the wallet file to open
+   * @param password is the password of the wallet file to open
+   * @param networkType is the wallet's network type
+   * @param daemonConnection is connection configuration to a daemon which is set once the wallet is loaded (default = an unconnected wallet)
+   * @return the opened wallet
+   */
+  public static MoneroWalletJni openWalletLazy(String path, String password, MoneroNetworkType networkType) { return openWalletLazy(path, password, networkType, null); }
+  public static MoneroWalletJni openWalletLazy(String path, String password, MoneroNetworkType networkType, MoneroRpcConnection daemonConnection) {
+    if (!walletExistsJni(path)) throw new MoneroException("Wallet does not exist at path: " + path);
+    if (networkType == null) throw new MoneroException("Must provide a network type");
+    long jniLazyWalletHandle;
+    try {
+      jniLazyWalletHandle = openWalletLazyJni(path, password, networkType.ordinal());
+    } catch (Exception e) {
+      throw new MoneroException(e.getMessage());
+    }
+    MoneroWalletJni wallet = new MoneroWalletJni(0);
+    wallet.jniLazyWalletHandle = jniLazyWalletHandle;
+    wallet.loadingDaemonConnection = daemonConnection;
+    wallet.isLoading = true;
+    return wallet;
+  }
+  
+  /**
+   * Open existing wallets concurrently.
+   * 
+   * Opening a wallet is bound by its key derivation and cache decryption,
+   * so the wallets are opened in parallel on native threads.  Each open
+   * briefly holds its cache read, decrypted, and deserialized, peaking at a
+   * few times its cache file's size, so concurrent opens can be throttled by
+   * the total cache size of wallets opening at once.  The throttle limits
+   * how many wallets open at once, not the memory of a single open.
+   * 
+   * @param paths are the paths of the wallet files to open
+   * @param passwords are the passwords of the wallet files to open in the same order
+   * @param networkTypes are the network types of the wallets in the same order
+   * @param errors receives the error opening each wallet in order, null for each opened wallet (if null, all wallets must open or an exception is thrown)
+   * @param maxThreads is the maximum number of wallets opened at once (0 for the number of cores)
+   * @param maxOpenCacheBytes is the maximum total cache file size of wallets opening at once, a wallet larger than the limit opening alone (0 for no limit)
+   * @return the opened wallets in the order given, null for each wallet which failed to open
+   */
+  public static List<MoneroWalletJni> openWallets(List<String> paths, List<String> passwords, List<MoneroNetworkType> networkTypes, List<MoneroException> errors) { return openWallets(paths, passwords, networkTypes, errors, DEFAULT_MAX_OPEN_THREADS, 0); }
+  public static List<MoneroWalletJni> openWallets(List<String> paths, List<String> passwords, List<MoneroNetworkType> networkTypes, List<MoneroException> errors, int maxThreads, long maxOpenCacheBytes) {
+    if (paths.size() != passwords.size() || paths.size() != networkTypes.size()) throw new MoneroException("Must provide a password and network type for each wallet");
+    int[] networkTypeOrdinals = new int[networkTypes.size()];
+    for (int i = 0; i < networkTypes.size(); i++) {
+      if (networkTypes.get(i) == null) throw new MoneroException("Must provide a network type");
+      networkTypeOrdinals[i] = networkTypes.get(i).ordinal();
+    }
+    
+    // open wallets natively
+    String[] errorMsgs = new String[paths.size()];
+    long[] handles;
+    try {
+      handles = openWalletsJni(paths.toArray(new String[paths.size()]), passwords.toArray(new String[passwords.size()]), networkTypeOrdinals, maxThreads, maxOpenCacheBytes, errorMsgs);
+    } catch (Exception e) {
+      throw new MoneroException(e.getMessage());
+    }
+    
+    // collect wallets and errors
+    List<MoneroWalletJni> wallets = new ArrayList<MoneroWalletJni>();
+    MoneroException firstError = null;
+    for (int i = 0; i < handles.length; i++) {
+      MoneroException error = errorMsgs[i] == null ? null : new MoneroException(errorMsgs[i]);
+      if (firstError == null) firstError = error;
+      if (errors != null) errors.add(error);
+      wallets.add(handles[i] == 0 ? null : new MoneroWalletJni(handles[i]));
+    }
+    
+    // close opened wallets if all wallets must open
+    if (errors == null && firstError != null) {
+      for (MoneroWalletJni wallet : wallets) if (wallet != null) wallet.close();
+      throw firstError;
+    }
+    return wallets;
+  }
+  
   /**
    * Create a new wallet with a randomly generated seed.
    * 
@@ -219,6 +342,43 @@ public class MoneroWalletJni extends MoneroWalletBase {
     return Arrays.asList(getMnemonicLanguagesJni());
   }
   
+  /**
+   * Make a group of wallets multisig together by running the prepare, make,
+   * and key exchange rounds natively, passing each round's hex between the
+   * wallets without returning to Java.
+   * 
+   * @param wallets are the distinct wallets to make multisig
+   * @param threshold is the number of signatures needed to sign a tx
+   * @param password is the password of every wallet
+   * @return the final multisig init result of each wallet in the order given
+   */
+  public static List<MoneroMultisigInitResult> createMultisigGroup(List<MoneroWalletJni> wallets, int threshold, String password) {
+    try {
+      byte[] resultsJson = createMultisigGroupJni(getWalletHandles(wallets), threshold, password);
+      return JsonUtils.deserialize(MoneroRpcConnection.MAPPER, resultsJson, MultisigInitResultsContainer.class).results;
+    } catch (Exception e) {
+      throw new MoneroException(e.getMessage());
+    }
+  }
+  
+  /**
+   * Synchronize a group of multisig wallets by exporting each wallet's
+   * multisig hex and importing the others' hex into each wallet concurrently.
+   * 
+   * @param wallets are the distinct multisig wallets to synchronize
+   * @return the number of outputs signed by each wallet in the order given
+   */
+  public static List<Integer> syncMultisigGroup(List<MoneroWalletJni> wallets) {
+    try {
+      int[] numOutputs = syncMultisigGroupJni(getWalletHandles(wallets));
+      List<Integer> numOutputsList = new ArrayList<Integer>();
+      for (int num : numOutputs) numOutputsList.add(num);
+      return numOutputsList;
+    } catch (Exception e) {
+      throw new MoneroException(e.getMessage());
+    }
+  }
+  
   // ------------ WALLET METHODS SPECIFIC TO JNI IMPLEMENTATION ---------------
   
   /**
@@ -269,7 +429,7 @@ public class MoneroWalletJni extends MoneroWalletBase {
    * @return the wallet's network type
    */
   public MoneroNetworkType getNetworkType() {
-    assertNotClosed();
+    assertKeysNotClosed();
     return MoneroNetworkType.values()[getNetworkTypeJni()];
   }
   
@@ -337,6 +497,104 @@ public class MoneroWalletJni extends MoneroWalletBase {
     moveToJni(path, password);
   }
   
+  /**
+   * Start a native send pipeline which prepares, signs, and relays queued
+   * send requests in overlapped stages.  Replaces any running pipeline.
+   * 
+   * The pipeline is stopped if the signer is closed.
+   * 
+   * @param signer is the wallet which signs txs prepared by this view-only wallet (null if this wallet signs)
+   * @param maxRelayBatchSize is the maximum number of requests relayed at once
+   */
+  public synchronized void startSendPipeline(MoneroWalletJni signer, int maxRelayBatchSize) {
+    assertNotClosed();
+    if (signer != null) signer.assertNotClosed();
+    closeSendPipeline();
+    try {
+      jniSendPipelineHandle = startSendPipelineJni(signer == null ? 0 : signer.jniWalletHandle, maxRelayBatchSize);
+    } catch (Exception e) {
+      throw new MoneroException(e.getMessage());
+    }
+    if (signer != null) {
+      synchronized (signer.signedPipelines) {
+        signer.signedPipelines.add(this);
+      }
+      sendPipelineSigner = signer;
+    }
+  }
+  
+  /**
+   * Stop the send pipeline.  Requests which have not been relayed fail.
+   */
+  public void stopSendPipeline() {
+    assertNotClosed();
+    closeSendPipeline();
+  }
+  
+  /**
+   * Queue a send request in the send pipeline.
+   * 
+   * @param request is the send request to prepare, sign, and relay
+   * @return the id to get the request's result
+   */
+  public long queueSend(MoneroSendRequest request) {
+    assertNotClosed();
+    if (request == null) throw new MoneroException("Send request cannot be null");
+    sendPipelineLock.readLock().lock();
+    try {
+      assertSendPipelineStarted();
+      return submitToSendPipelineJni(JsonUtils.serializeBytes(request));
+    } catch (Exception e) {
+      throw new MoneroException(e.getMessage());
+    } finally {
+      sendPipelineLock.readLock().unlock();
+    }
+  }
+  
+  /**
+   * Get the result of a request queued in the send pipeline.  The result is
+   * forgotten once returned relayed or failed.
+   * 
+   * @param id is the id returned by queueSend()
+   * @param wait specifies if the call blocks until the request is relayed or fails
+   * @return the request's result or null if the id is unknown
+   */
+  public MoneroSendPipelineResult getSendResult(long id, boolean wait) {
+    assertNotClosed();
+    byte[] resultJson;
+    sendPipelineLock.readLock().lock();
+    try {
+      assertSendPipelineStarted();
+      resultJson = getSendPipelineResultJni(id, wait);
+    } catch (Exception e) {
+      throw new MoneroException(e.getMessage());
+    } finally {
+      sendPipelineLock.readLock().unlock();
+    }
+    if (resultJson == null) return null;
+    return JsonUtils.deserialize(resultJson, MoneroSendPipelineResult.class);
+  }
+  
+  /**
+   * Get the queue depth and latency of each stage of the send pipeline.
+   * 
+   * @return stats of the prepare, sign (if a signer is used), and relay stages
+   */
+  public List<MoneroSendPipelineStageStats> getSendPipelineStats() {
+    assertNotClosed();
+    byte[] statsJson;
+    sendPipelineLock.readLock().lock();
+    try {
+      assertSendPipelineStarted();
+      statsJson = getSendPipelineStatsJni();
+    } catch (Exception e) {
+      throw new MoneroException(e.getMessage());
+    } finally {
+      sendPipelineLock.readLock().unlock();
+    }
+    return JsonUtils.deserialize(statsJson, SendPipelineStagesContainer.class).stages;
+  }
+  
   /**
    * Indicates if this wallet is closed or not.
    * 
@@ -346,6 +604,17 @@ public class MoneroWalletJni extends MoneroWalletBase {
     return isClosed;
   }
   
+  /**
+   * Indicates if this wallet is fully loaded or still loading its cache
+   * after being opened with openWalletLazy().
+   * 
+   * @return true if the wallet is loaded, false otherwise
+   */
+  public boolean isLoaded() {
+    assertKeysNotClosed();
+    return !isLoading || isWalletLoadedJni();
+  }
+  
   // -------------------------- COMMON WALLET METHODS -------------------------
   
   public void setDaemonConnection(MoneroRpcConnection daemonConnection) {
@@ -370,6 +639,38 @@ public class MoneroWalletJni extends MoneroWalletBase {
     }
   }
   
+  /**
+   * Start or stop building txs with ring members from the shared output
+   * cache.
+   * 
+   * While enabled, the wallet connects to its daemon through a local proxy
+   * which answers get_outs and get_output_distribution requests from the
+   * cache and fetches only misses from the daemon.  The proxy requires
+   * credentials generated for the wallet and forwards only the requests the
+   * wallet makes.  The daemon connection reported by getDaemonConnection()
+   * remains the proxied daemon.
+   * 
+   * @param enabled specifies if the output cache is used to build txs
+   */
+  public void setOutputCacheEnabled(boolean enabled) {
+    assertNotClosed();
+    try {
+      jniOutputCacheProxyHandle = setOutputCacheProxyJni(enabled);
+    } catch (Exception e) {
+      throw new MoneroException(e.getMessage());
+    }
+  }
+  
+  /**
+   * Indicates if the wallet builds txs with ring members from the shared
+   * output cache.
+   * 
+   * @return true if the output cache is used to build txs, false otherwise
+   */
+  public boolean isOutputCacheEnabled() {
+    return jniOutputCacheProxyHandle != 0;
+  }
+  
   public boolean isConnected() {
     assertNotClosed();
     try {
@@ -399,7 +700,7 @@ public class MoneroWalletJni extends MoneroWalletBase {
 
   @Override
   public String getMnemonic() {
-    assertNotClosed();
+    assertKeysNotClosed();
     String mnemonic = getMnemonicJni();
     if ("".equals(mnemonic)) return null;
     return mnemonic;
@@ -407,7 +708,7 @@ public class MoneroWalletJni extends MoneroWalletBase {
   
   @Override
   public String getMnemonicLanguage() {
-    assertNotClosed();
+    assertKeysNotClosed();
     String mnemonicLanguage = getMnemonicLanguageJni();
     if ("".equals(mnemonicLanguage)) return null;
     return mnemonicLanguage;
@@ -415,13 +716,13 @@ public class MoneroWalletJni extends MoneroWalletBase {
 
   @Override
   public String getPrivateViewKey() {
-    assertNotClosed();
+    assertKeysNotClosed();
     return getPrivateViewKeyJni();
   }
   
   @Override
   public String getPrivateSpendKey() {
-    assertNotClosed();
+    assertKeysNotClosed();
     String privateSpendKey = getPrivateSpendKeyJni();
     if ("".equals(privateSpendKey)) return null;
     return privateSpendKey;
@@ -429,13 +730,13 @@ public class MoneroWalletJni extends MoneroWalletBase {
   
   @Override
   public String getPublicViewKey() {
-    assertNotClosed();
+    assertKeysNotClosed();
     return getPublicViewKeyJni();
   }
   
   @Override
   public String getPublicSpendKey() {
-    assertNotClosed();
+    assertKeysNotClosed();
     return getPublicSpendKeyJni();
   }
 
@@ -500,6 +801,72 @@ public class MoneroWalletJni extends MoneroWalletBase {
     }
   }
   
+  /**
+   * Start or stop collecting counters and stage timings of the wallet's syncs.
+   * 
+   * Both sync() and background syncing started by startSyncing() are
+   * recorded.  Daemon requests and bytes downloaded are recorded while the
+   * wallet connects through the output cache (see setOutputCacheEnabled()).
+   * While collecting, listeners which implement MoneroSyncStatsListener
+   * receive the stats with each progress notification.
+   * 
+   * @param enabled specifies if sync stats are collected
+   */
+  public void setSyncStatsEnabled(boolean enabled) {
+    assertNotClosed();
+    try {
+      jniSyncStatsHandle = setSyncStatsJni(enabled);
+      isSyncStatsEnabled = enabled;
+    } catch (Exception e) {
+      throw new MoneroException(e.getMessage());
+    }
+  }
+  
+  /**
+   * Indicates if the wallet collects sync stats.
+   * 
+   * @return true if sync stats are collected, false otherwise
+   */
+  public boolean isSyncStatsEnabled() {
+    return isSyncStatsEnabled;
+  }
+  
+  /**
+   * Get the counters and stage timings collected since sync stats were
+   * enabled or reset.
+   * 
+   * @return the wallet's sync stats
+   */
+  public MoneroSyncStats getSyncStats() {
+    assertNotClosed();
+    assertSyncStatsEnabled();
+    try {
+      return JsonUtils.deserialize(getSyncStatsJni(), MoneroSyncStats.class);
+    } catch (Exception e) {
+      throw new MoneroException(e.getMessage());
+    }
+  }
+  
+  /**
+   * Reset the collected sync stats to zero.
+   */
+  public void resetSyncStats() {
+    assertNotClosed();
+    assertSyncStatsEnabled();
+    try {
+      resetSyncStatsJni();
+    } catch (Exception e) {
+      throw new MoneroException(e.getMessage());
+    }
+  }
+  
+  /**
+   * Start syncing the wallet in a native thread every 10 seconds.
+   * 
+   * Each sync locks the wallet like other calls on it, so calls wait for the
+   * sync in progress and listeners it notifies must not wait on threads
+   * which call the wallet.
+   */
   @Override
   public void startSyncing() {
     assertNotClosed();
@@ -542,7 +909,7 @@ public class MoneroWalletJni extends MoneroWalletBase {
   @Override
   public List<MoneroAccount> getAccounts(boolean includeSubaddresses, String tag) {
     assertNotClosed();
-    String accountsJson = getAccountsJni(includeSubaddresses, tag);
+    byte[] accountsJson = getAccountsJni(includeSubaddresses, tag);
     List<MoneroAccount> accounts = JsonUtils.deserialize(MoneroRpcConnection.MAPPER, accountsJson, AccountsContainer.class).accounts;
     for (MoneroAccount account : accounts) sanitizeAccount(account);
     return accounts;
@@ -551,7 +918,7 @@ public class MoneroWalletJni extends MoneroWalletBase {
   @Override
   public MoneroAccount getAccount(int accountIdx, boolean includeSubaddresses) {
     assertNotClosed();
-    String accountJson = getAccountJni(accountIdx, includeSubaddresses);
+    byte[] accountJson = getAccountJni(accountIdx, includeSubaddresses);
     MoneroAccount account = JsonUtils.deserialize(MoneroRpcConnection.MAPPER, accountJson, MoneroAccount.class);
     sanitizeAccount(account);
     return account;
@@ -560,7 +927,7 @@ public class MoneroWalletJni extends MoneroWalletBase {
   @Override
   public MoneroAccount createAccount(String label) {
     assertNotClosed();
-    String accountJson = createAccountJni(label);
+    byte[] accountJson = createAccountJni(label);
     MoneroAccount account = JsonUtils.deserialize(MoneroRpcConnection.MAPPER, accountJson, MoneroAccount.class);
     sanitizeAccount(account);
     return account;
@@ -569,7 +936,7 @@ public class MoneroWalletJni extends MoneroWalletBase {
   @Override
   public List<MoneroSubaddress> getSubaddresses(int accountIdx, List<Integer> subaddressIndices) {
     assertNotClosed();
-    String subaddresses_json = getSubaddressesJni(accountIdx, GenUtils.listToIntArray(subaddressIndices));
+    byte[] subaddresses_json = getSubaddressesJni(accountIdx, GenUtils.listToIntArray(subaddressIndices));
     List<MoneroSubaddress> subaddresses = JsonUtils.deserialize(MoneroRpcConnection.MAPPER, subaddresses_json, SubaddressesContainer.class).subaddresses;
     for (MoneroSubaddress subaddress : subaddresses) sanitizeSubaddress(subaddress);
     return subaddresses;
@@ -578,7 +945,7 @@ public class MoneroWalletJni extends MoneroWalletBase {
   @Override
   public MoneroSubaddress createSubaddress(int accountIdx, String label) {
     assertNotClosed();
-    String subaddressJson = createSubaddressJni(accountIdx, label);
+    byte[] subaddressJson = createSubaddressJni(accountIdx, label);
     MoneroSubaddress subaddress = JsonUtils.deserialize(MoneroRpcConnection.MAPPER, subaddressJson, MoneroSubaddress.class);
     sanitizeSubaddress(subaddress);
     return subaddress;
@@ -586,15 +953,267 @@ public class MoneroWalletJni extends MoneroWalletBase {
 
   @Override
   public String getAddress(int accountIdx, int subaddressIdx) {
-    assertNotClosed();
+    assertKeysNotClosed();
     return getAddressJni(accountIdx, subaddressIdx);
   }
 
+  /**
+   * Get the addresses of a range of subaddresses packed into ASCII bytes,
+   * each address terminated by a newline.
+   * 
+   * The addresses are derived from the wallet's keys across cores, so the
+   * range may extend beyond the subaddresses created in the wallet.
+   * 
+   * @param accountIdx is the index of the account
+   * @param startIdx is the first subaddress index
+   * @param endIdx is one past the last subaddress index
+   * @return the packed addresses of the subaddresses in order
+   */
+  public byte[] getAddressesPacked(int accountIdx, int startIdx, int endIdx) {
+    assertNotClosed();
+    if (accountIdx < 0) throw new MoneroException("Account index must be >= 0");
+    if (startIdx < 0 || startIdx > endIdx) throw new MoneroException("Subaddress range must satisfy 0 <= start <= end");
+    try {
+      return getAddressesJni(accountIdx, startIdx, endIdx, DEFAULT_MAX_DERIVATION_THREADS);
+    } catch (Exception e) {
+      throw new MoneroException(e.getMessage());
+    }
+  }
+  
+  /**
+   * Get the addresses of a range of subaddresses.
+   * 
+   * @param accountIdx is the index of the account
+   * @param startIdx is the first subaddress index
+   * @param endIdx is one past the last subaddress index
+   * @return the addresses of the subaddresses in order
+   */
+  public List<String> getAddresses(int accountIdx, int startIdx, int endIdx) {
+    return MoneroUtils.unpackStrings(getAddressesPacked(accountIdx, startIdx, endIdx));
+  }
+  
+  /**
+   * Create subaddresses within an account in one call.
+   * 
+   * The subaddresses are created under one hold of the wallet so no other
+   * call interleaves, and are saved with the wallet's next save.
+   * 
+   * @param accountIdx is the index of the account
+   * @param numSubaddresses is the number of subaddresses to create
+   * @param label is the label of each subaddress (optional)
+   * @return the created subaddresses in order
+   */
+  public List<MoneroSubaddress> createSubaddresses(int accountIdx, int numSubaddresses, String label) {
+    assertNotClosed();
+    if (accountIdx < 0) throw new MoneroException("Account index must be >= 0");
+    if (numSubaddresses < 0) throw new MoneroException("Number of subaddresses must be >= 0");
+    try {
+      int[] firstIdx = new int[1];
+      List<String> addresses = MoneroUtils.unpackStrings(createSubaddressesJni(accountIdx, numSubaddresses, label, firstIdx));
+      List<MoneroSubaddress> subaddresses = new ArrayList<MoneroSubaddress>();
+      for (int i = 0; i < addresses.size(); i++) {
+        subaddresses.add(sanitizeSubaddress(new MoneroSubaddress(addresses.get(i)).setAccountIndex(accountIdx).setIndex(firstIdx[0] + i).setLabel(label == null ? "" : label)));
+      }
+      return subaddresses;
+    } catch (Exception e) {
+      throw new MoneroException(e.getMessage());
+    }
+  }
+
+  /**
+   * Build a compact table to look up the subaddress indices of addresses,
+   * replacing any previous table.
+   * 
+   * The table covers subaddresses [0, numSubaddresses) of accounts
+   * [0, numAccounts), whether or not they are created in the wallet.
+   * 
+   * @param numAccounts is the number of accounts to cover
+   * @param numSubaddresses is the number of subaddresses to cover per account
+   */
+  public void buildSubaddressTable(int numAccounts, int numSubaddresses) {
+    assertNotClosed();
+    if (numAccounts < 1) throw new MoneroException("Number of accounts must be > 0");
+    if (numSubaddresses < 1) throw new MoneroException("Number of subaddresses must be > 0");
+    try {
+      buildSubaddressTableJni(numAccounts, numSubaddresses, DEFAULT_MAX_DERIVATION_THREADS);
+    } catch (Exception e) {
+      throw new MoneroException(e.getMessage());
+    }
+  }
+  
+  /**
+   * Free the subaddress lookup table.
+   */
+  public void freeSubaddressTable() {
+    assertNotClosed();
+    freeSubaddressTableJni();
+  }
+  
+  /**
+   * Get the number of subaddresses in the subaddress lookup table.
+   * 
+   * @return the number of subaddresses in the table, 0 if not built
+   */
+  public long getSubaddressTableSize() {
+    assertNotClosed();
+    return getSubaddressTableStatsJni()[0];
+  }
+  
+  /**
+   * Get the approximate memory used by the subaddress lookup table.
+   * 
+   * @return the number of bytes used by the table, 0 if not built
+   */
+  public long getSubaddressTableMemorySize() {
+    assertNotClosed();
+    return getSubaddressTableStatsJni()[1];
+  }
+  
+  /**
+   * Look up the subaddress indices of addresses, using the subaddress lookup
+   * table if built or else the wallet.
+   * 
+   * @param addresses are the addresses to look up
+   * @return the account and subaddress index of each address packed in order, -1 for each if not found
+   */
+  public int[] getAddressIndices(List<String> addresses) {
+    assertNotClosed();
+    try {
+      return getAddressIndicesJni(addresses.toArray(new String[addresses.size()]));
+    } catch (Exception e) {
+      throw new MoneroException(e.getMessage());
+    }
+  }
+  
+  /**
+   * Snapshot the wallet's outputs into a compact native store, replacing any
+   * previous store.
+   * 
+   * The store keeps each output field in one array with keys inline and tx
+   * hashes shared by outputs of the same tx, so holding and repeatedly
+   * querying outputs uses a fraction of the memory of the wallet's output
+   * objects and scans quickly for queries and balances.  Building it still
+   * queries the wallet's outputs one account at a time.
+   * 
+   * The store is rebuilt on its next use if the wallet's outputs may have
+   * changed since it was built, as after syncing or sending.
+   */
+  public void buildOutputStore() {
+    assertNotClosed();
+    try {
+      buildOutputStoreJni();
+    } catch (Exception e) {
+      throw new MoneroException(e.getMessage());
+    }
+  }
+  
+  /**
+   * Free the compact output store.
+   */
+  public void freeOutputStore() {
+    assertNotClosed();
+    freeOutputStoreJni();
+  }
+  
+  /**
+   * Get the number of outputs in the compact output store.
+   * 
+   * @return the number of outputs in the store, 0 if not built
+   */
+  public long getOutputStoreSize() {
+    assertNotClosed();
+    try {
+      return getOutputStoreStatsJni()[0];
+    } catch (Exception e) {
+      throw new MoneroException(e.getMessage());
+    }
+  }
+  
+  /**
+   * Get the approximate memory used by the compact output store.
+   * 
+   * @return the number of bytes used by the store, 0 if not built
+   */
+  public long getOutputStoreMemorySize() {
+    assertNotClosed();
+    try {
+      return getOutputStoreStatsJni()[2];
+    } catch (Exception e) {
+      throw new MoneroException(e.getMessage());
+    }
+  }
+  
+  /**
+   * Get the unspent balance of outputs in the compact output store.
+   * 
+   * @param accountIdx is the index of the account to get the balance of (null for all accounts)
+   * @param subaddressIdx is the index of the subaddress to get the balance of (null for all subaddresses)
+   * @return the sum of unspent output amounts in the store
+   */
+  public BigInteger getOutputStoreBalance(Integer accountIdx, Integer subaddressIdx) {
+    assertNotClosed();
+    assertOutputStoreBuilt();
+    try {
+      return new BigInteger(getOutputStoreBalanceJni(accountIdx == null ? -1 : accountIdx, subaddressIdx == null ? -1 : subaddressIdx));
+    } catch (Exception e) {
+      throw new MoneroException(e.getMessage());
+    }
+  }
+  
+  /**
+   * Get outputs from the compact output store.
+   * 
+   * Outputs of the same tx share one tx which has only its hash, whether
+   * it's confirmed, and the height of its block if confirmed.
+   * 
+   * @param accountIdx is the index of the account to get outputs from (null for all accounts)
+   * @param subaddressIdx is the index of the subaddress to get outputs from (null for all subaddresses)
+   * @param isSpent specifies if spent or unspent outputs are returned (null for both)
+   * @return the matching outputs in the store
+   */
+  public List<MoneroOutputWallet> getOutputStoreOutputs(Integer accountIdx, Integer subaddressIdx, Boolean isSpent) {
+    assertNotClosed();
+    assertOutputStoreBuilt();
+    List<String> fields;
+    try {
+      fields = MoneroUtils.unpackStrings(getOutputStoreOutputsJni(accountIdx == null ? -1 : accountIdx, subaddressIdx == null ? -1 : subaddressIdx, isSpent == null ? -1 : isSpent ? 1 : 0));
+    } catch (Exception e) {
+      throw new MoneroException(e.getMessage());
+    }
+    Map<String, MoneroTxWallet> txs = new HashMap<String, MoneroTxWallet>();
+    List<MoneroOutputWallet> outputs = new ArrayList<MoneroOutputWallet>();
+    for (int i = 0; i < fields.size(); i += 9) {
+      MoneroTxWallet tx = txs.get(fields.get(i + 7));
+      if (tx == null) {
+        tx = new MoneroTxWallet().setHash(fields.get(i + 7));
+        if (fields.get(i + 4).isEmpty()) tx.setIsConfirmed(false);
+        else {
+          tx.setIsConfirmed(true);
+          tx.setBlock(new MoneroBlock().setHeight(Long.parseLong(fields.get(i + 4))).setTxs(tx));
+        }
+        tx.setOutputs(new ArrayList<MoneroOutput>());
+        txs.put(tx.getHash(), tx);
+      }
+      MoneroOutputWallet output = new MoneroOutputWallet();
+      output.setAccountIndex(Integer.parseInt(fields.get(i)));
+      output.setSubaddressIndex(Integer.parseInt(fields.get(i + 1)));
+      output.setAmount(new BigInteger(fields.get(i + 2)));
+      output.setIndex(Long.parseLong(fields.get(i + 3)));
+      output.setIsSpent("1".equals(fields.get(i + 5)));
+      output.setIsFrozen("1".equals(fields.get(i + 6)));
+      output.setKeyImage(new MoneroKeyImage(fields.get(i + 8)));
+      output.setTx(tx);
+      tx.getOutputs().add(output);
+      outputs.add(output);
+    }
+    return outputs;
+  }
+  
   @Override
   public MoneroSubaddress getAddressIndex(String address) {
     assertNotClosed();
     try {
-      String subaddressJson = getAddressIndexJni(address);
+      byte[] subaddressJson = getAddressIndexJni(address);
       MoneroSubaddress subaddress = JsonUtils.deserialize(MoneroRpcConnection.MAPPER, subaddressJson, MoneroSubaddress.class);
       return sanitizeSubaddress(subaddress);
     } catch (Exception e) {
@@ -671,9 +1290,9 @@ public class MoneroWalletJni extends MoneroWalletBase {
     if (query.getBlock() == null) query.setBlock(new MoneroBlock().setTxs(query));
     
     // serialize query from block and fetch txs from jni
-    String blocksJson;
+    byte[] blocksJson;
     try {
-      blocksJson = getTxsJni(JsonUtils.serialize(query.getBlock()));
+      blocksJson = getTxsJni(JsonUtils.serializeBytes(query.getBlock()));
     } catch (Exception e) {
       throw new MoneroException(e.getMessage());
     }
@@ -726,9 +1345,9 @@ public class MoneroWalletJni extends MoneroWalletBase {
     if (query.getTxQuery().getBlock() == null) query.getTxQuery().setBlock(new MoneroBlock().setTxs(query.getTxQuery()));
     
     // serialize query from block and fetch transfers from jni
-    String blocksJson;
+    byte[] blocksJson;
     try {
-      blocksJson = getTransfersJni(JsonUtils.serialize(query.getTxQuery().getBlock()));
+      blocksJson = getTransfersJni(JsonUtils.serializeBytes(query.getTxQuery().getBlock()));
     } catch (Exception e) {
       throw new MoneroException(e.getMessage());
     }
@@ -775,7 +1394,7 @@ public class MoneroWalletJni extends MoneroWalletBase {
     if (query.getTxQuery().getBlock() == null) query.getTxQuery().setBlock(new MoneroBlock().setTxs(query.getTxQuery()));
     
     // serialize query from block and fetch outputs from jni
-    String blocksJson = getOutputsJni(JsonUtils.serialize(query.getTxQuery().getBlock()));
+    byte[] blocksJson = getOutputsJni(JsonUtils.serializeBytes(query.getTxQuery().getBlock()));
     
     // deserialize blocks
     List<MoneroBlock> blocks = deserializeBlocks(blocksJson);
@@ -808,7 +1427,7 @@ public class MoneroWalletJni extends MoneroWalletBase {
   @Override
   public List<MoneroKeyImage> getKeyImages() {
     assertNotClosed();
-    String keyImagesJson = getKeyImagesJni();
+    byte[] keyImagesJson = getKeyImagesJni();
     List<MoneroKeyImage> keyImages = JsonUtils.deserialize(MoneroRpcConnection.MAPPER, keyImagesJson, KeyImagesContainer.class).keyImages;
     return keyImages;
   }
@@ -819,7 +1438,7 @@ public class MoneroWalletJni extends MoneroWalletBase {
     
     // wrap and serialize key images in container for jni
     KeyImagesContainer keyImageContainer = new KeyImagesContainer(keyImages);
-    String importResultJson = importKeyImagesJni(JsonUtils.serialize(keyImageContainer));
+    byte[] importResultJson = importKeyImagesJni(JsonUtils.serializeBytes(keyImageContainer));
     
     // deserialize response
     return JsonUtils.deserialize(MoneroRpcConnection.MAPPER, importResultJson, MoneroKeyImageImportResult.class);
@@ -831,15 +1450,40 @@ public class MoneroWalletJni extends MoneroWalletBase {
     throw new RuntimeException("Not implemented");
   }
   
+  /**
+   * Relay previously created transactions.
+   * 
+   * Nothing is relayed if any metadata is invalid.  Otherwise txs are relayed
+   * until one fails, whose error is thrown; txs relayed before it stay
+   * relayed, as when the wallet relays them one at a time.
+   */
   @Override
   public List<String> relayTxs(Collection<String> txMetadatas) {
-    assertNotClosed();
-    String[] txMetadatasArr = txMetadatas.toArray(new String[txMetadatas.size()]);  // convert to array for jni
-    try {
-      return Arrays.asList(relayTxsJni(txMetadatasArr));
-    } catch (Exception e) {
-      throw new MoneroException(e.getMessage());
+    List<String> txHashes = new ArrayList<String>();
+    for (MoneroTxRelayResult result : relayTxs(txMetadatas, DEFAULT_MAX_RELAYS_IN_FLIGHT, true)) {
+      if (!result.isRelayed()) throw new MoneroException(result.getError());
+      txHashes.add(result.getTxHash());
     }
+    return txHashes;
+  }
+  
+  /**
+   * Relay previously created transactions with a result per tx.
+   * 
+   * Unlike relayTxs(Collection), a tx which fails to relay does not stop
+   * the rest of the batch, so the results may be partial: some txs relayed
+   * and others failed.
+   * 
+   * Txs are submitted over parallel daemon connections if the output cache
+   * is enabled (see setOutputCacheEnabled()), otherwise the wallet submits
+   * them one at a time.  Each tx is submitted to the daemon once either way.
+   * 
+   * @param txMetadatas are transaction metadata previously created without relaying
+   * @param maxInFlight is the maximum number of txs submitted to the daemon concurrently
+   * @return a result per tx, in the given order, with its hash or error
+   */
+  public List<MoneroTxRelayResult> relayTxs(Collection<String> txMetadatas, int maxInFlight) {
+    return relayTxs(txMetadatas, maxInFlight, false);
   }
 
   @Override
@@ -852,10 +1496,10 @@ public class MoneroWalletJni extends MoneroWalletBase {
     if (request == null) throw new MoneroException("Send request cannot be null");
     
     // submit send request to JNI and get response as json rooted at tx set
-    String txSetJson;
+    byte[] txSetJson;
     try {
-      txSetJson = sendSplitJni(JsonUtils.serialize(request));
-      LOGGER.fine("Received sendSplit() response from JNI: " + txSetJson.substring(0, Math.min(5000, txSetJson.length())) + "...");
+      txSetJson = sendSplitJni(JsonUtils.serializeBytes(request));
+      LOGGER.fine("Received sendSplit() response from JNI: " + txSetJson.length + " bytes");
     } catch (Exception e) {
       throw new MoneroException(e.getMessage());
     }
@@ -875,10 +1519,10 @@ public class MoneroWalletJni extends MoneroWalletBase {
     if (request == null) throw new MoneroException("Send request cannot be null");
     
     // submit send request to JNI and get response as json rooted at tx set
-    String txSetsJson;
+    byte[] txSetsJson;
     try {
-      txSetsJson = sweepUnlockedJni(JsonUtils.serialize(request));
-      LOGGER.fine("Received sweepUnlocked() response from JNI: " + txSetsJson.substring(0, Math.min(5000, txSetsJson.length())) + "...");
+      txSetsJson = sweepUnlockedJni(JsonUtils.serializeBytes(request));
+      LOGGER.fine("Received sweepUnlocked() response from JNI: " + txSetsJson.length + " bytes");
     } catch (Exception e) {
       throw new MoneroException(e.getMessage());
     }
@@ -891,7 +1535,7 @@ public class MoneroWalletJni extends MoneroWalletBase {
   public MoneroTxSet sweepOutput(MoneroSendRequest request) {
     assertNotClosed();
     try {
-      String txSetJson = sweepOutputJni(JsonUtils.serialize(request));
+      byte[] txSetJson = sweepOutputJni(JsonUtils.serializeBytes(request));
       MoneroTxSet txSet = JsonUtils.deserialize(txSetJson, MoneroTxSet.class);
       return txSet;
     } catch (Exception e) {
@@ -902,7 +1546,7 @@ public class MoneroWalletJni extends MoneroWalletBase {
   @Override
   public MoneroTxSet sweepDust(boolean doNotRelay) {
     assertNotClosed();
-    String txSetJson;
+    byte[] txSetJson;
     try { txSetJson = sweepDustJni(doNotRelay); }
     catch (Exception e) { throw new MoneroException(e.getMessage()); }
     MoneroTxSet txSet = JsonUtils.deserialize(txSetJson, MoneroTxSet.class);
@@ -912,9 +1556,9 @@ public class MoneroWalletJni extends MoneroWalletBase {
   @Override
   public MoneroTxSet parseTxSet(MoneroTxSet txSet) {
     assertNotClosed();
-    String parsedTxSetJson;
+    byte[] parsedTxSetJson;
     try {
-      parsedTxSetJson = parseTxSetJni(JsonUtils.serialize(txSet));
+      parsedTxSetJson = parseTxSetJni(JsonUtils.serializeBytes(txSet));
     } catch (Exception e) {
       throw new MoneroException(e.getMessage());
     }
@@ -1023,6 +1667,107 @@ public class MoneroWalletJni extends MoneroWalletBase {
     }
   }
 
+  /**
+   * Check tx keys over a pool of worker threads.
+   * 
+   * Tx keys are checked against the wallet's daemon without the wallet, so
+   * other calls to the wallet proceed meanwhile, and their txs are fetched
+   * together.  A tx key which cannot be checked yields a check which is not
+   * good instead of failing the batch, but the batch fails if the daemon
+   * cannot be queried.
+   * 
+   * @param txHashes are the hashes of the txs to check
+   * @param txKeys are the private keys of each tx
+   * @param addresses are the destination addresses of each tx
+   * @return the check of each tx key in the order given
+   */
+  public List<MoneroCheckTx> checkTxKeys(List<String> txHashes, List<String> txKeys, List<String> addresses) {
+    assertNotClosed();
+    if (txKeys.size() != txHashes.size() || addresses.size() != txHashes.size()) throw new MoneroException("Must provide a tx key and address for each tx hash");
+    try {
+      return unpackCheckTxs(checkTxKeysJni(txHashes.toArray(new String[txHashes.size()]), txKeys.toArray(new String[txKeys.size()]), addresses.toArray(new String[addresses.size()]), DEFAULT_MAX_PROOF_THREADS));
+    } catch (Exception e) {
+      throw new MoneroException(e.getMessage());
+    }
+  }
+  
+  /**
+   * Check tx proofs over a pool of worker threads.
+   * 
+   * Tx proofs are checked against the wallet's daemon without the wallet, so
+   * other calls to the wallet proceed meanwhile, and their txs are fetched
+   * together.  A tx proof which cannot be checked yields a check which is not
+   * good instead of failing the batch, but the batch fails if the daemon
+   * cannot be queried.
+   * 
+   * @param txHashes are the hashes of the txs to check
+   * @param addresses are the destination addresses of each tx
+   * @param messages are the messages included with each proof
+   * @param signatures are the tx proof signatures
+   * @return the check of each tx proof in the order given
+   */
+  public List<MoneroCheckTx> checkTxProofs(List<String> txHashes, List<String> addresses, List<String> messages, List<String> signatures) {
+    assertNotClosed();
+    if (addresses.size() != txHashes.size() || messages.size() != txHashes.size() || signatures.size() != txHashes.size()) throw new MoneroException("Must provide an address, message, and signature for each tx hash");
+    try {
+      return unpackCheckTxs(checkTxProofsJni(txHashes.toArray(new String[txHashes.size()]), addresses.toArray(new String[addresses.size()]), messages.toArray(new String[messages.size()]), signatures.toArray(new String[signatures.size()]), DEFAULT_MAX_PROOF_THREADS));
+    } catch (Exception e) {
+      throw new MoneroException(e.getMessage());
+    }
+  }
+  
+  /**
+   * Check spend proofs over a pool of worker threads.
+   * 
+   * Spend proofs are checked against the wallet's daemon without the wallet,
+   * so other calls to the wallet proceed meanwhile, and their txs and ring
+   * members are fetched together.  The batch fails if the daemon cannot be
+   * queried.
+   * 
+   * @param txHashes are the hashes of the txs to check
+   * @param messages are the messages included with each proof
+   * @param signatures are the spend proof signatures
+   * @return true for each spend proof in the order given which is good, false otherwise
+   */
+  public List<Boolean> checkSpendProofs(List<String> txHashes, List<String> messages, List<String> signatures) {
+    assertNotClosed();
+    if (messages.size() != txHashes.size() || signatures.size() != txHashes.size()) throw new MoneroException("Must provide a message and signature for each tx hash");
+    try {
+      boolean[] goods = checkSpendProofsJni(txHashes.toArray(new String[txHashes.size()]), messages.toArray(new String[messages.size()]), signatures.toArray(new String[signatures.size()]), DEFAULT_MAX_PROOF_THREADS);
+      List<Boolean> goodsList = new ArrayList<Boolean>();
+      for (boolean good : goods) goodsList.add(good);
+      return goodsList;
+    } catch (Exception e) {
+      throw new MoneroException(e.getMessage());
+    }
+  }
+  
+  /**
+   * Check reserve proofs over a pool of worker threads.
+   * 
+   * Proofs are checked against the wallet's daemon without the wallet, so
+   * other calls to the wallet proceed meanwhile, and the outputs of one large
+   * proof are checked in parallel.  A proof which cannot be checked yields a
+   * check which is not good instead of failing the batch, but the batch fails
+   * if the daemon cannot be queried.
+   * 
+   * @param addresses are the addresses which signed each proof
+   * @param messages are the messages included with each proof
+   * @param signatures are the reserve proof signatures
+   * @param listener is notified as proofs are checked (optional)
+   * @return the check of each proof in the order given
+   */
+  public List<MoneroCheckReserve> checkReserveProofs(List<String> addresses, List<String> messages, List<String> signatures, MoneroProgressListener listener) {
+    assertNotClosed();
+    if (addresses.size() != signatures.size() || messages.size() != signatures.size()) throw new MoneroException("Must provide an address and message for each signature");
+    try {
+      byte[] checksJson = checkReserveProofsJni(addresses.toArray(new String[addresses.size()]), messages.toArray(new String[messages.size()]), signatures.toArray(new String[signatures.size()]), DEFAULT_MAX_PROOF_THREADS, listener);
+      return JsonUtils.deserialize(MoneroRpcConnection.MAPPER, checksJson, CheckReservesContainer.class).checks;
+    } catch (Exception e) {
+      throw new MoneroException(e.getMessage(), -1);
+    }
+  }
+
   @Override
   public String sign(String msg) {
     assertNotClosed();
@@ -1034,6 +1779,40 @@ public class MoneroWalletJni extends MoneroWalletBase {
     assertNotClosed();
     return verifyJni(msg, address, signature);
   }
+  
+  /**
+   * Sign messages with the private spend key over a pool of worker threads.
+   * 
+   * @param msgs are the messages to sign
+   * @return the signature of each message in the order given
+   */
+  public List<String> signBatch(List<String> msgs) {
+    assertNotClosed();
+    try {
+      return Arrays.asList(signBatchJni(msgs.toArray(new String[msgs.size()]), DEFAULT_MAX_PROOF_THREADS));
+    } catch (Exception e) {
+      throw new MoneroException(e.getMessage());
+    }
+  }
+  
+  /**
+   * Verify message signatures over a pool of worker threads, decoding each
+   * distinct address once.
+   * 
+   * @param msgs are the signed messages
+   * @param addresses are the addresses which signed each message
+   * @param signatures are the signatures to verify
+   * @return true for each signature in the order given which is good, false otherwise
+   */
+  public boolean[] verifyBatch(List<String> msgs, List<String> addresses, List<String> signatures) {
+    assertNotClosed();
+    if (addresses.size() != msgs.size() || signatures.size() != msgs.size()) throw new MoneroException("Must provide an address and signature for each message");
+    try {
+      return verifyBatchJni(msgs.toArray(new String[msgs.size()]), addresses.toArray(new String[addresses.size()]), signatures.toArray(new String[signatures.size()]), DEFAULT_MAX_PROOF_THREADS);
+    } catch (Exception e) {
+      throw new MoneroException(e.getMessage());
+    }
+  }
 
   @Override
   public String getTxKey(String txHash) {
@@ -1061,7 +1840,7 @@ public class MoneroWalletJni extends MoneroWalletBase {
   public List<MoneroAddressBookEntry> getAddressBookEntries(List<Integer> entryIndices) {
     assertNotClosed();
     if (entryIndices == null) entryIndices = new ArrayList<Integer>();
-    String entriesJson = getAddressBookEntriesJni(GenUtils.listToIntArray(entryIndices));
+    byte[] entriesJson = getAddressBookEntriesJni(GenUtils.listToIntArray(entryIndices));
     List<MoneroAddressBookEntry> entries = JsonUtils.deserialize(MoneroRpcConnection.MAPPER, entriesJson, AddressBookEntriesContainer.class).entries;
     if (entries == null) entries = new ArrayList<MoneroAddressBookEntry>();
     return entries;
@@ -1113,7 +1892,7 @@ public class MoneroWalletJni extends MoneroWalletBase {
   public String createPaymentUri(MoneroSendRequest request) {
     assertNotClosed();
     try {
-      return createPaymentUriJni(JsonUtils.serialize(request));
+      return createPaymentUriJni(JsonUtils.serializeBytes(request));
     } catch (Exception e) {
       throw new MoneroException(e.getMessage());
     }
@@ -1123,7 +1902,7 @@ public class MoneroWalletJni extends MoneroWalletBase {
   public MoneroSendRequest parsePaymentUri(String uri) {
     assertNotClosed();
     try {
-      String sendRequestJson = parsePaymentUriJni(uri);
+      byte[] sendRequestJson = parsePaymentUriJni(uri);
       return JsonUtils.deserialize(MoneroRpcConnection.MAPPER, sendRequestJson, MoneroSendRequest.class);
     } catch (Exception e) {
       throw new MoneroException(e.getMessage());
@@ -1250,9 +2029,26 @@ public class MoneroWalletJni extends MoneroWalletBase {
   @Override
   public void close(boolean save) {
     if (isClosed) return; // closing a closed wallet has no effect
+    if (save) assertNotClosed();
     isClosed = true;
+    
+    // stop send pipelines using this wallet before it's deleted
+    closeSendPipeline();
+    List<MoneroWalletJni> signedWallets;
+    synchronized (signedPipelines) {
+      signedWallets = new ArrayList<MoneroWalletJni>(signedPipelines);
+    }
+    for (MoneroWalletJni signedWallet : signedWallets) signedWallet.closeSendPipeline();
     try {
       closeJni(save);
+      jniLazyWalletHandle = 0;
+      jniSendPipelineHandle = 0;
+      jniSubaddressTableHandle = 0;
+      jniOutputStoreHandle = 0;
+      jniSyncStatsHandle = 0;
+      isSyncStatsEnabled = false;
+      jniOutputCacheProxyHandle = 0;
+      jniSyncLoopHandle = 0;
     } catch (Exception e) {
       throw new MoneroException(e.getMessage());
     }
@@ -1264,12 +2060,20 @@ public class MoneroWalletJni extends MoneroWalletBase {
   
   private native static long openWalletJni(String path, String password, int networkType);
   
+  private native static long openWalletLazyJni(String path, String password, int networkType);
+  
+  private native static long[] openWalletsJni(String[] paths, String[] passwords, int[] networkTypes, int maxThreads, long maxOpenCacheBytes, String[] errors);
+  
   private native static long createWalletRandomJni(String path, String password, int networkType, String daemonUrl, String daemonUsername, String daemonPassword, String language);
   
   private native static long createWalletFromMnemonicJni(String path, String password, int networkType, String mnemonic, long restoreHeight, String seedOffset);
   
   private native static long createWalletFromKeysJni(String path, String password, int networkType, String address, String viewKey, String spendKey, long restoreHeight, String language);
   
+  private native boolean isWalletLoadedJni();
+  
+  private native long awaitWalletJni();
+  
   private native long getHeightJni();
   
   private native long getRestoreHeightJni();
@@ -1284,6 +2088,8 @@ public class MoneroWalletJni extends MoneroWalletBase {
   
   private native void setDaemonConnectionJni(String uri, String username, String password);
   
+  private native long setOutputCacheProxyJni(boolean enabled);
+  
   private native boolean isConnectedJni();
   
   private native boolean isDaemonSyncedJni();
@@ -1312,7 +2118,27 @@ public class MoneroWalletJni extends MoneroWalletBase {
   
   private native String getAddressJni(int accountIdx, int subaddressIdx);
   
-  private native String getAddressIndexJni(String address);
+  private native byte[] getAddressIndexJni(String address);
+  
+  private native void buildSubaddressTableJni(int numAccounts, int numSubaddresses, int maxThreads);
+  
+  private native void freeSubaddressTableJni();
+  
+  private native long[] getSubaddressTableStatsJni();
+  
+  private native int[] getAddressIndicesJni(String[] addresses);
+  
+  private native void buildOutputStoreJni();
+  
+  private native void freeOutputStoreJni();
+  
+  private native long[] getOutputStoreStatsJni();
+  
+  private native String getOutputStoreBalanceJni(int accountIdx, int subaddressIdx);
+  
+  private native byte[] getOutputStoreOutputsJni(int accountIdx, int subaddressIdx, int isSpent);
+  
+  private native byte[] getAddressesJni(int accountIdx, int startIdx, int endIdx, int maxThreads);
   
   private native String getIntegratedAddressJni(String standardAddress, String paymentId);
   
@@ -1322,6 +2148,12 @@ public class MoneroWalletJni extends MoneroWalletBase {
   
   private native Object[] syncJni(long startHeight);
   
+  private native long setSyncStatsJni(boolean enabled);
+  
+  private native byte[] getSyncStatsJni();
+  
+  private native void resetSyncStatsJni();
+  
   private native void startSyncingJni();
   
   private native void stopSyncingJni();
@@ -1342,15 +2174,17 @@ public class MoneroWalletJni extends MoneroWalletBase {
   
   private native String getUnlockedBalanceSubaddressJni(int accountIdx, int subaddressIdx);
   
-  private native String getAccountsJni(boolean includeSubaddresses, String tag);
+  private native byte[] getAccountsJni(boolean includeSubaddresses, String tag);
+  
+  private native byte[] getAccountJni(int accountIdx, boolean includeSubaddresses);
   
-  private native String getAccountJni(int accountIdx, boolean includeSubaddresses);
+  private native byte[] createAccountJni(String label);
   
-  private native String createAccountJni(String label);
+  private native byte[] getSubaddressesJni(int accountIdx, int[] subaddressIndices);
   
-  private native String getSubaddressesJni(int accountIdx, int[] subaddressIndices);
+  private native byte[] createSubaddressJni(int accountIdx, String label);
   
-  private native String createSubaddressJni(int accountIdx, String label);
+  private native byte[] createSubaddressesJni(int accountIdx, int numSubaddresses, String label, int[] firstIdx);
   
   /**
    * Gets txs from the native layer using strings to communicate.
@@ -1358,31 +2192,43 @@ public class MoneroWalletJni extends MoneroWalletBase {
    * @param txQueryJson is a tx query serialized to a json string
    * @return a serialized BlocksContainer to preserve model relationships
    */
-  private native String getTxsJni(String txQueryJson);
+  private native byte[] getTxsJni(byte[] txQueryJson);
   
-  private native String getTransfersJni(String transferQueryJson);
+  private native byte[] getTransfersJni(byte[] transferQueryJson);
   
-  private native String getOutputsJni(String outputQueryJson);
+  private native byte[] getOutputsJni(byte[] outputQueryJson);
   
   private native String getOutputsHexJni();
   
   private native int importOutputsHexJni(String outputsHex);
   
-  private native String getKeyImagesJni();
+  private native byte[] getKeyImagesJni();
+  
+  private native byte[] importKeyImagesJni(byte[] keyImagesJson);
+  
+  private native byte[] relayTxsJni(String[] txMetadatas, int maxInFlight, boolean stopOnError);
+  
+  private native byte[] sendSplitJni(byte[] sendRequestJson);
+  
+  private native byte[] sweepUnlockedJni(byte[] sendRequestJson);
+  
+  private native byte[] sweepOutputJni(byte[] sendRequestJson);
+  
+  private native byte[] sweepDustJni(boolean doNotRelay);
   
-  private native String importKeyImagesJni(String keyImagesJson);
+  private native long startSendPipelineJni(long signerHandle, int maxRelayBatchSize);
   
-  private native String[] relayTxsJni(String[] txMetadatas);
+  private native void stopSendPipelineJni();
   
-  private native String sendSplitJni(String sendRequestJson);
+  private native void deleteSendPipelineJni();
   
-  private native String sweepUnlockedJni(String sendRequestJson);
+  private native long submitToSendPipelineJni(byte[] sendRequestJson);
   
-  private native String sweepOutputJni(String sendRequestJson);
+  private native byte[] getSendPipelineResultJni(long id, boolean wait);
   
-  private native String sweepDustJni(boolean doNotRelay);
+  private native byte[] getSendPipelineStatsJni();
   
-  private native String parseTxSetJni(String txSetJson);
+  private native byte[] parseTxSetJni(byte[] txSetJson);
   
   private native String signTxsJni(String unsignedTxHex);
   
@@ -1396,6 +2242,10 @@ public class MoneroWalletJni extends MoneroWalletBase {
   
   private native boolean verifyJni(String msg, String address, String signature);
   
+  private native String[] signBatchJni(String[] msgs, int maxThreads);
+  
+  private native boolean[] verifyBatchJni(String[] msgs, String[] addresses, String[] signatures, int maxThreads);
+  
   private native String getTxKeyJni(String txHash);
   
   private native String checkTxKeyJni(String txHash, String txKey, String address);
@@ -1414,7 +2264,15 @@ public class MoneroWalletJni extends MoneroWalletBase {
   
   private native String checkReserveProofJni(String address, String message, String signature);
   
-  private native String getAddressBookEntriesJni(int[] indices);
+  private native long[] checkTxKeysJni(String[] txHashes, String[] txKeys, String[] addresses, int maxThreads);
+  
+  private native long[] checkTxProofsJni(String[] txHashes, String[] addresses, String[] messages, String[] signatures, int maxThreads);
+  
+  private native boolean[] checkSpendProofsJni(String[] txHashes, String[] messages, String[] signatures, int maxThreads);
+  
+  private native byte[] checkReserveProofsJni(String[] addresses, String[] messages, String[] signatures, int maxThreads, MoneroProgressListener listener);
+  
+  private native byte[] getAddressBookEntriesJni(int[] indices);
   
   private native int addAddressBookEntryJni(String address, String description);
   
@@ -1422,9 +2280,9 @@ public class MoneroWalletJni extends MoneroWalletBase {
   
   private native void deleteAddressBookEntryJni(int entryIdx);
   
-  private native String createPaymentUriJni(String sendRequestJson);
+  private native String createPaymentUriJni(byte[] sendRequestJson);
   
-  private native String parsePaymentUriJni(String uri);
+  private native byte[] parsePaymentUriJni(String uri);
   
   private native String getAttributeJni(String key);
   
@@ -1452,6 +2310,10 @@ public class MoneroWalletJni extends MoneroWalletBase {
   
   private native String[] submitMultisigTxHexJni(String signedMultisigTxHex);
   
+  private native static byte[] createMultisigGroupJni(long[] walletHandles, int threshold, String password);
+  
+  private native static int[] syncMultisigGroupJni(long[] walletHandles);
+  
   private native void saveJni();
   
   private native void moveToJni(String path, String password);
@@ -1473,8 +2335,16 @@ public class MoneroWalletJni extends MoneroWalletBase {
     }
     
     public void onSyncProgress(long height, long startHeight, long endHeight, double percentDone, String message) {
+      MoneroSyncStats stats = null;
       for (MoneroWalletListenerI listener : wallet.getListeners()) {
         listener.onSyncProgress(height, startHeight, endHeight, percentDone, message);
+        
+        // attach sync stats if collected and the listener receives them
+        MoneroSyncListener syncListener = listener instanceof SyncListenerWrapper ? ((SyncListenerWrapper) listener).listener : listener;
+        if (syncListener instanceof MoneroSyncStatsListener && wallet.isSyncStatsEnabled()) {
+          if (stats == null) stats = wallet.getSyncStats();
+          ((MoneroSyncStatsListener) syncListener).onSyncStats(stats);
+        }
       }
     }
     
@@ -1622,7 +2492,7 @@ public class MoneroWalletJni extends MoneroWalletBase {
     public KeyImagesContainer(List<MoneroKeyImage> keyImages) { this.keyImages = keyImages; };
   }
   
-  private static List<MoneroBlock> deserializeBlocks(String blocksJson) {
+  private static List<MoneroBlock> deserializeBlocks(byte[] blocksJson) {
     List<MoneroBlockWallet> blockWallets =  JsonUtils.deserialize(MoneroRpcConnection.MAPPER, blocksJson, BlocksContainer.class).blocks;
     List<MoneroBlock> blocks = new ArrayList<MoneroBlock>();
     if (blockWallets == null) return blocks;
@@ -1634,8 +2504,51 @@ public class MoneroWalletJni extends MoneroWalletBase {
     public List<MoneroAddressBookEntry> entries;
   }
   
+  private static class CheckReservesContainer {
+    public List<MoneroCheckReserve> checks;
+  }
+  
+  private static class MultisigInitResultsContainer {
+    public List<MoneroMultisigInitResult> results;
+  }
+  
+  private static class TxRelayResultsContainer {
+    public List<MoneroTxRelayResult> results;
+  }
+  
+  private static class SendPipelineStagesContainer {
+    public List<MoneroSendPipelineStageStats> stages;
+  }
+  
   // ---------------------------- PRIVATE HELPERS -----------------------------
   
+  /**
+   * Unpacks tx checks packed as [isGood, inTxPool, numConfirmations, receivedAmount] per check.
+   */
+  private static List<MoneroCheckTx> unpackCheckTxs(long[] packed) {
+    List<MoneroCheckTx> checks = new ArrayList<MoneroCheckTx>();
+    for (int i = 0; i < packed.length; i += 4) {
+      MoneroCheckTx check = new MoneroCheckTx();
+      check.setIsGood(packed[i] == 1);
+      if (check.isGood()) {
+        check.setInTxPool(packed[i + 1] == 1);
+        check.setNumConfirmations(packed[i + 2]);
+        check.setReceivedAmount(new BigInteger(Long.toUnsignedString(packed[i + 3])));
+      }
+      checks.add(check);
+    }
+    return checks;
+  }
+  
+  private static long[] getWalletHandles(List<MoneroWalletJni> wallets) {
+    long[] walletHandles = new long[wallets.size()];
+    for (int i = 0; i < wallets.size(); i++) {
+      wallets.get(i).assertNotClosed();
+      walletHandles[i] = wallets.get(i).jniWalletHandle;
+    }
+    return walletHandles;
+  }
+  
   /**
    * Enables or disables listening in the c++ wallet.
    */
@@ -1644,9 +2557,84 @@ public class MoneroWalletJni extends MoneroWalletBase {
   }
   
   private void assertNotClosed() {
+    assertKeysNotClosed();
+    if (isLoading) awaitLoaded();
+  }
+  
+  /**
+   * Asserts the wallet is not closed without waiting for a lazily opened
+   * wallet to load, for calls which only need the wallet's keys.
+   */
+  private void assertKeysNotClosed() {
     if (isClosed) throw new MoneroException("Wallet is closed");
   }
   
+  /**
+   * Waits for a lazily opened wallet to load and switches to it from its keys.
+   * 
+   * The keys are kept until the wallet is closed, so calls which read the
+   * handle before the switch may still answer from them.
+   */
+  private synchronized void awaitLoaded() {
+    if (!isLoading) return;
+    try {
+      jniWalletHandle = awaitWalletJni();
+    } catch (Exception e) {
+      throw new MoneroException(e.getMessage());
+    }
+    isLoading = false;
+    if (loadingDaemonConnection != null) setDaemonConnection(loadingDaemonConnection);
+    loadingDaemonConnection = null;
+  }
+  
+  private void assertOutputStoreBuilt() {
+    if (jniOutputStoreHandle == 0) throw new MoneroException("Output store is not built");
+  }
+  
+  /**
+   * Stop and delete the send pipeline.  Callers blocked on the pipeline are
+   * woken by the stop and return before it's deleted.
+   */
+  private synchronized void closeSendPipeline() {
+    if (jniSendPipelineHandle == 0) return;
+    try {
+      stopSendPipelineJni();
+    } catch (Exception e) {
+      throw new MoneroException(e.getMessage());
+    }
+    sendPipelineLock.writeLock().lock();
+    try {
+      deleteSendPipelineJni();
+      jniSendPipelineHandle = 0;
+    } finally {
+      sendPipelineLock.writeLock().unlock();
+    }
+    if (sendPipelineSigner != null) {
+      synchronized (sendPipelineSigner.signedPipelines) {
+        sendPipelineSigner.signedPipelines.remove(this);
+      }
+      sendPipelineSigner = null;
+    }
+  }
+  
+  private List<MoneroTxRelayResult> relayTxs(Collection<String> txMetadatas, int maxInFlight, boolean stopOnError) {
+    assertNotClosed();
+    String[] txMetadatasArr = txMetadatas.toArray(new String[txMetadatas.size()]);  // convert to array for jni
+    try {
+      return JsonUtils.deserialize(relayTxsJni(txMetadatasArr, maxInFlight, stopOnError), TxRelayResultsContainer.class).results;
+    } catch (Exception e) {
+      throw new MoneroException(e.getMessage());
+    }
+  }
+  
+  private void assertSendPipelineStarted() {
+    if (jniSendPipelineHandle == 0) throw new MoneroException("Send pipeline is not started");
+  }
+  
+  private void assertSyncStatsEnabled() {
+    if (!isSyncStatsEnabled) throw new MoneroException("Sync stats are not enabled");
+  }
+  
   private static MoneroAccount sanitizeAccount(MoneroAccount account) {
     if (account.getSubaddresses() != null) {
       for (MoneroSubaddress subaddress : account.getSubaddresses()) sanitizeSubaddress(subaddress);
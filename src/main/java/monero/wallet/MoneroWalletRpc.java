@@ -2214,7 +2214,7 @@ public class MoneroWalletRpc extends MoneroWalletBase {
       if (key.equals("amount")) output.setAmount((BigInteger) val);
       else if (key.equals("spent")) output.setIsSpent((Boolean) val);
       else if (key.equals("key_image")) output.setKeyImage(new MoneroKeyImage((String) val));
-      else if (key.equals("global_index")) output.setIndex(((BigInteger) val).intValue());
+      else if (key.equals("global_index")) output.setIndex(((BigInteger) val).longValue());
       else if (key.equals("tx_hash")) tx.setHash((String) val);
       else if (key.equals("unlocked")) tx.setIsLocked(!(Boolean) val);
       else if (key.equals("frozen")) output.setIsFrozen((Boolean) val);
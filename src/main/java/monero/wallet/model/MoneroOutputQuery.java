@@ -168,7 +168,7 @@ public class MoneroOutputQuery extends MoneroOutputWallet implements Filter<Mone
   }
 
   @Override
-  public MoneroOutputQuery setIndex(Integer index) {
+  public MoneroOutputQuery setIndex(Long index) {
     super.setIndex(index);
     return this;
   }
@@ -0,0 +1,15 @@
+package monero.wallet.model;
+
+/**
+ * Interface to receive progress notifications as a batch of work completes.
+ */
+public interface MoneroProgressListener {
+  
+  /**
+   * Invoked as items in the batch complete.
+   * 
+   * @param numDone is the number of items completed
+   * @param numTotal is the number of items in the batch
+   */
+  public void onProgress(long numDone, long numTotal);
+}
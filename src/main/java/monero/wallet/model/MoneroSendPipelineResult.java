@@ -0,0 +1,67 @@
+package monero.wallet.model;
+
+import java.util.List;
+
+import com.fasterxml.jackson.annotation.JsonIgnore;
+
+/**
+ * Result of a send request queued in a wallet's send pipeline.
+ */
+public class MoneroSendPipelineResult {
+  
+  private Long id;
+  private String state;  // queued, prepared, signed, relayed, or failed
+  private List<String> txHashes;
+  private String error;
+  private MoneroTxSet txSet;
+  
+  public Long getId() {
+    return id;
+  }
+  
+  public void setId(Long id) {
+    this.id = id;
+  }
+  
+  public String getState() {
+    return state;
+  }
+  
+  public void setState(String state) {
+    this.state = state;
+  }
+  
+  @JsonIgnore
+  public boolean isRelayed() {
+    return "relayed".equals(state);
+  }
+  
+  @JsonIgnore
+  public boolean isFailed() {
+    return "failed".equals(state);
+  }
+  
+  public List<String> getTxHashes() {
+    return txHashes;
+  }
+  
+  public void setTxHashes(List<String> txHashes) {
+    this.txHashes = txHashes;
+  }
+  
+  public String getError() {
+    return error;
+  }
+  
+  public void setError(String error) {
+    this.error = error;
+  }
+  
+  public MoneroTxSet getTxSet() {
+    return txSet;
+  }
+  
+  public void setTxSet(MoneroTxSet txSet) {
+    this.txSet = txSet;
+  }
+}
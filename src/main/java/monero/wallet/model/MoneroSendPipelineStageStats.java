@@ -0,0 +1,62 @@
+package monero.wallet.model;
+
+/**
+ * Queue depth and latency of a stage in a wallet's send pipeline.
+ */
+public class MoneroSendPipelineStageStats {
+  
+  private String name;
+  private Long queueDepth;
+  private Long numProcessed;
+  private Long numFailed;
+  private Double avgLatencyMs;
+  private Double maxLatencyMs;
+  
+  public String getName() {
+    return name;
+  }
+  
+  public void setName(String name) {
+    this.name = name;
+  }
+  
+  public Long getQueueDepth() {
+    return queueDepth;
+  }
+  
+  public void setQueueDepth(Long queueDepth) {
+    this.queueDepth = queueDepth;
+  }
+  
+  public Long getNumProcessed() {
+    return numProcessed;
+  }
+  
+  public void setNumProcessed(Long numProcessed) {
+    this.numProcessed = numProcessed;
+  }
+  
+  public Long getNumFailed() {
+    return numFailed;
+  }
+  
+  public void setNumFailed(Long numFailed) {
+    this.numFailed = numFailed;
+  }
+  
+  public Double getAvgLatencyMs() {
+    return avgLatencyMs;
+  }
+  
+  public void setAvgLatencyMs(Double avgLatencyMs) {
+    this.avgLatencyMs = avgLatencyMs;
+  }
+  
+  public Double getMaxLatencyMs() {
+    return maxLatencyMs;
+  }
+  
+  public void setMaxLatencyMs(Double maxLatencyMs) {
+    this.maxLatencyMs = maxLatencyMs;
+  }
+}
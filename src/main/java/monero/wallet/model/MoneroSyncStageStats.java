@@ -0,0 +1,53 @@
+package monero.wallet.model;
+
+/**
+ * Cumulative timing of a stage of a wallet's syncs.
+ */
+public class MoneroSyncStageStats {
+  
+  private String name;
+  private Long count;
+  private Double totalMs;
+  private Double avgMs;
+  private Double maxMs;
+  
+  public String getName() {
+    return name;
+  }
+  
+  public void setName(String name) {
+    this.name = name;
+  }
+  
+  public Long getCount() {
+    return count;
+  }
+  
+  public void setCount(Long count) {
+    this.count = count;
+  }
+  
+  public Double getTotalMs() {
+    return totalMs;
+  }
+  
+  public void setTotalMs(Double totalMs) {
+    this.totalMs = totalMs;
+  }
+  
+  public Double getAvgMs() {
+    return avgMs;
+  }
+  
+  public void setAvgMs(Double avgMs) {
+    this.avgMs = avgMs;
+  }
+  
+  public Double getMaxMs() {
+    return maxMs;
+  }
+  
+  public void setMaxMs(Double maxMs) {
+    this.maxMs = maxMs;
+  }
+}
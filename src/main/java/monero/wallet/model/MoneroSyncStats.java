@@ -0,0 +1,103 @@
+package monero.wallet.model;
+
+import java.util.List;
+
+/**
+ * Counters and stage timings of a wallet's syncs.
+ * 
+ * The "sync" stage times each call to sync() in native code, including
+ * upcalls to listeners, and each background sync from its first to its last
+ * progress notification.  The "process" stage is the time of each sync not
+ * spent waiting on the daemon, in which blocks are parsed and scanned.  The
+ * "fetchBlocks", "fetchPool", "checkKeyImages", and "otherRequests" stages
+ * time the wallet's daemon requests by kind and, with bytesDownloaded, are
+ * recorded while the wallet connects through the output cache.  The other
+ * stages time each kind of upcall to the wallet's listeners.
+ */
+public class MoneroSyncStats {
+  
+  private Long height;
+  private Long numBlocks;
+  private Long numBlocksFetched;
+  private Long numOutputsReceived;
+  private Long numOutputsSpent;
+  private Long bytesDownloaded;
+  private Double blocksPerSecond;
+  private List<MoneroSyncStageStats> stages;
+  
+  public Long getHeight() {
+    return height;
+  }
+  
+  public void setHeight(Long height) {
+    this.height = height;
+  }
+  
+  public Long getNumBlocks() {
+    return numBlocks;
+  }
+  
+  public void setNumBlocks(Long numBlocks) {
+    this.numBlocks = numBlocks;
+  }
+  
+  public Long getNumBlocksFetched() {
+    return numBlocksFetched;
+  }
+  
+  public void setNumBlocksFetched(Long numBlocksFetched) {
+    this.numBlocksFetched = numBlocksFetched;
+  }
+  
+  public Long getNumOutputsReceived() {
+    return numOutputsReceived;
+  }
+  
+  public void setNumOutputsReceived(Long numOutputsReceived) {
+    this.numOutputsReceived = numOutputsReceived;
+  }
+  
+  public Long getNumOutputsSpent() {
+    return numOutputsSpent;
+  }
+  
+  public void setNumOutputsSpent(Long numOutputsSpent) {
+    this.numOutputsSpent = numOutputsSpent;
+  }
+  
+  public Long getBytesDownloaded() {
+    return bytesDownloaded;
+  }
+  
+  public void setBytesDownloaded(Long bytesDownloaded) {
+    this.bytesDownloaded = bytesDownloaded;
+  }
+  
+  public Double getBlocksPerSecond() {
+    return blocksPerSecond;
+  }
+  
+  public void setBlocksPerSecond(Double blocksPerSecond) {
+    this.blocksPerSecond = blocksPerSecond;
+  }
+  
+  public List<MoneroSyncStageStats> getStages() {
+    return stages;
+  }
+  
+  public void setStages(List<MoneroSyncStageStats> stages) {
+    this.stages = stages;
+  }
+  
+  /**
+   * Get the timing of a stage by name.
+   * 
+   * @param name is the name of the stage
+   * @return the stage's timing or null if not found
+   */
+  public MoneroSyncStageStats getStage(String name) {
+    if (stages == null) return null;
+    for (MoneroSyncStageStats stage : stages) if (name.equals(stage.getName())) return stage;
+    return null;
+  }
+}
@@ -0,0 +1,15 @@
+package monero.wallet.model;
+
+/**
+ * Sync listener which also receives the wallet's sync stats with each progress
+ * notification while the wallet collects sync stats.
+ */
+public interface MoneroSyncStatsListener extends MoneroSyncListener {
+  
+  /**
+   * Invoked after onSyncProgress() while the wallet collects sync stats.
+   * 
+   * @param stats are the wallet's sync stats
+   */
+  public void onSyncStats(MoneroSyncStats stats);
+}
@@ -0,0 +1,33 @@
+package monero.wallet.model;
+
+import com.fasterxml.jackson.annotation.JsonIgnore;
+
+/**
+ * Result of relaying one tx in a batch.
+ */
+public class MoneroTxRelayResult {
+  
+  private String txHash;
+  private String error;
+  
+  public String getTxHash() {
+    return txHash;
+  }
+  
+  public void setTxHash(String txHash) {
+    this.txHash = txHash;
+  }
+  
+  public String getError() {
+    return error;
+  }
+  
+  public void setError(String error) {
+    this.error = error;
+  }
+  
+  @JsonIgnore
+  public boolean isRelayed() {
+    return error == null;
+  }
+}
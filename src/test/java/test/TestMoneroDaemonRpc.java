@@ -12,7 +12,9 @@ import java.math.BigInteger;
 import java.util.ArrayList;
 import java.util.Arrays;
 import java.util.Date;
+import java.util.HashMap;
 import java.util.List;
+import java.util.Map;
 import java.util.concurrent.TimeUnit;
 
 import org.junit.Before;
@@ -21,12 +23,14 @@ import org.junit.Ignore;
 import org.junit.Test;
 
 import common.utils.JsonUtils;
+import monero.daemon.MoneroBlockStream;
 import monero.daemon.MoneroDaemon;
 import monero.daemon.MoneroDaemonRpc;
 import monero.daemon.model.MoneroAltChain;
 import monero.daemon.model.MoneroBan;
 import monero.daemon.model.MoneroBlock;
 import monero.daemon.model.MoneroBlockHeader;
+import monero.daemon.model.MoneroBlockHeaderCacheStats;
 import monero.daemon.model.MoneroBlockTemplate;
 import monero.daemon.model.MoneroDaemonConnection;
 import monero.daemon.model.MoneroDaemonConnectionSpan;
@@ -351,6 +355,139 @@ public class TestMoneroDaemonRpc {
     testGetBlocksRange(endHeight - numBlocks - 1, null, height, true);
   };
   
+  // Can decode binary blocks quickly
+  @Test
+  public void testBinaryBlocksThroughput() {
+    org.junit.Assume.assumeTrue(TEST_NON_RELAYS && MoneroUtils.isJniLoaded());
+    
+    // fetch recent blocks in binary once
+    long height = daemon.getHeight();
+    List<Long> heights = new ArrayList<Long>();
+    for (long h = height - 100; h < height; h++) heights.add(h);
+    Map<String, Object> params = new HashMap<String, Object>();
+    params.put("heights", heights);
+    byte[] respBin = daemon.getRpcConnection().sendBinaryRequest("get_blocks_by_height.bin", params);
+    
+    // decode the same response repeatedly
+    int numIterations = 20;
+    long start = System.currentTimeMillis();
+    for (int i = 0; i < numIterations; i++) {
+      Map<String, Object> rpcResp = MoneroUtils.binaryBlocksToMap(respBin);
+      assertEquals(heights.size(), ((List<?>) rpcResp.get("blocks")).size());
+      assertEquals(heights.size(), ((List<?>) rpcResp.get("txs")).size());
+    }
+    long elapsedMs = Math.max(1, System.currentTimeMillis() - start);
+    System.out.println("Decoded " + respBin.length + " bytes of binary blocks " + numIterations + " times in " + elapsedMs + " ms (" + ((long) respBin.length * numIterations * 1000 / elapsedMs / 1024) + " KB/s)");
+  }
+  
+  // Can cache block headers natively with a bounded ring
+  @Test
+  public void testBlockHeaderCache() {
+    org.junit.Assume.assumeTrue(TEST_NON_RELAYS && MoneroUtils.isJniLoaded());
+    String uri = daemon.getRpcConnection().getUri();
+    
+    // cache headers by fetching a chunked range
+    MoneroUtils.clearBlockHeaderCache(uri);
+    long height = daemon.getHeight();
+    long startHeight = height - 100;
+    daemon.getBlocksByRangeChunked(startHeight, height - 1);
+    MoneroBlockHeaderCacheStats stats = MoneroUtils.getBlockHeaderCacheStats(uri);
+    assertTrue(stats.getNumHeaders() >= 100);
+    assertEquals(height - 1, MoneroUtils.getBlockHeaderCacheTipHeight(uri));
+    
+    // cached headers match the daemon's
+    List<MoneroBlockHeader> expectedHeaders = daemon.getBlockHeadersByRange(startHeight, startHeight + 9);
+    for (MoneroBlockHeader expected : expectedHeaders) {
+      MoneroBlockHeader cached = MoneroUtils.getCachedBlockHeader(uri, expected.getHeight());
+      assertNotNull(cached);
+      assertEquals(expected.getHash(), cached.getHash());
+      assertEquals(expected.getPrevHash(), cached.getPrevHash());
+      assertEquals(expected.getSize(), cached.getSize());
+      assertEquals(expected.getDifficulty(), cached.getDifficulty());
+      assertEquals(expected.getCumulativeDifficulty(), cached.getCumulativeDifficulty());
+      assertEquals(expected.getReward(), cached.getReward());
+      assertEquals(expected.getNumTxs(), cached.getNumTxs());
+    }
+    
+    // sizes are read without fetching
+    long[] sizes = new long[10];
+    assertEquals(10, MoneroUtils.getCachedBlockSizes(uri, startHeight, sizes));
+    assertTrue(MoneroUtils.getBlockHeaderCacheStats(uri).getHits() > stats.getHits());
+    
+    // another daemon's cache is separate
+    assertNull(MoneroUtils.getCachedBlockHeader(uri + "/other", startHeight));
+    
+    // headers which do not chain to the tip or the cached headers are rejected
+    MoneroBlockHeader tip = daemon.getLastBlockHeader();
+    MoneroUtils.setBlockHeaderCacheTip(uri, tip.getHeight(), tip.getHash(), tip.getHash());
+    String tipHash = tip.getHash();
+    assertFalse(MoneroUtils.putCachedBlockHeaders(uri, "0000000000000000000000000000000000000000000000000000000000000000", expectedHeaders));
+    List<MoneroBlockHeader> unlinked = new ArrayList<MoneroBlockHeader>(expectedHeaders);
+    unlinked.remove(5);
+    assertFalse(MoneroUtils.putCachedBlockHeaders(uri, tipHash, unlinked));
+    assertTrue(MoneroUtils.getBlockHeaderCacheStats(uri).getNumRejected() >= 2);
+    assertTrue(MoneroUtils.putCachedBlockHeaders(uri, tipHash, expectedHeaders));
+    
+    // invalid arguments are rejected
+    try {
+      MoneroUtils.setBlockHeaderCacheLimit(uri, -1);
+      fail("Should have rejected a negative limit");
+    } catch (MoneroException e) {
+      assertEquals("Header cache limit must be > 0", e.getMessage());
+    }
+    try {
+      MoneroUtils.getCachedBlockSizes(uri, -1, sizes);
+      fail("Should have rejected a negative height");
+    } catch (MoneroException e) {
+      assertEquals("Start height must be >= 0", e.getMessage());
+    }
+    
+    // cache stays within its limit
+    MoneroUtils.setBlockHeaderCacheLimit(uri, 50);
+    daemon.getBlocksByRangeChunked(startHeight, height - 1);
+    stats = MoneroUtils.getBlockHeaderCacheStats(uri);
+    assertEquals(50, (long) stats.getMaxHeaders());
+    assertTrue(stats.getNumHeaders() <= 50);
+    MoneroUtils.setBlockHeaderCacheLimit(uri, 32768);
+  }
+  
+  // Can stream blocks by range with prefetched chunks
+  @Test
+  public void testStreamBlocksByRange() {
+    org.junit.Assume.assumeTrue(TEST_NON_RELAYS && !LITE_MODE && MoneroUtils.isJniLoaded());
+    
+    // get long height range
+    long numBlocks = 2160;
+    long height = daemon.getHeight();
+    long startHeight = height - numBlocks;
+    long endHeight = height - 1;
+    
+    // fetch blocks with one request per chunk
+    long start = System.currentTimeMillis();
+    List<MoneroBlock> expected = daemon.getBlocksByRangeChunked(startHeight, endHeight, 500000l);
+    long sequentialMs = System.currentTimeMillis() - start;
+    
+    // stream blocks with up to 4 chunks in flight
+    start = System.currentTimeMillis();
+    List<MoneroBlock> streamed = new ArrayList<MoneroBlock>();
+    try (MoneroBlockStream stream = daemon.streamBlocksByRange(startHeight, endHeight, 500000l, 4)) {
+      assertTrue(stream.getNumChunks() > 1);
+      List<MoneroBlock> chunk;
+      while ((chunk = stream.next()) != null) streamed.addAll(chunk);
+    }
+    long streamedMs = System.currentTimeMillis() - start;
+    System.out.println("Fetched " + numBlocks + " blocks in " + sequentialMs + " ms sequentially and " + streamedMs + " ms streamed");
+    
+    // streamed blocks match in order
+    assertEquals(expected.size(), streamed.size());
+    for (int i = 0; i < streamed.size(); i++) {
+      assertEquals(startHeight + i, (long) streamed.get(i).getHeight());
+      assertEquals(expected.get(i).getHash(), streamed.get(i).getHash());
+      assertEquals(expected.get(i).getTxHashes(), streamed.get(i).getTxHashes());
+      testBlock(streamed.get(i), BINARY_BLOCK_CTX);
+    }
+  }
+  
   // Can get block hashes (binary)
   @Test
   public void testGetBlockIdsBinary() {
@@ -0,0 +1,527 @@
+package test;
+
+import static org.junit.Assert.assertEquals;
+import static org.junit.Assert.assertFalse;
+import static org.junit.Assert.assertNotEquals;
+import static org.junit.Assert.assertNull;
+import static org.junit.Assert.assertTrue;
+import static org.junit.Assert.fail;
+
+import java.math.BigInteger;
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.Collections;
+import java.util.List;
+import java.util.UUID;
+import java.util.concurrent.atomic.AtomicBoolean;
+
+import org.junit.AfterClass;
+import org.junit.Assume;
+import org.junit.BeforeClass;
+import org.junit.Test;
+
+import monero.daemon.MoneroBlockStream;
+import monero.daemon.MoneroDaemonRpc;
+import monero.daemon.model.MoneroBlock;
+import monero.daemon.model.MoneroOutput;
+import monero.daemon.model.MoneroOutputCacheStats;
+import monero.daemon.model.MoneroOutputDistributionEntry;
+import monero.utils.MoneroException;
+import monero.utils.MoneroUtils;
+import monero.wallet.MoneroWalletJni;
+import monero.wallet.model.MoneroCheckReserve;
+import monero.wallet.model.MoneroCheckTx;
+import monero.wallet.model.MoneroOutputQuery;
+import monero.wallet.model.MoneroOutputWallet;
+import monero.wallet.model.MoneroProgressListener;
+import monero.wallet.model.MoneroSendPipelineResult;
+import monero.wallet.model.MoneroSendRequest;
+import monero.wallet.model.MoneroSyncResult;
+import monero.wallet.model.MoneroSyncStageStats;
+import monero.wallet.model.MoneroSyncStats;
+import monero.wallet.model.MoneroSyncStatsListener;
+import monero.wallet.model.MoneroTxRelayResult;
+import monero.wallet.model.MoneroTxSet;
+import monero.wallet.model.MoneroTxWallet;
+import utils.FakeDaemon;
+import utils.TestUtils;
+
+/**
+ * Tests caches and native paths against a stand-in daemon serving a fake
+ * chain, so they run without a network.
+ *
+ * Skipped unless monero-java-fixtures is built and the JNI library is loaded.
+ */
+public class TestMoneroFakeDaemon {
+  
+  private static final BigInteger SEND_AMOUNT = BigInteger.valueOf(1000000000);
+  
+  private static FakeDaemon fakeDaemon;
+  private static MoneroDaemonRpc daemon;
+  
+  @BeforeClass
+  public static void setUpBeforeClass() throws Exception {
+    Assume.assumeTrue("monero-java-fixtures is not built", FakeDaemon.isAvailable());
+    Assume.assumeTrue("JNI library is not loaded", MoneroUtils.isJniLoaded());
+    fakeDaemon = FakeDaemon.start();
+    daemon = new MoneroDaemonRpc(fakeDaemon.getRpcConnection());
+  }
+  
+  @AfterClass
+  public static void tearDownAfterClass() {
+    if (fakeDaemon != null) fakeDaemon.close();
+  }
+  
+  // Can get outputs by amount and index and serve repeats from the output cache
+  @Test
+  public void testGetOutputsCached() {
+    String uri = daemon.getRpcConnection().getUri();
+    MoneroUtils.clearOutputCache(uri);
+    List<MoneroOutput> requests = new ArrayList<MoneroOutput>();
+    for (int i = 0; i < 10; i++) requests.add(new MoneroOutput().setAmount(BigInteger.valueOf(0)).setIndex((long) i));
+    List<MoneroOutput> outputs = daemon.getOutputs(requests);
+    assertEquals(requests.size(), outputs.size());
+    for (int i = 0; i < outputs.size(); i++) {
+      MoneroOutput output = outputs.get(i);
+      assertEquals(requests.get(i).getIndex(), output.getIndex());
+      assertEquals(64, output.getStealthPublicKey().length());
+      assertEquals(64, output.getCommitment().length());
+      assertEquals(64, output.getTx().getHash().length());
+      assertTrue(output.getTx().getHeight() >= 0);
+    }
+    
+    // fetch again which should hit the cache and return the same outputs
+    MoneroOutputCacheStats statsBefore = MoneroUtils.getOutputCacheStats(uri);
+    List<MoneroOutput> cachedOutputs = daemon.getOutputs(requests);
+    MoneroOutputCacheStats statsAfter = MoneroUtils.getOutputCacheStats(uri);
+    for (int i = 0; i < outputs.size(); i++) {
+      assertEquals(outputs.get(i).getStealthPublicKey(), cachedOutputs.get(i).getStealthPublicKey());
+      assertEquals(outputs.get(i).getCommitment(), cachedOutputs.get(i).getCommitment());
+    }
+    assertEquals(statsBefore.getOutputHits() + requests.size(), (long) statsAfter.getOutputHits());
+    
+    // outputs are not shared with other daemons whose chains may differ
+    assertEquals(0, (long) MoneroUtils.getOutputCacheStats("http://127.0.0.1:1").getNumOutputs());
+  }
+  
+  // Can get an output distribution and serve repeats from the output cache
+  @Test
+  public void testGetOutputDistributionCached() {
+    String uri = daemon.getRpcConnection().getUri();
+    MoneroUtils.clearOutputCache(uri);
+    List<BigInteger> amounts = Arrays.asList(BigInteger.valueOf(0));
+    List<MoneroOutputDistributionEntry> entries = daemon.getOutputDistribution(amounts);
+    assertEquals(1, entries.size());
+    assertEquals(fakeDaemon.getNumBlocks(), entries.get(0).getDistribution().size());
+    MoneroOutputCacheStats statsBefore = MoneroUtils.getOutputCacheStats(uri);
+    List<MoneroOutputDistributionEntry> cachedEntries = daemon.getOutputDistribution(amounts);
+    MoneroOutputCacheStats statsAfter = MoneroUtils.getOutputCacheStats(uri);
+    assertEquals(entries.get(0).getDistribution(), cachedEntries.get(0).getDistribution());
+    assertEquals(statsBefore.getDistributionHits() + 1, (long) statsAfter.getDistributionHits());
+  }
+  
+  // Can sync through the output cache proxy while reporting the proxied daemon
+  @Test
+  public void testOutputCacheProxy() {
+    String path = TestUtils.TEST_WALLETS_DIR + "/" + UUID.randomUUID().toString();
+    MoneroWalletJni wallet = MoneroWalletJni.createWalletFromMnemonic(path, TestUtils.WALLET_PASSWORD, TestUtils.NETWORK_TYPE, TestUtils.MNEMONIC, fakeDaemon.getRpcConnection(), 0l, null);
+    try {
+      wallet.setOutputCacheEnabled(true);
+      assertTrue(wallet.isOutputCacheEnabled());
+      assertEquals(fakeDaemon.getUri(), wallet.getDaemonConnection().getUri().toString());
+      assertTrue(wallet.isConnected());
+      wallet.sync();
+      assertEquals(fakeDaemon.getNumBlocks(), wallet.getHeight());
+      assertTrue(wallet.getBalance().compareTo(BigInteger.valueOf(0)) > 0);
+      
+      // the proxied daemon can be changed and the proxy disabled
+      wallet.setDaemonConnection(fakeDaemon.getRpcConnection());
+      assertEquals(fakeDaemon.getUri(), wallet.getDaemonConnection().getUri().toString());
+      wallet.setOutputCacheEnabled(false);
+      assertFalse(wallet.isOutputCacheEnabled());
+      assertEquals(fakeDaemon.getUri(), wallet.getDaemonConnection().getUri().toString());
+      assertTrue(wallet.isConnected());
+    } finally {
+      wallet.close();
+    }
+  }
+  
+  // Can collect sync stats of syncs and background syncs
+  @Test
+  public void testSyncStats() throws InterruptedException {
+    String path = TestUtils.TEST_WALLETS_DIR + "/" + UUID.randomUUID().toString();
+    MoneroWalletJni wallet = MoneroWalletJni.createWalletFromMnemonic(path, TestUtils.WALLET_PASSWORD, TestUtils.NETWORK_TYPE, TestUtils.MNEMONIC, fakeDaemon.getRpcConnection(), 0l, null);
+    try {
+      assertFalse(wallet.isSyncStatsEnabled());
+      try {
+        wallet.getSyncStats();
+        fail("Should have thrown exception");
+      } catch (MoneroException e) {
+        assertEquals("Sync stats are not enabled", e.getMessage());
+      }
+      
+      // sync through the output cache with a listener which receives stats
+      wallet.setOutputCacheEnabled(true);
+      wallet.setSyncStatsEnabled(true);
+      assertTrue(wallet.isSyncStatsEnabled());
+      List<MoneroSyncStats> received = new ArrayList<MoneroSyncStats>();
+      MoneroSyncResult result = wallet.sync(null, new MoneroSyncStatsListener() {
+        @Override
+        public void onSyncProgress(long height, long startHeight, long endHeight, double percentDone, String message) { }
+        @Override
+        public void onSyncStats(MoneroSyncStats stats) { received.add(stats); }
+      });
+      assertFalse(received.isEmpty());
+      
+      // test stats after syncing
+      MoneroSyncStats stats = wallet.getSyncStats();
+      assertEquals(result.getNumBlocksFetched(), stats.getNumBlocksFetched());
+      assertTrue(stats.getHeight() > 0);
+      assertTrue(stats.getNumBlocks() > 0);
+      assertTrue(stats.getNumOutputsReceived() > 0);
+      assertTrue(stats.getBytesDownloaded() > 0);
+      assertEquals(1, (long) stats.getStage("sync").getCount());
+      assertEquals(1, (long) stats.getStage("process").getCount());
+      assertTrue(stats.getStage("fetchBlocks").getCount() > 0);
+      assertTrue(stats.getStage("process").getTotalMs() <= stats.getStage("sync").getTotalMs());
+      assertTrue(stats.getStage("onSyncProgress").getCount() >= received.size());
+      assertTrue(stats.getBlocksPerSecond() > 0);
+      for (MoneroSyncStageStats stageStats : stats.getStages()) {
+        assertTrue(stageStats.getMaxMs() <= stageStats.getTotalMs());
+        assertTrue(stageStats.getAvgMs() <= stageStats.getMaxMs());
+      }
+      
+      // reset and disable stats
+      wallet.resetSyncStats();
+      assertEquals(0, (long) wallet.getSyncStats().getNumBlocks());
+      wallet.setSyncStatsEnabled(false);
+      assertFalse(wallet.isSyncStatsEnabled());
+    } finally {
+      wallet.close();
+    }
+    
+    // background syncs are recorded and stats can be disabled while syncing
+    path = TestUtils.TEST_WALLETS_DIR + "/" + UUID.randomUUID().toString();
+    wallet = MoneroWalletJni.createWalletFromMnemonic(path, TestUtils.WALLET_PASSWORD, TestUtils.NETWORK_TYPE, TestUtils.MNEMONIC, fakeDaemon.getRpcConnection(), 0l, null);
+    try {
+      wallet.setSyncStatsEnabled(true);
+      wallet.startSyncing();
+      long deadline = System.currentTimeMillis() + 60000;
+      while (wallet.getSyncStats().getStage("sync").getCount() == 0 && System.currentTimeMillis() < deadline) Thread.sleep(100);
+      MoneroSyncStats stats = wallet.getSyncStats();
+      assertTrue(stats.getStage("sync").getCount() > 0);
+      assertTrue(stats.getNumBlocksFetched() > 0);
+      assertTrue(stats.getBlocksPerSecond() > 0);
+      wallet.setSyncStatsEnabled(false);
+      wallet.setSyncStatsEnabled(true);
+      assertEquals(0, (long) wallet.getSyncStats().getNumBlocksFetched());
+      wallet.stopSyncing();
+    } finally {
+      wallet.close();
+    }
+  }
+  
+  // Can stream blocks in order with chunks fetched ahead of the consumer
+  @Test
+  public void testStreamBlocksByRange() {
+    long endHeight = fakeDaemon.getNumBlocks() - 1;
+    List<MoneroBlock> expected = daemon.getBlocksByRangeChunked(0l, endHeight, 20000l);
+    List<MoneroBlock> streamed = new ArrayList<MoneroBlock>();
+    try (MoneroBlockStream stream = daemon.streamBlocksByRange(0l, endHeight, 20000l, 4)) {
+      assertTrue(stream.getNumChunks() > 1);
+      List<MoneroBlock> chunk;
+      while ((chunk = stream.next()) != null) streamed.addAll(chunk);
+      assertNull(stream.next());
+    }
+    assertEquals(expected.size(), streamed.size());
+    for (int i = 0; i < streamed.size(); i++) {
+      assertEquals(i, (long) streamed.get(i).getHeight());
+      assertEquals(expected.get(i).getHash(), streamed.get(i).getHash());
+      assertEquals(expected.get(i).getTxHashes(), streamed.get(i).getTxHashes());
+    }
+    
+    // a chunk which fails is reported in order and later chunks are still delivered
+    long numBlocks = fakeDaemon.getNumBlocks();
+    long handle = MoneroUtils.startBlockStream(fakeDaemon.getUri(), null, null, new long[] { 0, numBlocks, 10 }, new long[] { 9, numBlocks + 9, 19 }, 2);
+    try {
+      assertEquals("OK", MoneroUtils.getNextBlockStreamChunk(handle).get("status"));
+      assertNotEquals("OK", MoneroUtils.getNextBlockStreamChunk(handle).get("status"));
+      assertEquals("OK", MoneroUtils.getNextBlockStreamChunk(handle).get("status"));
+      assertNull(MoneroUtils.getNextBlockStreamChunk(handle));
+    } finally {
+      MoneroUtils.stopBlockStream(handle);
+    }
+    
+    // chunks which can't connect report the error instead of ending the stream
+    handle = MoneroUtils.startBlockStream("http://127.0.0.1:1", null, null, new long[] { 0, 10 }, new long[] { 9, 19 }, 1);
+    try {
+      for (int i = 0; i < 2; i++) {
+        try {
+          MoneroUtils.getNextBlockStreamChunk(handle);
+          fail("Should have failed to connect");
+        } catch (Exception e) {
+          assertTrue(e.getMessage().contains("No connection to daemon"));
+        }
+      }
+      assertNull(MoneroUtils.getNextBlockStreamChunk(handle));
+    } finally {
+      MoneroUtils.stopBlockStream(handle);
+    }
+  }
+  
+  // Can relay txs all or nothing or with a result per tx, with the wallet recording each relayed tx
+  @Test
+  public void testRelayTxs() {
+    MoneroWalletJni wallet = createSyncedWallet();
+    try {
+      
+      // nothing is relayed if any metadata is invalid
+      List<String> txMetadatas = createTxMetadatas(wallet);
+      int numPoolTxs = daemon.getInfo().getNumTxsPool();
+      try {
+        List<String> invalidMetadatas = new ArrayList<String>(txMetadatas);
+        invalidMetadatas.add("invalid metadata");
+        wallet.relayTxs(invalidMetadatas);
+        fail("Should have failed to relay invalid metadata");
+      } catch (MoneroException e) {
+        assertEquals("Failed to parse tx metadata", e.getMessage());
+      }
+      assertEquals(numPoolTxs, (int) daemon.getInfo().getNumTxsPool());
+      
+      // relay one at a time without the output cache proxy
+      List<String> txHashes = wallet.relayTxs(txMetadatas);
+      assertEquals(txMetadatas.size(), txHashes.size());
+      assertRelayed(wallet, txHashes);
+      assertEquals(numPoolTxs + txHashes.size(), (int) daemon.getInfo().getNumTxsPool());
+      
+      // relay in parallel through the proxy, which does not fail the batch on an invalid entry
+      wallet.setOutputCacheEnabled(true);
+      txMetadatas = createTxMetadatas(wallet);
+      txMetadatas.add(0, "invalid metadata");
+      numPoolTxs = daemon.getInfo().getNumTxsPool();
+      List<MoneroTxRelayResult> results = wallet.relayTxs(txMetadatas, 4);
+      assertEquals(txMetadatas.size(), results.size());
+      assertFalse(results.get(0).isRelayed());
+      txHashes = new ArrayList<String>();
+      for (int i = 1; i < results.size(); i++) {
+        assertTrue(results.get(i).getError(), results.get(i).isRelayed());
+        txHashes.add(results.get(i).getTxHash());
+      }
+      assertRelayed(wallet, txHashes);
+      assertEquals(numPoolTxs + txHashes.size(), (int) daemon.getInfo().getNumTxsPool());
+    } finally {
+      wallet.close();
+    }
+  }
+  
+  // Can run the send pipeline while the wallet syncs in the background and from other threads
+  @Test
+  public void testSendPipelineWhileSyncing() throws InterruptedException {
+    MoneroWalletJni wallet = createSyncedWallet();
+    try {
+      wallet.startSyncing();
+      wallet.startSendPipeline(null, 4);
+      
+      // sync and switch the daemon connection from another thread while sends are prepared and relayed
+      List<Throwable> errors = Collections.synchronizedList(new ArrayList<Throwable>());
+      AtomicBoolean isDone = new AtomicBoolean(false);
+      Thread syncer = new Thread(() -> {
+        try {
+          boolean isOutputCacheEnabled = false;
+          while (!isDone.get()) {
+            wallet.sync();
+            isOutputCacheEnabled = !isOutputCacheEnabled;
+            wallet.setOutputCacheEnabled(isOutputCacheEnabled);
+          }
+        } catch (Throwable e) {
+          errors.add(e);
+        }
+      });
+      syncer.start();
+      try {
+        List<Long> ids = new ArrayList<Long>();
+        for (int i = 0; i < 3; i++) ids.add(wallet.queueSend(new MoneroSendRequest(0, wallet.getPrimaryAddress(), SEND_AMOUNT)));
+        for (long id : ids) {
+          MoneroSendPipelineResult result = wallet.getSendResult(id, true);
+          assertTrue(result.getError(), result.isRelayed());
+          assertRelayed(wallet, result.getTxHashes());
+        }
+      } finally {
+        isDone.set(true);
+        syncer.join(60000);
+      }
+      assertFalse(syncer.isAlive());
+      assertTrue(errors.toString(), errors.isEmpty());
+    } finally {
+      wallet.stopSendPipeline();
+      wallet.stopSyncing();
+      wallet.close();
+    }
+  }
+  
+  // Can check batches of tx keys, tx proofs, and spend proofs without the wallet as the wallet checks them
+  @Test
+  public void testCheckTxProofsBatch() {
+    MoneroWalletJni wallet = createSyncedWallet();
+    try {
+      
+      // send from an account no other test spends from so its outputs are not already spent in the pool
+      String address = wallet.getAddress(1, 0);
+      MoneroTxSet txSet = wallet.sendSplit(new MoneroSendRequest(2, address, SEND_AMOUNT));
+      List<String> txHashes = new ArrayList<String>();
+      List<String> txKeys = new ArrayList<String>();
+      List<String> addresses = new ArrayList<String>();
+      List<String> messages = new ArrayList<String>();
+      List<String> signatures = new ArrayList<String>();
+      List<String> spendSignatures = new ArrayList<String>();
+      for (MoneroTxWallet tx : txSet.getTxs()) {
+        txHashes.add(tx.getHash());
+        txKeys.add(wallet.getTxKey(tx.getHash()));
+        addresses.add(address);
+        messages.add("Test message");
+        signatures.add(wallet.getTxProof(tx.getHash(), address, "Test message"));
+        spendSignatures.add(wallet.getSpendProof(tx.getHash(), "Test message"));
+      }
+      
+      // batch checks match the wallet's checks
+      List<MoneroCheckTx> keyChecks = wallet.checkTxKeys(txHashes, txKeys, addresses);
+      List<MoneroCheckTx> proofChecks = wallet.checkTxProofs(txHashes, addresses, messages, signatures);
+      List<Boolean> spendChecks = wallet.checkSpendProofs(txHashes, messages, spendSignatures);
+      assertEquals(txHashes.size(), keyChecks.size());
+      assertEquals(txHashes.size(), proofChecks.size());
+      assertEquals(txHashes.size(), spendChecks.size());
+      for (int i = 0; i < txHashes.size(); i++) {
+        MoneroCheckTx keyCheck = wallet.checkTxKey(txHashes.get(i), txKeys.get(i), addresses.get(i));
+        MoneroCheckTx proofCheck = wallet.checkTxProof(txHashes.get(i), addresses.get(i), messages.get(i), signatures.get(i));
+        assertTrue(keyChecks.get(i).isGood());
+        assertEquals(keyCheck.getReceivedAmount(), keyChecks.get(i).getReceivedAmount());
+        assertEquals(keyCheck.getInTxPool(), keyChecks.get(i).getInTxPool());
+        assertEquals(keyCheck.getNumConfirmations(), keyChecks.get(i).getNumConfirmations());
+        assertTrue(proofChecks.get(i).isGood());
+        assertEquals(proofCheck.getReceivedAmount(), proofChecks.get(i).getReceivedAmount());
+        assertEquals(wallet.checkSpendProof(txHashes.get(i), messages.get(i), spendSignatures.get(i)), spendChecks.get(i));
+        assertTrue(spendChecks.get(i));
+      }
+      assertTrue(keyChecks.get(0).getReceivedAmount().compareTo(BigInteger.valueOf(0)) > 0);
+      
+      // a wrong entry does not fail the batch
+      txKeys.set(0, "invalid tx key");
+      messages.set(0, "Wrong message");
+      assertFalse(wallet.checkTxKeys(txHashes, txKeys, addresses).get(0).isGood());
+      assertFalse(wallet.checkTxProofs(txHashes, addresses, messages, signatures).get(0).isGood());
+      assertFalse(wallet.checkSpendProofs(txHashes, messages, spendSignatures).get(0));
+    } finally {
+      wallet.close();
+    }
+  }
+  
+  // Can check reserve proofs without the wallet as the wallet checks them
+  @Test
+  public void testCheckReserveProofs() {
+    MoneroWalletJni wallet = createSyncedWallet();
+    try {
+      
+      // a proof of the whole wallet covers many outputs to check in parallel
+      List<String> addresses = new ArrayList<String>();
+      List<String> messages = new ArrayList<String>();
+      List<String> signatures = new ArrayList<String>();
+      addresses.add(wallet.getPrimaryAddress());
+      messages.add("Test message");
+      signatures.add(wallet.getReserveProofWallet("Test message"));
+      addresses.add(wallet.getPrimaryAddress());
+      messages.add("Test message");
+      signatures.add(wallet.getReserveProofAccount(0, SEND_AMOUNT, "Test message"));
+      addresses.add(wallet.getPrimaryAddress());
+      messages.add("Wrong message");
+      signatures.add(signatures.get(0));
+      addresses.add(wallet.getAddress(0, 1));
+      messages.add("Test message");
+      signatures.add(signatures.get(0));
+      addresses.add(wallet.getPrimaryAddress());
+      messages.add("Test message");
+      signatures.add("wrong signature");
+      
+      // check batch and collect progress
+      List<Long> progress = new ArrayList<Long>();
+      List<MoneroCheckReserve> checks = wallet.checkReserveProofs(addresses, messages, signatures, new MoneroProgressListener() {
+        @Override
+        public void onProgress(long numDone, long numTotal) {
+          assertEquals(signatures.size(), numTotal);
+          progress.add(numDone);
+        }
+      });
+      assertEquals(signatures.size(), checks.size());
+      for (int i = 0; i < 2; i++) {
+        MoneroCheckReserve check = wallet.checkReserveProof(addresses.get(i), messages.get(i), signatures.get(i));
+        assertTrue(checks.get(i).isGood());
+        assertEquals(check.getTotalAmount(), checks.get(i).getTotalAmount());
+        assertEquals(check.getUnconfirmedSpentAmount(), checks.get(i).getUnconfirmedSpentAmount());
+      }
+      assertTrue(checks.get(0).getTotalAmount().compareTo(BigInteger.valueOf(0)) > 0);
+      for (int i = 2; i < checks.size(); i++) assertFalse(checks.get(i).isGood());
+      for (int i = 1; i < progress.size(); i++) assertTrue(progress.get(i) > progress.get(i - 1));
+      assertEquals((Long) (long) signatures.size(), progress.get(progress.size() - 1));
+    } finally {
+      wallet.close();
+    }
+  }
+  
+  // Can rebuild the output store once the wallet syncs
+  @Test
+  public void testOutputStoreRebuildsOnSync() {
+    String path = TestUtils.TEST_WALLETS_DIR + "/" + UUID.randomUUID().toString();
+    MoneroWalletJni wallet = MoneroWalletJni.createWalletFromMnemonic(path, TestUtils.WALLET_PASSWORD, TestUtils.NETWORK_TYPE, TestUtils.MNEMONIC, fakeDaemon.getRpcConnection(), 0l, null);
+    try {
+      
+      // store built before syncing is empty
+      wallet.buildOutputStore();
+      assertEquals(0, wallet.getOutputStoreSize());
+      assertEquals(BigInteger.valueOf(0), wallet.getOutputStoreBalance(null, null));
+      
+      // store reflects the synced outputs without being rebuilt by the caller
+      wallet.sync();
+      assertEquals(wallet.getBalance(), wallet.getOutputStoreBalance(null, null));
+      List<MoneroOutputWallet> outputs = wallet.getOutputStoreOutputs(null, null, null);
+      assertFalse(outputs.isEmpty());
+      assertEquals(outputs.size(), wallet.getOutputStoreSize());
+      for (MoneroOutputWallet output : outputs) {
+        assertTrue(output.getTx().isConfirmed());
+        assertTrue(output.getTx().getHeight() > 0);
+      }
+      
+      // store reflects outputs spent by a relayed tx without being rebuilt by the caller
+      MoneroTxSet txSet = wallet.sendSplit(new MoneroSendRequest(0, wallet.getPrimaryAddress(), SEND_AMOUNT));
+      List<String> txHashes = new ArrayList<String>();
+      for (MoneroTxWallet tx : txSet.getTxs()) txHashes.add(tx.getHash());
+      assertRelayed(wallet, txHashes);
+      assertEquals(wallet.getOutputs(new MoneroOutputQuery().setIsSpent(true)).size(), wallet.getOutputStoreOutputs(null, null, true).size());
+      assertEquals(wallet.getOutputs(new MoneroOutputQuery()).size(), wallet.getOutputStoreSize());
+    } finally {
+      wallet.freeOutputStore();
+      wallet.close();
+    }
+  }
+  
+  private static MoneroWalletJni createSyncedWallet() {
+    String path = TestUtils.TEST_WALLETS_DIR + "/" + UUID.randomUUID().toString();
+    MoneroWalletJni wallet = MoneroWalletJni.createWalletFromMnemonic(path, TestUtils.WALLET_PASSWORD, TestUtils.NETWORK_TYPE, TestUtils.MNEMONIC, fakeDaemon.getRpcConnection(), 0l, null);
+    wallet.sync();
+    return wallet;
+  }
+  
+  private static List<String> createTxMetadatas(MoneroWalletJni wallet) {
+    MoneroTxSet txSet = wallet.sendSplit(new MoneroSendRequest(0, wallet.getPrimaryAddress(), SEND_AMOUNT).setDoNotRelay(true));
+    List<String> txMetadatas = new ArrayList<String>();
+    for (MoneroTxWallet tx : txSet.getTxs()) txMetadatas.add(tx.getMetadata());
+    assertFalse(txMetadatas.isEmpty());
+    return txMetadatas;
+  }
+  
+  private static void assertRelayed(MoneroWalletJni wallet, List<String> txHashes) {
+    for (String txHash : txHashes) {
+      MoneroTxWallet tx = wallet.getTx(txHash);
+      assertTrue(tx.isRelayed());
+      assertTrue(tx.inTxPool());
+    }
+  }
+}
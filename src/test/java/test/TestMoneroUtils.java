@@ -2,9 +2,14 @@ package test;
 
 import static org.junit.Assert.assertEquals;
 import static org.junit.Assert.assertFalse;
+import static org.junit.Assert.assertNull;
 import static org.junit.Assert.assertTrue;
 import static org.junit.Assert.fail;
 
+import java.io.IOException;
+import java.nio.charset.StandardCharsets;
+import java.nio.file.Files;
+import java.nio.file.Path;
 import java.util.ArrayList;
 import java.util.Arrays;
 import java.util.HashMap;
@@ -14,11 +19,17 @@ import java.util.UUID;
 
 import org.junit.Test;
 
+import com.fasterxml.jackson.core.type.TypeReference;
+
+import common.utils.JsonUtils;
 import monero.daemon.model.MoneroNetworkType;
 import monero.utils.MoneroException;
 import monero.utils.MoneroUtils;
 import monero.wallet.MoneroWallet;
 import monero.wallet.MoneroWalletJni;
+import monero.wallet.model.MoneroAddressType;
+import monero.wallet.model.MoneroDecodedAddress;
+import monero.wallet.model.MoneroIntegratedAddress;
 import utils.TestUtils;
 
 /**
@@ -84,6 +95,103 @@ public class TestMoneroUtils {
     assertEquals(map, map2);
   }
   
+  // Can serialize nested objects and arrays
+  @Test
+  public void testSerializeNested() {
+    Map<String, Object> entry1 = new HashMap<String, Object>();
+    entry1.put("amount", 0);
+    entry1.put("index", 12345678);
+    Map<String, Object> entry2 = new HashMap<String, Object>();
+    entry2.put("amount", 0);
+    entry2.put("index", 87654321);
+    Map<String, Object> map = new HashMap<String, Object>();
+    map.put("outputs", Arrays.asList(entry1, entry2));
+    map.put("offsets", Arrays.asList(Arrays.asList(1, 2), Arrays.asList(3)));
+    map.put("delta", -42);
+    map.put("get_txid", true);
+    map.put("client", "monero-java");
+    byte[] binary = MoneroUtils.mapToBinary(map);
+    Map<String, Object> map2 = MoneroUtils.binaryToMap(binary);
+    assertEquals(map, map2);
+  }
+  
+  // Can serialize empty arrays and strings with escaped and non-ascii bytes
+  @Test
+  public void testSerializeEmptyAndEscaped() {
+    Map<String, Object> map = new HashMap<String, Object>();
+    map.put("heights", new ArrayList<Long>());
+    map.put("offsets", Arrays.asList(Arrays.asList(1, 2), new ArrayList<Long>()));
+    map.put("msg", "quote \" backslash \\ tab \t newline \n bell \u0007");
+    byte[] binary = MoneroUtils.mapToBinary(map);
+    Map<String, Object> map2 = MoneroUtils.binaryToMap(binary);
+    assertFalse(map2.containsKey("heights")); // omitted like epee omits empty containers
+    assertEquals(map.get("offsets"), map2.get("offsets"));
+    assertEquals(map.get("msg"), map2.get("msg"));
+    
+    // each byte of a non-ascii string is one char
+    map = new HashMap<String, Object>();
+    map.put("msg", "\u00e9");
+    assertEquals("\u00c3\u00a9", MoneroUtils.binaryToMap(MoneroUtils.mapToBinary(map)).get("msg"));
+  }
+  
+  // Can trace native calls and dump the trace as chrome trace events
+  @Test
+  public void testJniTrace() throws IOException {
+    Map<String, Object> map = new HashMap<String, Object>();
+    map.put("heights", Arrays.asList(111, 222, 333));
+    MoneroUtils.startJniTrace(1000);
+    try {
+      for (int i = 0; i < 10; i++) MoneroUtils.binaryToMap(MoneroUtils.mapToBinary(map));
+    } finally {
+      MoneroUtils.stopJniTrace();
+    }
+    
+    // dump and parse trace
+    Path path = Files.createTempFile("monero-java-trace", ".json");
+    try {
+      MoneroUtils.dumpJniTrace(path.toString());
+      Map<String, Object> trace = JsonUtils.deserialize(new String(Files.readAllBytes(path), StandardCharsets.UTF_8), new TypeReference<Map<String, Object>>(){});
+      @SuppressWarnings("unchecked")
+      List<Map<String, Object>> events = (List<Map<String, Object>>) trace.get("traceEvents");
+      int numToBinary = 0;
+      for (Map<String, Object> event : events) {
+        assertEquals("X", event.get("ph"));
+        assertTrue(((Number) event.get("dur")).doubleValue() >= 0);
+        if ("Java_monero_utils_MoneroUtils_jsonToBinaryJni".equals(event.get("name"))) numToBinary++;
+      }
+      assertEquals(10, numToBinary);
+    } finally {
+      Files.delete(path);
+    }
+    
+    // test invalid capacity
+    try {
+      MoneroUtils.startJniTrace(0);
+      fail("Should have thrown exception");
+    } catch (MoneroException e) {
+      assertEquals("Trace capacity must be greater than 0", e.getMessage());
+    }
+  }
+  
+  // Can serialize large requests quickly
+  @Test
+  public void testSerializeThroughput() {
+    List<Long> heights = new ArrayList<Long>();
+    for (long height = 0; height < 100000; height++) heights.add(1000000 + height);
+    Map<String, Object> map = new HashMap<String, Object>();
+    map.put("heights", heights);
+    int numIterations = 20;
+    long binaryBytes = 0;
+    long start = System.currentTimeMillis();
+    for (int i = 0; i < numIterations; i++) {
+      byte[] binary = MoneroUtils.mapToBinary(map);
+      binaryBytes += binary.length;
+      assertEquals(heights.size(), ((List<?>) MoneroUtils.binaryToMap(binary).get("heights")).size());
+    }
+    long elapsedMs = Math.max(1, System.currentTimeMillis() - start);
+    System.out.println("Converted " + binaryBytes / numIterations + " bytes of portable storage to and from json " + numIterations + " times in " + elapsedMs + " ms (" + (binaryBytes * 1000 / elapsedMs / 1024 / 1024) + " MB/s)");
+  }
+  
   @Test
   public void testAddressValidation() {
     
@@ -154,6 +262,57 @@ public class TestMoneroUtils {
     testInvalidAddress("718B5D2JmMh5TJVWFbygJR15dvio5Z5B24hfSrWDzeroM8j8Lqc9sMoFE6324xg2ReaAZqHJkgfGFRugRmYHugHZ4f17Gxo", MoneroNetworkType.STAGENET);
   }
   
+  @Test
+  public void testAddressValidationBatch() {
+    
+    // collect addresses with known validity
+    List<String> addresses = new ArrayList<String>();
+    addresses.add("42U9v3qs5CjZEePHBZHwuSckQXebuZu299NSmVEmQ41YJZQhKcPyujyMSzpDH4VMMVSBo3U3b54JaNvQLwAjqDhKS3rvM3L");
+    addresses.add("4CApvrfMgUFZEePHBZHwuSckQXebuZu299NSmVEmQ41YJZQhKcPyujyMSzpDH4VMMVSBo3U3b54JaNvQLwAjqDhKeGLQ9vfRBRKFKnBtVH");
+    addresses.add("891TQPrWshJVpnBR4ZMhHiHpLx1PUnMqa3ccV5TJFBbqcJa3DWhjBh2QByCv3Su7WDPTGMHmCKkiVFN2fyGJKwbM1t6G7Ea");
+    addresses.add("9tUBnNCkC3UKGygHCwYvAB1FscpjUuq5e9MYJd2rXuiiTjjfVeSVjnbSG5VTnJgBgy9Y7GTLfxpZNMUwNZjGfdFr1z79eV1");
+    addresses.add("5B8s3obCY2ETeQB3GNAGPK2zRGen5UeW1WzegSizVsmf6z5NvM2GLoN6zzk1vHyzGAAfA8pGhuYAeCFZjHAp59jRVQkunGS");
+    addresses.add("42ZxX3Y2y5s4nJ8fdz2w65TrTEp9PRsv5J8iHSShkHQcE2V31FhnWptioNst1K9oeDY4KpWZ7v8V2BZNVa4Wdky89iqmPz2");
+    addresses.add("");
+    
+    // validate addresses on any network and on mainnet
+    boolean[] valids = MoneroUtils.validateAddresses(addresses, null);
+    assertTrue(Arrays.equals(new boolean[] { true, true, true, true, true, false, false }, valids));
+    valids = MoneroUtils.validateAddresses(addresses, MoneroNetworkType.MAINNET);
+    assertTrue(Arrays.equals(new boolean[] { true, true, true, false, false, false, false }, valids));
+    
+    // decode address and network types
+    List<MoneroDecodedAddress> decodedAddresses = MoneroUtils.decodeAddresses(addresses);
+    assertEquals(MoneroAddressType.PRIMARY_ADDRESS, decodedAddresses.get(0).getAddressType());
+    assertEquals(MoneroAddressType.INTEGRATED_ADDRESS, decodedAddresses.get(1).getAddressType());
+    assertEquals(MoneroAddressType.SUBADDRESS, decodedAddresses.get(2).getAddressType());
+    assertEquals(MoneroNetworkType.TESTNET, decodedAddresses.get(3).getNetworkType());
+    assertEquals(MoneroNetworkType.STAGENET, decodedAddresses.get(4).getNetworkType());
+    assertNull(decodedAddresses.get(5));
+    assertNull(decodedAddresses.get(6));
+    
+    // build and decode integrated addresses
+    List<String> standardAddresses = Arrays.asList(addresses.get(0), addresses.get(0), addresses.get(2));
+    List<String> paymentIds = Arrays.asList("03284e41c342f036", null, "03284e41c342f036");
+    List<MoneroIntegratedAddress> integratedAddresses = MoneroUtils.getIntegratedAddresses(standardAddresses, paymentIds, MoneroNetworkType.MAINNET);
+    assertEquals("03284e41c342f036", integratedAddresses.get(0).getPaymentId());
+    assertEquals(16, integratedAddresses.get(1).getPaymentId().length());
+    assertNull(integratedAddresses.get(2)); // subaddresses cannot be integrated
+    List<String> integrateds = Arrays.asList(integratedAddresses.get(0).getIntegratedAddress(), integratedAddresses.get(1).getIntegratedAddress(), addresses.get(0));
+    List<MoneroIntegratedAddress> decodedIntegrateds = MoneroUtils.decodeIntegratedAddresses(integrateds, MoneroNetworkType.MAINNET);
+    assertEquals(integratedAddresses.get(0), decodedIntegrateds.get(0));
+    assertEquals(integratedAddresses.get(1), decodedIntegrateds.get(1));
+    assertNull(decodedIntegrateds.get(2));
+    
+    // print validation throughput
+    List<String> many = new ArrayList<String>();
+    for (int i = 0; i < 10000; i++) many.add(addresses.get(i % addresses.size()));
+    long startTime = System.currentTimeMillis();
+    MoneroUtils.validateAddresses(many, null);
+    long elapsed = Math.max(1, System.currentTimeMillis() - startTime);
+    System.out.println("Validated " + many.size() + " addresses in " + elapsed + " ms (" + (many.size() * 1000l / elapsed) + " addresses/s)");
+  }
+  
   // ---------------------------- PRIVATE HELPERS -----------------------------
   
   private static void testInvalidAddress(String address, MoneroNetworkType networkType) {
@@ -7,9 +7,16 @@ import static org.junit.Assert.assertNull;
 import static org.junit.Assert.assertTrue;
 import static org.junit.Assert.fail;
 
+import java.io.IOException;
 import java.math.BigInteger;
+import java.nio.charset.StandardCharsets;
+import java.nio.file.Files;
+import java.nio.file.Path;
 import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.Collections;
 import java.util.List;
+import java.util.Map;
 import java.util.UUID;
 import java.util.concurrent.TimeUnit;
 
@@ -17,6 +24,10 @@ import org.junit.BeforeClass;
 import org.junit.Ignore;
 import org.junit.Test;
 
+import com.fasterxml.jackson.core.type.TypeReference;
+
+import common.utils.JsonUtils;
+
 import monero.daemon.model.MoneroKeyImage;
 import monero.daemon.model.MoneroMiningStatus;
 import monero.daemon.model.MoneroNetworkType;
@@ -27,15 +38,25 @@ import monero.wallet.MoneroWallet;
 import monero.wallet.MoneroWalletJni;
 import monero.wallet.MoneroWalletRpc;
 import monero.wallet.model.MoneroAccount;
+import monero.wallet.model.MoneroAddressBookEntry;
+import monero.wallet.model.MoneroCheckReserve;
+import monero.wallet.model.MoneroCheckTx;
 import monero.wallet.model.MoneroDestination;
 import monero.wallet.model.MoneroMultisigInfo;
 import monero.wallet.model.MoneroMultisigInitResult;
 import monero.wallet.model.MoneroOutputQuery;
 import monero.wallet.model.MoneroOutputWallet;
+import monero.wallet.model.MoneroProgressListener;
+import monero.wallet.model.MoneroSendPipelineResult;
+import monero.wallet.model.MoneroSendPipelineStageStats;
 import monero.wallet.model.MoneroSendRequest;
+import monero.wallet.model.MoneroSubaddress;
 import monero.wallet.model.MoneroSyncResult;
 import monero.wallet.model.MoneroTransfer;
 import monero.wallet.model.MoneroTransferQuery;
+import monero.wallet.model.MoneroTxQuery;
+import monero.wallet.model.MoneroTxRelayResult;
+import monero.wallet.model.MoneroTxSet;
 import monero.wallet.model.MoneroTxWallet;
 import monero.wallet.model.MoneroWalletListener;
 import utils.StartMining;
@@ -956,6 +977,114 @@ public class TestMoneroWalletJni extends TestMoneroWalletCommon {
     assertFalse(MoneroWalletJni.walletExists(movedPath));
   }
   
+  // Can relay a batch of txs with a result per tx
+  @Test
+  public void testRelayTxsBatch() {
+    org.junit.Assume.assumeTrue(TEST_RELAYS);
+    TestUtils.TX_POOL_WALLET_TRACKER.waitForWalletTxsToClearPool(wallet);
+    
+    // create tx without relaying
+    MoneroTxSet txSet = wallet.sendSplit(new MoneroSendRequest(0, wallet.getPrimaryAddress(), TestUtils.MAX_FEE).setDoNotRelay(true));
+    List<String> txMetadatas = new ArrayList<String>();
+    txMetadatas.add("invalid metadata");
+    for (MoneroTxWallet tx : txSet.getTxs()) txMetadatas.add(tx.getMetadata());
+    
+    // relay batch with an invalid entry which does not fail the others
+    List<MoneroTxRelayResult> results = wallet.relayTxs(txMetadatas, 4);
+    assertEquals(txMetadatas.size(), results.size());
+    assertFalse(results.get(0).isRelayed());
+    assertNotNull(results.get(0).getError());
+    for (int i = 1; i < results.size(); i++) {
+      assertTrue(results.get(i).getError(), results.get(i).isRelayed());
+      assertEquals(txSet.getTxs().get(i - 1).getHash(), results.get(i).getTxHash());
+    }
+  }
+  
+  // Can prepare and relay queued sends through the send pipeline
+  @Test
+  public void testSendPipeline() {
+    org.junit.Assume.assumeTrue(TEST_RELAYS);
+    TestUtils.TX_POOL_WALLET_TRACKER.waitForWalletTxsToClearPool(wallet);
+    
+    // queue sends to self
+    wallet.startSendPipeline(null, 4);
+    try {
+      List<Long> ids = new ArrayList<Long>();
+      for (int i = 0; i < 3; i++) {
+        ids.add(wallet.queueSend(new MoneroSendRequest(0, wallet.getPrimaryAddress(), TestUtils.MAX_FEE)));
+      }
+      
+      // wait for results
+      for (long id : ids) {
+        MoneroSendPipelineResult result = wallet.getSendResult(id, true);
+        assertEquals((Long) id, result.getId());
+        assertTrue(result.getError(), result.isRelayed());
+        assertFalse(result.getTxHashes().isEmpty());
+        assertEquals(result.getTxSet().getTxs().size(), result.getTxHashes().size());
+        assertNull(wallet.getSendResult(id, false));  // forgotten once returned
+      }
+      
+      // check stage stats
+      List<MoneroSendPipelineStageStats> stats = wallet.getSendPipelineStats();
+      assertEquals(2, stats.size());  // prepare and relay without a signer
+      for (MoneroSendPipelineStageStats stageStats : stats) {
+        assertEquals(0, (long) stageStats.getQueueDepth());
+        assertEquals(ids.size(), (long) stageStats.getNumProcessed());
+        assertTrue(stageStats.getMaxLatencyMs() >= stageStats.getAvgLatencyMs());
+      }
+    } finally {
+      wallet.stopSendPipeline();
+    }
+  }
+  
+  // Can close a send pipeline's signer while callers wait on the pipeline's results
+  @Test
+  public void testSendPipelineSignerClosed() throws InterruptedException {
+    
+    // queue sends from an empty wallet so nothing is relayed
+    MoneroWalletJni emptyWallet = (MoneroWalletJni) createWalletRandom();
+    MoneroWalletJni signer = (MoneroWalletJni) createWalletRandom();
+    try {
+      emptyWallet.startSendPipeline(signer, 4);
+      List<Long> ids = new ArrayList<Long>();
+      for (int i = 0; i < 3; i++) {
+        ids.add(emptyWallet.queueSend(new MoneroSendRequest(0, wallet.getPrimaryAddress(), TestUtils.MAX_FEE)));
+      }
+      
+      // wait on results from other threads
+      List<MoneroSendPipelineResult> results = Collections.synchronizedList(new ArrayList<MoneroSendPipelineResult>());
+      List<Thread> waiters = new ArrayList<Thread>();
+      for (long id : ids) {
+        Thread waiter = new Thread(() -> {
+          try {
+            results.add(emptyWallet.getSendResult(id, true));
+          } catch (MoneroException e) {
+            assertEquals("Send pipeline is not started", e.getMessage());
+          }
+        });
+        waiter.start();
+        waiters.add(waiter);
+      }
+      
+      // closing the signer stops the pipeline and wakes its waiters
+      signer.close();
+      for (Thread waiter : waiters) {
+        waiter.join(60000);
+        assertFalse(waiter.isAlive());
+      }
+      for (MoneroSendPipelineResult result : results) assertTrue(result.isFailed());
+      try {
+        emptyWallet.queueSend(new MoneroSendRequest(0, wallet.getPrimaryAddress(), TestUtils.MAX_FEE));
+        fail("Should have failed after the signer closed");
+      } catch (MoneroException e) {
+        assertEquals("Send pipeline is not started", e.getMessage());
+      }
+    } finally {
+      signer.close();
+      emptyWallet.close();
+    }
+  }
+  
   // TODO: this version assumes a wallet can be saved after creation which is not currently supported in wallet2
 //  // Can save the wallet
 //  @Test
@@ -1078,6 +1207,140 @@ public class TestMoneroWalletJni extends TestMoneroWalletCommon {
     assertTrue(wallet.isClosed());
   }
   
+  // Can open a wallet's keys before loading its cache
+  @Test
+  public void testOpenWalletLazy() throws InterruptedException {
+    org.junit.Assume.assumeTrue(TEST_NON_RELAYS);
+    
+    // create and save a synced test wallet
+    String path = getRandomWalletPath();
+    MoneroWalletJni wallet = MoneroWalletJni.createWalletRandom(path, TestUtils.WALLET_PASSWORD, TestUtils.NETWORK_TYPE, TestUtils.DAEMON_RPC_URI);
+    wallet.sync();
+    long height = wallet.getHeight();
+    String mnemonic = wallet.getMnemonic();
+    String mnemonicLanguage = wallet.getMnemonicLanguage();
+    String primaryAddress = wallet.getPrimaryAddress();
+    String subaddress = wallet.getAddress(1, 2);
+    String privateViewKey = wallet.getPrivateViewKey();
+    String privateSpendKey = wallet.getPrivateSpendKey();
+    String publicViewKey = wallet.getPublicViewKey();
+    String publicSpendKey = wallet.getPublicSpendKey();
+    wallet.close(true);
+    
+    // keys are decrypted with the wallet's password
+    try {
+      MoneroWalletJni.openWalletLazy(path, "wrong password", TestUtils.NETWORK_TYPE);
+      fail("Should have failed to open wallet with wrong password");
+    } catch (MoneroException e) {
+      assertEquals("invalid password", e.getMessage());
+    }
+    
+    // open the wallet lazily and read its keys
+    long startTime = System.currentTimeMillis();
+    wallet = MoneroWalletJni.openWalletLazy(path, TestUtils.WALLET_PASSWORD, TestUtils.NETWORK_TYPE, TestUtils.getDaemonRpc().getRpcConnection());
+    assertEquals(mnemonic, wallet.getMnemonic());
+    assertEquals(mnemonicLanguage, wallet.getMnemonicLanguage());
+    assertEquals(primaryAddress, wallet.getPrimaryAddress());
+    assertEquals(subaddress, wallet.getAddress(1, 2));
+    assertEquals(privateViewKey, wallet.getPrivateViewKey());
+    assertEquals(privateSpendKey, wallet.getPrivateSpendKey());
+    assertEquals(publicViewKey, wallet.getPublicViewKey());
+    assertEquals(publicSpendKey, wallet.getPublicSpendKey());
+    assertEquals(TestUtils.NETWORK_TYPE, wallet.getNetworkType());
+    long keysTime = System.currentTimeMillis() - startTime;
+    
+    // other calls wait for the cache
+    assertEquals(height, wallet.getHeight());
+    assertTrue(wallet.isLoaded());
+    assertEquals(TestUtils.getDaemonRpc().getRpcConnection().getUri(), wallet.getDaemonConnection().getUri());
+    System.out.println("Opened wallet keys in " + keysTime + " ms, fully loaded in " + (System.currentTimeMillis() - startTime) + " ms");
+    wallet.close();
+    
+    // keys answer the same while another thread switches the wallet to its cache
+    MoneroWalletJni lazyWallet = MoneroWalletJni.openWalletLazy(path, TestUtils.WALLET_PASSWORD, TestUtils.NETWORK_TYPE);
+    Thread loader = new Thread(() -> lazyWallet.getHeight());
+    loader.start();
+    while (loader.isAlive()) assertEquals(subaddress, lazyWallet.getAddress(1, 2));
+    loader.join();
+    assertTrue(lazyWallet.isLoaded());
+    assertEquals(subaddress, lazyWallet.getAddress(1, 2));
+    lazyWallet.close();
+    
+    // close a lazily opened wallet before it loads
+    wallet = MoneroWalletJni.openWalletLazy(path, TestUtils.WALLET_PASSWORD, TestUtils.NETWORK_TYPE);
+    assertEquals(primaryAddress, wallet.getPrimaryAddress());
+    wallet.close();
+    assertTrue(wallet.isClosed());
+    try { wallet.getPrimaryAddress(); }
+    catch (MoneroException e) { assertEquals("Wallet is closed", e.getMessage()); }
+  }
+  
+  // Can open wallets concurrently
+  @Test
+  public void testOpenWallets() {
+    org.junit.Assume.assumeTrue(TEST_NON_RELAYS);
+    
+    // create and save test wallets
+    int numWallets = 4;
+    List<String> paths = new ArrayList<String>();
+    List<String> primaryAddresses = new ArrayList<String>();
+    for (int i = 0; i < numWallets; i++) {
+      String path = getRandomWalletPath() + "_" + i;
+      MoneroWalletJni wallet = MoneroWalletJni.createWalletRandom(path, TestUtils.WALLET_PASSWORD, TestUtils.NETWORK_TYPE);
+      paths.add(path);
+      primaryAddresses.add(wallet.getPrimaryAddress());
+      wallet.close(true);
+    }
+    List<String> passwords = new ArrayList<String>();
+    List<MoneroNetworkType> networkTypes = new ArrayList<MoneroNetworkType>();
+    for (int i = 0; i < numWallets; i++) {
+      passwords.add(TestUtils.WALLET_PASSWORD);
+      networkTypes.add(TestUtils.NETWORK_TYPE);
+    }
+    passwords.set(numWallets - 1, "wrong password");
+    
+    // open the wallets concurrently and collect errors
+    long startTime = System.currentTimeMillis();
+    List<MoneroException> errors = new ArrayList<MoneroException>();
+    List<MoneroWalletJni> wallets = MoneroWalletJni.openWallets(paths, passwords, networkTypes, errors);
+    System.out.println("Opened " + numWallets + " wallets concurrently in " + (System.currentTimeMillis() - startTime) + " ms");
+    assertEquals(numWallets, wallets.size());
+    assertEquals(numWallets, errors.size());
+    for (int i = 0; i < numWallets - 1; i++) {
+      assertNull(errors.get(i));
+      assertEquals(primaryAddresses.get(i), wallets.get(i).getPrimaryAddress());
+      wallets.get(i).close();
+    }
+    assertNull(wallets.get(numWallets - 1));
+    assertNotNull(errors.get(numWallets - 1));
+    
+    // a cache size limit smaller than any cache opens the wallets one at a time
+    startTime = System.currentTimeMillis();
+    MoneroUtils.startJniTrace(1000);
+    try {
+      wallets = MoneroWalletJni.openWallets(paths.subList(0, numWallets - 1), passwords.subList(0, numWallets - 1), networkTypes.subList(0, numWallets - 1), null, 0, 1);
+    } finally {
+      MoneroUtils.stopJniTrace();
+    }
+    System.out.println("Opened " + (numWallets - 1) + " wallets one at a time in " + (System.currentTimeMillis() - startTime) + " ms, peak resident memory: " + getPeakResidentMemory());
+    for (int i = 0; i < numWallets - 1; i++) {
+      assertEquals(primaryAddresses.get(i), wallets.get(i).getPrimaryAddress());
+      wallets.get(i).close();
+    }
+    List<double[]> opens = getTraceSpans("monero_wallet_core::open_wallet");
+    assertEquals(numWallets - 1, opens.size());
+    Collections.sort(opens, (a, b) -> Double.compare(a[0], b[0]));
+    for (int i = 1; i < opens.size(); i++) assertTrue("Throttled wallet opens overlap", opens.get(i - 1)[0] + opens.get(i - 1)[1] <= opens.get(i)[0] + 0.001); // microseconds
+    
+    // all wallets must open without an error list
+    try {
+      MoneroWalletJni.openWallets(paths, passwords, networkTypes, null);
+      fail("Should have thrown exception");
+    } catch (MoneroException e) {
+      assertEquals(errors.get(numWallets - 1).getMessage(), e.getMessage());
+    }
+  }
+  
   // ----------------------------- NOTIFICATION TESTS -------------------------
   
   /**
@@ -1331,6 +1594,376 @@ public class TestMoneroWalletJni extends TestMoneroWalletCommon {
     }
   }
   
+  // Can get the addresses of a range of subaddresses
+  @Test
+  public void testGetAddressesRange() {
+    org.junit.Assume.assumeTrue(TEST_NON_RELAYS);
+    
+    // ranges match addresses fetched one at a time, including the primary address
+    for (int accountIdx = 0; accountIdx < 2; accountIdx++) {
+      List<String> addresses = wallet.getAddresses(accountIdx, 0, 50);
+      assertEquals(50, addresses.size());
+      for (int i = 0; i < addresses.size(); i++) assertEquals(wallet.getAddress(accountIdx, i), addresses.get(i));
+    }
+    assertEquals(wallet.getPrimaryAddress(), wallet.getAddresses(0, 0, 1).get(0));
+    assertEquals(wallet.getAddress(0, 1000), wallet.getAddresses(0, 1000, 1001).get(0));
+    assertTrue(wallet.getAddresses(0, 5, 5).isEmpty());
+    
+    // invalid indices are rejected
+    for (int[] range : new int[][] { { -1, 0, 1 }, { 0, -1, 1 }, { 0, 5, 4 }, { 0, -2, -1 } }) {
+      try {
+        wallet.getAddresses(range[0], range[1], range[2]);
+        fail("Should have rejected account " + range[0] + " and range " + range[1] + " to " + range[2]);
+      } catch (MoneroException e) {
+        assertTrue(e.getMessage().startsWith("Account index") || e.getMessage().startsWith("Subaddress range"));
+      }
+    }
+    
+    // compare throughput against fetching one at a time
+    int numAddresses = 20000;
+    long startTime = System.currentTimeMillis();
+    for (int i = 0; i < numAddresses; i++) wallet.getAddress(0, i);
+    long loopTime = Math.max(1, System.currentTimeMillis() - startTime);
+    startTime = System.currentTimeMillis();
+    byte[] packed = wallet.getAddressesPacked(0, 0, numAddresses);
+    long rangeTime = Math.max(1, System.currentTimeMillis() - startTime);
+    assertTrue(packed.length > numAddresses);
+    System.out.println("Got " + numAddresses + " addresses one at a time at " + (numAddresses * 1000 / loopTime) + "/s and as a range at " + (numAddresses * 1000 / rangeTime) + "/s");
+  }
+  
+  // Can look up the subaddress indices of addresses in a compact table
+  @Test
+  public void testGetAddressIndicesTable() {
+    org.junit.Assume.assumeTrue(TEST_NON_RELAYS);
+    
+    // collect addresses in and out of the wallet
+    List<String> addresses = new ArrayList<String>();
+    addresses.add(wallet.getPrimaryAddress());
+    addresses.add(wallet.getAddress(0, 7));
+    addresses.add(wallet.getAddress(1, 3));
+    addresses.add(TestUtils.getRandomWalletAddress());
+    addresses.add("invalid address");
+    
+    // look up indices without and with the table
+    int[] walletIndices = wallet.getAddressIndices(addresses);
+    int numAccounts = 3;
+    int numSubaddresses = 50000;
+    long startTime = System.currentTimeMillis();
+    wallet.buildSubaddressTable(numAccounts, numSubaddresses);
+    System.out.println("Built subaddress table of " + wallet.getSubaddressTableSize() + " subaddresses in " + (System.currentTimeMillis() - startTime) + " ms using " + (wallet.getSubaddressTableMemorySize() / wallet.getSubaddressTableSize()) + " bytes per subaddress");
+    try {
+      assertEquals(numAccounts * numSubaddresses, wallet.getSubaddressTableSize());
+      int[] tableIndices = wallet.getAddressIndices(addresses);
+      assertEquals(addresses.size() * 2, tableIndices.length);
+      int[] expected = new int[] { 0, 0, 0, 7, 1, 3, -1, -1, -1, -1 };
+      for (int i = 0; i < expected.length; i++) {
+        assertEquals(expected[i], tableIndices[i]);
+        if (i < 2) assertEquals(expected[i], walletIndices[i]);
+      }
+      
+      // measure lookup latency
+      List<String> lookups = wallet.getAddresses(2, numSubaddresses - 1000, numSubaddresses);
+      startTime = System.nanoTime();
+      tableIndices = wallet.getAddressIndices(lookups);
+      long elapsed = System.nanoTime() - startTime;
+      for (int i = 0; i < lookups.size(); i++) {
+        assertEquals(2, tableIndices[i * 2]);
+        assertEquals(numSubaddresses - 1000 + i, tableIndices[i * 2 + 1]);
+      }
+      System.out.println("Looked up " + lookups.size() + " addresses in the subaddress table at " + (elapsed / lookups.size()) + " ns per address");
+    } finally {
+      wallet.freeSubaddressTable();
+    }
+    assertEquals(0, wallet.getSubaddressTableSize());
+    
+    // counts below 1 are rejected
+    for (int[] counts : new int[][] { { 0, 1 }, { 1, 0 }, { -1, 1 }, { 1, -1 } }) {
+      try {
+        wallet.buildSubaddressTable(counts[0], counts[1]);
+        fail("Should have rejected counts " + counts[0] + " and " + counts[1]);
+      } catch (MoneroException e) {
+        assertTrue(e.getMessage().endsWith("must be > 0"));
+      }
+    }
+    assertEquals(0, wallet.getSubaddressTableSize());
+  }
+  
+  // Can snapshot outputs into a compact store
+  @Test
+  public void testOutputStore() {
+    org.junit.Assume.assumeTrue(TEST_NON_RELAYS);
+    
+    // build the store
+    long startTime = System.currentTimeMillis();
+    wallet.buildOutputStore();
+    try {
+      long size = wallet.getOutputStoreSize();
+      System.out.println("Built output store of " + size + " outputs in " + (System.currentTimeMillis() - startTime) + " ms using " + (size == 0 ? 0 : wallet.getOutputStoreMemorySize() / size) + " bytes per output");
+      
+      // compare outputs with the wallet's
+      MoneroOutputQuery query = new MoneroOutputQuery().setAccountIndex(0).setIsSpent(false);
+      List<MoneroOutputWallet> walletOutputs = wallet.getOutputs(query);
+      startTime = System.nanoTime();
+      List<MoneroOutputWallet> storeOutputs = wallet.getOutputStoreOutputs(0, null, false);
+      System.out.println("Queried " + storeOutputs.size() + " outputs from the output store in " + ((System.nanoTime() - startTime) / 1000) + " us");
+      assertEquals(walletOutputs.size(), storeOutputs.size());
+      for (int i = 0; i < walletOutputs.size(); i++) {
+        assertEquals(walletOutputs.get(i).getAmount(), storeOutputs.get(i).getAmount());
+        assertEquals(walletOutputs.get(i).getKeyImage().getHex(), storeOutputs.get(i).getKeyImage().getHex());
+        assertEquals(walletOutputs.get(i).getTx().getHash(), storeOutputs.get(i).getTx().getHash());
+        assertEquals(walletOutputs.get(i).getSubaddressIndex(), storeOutputs.get(i).getSubaddressIndex());
+        assertFalse(storeOutputs.get(i).isSpent());
+      }
+      
+      // unspent outputs of an account sum to its balance
+      BigInteger sum = BigInteger.valueOf(0);
+      for (MoneroOutputWallet output : walletOutputs) sum = sum.add(output.getAmount());
+      assertEquals(sum, wallet.getOutputStoreBalance(0, null));
+    } finally {
+      wallet.freeOutputStore();
+    }
+    assertEquals(0, wallet.getOutputStoreSize());
+  }
+
+  
+  // Can create subaddresses in bulk
+  @Test
+  public void testCreateSubaddresses() {
+    org.junit.Assume.assumeTrue(TEST_NON_RELAYS);
+    int numSubaddressesBefore = wallet.getSubaddresses(0).size();
+    List<MoneroSubaddress> subaddresses = wallet.createSubaddresses(0, 5, "bulk");
+    assertEquals(5, subaddresses.size());
+    for (int i = 0; i < subaddresses.size(); i++) {
+      MoneroSubaddress subaddress = subaddresses.get(i);
+      assertEquals((Integer) 0, subaddress.getAccountIndex());
+      assertEquals((Integer) (numSubaddressesBefore + i), subaddress.getIndex());
+      assertEquals("bulk", subaddress.getLabel());
+      assertEquals(wallet.getAddress(0, subaddress.getIndex()), subaddress.getAddress());
+      assertEquals(subaddress.getAddress(), wallet.getSubaddress(0, subaddress.getIndex()).getAddress());
+    }
+    assertEquals(numSubaddressesBefore + 5, wallet.getSubaddresses(0).size());
+    
+    // negative arguments are rejected without creating subaddresses
+    try {
+      wallet.createSubaddresses(-1, 5, "bulk");
+      fail("Should have rejected a negative account index");
+    } catch (MoneroException e) {
+      assertEquals("Account index must be >= 0", e.getMessage());
+    }
+    try {
+      wallet.createSubaddresses(0, -5, "bulk");
+      fail("Should have rejected a negative number of subaddresses");
+    } catch (MoneroException e) {
+      assertEquals("Number of subaddresses must be >= 0", e.getMessage());
+    }
+    assertEquals(numSubaddressesBefore + 5, wallet.getSubaddresses(0).size());
+  }
+
+  // Can round trip text outside the basic multilingual plane through the native wallet
+  @Test
+  public void testUtf8RoundTrip() {
+    org.junit.Assume.assumeTrue(TEST_NON_RELAYS);
+    String text = "caf\u00e9 \u20ac \ud83d\ude00 \ud834\udd1e";
+
+    // subaddress label is returned in utf-8 json
+    MoneroSubaddress subaddress = wallet.createSubaddress(0, text);
+    assertEquals(text, subaddress.getLabel());
+    assertEquals(text, wallet.getSubaddress(0, subaddress.getIndex()).getLabel());
+
+    // address book description is returned in utf-8 json
+    int idx = wallet.addAddressBookEntry(wallet.getPrimaryAddress(), text);
+    try {
+      List<MoneroAddressBookEntry> entries = wallet.getAddressBookEntries(Arrays.asList(idx));
+      assertEquals(1, entries.size());
+      assertEquals(text, entries.get(0).getDescription());
+    } finally {
+      wallet.deleteAddressBookEntry(idx);
+    }
+
+    // attribute value is returned as a string
+    wallet.setAttribute("utf8", text);
+    assertEquals(text, wallet.getAttribute("utf8"));
+  }
+
+  // Can sign and verify batches of messages compatibly with sign() and verify()
+  @Test
+  public void testSignAndVerifyBatch() {
+    org.junit.Assume.assumeTrue(TEST_NON_RELAYS);
+    
+    // sign batch of messages
+    int numMsgs = 2000;
+    List<String> msgs = new ArrayList<String>();
+    List<String> addresses = new ArrayList<String>();
+    for (int i = 0; i < numMsgs; i++) {
+      msgs.add("Login challenge " + i + " " + UUID.randomUUID());
+      addresses.add(wallet.getPrimaryAddress());
+    }
+    List<String> signatures = wallet.signBatch(msgs);
+    assertEquals(numMsgs, signatures.size());
+    assertTrue(wallet.verify(msgs.get(0), addresses.get(0), signatures.get(0)));  // signatures are randomized so compare by verifying
+    signatures.set(1, wallet.sign(msgs.get(1)));
+    
+    // break a signature, an address, and a message
+    String randomAddress = TestUtils.getRandomWalletAddress();
+    signatures.set(2, "SigV1invalid");
+    addresses.set(3, randomAddress);
+    addresses.set(4, "invalid address");
+    msgs.set(5, "Tampered message");
+    
+    // verify batch
+    boolean[] goods = wallet.verifyBatch(msgs, addresses, signatures);
+    assertEquals(numMsgs, goods.length);
+    for (int i = 0; i < numMsgs; i++) assertEquals(i < 2 || i > 5, goods[i]);
+    
+    // compare throughput against verifying one at a time
+    long startTime = System.currentTimeMillis();
+    for (int i = 0; i < numMsgs; i++) wallet.verify(msgs.get(i), addresses.get(i), signatures.get(i));
+    long loopTime = Math.max(1, System.currentTimeMillis() - startTime);
+    startTime = System.currentTimeMillis();
+    wallet.verifyBatch(msgs, addresses, signatures);
+    long batchTime = Math.max(1, System.currentTimeMillis() - startTime);
+    System.out.println("Verified " + numMsgs + " signatures one at a time at " + (numMsgs * 1000 / loopTime) + "/s and in a batch at " + (numMsgs * 1000 / batchTime) + "/s");
+  }
+  
+  // Can check batches of tx keys, tx proofs, and spend proofs
+  @Test
+  public void testCheckTxProofsBatch() {
+    org.junit.Assume.assumeTrue(TEST_NON_RELAYS);
+    
+    // collect proofs of confirmed txs with outgoing destinations
+    List<MoneroTxWallet> txs = wallet.getTxs(new MoneroTxQuery().setIsConfirmed(true).setTransferQuery(new MoneroTransferQuery().setHasDestinations(true)));
+    assertFalse("No txs with outgoing destinations found; run send tests", txs.isEmpty());
+    if (txs.size() > 10) txs = txs.subList(0, 10);
+    List<String> txHashes = new ArrayList<String>();
+    List<String> txKeys = new ArrayList<String>();
+    List<String> addresses = new ArrayList<String>();
+    List<String> messages = new ArrayList<String>();
+    List<String> signatures = new ArrayList<String>();
+    List<String> spendSignatures = new ArrayList<String>();
+    for (MoneroTxWallet tx : txs) {
+      String address = tx.getOutgoingTransfer().getDestinations().get(0).getAddress();
+      txHashes.add(tx.getHash());
+      txKeys.add(wallet.getTxKey(tx.getHash()));
+      addresses.add(address);
+      messages.add("Test message");
+      signatures.add(wallet.getTxProof(tx.getHash(), address, "Test message"));
+      spendSignatures.add(wallet.getSpendProof(tx.getHash(), "Test message"));
+    }
+    
+    // batch checks match individual checks
+    List<MoneroCheckTx> keyChecks = wallet.checkTxKeys(txHashes, txKeys, addresses);
+    List<MoneroCheckTx> proofChecks = wallet.checkTxProofs(txHashes, addresses, messages, signatures);
+    List<Boolean> spendChecks = wallet.checkSpendProofs(txHashes, messages, spendSignatures);
+    assertEquals(txs.size(), keyChecks.size());
+    assertEquals(txs.size(), proofChecks.size());
+    assertEquals(txs.size(), spendChecks.size());
+    for (int i = 0; i < txs.size(); i++) {
+      MoneroCheckTx keyCheck = wallet.checkTxKey(txHashes.get(i), txKeys.get(i), addresses.get(i));
+      assertTrue(keyChecks.get(i).isGood());
+      assertEquals(keyCheck.getReceivedAmount(), keyChecks.get(i).getReceivedAmount());
+      assertEquals(keyCheck.getInTxPool(), keyChecks.get(i).getInTxPool());
+      assertTrue(proofChecks.get(i).isGood());
+      assertEquals(keyCheck.getReceivedAmount(), proofChecks.get(i).getReceivedAmount());
+      assertTrue(spendChecks.get(i));
+    }
+    
+    // a wrong entry does not fail the batch
+    txKeys.set(0, "invalid tx key");
+    messages.set(0, "Wrong message");
+    assertFalse(wallet.checkTxKeys(txHashes, txKeys, addresses).get(0).isGood());
+    assertFalse(wallet.checkTxProofs(txHashes, addresses, messages, signatures).get(0).isGood());
+    assertFalse(wallet.checkSpendProofs(txHashes, messages, spendSignatures).get(0));
+  }
+  
+  // Can check a batch of reserve proofs with progress
+  @Test
+  public void testCheckReserveProofs() {
+    org.junit.Assume.assumeTrue(TEST_NON_RELAYS);
+    
+    // get proofs of the wallet and its first account
+    List<String> addresses = new ArrayList<String>();
+    List<String> messages = new ArrayList<String>();
+    List<String> signatures = new ArrayList<String>();
+    addresses.add(wallet.getPrimaryAddress());
+    messages.add("Test message");
+    signatures.add(wallet.getReserveProofWallet("Test message"));
+    addresses.add(wallet.getPrimaryAddress());
+    messages.add("Test message");
+    signatures.add(wallet.getReserveProofAccount(0, TestUtils.MAX_FEE, "Test message"));
+    
+    // add proofs with a wrong message and a wrong signature
+    addresses.add(wallet.getPrimaryAddress());
+    messages.add("Wrong message");
+    signatures.add(signatures.get(0));
+    addresses.add(wallet.getPrimaryAddress());
+    messages.add("Test message");
+    signatures.add("wrong signature");
+    
+    // check batch and collect progress
+    List<Long> progress = new ArrayList<Long>();
+    List<MoneroCheckReserve> checks = wallet.checkReserveProofs(addresses, messages, signatures, new MoneroProgressListener() {
+      @Override
+      public void onProgress(long numDone, long numTotal) {
+        assertEquals(signatures.size(), numTotal);
+        progress.add(numDone);
+      }
+    });
+    assertEquals(signatures.size(), checks.size());
+    assertTrue(checks.get(0).isGood());
+    assertEquals(wallet.checkReserveProof(addresses.get(0), messages.get(0), signatures.get(0)).getTotalAmount(), checks.get(0).getTotalAmount());
+    assertTrue(checks.get(1).isGood());
+    assertFalse(checks.get(2).isGood());
+    assertFalse(checks.get(3).isGood());
+    assertFalse(progress.isEmpty());
+    assertEquals((Long) (long) signatures.size(), progress.get(progress.size() - 1));
+  }
+  
+  // Can make and sync a group of wallets multisig in one call
+  @Test
+  public void testMultisigGroup() {
+    testMultisigGroup(2, 2);
+    testMultisigGroup(2, 4);
+  }
+  
+  private void testMultisigGroup(int M, int N) {
+    
+    // create participating wallets
+    List<MoneroWalletJni> wallets = new ArrayList<MoneroWalletJni>();
+    for (int i = 0; i < N; i++) wallets.add((MoneroWalletJni) createWalletRandom());
+    
+    // make wallets multisig together
+    List<MoneroMultisigInitResult> results = MoneroWalletJni.createMultisigGroup(wallets, M, TestUtils.WALLET_PASSWORD);
+    assertEquals(N, results.size());
+    String address = results.get(0).getAddress();
+    assertNotNull(address);
+    for (int i = 0; i < N; i++) {
+      assertEquals(address, results.get(i).getAddress());
+      assertEquals(address, wallets.get(i).getPrimaryAddress());
+      MoneroMultisigInfo info = wallets.get(i).getMultisigInfo();
+      assertTrue(info.isMultisig());
+      assertTrue(info.isReady());
+      assertEquals(M, (int) info.getThreshold());
+      assertEquals(N, (int) info.getNumParticipants());
+    }
+    
+    // sync multisig hex among the wallets which have no outputs to sign
+    List<Integer> numOutputs = MoneroWalletJni.syncMultisigGroup(wallets);
+    assertEquals(N, numOutputs.size());
+    for (int num : numOutputs) assertEquals(0, num);
+    
+    // a wallet cannot participate twice
+    try {
+      List<MoneroWalletJni> duplicates = new ArrayList<MoneroWalletJni>();
+      duplicates.add(wallets.get(0));
+      duplicates.add(wallets.get(0));
+      MoneroWalletJni.syncMultisigGroup(duplicates);
+      fail("Should have thrown on duplicate wallet");
+    } catch (MoneroException e) {
+      assertTrue(e.getMessage().contains("more than once"));
+    }
+    for (MoneroWalletJni wallet : wallets) wallet.close();
+  }
+  
   // ---------------------------------- HELPERS -------------------------------
   
   /**
@@ -1365,6 +1998,40 @@ public class TestMoneroWalletJni extends TestMoneroWalletCommon {
     }
   }
   
+  // reads the process's peak resident memory on linux
+  /**
+   * Dumps the native trace and gets the [start, duration] of each span with the given name.
+   */
+  private static List<double[]> getTraceSpans(String name) {
+    try {
+      Path path = Files.createTempFile("monero-java-trace", ".json");
+      try {
+        MoneroUtils.dumpJniTrace(path.toString());
+        Map<String, Object> trace = JsonUtils.deserialize(new String(Files.readAllBytes(path), StandardCharsets.UTF_8), new TypeReference<Map<String, Object>>(){});
+        @SuppressWarnings("unchecked")
+        List<Map<String, Object>> events = (List<Map<String, Object>>) trace.get("traceEvents");
+        List<double[]> spans = new ArrayList<double[]>();
+        for (Map<String, Object> event : events) {
+          if (name.equals(event.get("name"))) spans.add(new double[] { ((Number) event.get("ts")).doubleValue(), ((Number) event.get("dur")).doubleValue() });
+        }
+        return spans;
+      } finally {
+        Files.delete(path);
+      }
+    } catch (IOException e) {
+      throw new RuntimeException(e);
+    }
+  }
+  
+  private static String getPeakResidentMemory() {
+    try {
+      for (String line : java.nio.file.Files.readAllLines(java.nio.file.Paths.get("/proc/self/status"))) {
+        if (line.startsWith("VmHWM:")) return line.substring("VmHWM:".length()).trim();
+      }
+    } catch (Exception e) { }
+    return "unknown";
+  }
+  
   public static String getRandomWalletPath() {
     return TestUtils.TEST_WALLETS_DIR + "/test_wallet_" + System.currentTimeMillis();
   }
@@ -0,0 +1,126 @@
+package utils;
+
+import java.io.BufferedReader;
+import java.io.File;
+import java.io.IOException;
+import java.io.InputStreamReader;
+import java.net.ServerSocket;
+
+import monero.rpc.MoneroRpcConnection;
+
+/**
+ * Stand-in daemon serving a fake chain which pays the test wallet, for
+ * tests which need a daemon but not a network.
+ *
+ * Runs ./build/monero-java-fixtures which is built by passing
+ * -DMONERO_JAVA_FIXTURES=ON to ./bin/build-libmonero-java.sh.  Generated
+ * chains are kept in the test wallets directory and reused.
+ */
+public class FakeDaemon implements AutoCloseable {
+  
+  public static final String FIXTURES_PATH = "./build/monero-java-fixtures";
+  public static final long DEFAULT_NUM_BLOCKS = 200;
+  public static final int DEFAULT_TXS_PER_BLOCK = 2;
+  
+  private Process process;
+  private String uri;
+  private long numBlocks;
+  
+  /**
+   * Indicates if the fixtures binary is built so a fake daemon can be started.
+   *
+   * @return true if a fake daemon can be started, false otherwise
+   */
+  public static boolean isAvailable() {
+    return new File(FIXTURES_PATH).canExecute();
+  }
+  
+  /**
+   * Start a fake daemon serving the default chain on a free local port.
+   *
+   * @return the started fake daemon
+   */
+  public static FakeDaemon start() {
+    return start(DEFAULT_NUM_BLOCKS, DEFAULT_TXS_PER_BLOCK);
+  }
+  
+  /**
+   * Start a fake daemon serving a chain on a free local port.
+   *
+   * @param numBlocks is the number of blocks in the chain including the genesis block
+   * @param txsPerBlock is the number of txs paying the test wallet per block
+   * @return the started fake daemon
+   */
+  public static FakeDaemon start(long numBlocks, int txsPerBlock) {
+    try {
+      
+      // generate chain if not previously generated
+      File testWalletsDir = new File(TestUtils.TEST_WALLETS_DIR);
+      if (!testWalletsDir.exists()) testWalletsDir.mkdirs();
+      String chainPath = TestUtils.TEST_WALLETS_DIR + "/fake_chain_" + numBlocks + "_" + txsPerBlock + ".bin";
+      if (!new File(chainPath).exists()) {
+        run(FIXTURES_PATH, "generate", chainPath, "--blocks", Long.toString(numBlocks), "--txs-per-block", Integer.toString(txsPerBlock), "--mnemonic", TestUtils.MNEMONIC);
+      }
+      
+      // serve chain until the daemon reports it's listening
+      int port = getFreePort();
+      FakeDaemon daemon = new FakeDaemon();
+      daemon.numBlocks = numBlocks;
+      daemon.uri = "http://127.0.0.1:" + port;
+      daemon.process = new ProcessBuilder(FIXTURES_PATH, "serve", chainPath, "--ip", "127.0.0.1", "--port", Integer.toString(port)).redirectErrorStream(true).start();
+      BufferedReader reader = new BufferedReader(new InputStreamReader(daemon.process.getInputStream()));
+      String line;
+      while ((line = reader.readLine()) != null && !line.startsWith("Serving")) { }
+      if (line == null) throw new RuntimeException("Fake daemon exited with code " + daemon.process.waitFor());
+      
+      // drain the daemon's output so it never blocks on a full pipe
+      Thread drainer = new Thread(() -> {
+        try {
+          while (reader.readLine() != null) { }
+        } catch (IOException e) { }
+      });
+      drainer.setDaemon(true);
+      drainer.start();
+      return daemon;
+    } catch (IOException | InterruptedException e) {
+      throw new RuntimeException(e);
+    }
+  }
+  
+  public String getUri() {
+    return uri;
+  }
+  
+  public MoneroRpcConnection getRpcConnection() {
+    return new MoneroRpcConnection(uri);
+  }
+  
+  /**
+   * Get the number of blocks served, so the daemon's height.
+   */
+  public long getNumBlocks() {
+    return numBlocks;
+  }
+  
+  @Override
+  public void close() {
+    process.destroy();
+    try {
+      process.waitFor();
+    } catch (InterruptedException e) {
+      throw new RuntimeException(e);
+    }
+  }
+  
+  private static int getFreePort() throws IOException {
+    try (ServerSocket socket = new ServerSocket(0)) {
+      return socket.getLocalPort();
+    }
+  }
+  
+  private static void run(String... command) throws IOException, InterruptedException {
+    Process process = new ProcessBuilder(command).inheritIO().start();
+    int code = process.waitFor();
+    if (code != 0) throw new RuntimeException("Command failed with code " + code + ": " + String.join(" ", command));
+  }
+}